@@ -22,6 +22,7 @@
 #define EXTERN extern "C"
 #else
 #define EXTERN
+#include <stdbool.h>
 #endif
 
 
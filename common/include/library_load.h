@@ -35,6 +35,7 @@
 #define xt_ulong    unsigned long
 
 struct xtlib_packaged_library;
+struct xf_lib_cache;
 
 enum {
 	XTLIB_NO_ERR = 0,
@@ -100,10 +101,14 @@ struct lib_info {
 
 	const char   *filename;
 	unsigned int lib_type;
+
+	/* ...cached image; code section is owned by the cache when shared */
+	struct xf_lib_cache *cache;
 };
 
 long xf_load_lib(xaf_comp_t *handle, struct lib_info *lib_info);
 long xf_unload_lib(xaf_comp_t *handle, struct lib_info *lib_info);
 XAF_ERR_CODE xaf_load_library(xaf_adev_t *p_adev, xaf_comp_t *p_comp, xf_id_t comp_id);
+void xf_lib_cache_flush(xaf_adev_t *p_adev);
 
 #endif
@@ -0,0 +1,131 @@
+/*****************************************************************
+ * Copyright 2018 NXP
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************/
+
+
+#ifndef __LIBRARY_PRELINK_H
+#define __LIBRARY_PRELINK_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Pre-linked codec library image ("<library>.plk")
+ *
+ * Produced offline by xtlib-prelink for a DSP code buffer address. Dynamic
+ * section parsing and relocation are done by the tool: code and data images
+ * hold relocated values for that code address and for a data buffer at zero,
+ * and every relocated word is listed in a fixup table. The loader copies both
+ * images and adds the actual data address (and the code displacement, if the
+ * code buffer moved) to the listed words, so every instance is loaded without
+ * ELF parsing and DSP skips relocation (rela_count is zero).
+ *
+ * Layout: header, code image (code_size bytes), data image (data_size bytes),
+ * fixup table (fixup_count words).
+ */
+
+#define XTLIB_PRELINK_MAGIC	0x4b4c5058	/* "XPLK" */
+#define XTLIB_PRELINK_VERSION	2
+#define XTLIB_PRELINK_SUFFIX	".plk"
+
+/* ...relocation types handled on host */
+#define XTLIB_R_XTENSA_NONE	0
+#define XTLIB_R_XTENSA_RELATIVE	5
+
+/* ...fixup entry: segment offset of the word, location and target flags */
+#define XTLIB_PRELINK_FIXUP_IN_DATA	0x80000000	/* word is in data image */
+#define XTLIB_PRELINK_FIXUP_TO_DATA	0x40000000	/* word refers to data */
+#define XTLIB_PRELINK_FIXUP_OFFS(f)	((f) & 0x3fffffff)
+
+/* ...pil_info words (struct xtlib_pil_info) */
+#define XTLIB_PRELINK_PIL_WORDS	14
+
+struct xtlib_prelink_header {
+	uint32_t magic;
+	uint32_t version;
+
+	/* ...size and checksum of the library file image was built from */
+	uint32_t lib_size;
+	uint32_t lib_checksum;
+
+	/* ...checksum of code, data images and fixup table following the header */
+	uint32_t image_checksum;
+
+	/* ...DSP address of code buffer (before alignment) images are linked for */
+	uint32_t code_addr;
+
+	/* ...code image size; it is placed at aligned code address */
+	uint32_t code_size;
+
+	/* ...data image size and offset from aligned data address */
+	uint32_t data_size;
+	uint32_t data_offs;
+
+	/* ...section alignment and number of fixup entries */
+	uint32_t align;
+	uint32_t fixup_count;
+
+	/* ...struct xtlib_pil_info for code_addr and data buffer at zero */
+	uint32_t pil_info[XTLIB_PRELINK_PIL_WORDS];
+};
+
+/* ...FNV-1a checksum; pass XTLIB_PRELINK_SEED for the first block */
+#define XTLIB_PRELINK_SEED	2166136261u
+
+static inline uint32_t xtlib_prelink_checksum(const void *data, size_t size,
+					      uint32_t hash)
+{
+	const unsigned char *p = data;
+
+	while (size--)
+		hash = (hash ^ *p++) * 16777619u;
+
+	return hash;
+}
+
+/* ...size of the image following the header */
+static inline size_t xtlib_prelink_body_size(const struct xtlib_prelink_header *plk)
+{
+	return (size_t)plk->code_size + plk->data_size +
+	       (size_t)plk->fixup_count * sizeof(uint32_t);
+}
+
+/* ...build pre-linked image of split-load PI library for code buffer at
+ * code_addr; returns malloc'ed image, or NULL with error description set
+ */
+struct xtlib_prelink_header *xtlib_prelink_build(const unsigned char *image,
+						 size_t size,
+						 uint32_t code_addr,
+						 const char **err);
+
+/* ...copy pre-linked image to code (if load_code is set; shared code is
+ * already in place) and data buffers, relocate it for their DSP addresses
+ * and fill pil_info; virtual pointers are advanced to aligned addresses, as
+ * the PI loader does
+ */
+void xtlib_prelink_load(const struct xtlib_prelink_header *plk,
+			void **code_virt, uint32_t code_phys,
+			void **data_virt, uint32_t data_phys,
+			int load_code,
+			uint32_t pil_info[XTLIB_PRELINK_PIL_WORDS]);
+
+#endif
@@ -28,7 +28,12 @@
 #include <elf.h>
 #include <errno.h>
 #include <stdbool.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include "library_load.h"
+#include "library_prelink.h"
 #include "fsl_unia.h"
 
 static Elf32_Half xtlib_host_half(Elf32_Half v, int byteswap)
@@ -394,7 +399,8 @@ static xt_ptr xtlib_load_split_pi_library_common(
 				xt_ptr destination_code_address,
 				xt_ptr destination_data_address,
 				struct xtlib_pil_info *info,
-				struct lib_info *lib_info)
+				struct lib_info *lib_info,
+				int load_code)
 {
 	struct xtlib_loader_globals *xtlib_globals =
 					&lib_info->xtlib_globals;
@@ -441,12 +447,13 @@ static xt_ptr xtlib_load_split_pi_library_common(
 		return 0;
 	}
 
-	/* loading code */
-	xtlib_load_seg(&pheader[0],
-		       (char *)library + xtlib_host_word(pheader[0].p_offset,
-			xtlib_globals->byteswap),
-			(xt_ptr)lib_info->code_buf_virt,
-			lib_info);
+	/* loading code (unless it is shared and already in place) */
+	if (load_code)
+		xtlib_load_seg(&pheader[0],
+			       (char *)library + xtlib_host_word(pheader[0].p_offset,
+				xtlib_globals->byteswap),
+				(xt_ptr)lib_info->code_buf_virt,
+				lib_info);
 
 	if (info->text_addr == 0)
 		info->text_addr =
@@ -476,90 +483,457 @@ static xt_ptr xtlib_host_load_split_pi_library(
 				  xt_ptr destination_code_address,
 				  xt_ptr destination_data_address,
 				  struct xtlib_pil_info *info,
-				  struct lib_info *lib_info)
+				  struct lib_info *lib_info,
+				  int load_code)
 {
 	return  xtlib_load_split_pi_library_common(library,
 					      destination_code_address,
 					      destination_data_address,
 					      info,
-					      lib_info);
+					      lib_info,
+					      load_code);
+}
+
+/* ...library image cache entry; one per library file opened on a device.
+ * The file is mapped read-only and validated once; segments are copied into
+ * DSP memory straight from the mapping. Read-only code section is loaded into
+ * DSP memory once and shared by all instances, unless the library has code
+ * relocations; data section is cloned for every instance as DSP relocates it
+ * in place. Idle entries are kept for the next instance until the file is
+ * replaced, DSP memory runs short or the device is closed. A pre-linked image
+ * ("<library>.plk") found next to the library is mapped along with it.
+ */
+struct xf_lib_cache {
+	struct xf_lib_cache *next;
+
+	/* ...cache key */
+	char		 *filename;
+	time_t		 mtime;
+	off_t		 size;
+
+	/* ...read-only mapping of library file */
+	unsigned char	 *image;
+
+	/* ...validated pre-linked image, if any */
+	struct xtlib_prelink_header *prelink;
+	size_t		 prelink_size;
+
+	/* ...memoized section sizes (including alignment) */
+	unsigned int	 size_code;
+	unsigned int	 size_data;
+	unsigned int	 align;
+	int		 byteswap;
+
+	/* ...shared code section; NULL if every instance needs its own copy */
+	struct xf_pool	 *code_section_pool;
+	void		 *code_buf_virt;
+	unsigned int	 code_buf_phys;
+
+	unsigned int	 refcount;
+	bool		 stale;
+};
+
+/* ...check that headers and segments lie within the mapped file */
+static bool xtlib_image_in_bounds(Elf32_Ehdr *header, off_t size,
+				  struct lib_info *lib_info)
+{
+	int byteswap = lib_info->xtlib_globals.byteswap;
+	Elf32_Word phoff = xtlib_host_word(header->e_phoff, byteswap);
+	Elf32_Word shoff = xtlib_host_word(header->e_shoff, byteswap);
+	Elf32_Half shnum = xtlib_host_half(header->e_shnum, byteswap);
+	Elf32_Phdr *pheader;
+	int seg;
+
+	if ((off_t)phoff + 3 * sizeof(Elf32_Phdr) > size ||
+	    (off_t)shoff + shnum * sizeof(Elf32_Shdr) > size)
+		return false;
+
+	pheader = (Elf32_Phdr *)((char *)header + phoff);
+
+	for (seg = 0; seg < 3; seg++)
+		if ((off_t)xtlib_host_word(pheader[seg].p_offset, byteswap) +
+		    xtlib_host_word(pheader[seg].p_filesz, byteswap) > size)
+			return false;
+
+	return true;
+}
+
+/* ...check that no relocation targets code segment (so it can be shared) */
+static bool xtlib_code_is_shareable(Elf32_Ehdr *header,
+				    struct lib_info *lib_info)
+{
+	int byteswap = lib_info->xtlib_globals.byteswap;
+	Elf32_Phdr *pheader = (Elf32_Phdr *)((char *)header +
+				xtlib_host_word(header->e_phoff, byteswap));
+	Elf32_Dyn *dyn_entry = find_dynamic_info(header, lib_info);
+	Elf32_Word data_offs = xtlib_host_word(pheader[1].p_paddr, byteswap);
+	Elf32_Word rela = 0, relasz = 0;
+	Elf32_Rela *relocations;
+	unsigned int i;
+
+	if (dyn_entry == 0)
+		return false;
+
+	for (; dyn_entry->d_tag != DT_NULL; dyn_entry++) {
+		switch ((Elf32_Sword)xtlib_host_word(
+				(Elf32_Word)dyn_entry->d_tag, byteswap)) {
+		case DT_RELA:
+			rela = xtlib_host_word(dyn_entry->d_un.d_ptr, byteswap);
+			break;
+		case DT_RELASZ:
+			relasz = xtlib_host_word(dyn_entry->d_un.d_val, byteswap);
+			break;
+		default:
+			break;
+		}
+	}
+
+	/* ...relocation table is expected within data segment */
+	if (relasz == 0)
+		return true;
+	if (rela < data_offs)
+		return false;
+
+	if (rela - data_offs + relasz > xtlib_host_word(pheader[1].p_filesz, byteswap))
+		return false;
+
+	relocations = (Elf32_Rela *)((char *)header +
+			xtlib_host_word(pheader[1].p_offset, byteswap) +
+			(rela - data_offs));
+
+	for (i = 0; i < relasz / sizeof(Elf32_Rela); i++)
+		if (xtlib_host_word(relocations[i].r_offset, byteswap) < data_offs)
+			return false;
+
+	return true;
+}
+
+static void xf_lib_cache_free(struct xf_lib_cache *cache)
+{
+	if (cache->code_section_pool)
+		xf_pool_free(cache->code_section_pool, XAF_MEM_ID_COMP);
+	if (cache->image)
+		munmap(cache->image, cache->size);
+	if (cache->prelink)
+		munmap(cache->prelink, cache->prelink_size);
+	free(cache->filename);
+	free(cache);
+}
+
+/* ...release idle entries (all or stale only); cache lock is held */
+static int xf_lib_cache_evict(xaf_adev_t *p_adev, bool all)
+{
+	struct xf_lib_cache **link = (struct xf_lib_cache **)&p_adev->lib_cache;
+	struct xf_lib_cache *cache;
+	int n = 0;
+
+	while ((cache = *link) != NULL) {
+		if (cache->refcount == 0 && (all || cache->stale)) {
+			*link = cache->next;
+			TRACE(INFO, _b("library %s evicted from cache\n"), cache->filename);
+			xf_lib_cache_free(cache);
+			n++;
+		} else {
+			link = &cache->next;
+		}
+	}
+
+	return n;
+}
+
+/* ...allocate DSP memory, dropping idle cached libraries if it runs short */
+static long xf_lib_pool_alloc(struct xf_proxy *proxy, unsigned int size,
+			      struct xf_pool **pool)
+{
+	xaf_adev_t *p_adev = container_of(proxy, xaf_adev_t, proxy);
+	long ret_val;
+
+	ret_val = xf_pool_alloc(proxy, 1, size, XF_POOL_AUX, pool, XAF_MEM_ID_COMP);
+	if (ret_val && xf_lib_cache_evict(p_adev, true))
+		ret_val = xf_pool_alloc(proxy, 1, size, XF_POOL_AUX, pool, XAF_MEM_ID_COMP);
+
+	return ret_val;
+}
+
+/* ...map "<library>.plk" if it was built from this very library file */
+static void xf_lib_prelink_map(struct xf_lib_cache *cache)
+{
+	struct xtlib_prelink_header *plk;
+	Elf32_Ehdr *header = (Elf32_Ehdr *)cache->image;
+	Elf32_Phdr *pheader;
+	struct stat st;
+	uint32_t checksum;
+	char *path;
+	void *image;
+	int fd;
+
+	if (cache->byteswap ||
+	    sizeof(plk->pil_info) != sizeof(struct xtlib_pil_info))
+		return;
+
+	path = malloc(strlen(cache->filename) + sizeof(XTLIB_PRELINK_SUFFIX));
+	if (!path)
+		return;
+	sprintf(path, "%s%s", cache->filename, XTLIB_PRELINK_SUFFIX);
+
+	fd = open(path, O_RDONLY);
+	free(path);
+	if (fd < 0)
+		return;
+
+	if (fstat(fd, &st) || st.st_size < (off_t)sizeof(*plk)) {
+		close(fd);
+		return;
+	}
+
+	image = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (image == MAP_FAILED)
+		return;
+
+	plk = image;
+	pheader = (Elf32_Phdr *)((char *)header + header->e_phoff);
+
+	/* ...image must match segment layout and alignment of the library */
+	if (plk->magic != XTLIB_PRELINK_MAGIC ||
+	    plk->version != XTLIB_PRELINK_VERSION ||
+	    plk->lib_size != cache->size ||
+	    plk->code_size != pheader[0].p_memsz ||
+	    plk->data_size != pheader[1].p_memsz ||
+	    plk->data_offs != pheader[1].p_paddr ||
+	    plk->align != cache->align ||
+	    plk->fixup_count > st.st_size / sizeof(uint32_t) ||
+	    (off_t)(sizeof(*plk) + xtlib_prelink_body_size(plk)) != st.st_size)
+		goto stale;
+
+	checksum = xtlib_prelink_checksum(plk + 1, xtlib_prelink_body_size(plk),
+					  XTLIB_PRELINK_SEED);
+	if (checksum != plk->image_checksum)
+		goto stale;
+
+	checksum = xtlib_prelink_checksum(cache->image, cache->size,
+					  XTLIB_PRELINK_SEED);
+	if (checksum != plk->lib_checksum)
+		goto stale;
+
+	cache->prelink = plk;
+	cache->prelink_size = st.st_size;
+	return;
+
+stale:
+	TRACE(INFO, _b("pre-linked image of %s does not match, ignored\n"),
+	      cache->filename);
+	munmap(image, st.st_size);
+}
+
+/* ...read library file and load shareable code section; cache lock is held */
+static struct xf_lib_cache *xf_lib_cache_create(struct xf_proxy *proxy,
+						struct lib_info *lib_info,
+						struct stat *st,
+						long *ret_val)
+{
+	struct xf_lib_cache *cache;
+	Elf32_Ehdr *header;
+	Elf32_Phdr *pheader;
+	xt_ptr code_addr;
+	void *image;
+	int fd;
+
+	cache = calloc(1, sizeof(*cache));
+	if (!cache) {
+		*ret_val = -ENOMEM;
+		return NULL;
+	}
+
+	cache->filename = strdup(lib_info->filename);
+	cache->mtime = st->st_mtime;
+	cache->size = st->st_size;
+	if (!cache->filename) {
+		*ret_val = -ENOMEM;
+		goto err;
+	}
+
+	if (st->st_size < (off_t)sizeof(Elf32_Ehdr)) {
+		*ret_val = -EINVAL;
+		goto err;
+	}
+
+	/* Map DPU's library read-only; page cache is the only copy */
+	fd = open(lib_info->filename, O_RDONLY);
+	if (fd < 0) {
+		TRACE(ERROR, _b("Error: %s not exist\n"), lib_info->filename);
+		*ret_val = -ENOENT;
+		goto err;
+	}
+
+	image = mmap(NULL, st->st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (image == MAP_FAILED) {
+		*ret_val = -errno;
+		goto err;
+	}
+	cache->image = image;
+
+	header = (Elf32_Ehdr *)cache->image;
+	if (validate_dynamic(header, lib_info) != XTLIB_NO_ERR ||
+	    !xtlib_image_in_bounds(header, st->st_size, lib_info) ||
+	    xtlib_split_pi_library_size((struct xtlib_packaged_library *)header,
+					&cache->size_code, &cache->size_data,
+					lib_info) != XTLIB_NO_ERR) {
+		*ret_val = -EINVAL;
+		goto err;
+	}
+
+	cache->align = find_align(header, lib_info);
+	cache->byteswap = lib_info->xtlib_globals.byteswap;
+
+	xf_lib_prelink_map(cache);
+
+	if (xtlib_code_is_shareable(header, lib_info)) {
+		pheader = (Elf32_Phdr *)((char *)header +
+			xtlib_host_word(header->e_phoff, cache->byteswap));
+
+		if (xf_lib_pool_alloc(proxy, cache->size_code + cache->align,
+				      &cache->code_section_pool)) {
+			cache->code_section_pool = NULL;
+			printf("not enough buffer when loading code section\n");
+			*ret_val = -ENOMEM;
+			goto err;
+		}
+
+		cache->code_buf_virt = xf_buffer_data(xf_buffer_get(cache->code_section_pool));
+		cache->code_buf_phys = xf_proxy_b2a(proxy, cache->code_buf_virt);
+
+		/* ...load code at the same aligned address the loader computes */
+		code_addr = align_ptr(cache->code_buf_phys, cache->align);
+		xtlib_load_seg(&pheader[0],
+			       (char *)header + xtlib_host_word(pheader[0].p_offset,
+					lib_info->xtlib_globals.byteswap),
+			       (xt_ptr)cache->code_buf_virt + (code_addr - cache->code_buf_phys),
+			       lib_info);
+	}
+
+	TRACE(INFO, _b("library %s cached (code %s%s)\n"), cache->filename,
+	      cache->code_section_pool ? "shared" : "per instance",
+	      cache->prelink ? ", pre-linked" : "");
+
+	return cache;
+
+err:
+	xf_lib_cache_free(cache);
+	return NULL;
+}
+
+/* ...drop instance reference; cache lock is held */
+static void xf_lib_cache_put(xaf_adev_t *p_adev, struct xf_lib_cache *cache)
+{
+	if (--cache->refcount == 0 && cache->stale)
+		xf_lib_cache_evict(p_adev, false);
+}
+
+/* ...release all idle cached libraries of a device */
+void xf_lib_cache_flush(xaf_adev_t *p_adev)
+{
+	__xf_lock(&p_adev->lib_cache_lock);
+	xf_lib_cache_evict(p_adev, true);
+	__xf_unlock(&p_adev->lib_cache_lock);
 }
 
 static long load_dpu_with_library(struct xf_proxy *proxy,
 				  struct lib_info *lib_info)
 {
-	FILE *fpInfile = NULL;
-	unsigned char *srambuf = NULL;
+	xaf_adev_t *p_adev = container_of(proxy, xaf_adev_t, proxy);
+	struct xf_lib_cache *cache;
 	struct lib_dnld_info_t dpulib;
 	struct xf_buffer *buf;
 	Elf32_Phdr *pheader;
 	Elf32_Ehdr *header;
+	struct stat st;
 	unsigned int align;
-	int filesize = 0;
 	long ret_val = 0;
 
-	/* Load DPU's main program to System memory */
-	fpInfile = fopen(lib_info->filename, "r");
-	if (!fpInfile) {
+	lib_info->cache = NULL;
+	lib_info->code_section_pool = NULL;
+	lib_info->data_section_pool = NULL;
+
+	if (stat(lib_info->filename, &st)) {
 		TRACE(ERROR, _b("Error: %s not exist\n"), lib_info->filename);
 		return -ENOENT;
 	}
 
-	fseek(fpInfile, 0, SEEK_END);
-	filesize = ftell(fpInfile);
+	__xf_lock(&p_adev->lib_cache_lock);
+
+	/* ...look up library image by path and modification time */
+	for (cache = p_adev->lib_cache; cache; cache = cache->next) {
+		if (cache->stale || strcmp(cache->filename, lib_info->filename))
+			continue;
+		if (cache->mtime == st.st_mtime && cache->size == st.st_size)
+			break;
+
+		/* ...file has been replaced; retire old image */
+		cache->stale = true;
+	}
+
+	xf_lib_cache_evict(p_adev, false);
 
-	srambuf = malloc(filesize);
-	fseek(fpInfile, 0, SEEK_SET);
+	if (!cache) {
+		cache = xf_lib_cache_create(proxy, lib_info, &st, &ret_val);
+		if (!cache)
+			goto out;
 
-	ret_val = fread(srambuf, 1, filesize, fpInfile);
-	fclose(fpInfile);
+		cache->next = p_adev->lib_cache;
+		p_adev->lib_cache = cache;
+	}
+
+	cache->refcount++;
+	lib_info->cache = cache;
 
-	ret_val = xtlib_split_pi_library_size(
-			(struct xtlib_packaged_library *)(srambuf),
-			(unsigned int *)&dpulib.size_code,
-			(unsigned int *)&dpulib.size_data,
-			lib_info);
-	if (ret_val != XTLIB_NO_ERR)
-		return -EINVAL;
+	/* ...image has been validated and sized when cached */
+	lib_info->xtlib_globals.byteswap = cache->byteswap;
+	lib_info->xtlib_globals.err = XTLIB_NO_ERR;
+	dpulib.size_code = cache->size_code;
+	dpulib.size_data = cache->size_data;
+	align = cache->align;
 
 	lib_info->code_buf_size = dpulib.size_code;
 	lib_info->data_buf_size = dpulib.size_data;
 
-	header = (Elf32_Ehdr *)srambuf;
-	pheader = (Elf32_Phdr *)((char *)srambuf +
+	header = (Elf32_Ehdr *)cache->image;
+	pheader = (Elf32_Phdr *)((char *)cache->image +
 				xtlib_host_word(header->e_phoff,
 						lib_info->xtlib_globals.byteswap));
 
-	align = find_align(header, lib_info);
+	if (cache->code_section_pool) {
+		/* ...code section is shared and already loaded */
+		lib_info->code_section_pool = NULL;
+		lib_info->code_buf_phys = cache->code_buf_phys;
+		lib_info->code_buf_virt = cache->code_buf_virt;
+	} else {
+		ret_val = xf_lib_pool_alloc(proxy,
+					    dpulib.size_code + align,
+					    &lib_info->code_section_pool);
+		if (ret_val) {
+			lib_info->code_section_pool = NULL;
+			printf("not enough buffer when loading code section\n");
+			ret_val = -ENOMEM;
+			goto err;
+		}
 
-	ret_val = xf_pool_alloc(proxy,
-				1,
-				dpulib.size_code + align,
-				XF_POOL_AUX,
-				&lib_info->code_section_pool,
-				XAF_MEM_ID_COMP);
-	if (ret_val) {
-		free(srambuf);
-		printf("not enough buffer when loading code section\n");
-		return -ENOMEM;
+		buf = xf_buffer_get(lib_info->code_section_pool);
+		lib_info->code_buf_phys = xf_proxy_b2a(proxy, xf_buffer_data(buf));
+		lib_info->code_buf_virt = xf_buffer_data(buf);
 	}
 
-	ret_val = xf_pool_alloc(proxy,
-				1,
-				dpulib.size_data + pheader[1].p_paddr + align,
-				XF_POOL_AUX,
-				&lib_info->data_section_pool,
-				XAF_MEM_ID_COMP);
+	ret_val = xf_lib_pool_alloc(proxy,
+				    dpulib.size_data + pheader[1].p_paddr + align,
+				    &lib_info->data_section_pool);
 	if (ret_val) {
-		free(srambuf);
+		lib_info->data_section_pool = NULL;
 		printf("not enough buffer when loading data section\n");
-		return -ENOMEM;
+		ret_val = -ENOMEM;
+		goto err;
 	}
 
-	buf = xf_buffer_get(lib_info->code_section_pool);
-	lib_info->code_buf_phys = xf_proxy_b2a(proxy, xf_buffer_data(buf));
-	lib_info->code_buf_virt = xf_buffer_data(buf);
-
 	buf = xf_buffer_get(lib_info->data_section_pool);
 	lib_info->data_buf_phys = xf_proxy_b2a(proxy, xf_buffer_data(buf));
 	lib_info->data_buf_virt = xf_buffer_data(buf);
@@ -570,14 +944,40 @@ static long load_dpu_with_library(struct xf_proxy *proxy,
 	dpulib.pbuf_data = (unsigned long)lib_info->data_buf_phys;
 
 	dpulib.ppil_inf = &lib_info->pil_info;
+
+	TRACE(INFO, _b("library %s loaded at code 0x%x data 0x%x\n"),
+	      lib_info->filename, lib_info->code_buf_phys,
+	      lib_info->data_buf_phys);
+
+	/* ...fast path: pre-linked image, rebased on host for these buffers */
+	if (cache->prelink) {
+		xtlib_prelink_load(cache->prelink,
+				   &lib_info->code_buf_virt, lib_info->code_buf_phys,
+				   &lib_info->data_buf_virt, lib_info->data_buf_phys,
+				   cache->code_section_pool == NULL,
+				   (uint32_t *)&lib_info->pil_info);
+		goto out;
+	}
+
 	xtlib_host_load_split_pi_library(
-			(struct xtlib_packaged_library *)(srambuf),
+			(struct xtlib_packaged_library *)(cache->image),
 			(xt_ptr)(dpulib.pbuf_code),
 			(xt_ptr)(dpulib.pbuf_data),
 			(struct xtlib_pil_info *)dpulib.ppil_inf,
-			(void *)lib_info);
+			(void *)lib_info,
+			cache->code_section_pool == NULL);
+
+	goto out;
 
-	free(srambuf);
+err:
+	if (lib_info->code_section_pool) {
+		xf_pool_free(lib_info->code_section_pool, XAF_MEM_ID_COMP);
+		lib_info->code_section_pool = NULL;
+	}
+	lib_info->cache = NULL;
+	xf_lib_cache_put(p_adev, cache);
+out:
+	__xf_unlock(&p_adev->lib_cache_lock);
 
 	return ret_val;
 }
@@ -585,10 +985,20 @@ static long load_dpu_with_library(struct xf_proxy *proxy,
 static long unload_dpu_with_library(struct xf_proxy *proxy,
 				    struct lib_info *lib_info)
 {
-	if (!lib_info->code_section_pool || !lib_info->data_section_pool)
+	xaf_adev_t *p_adev = container_of(proxy, xaf_adev_t, proxy);
+
+	if (!lib_info->cache || !lib_info->data_section_pool)
 		return XAF_INVALIDPTR_ERR;
-	xf_pool_free(lib_info->code_section_pool, XAF_MEM_ID_COMP);
+	if (lib_info->code_section_pool)
+		xf_pool_free(lib_info->code_section_pool, XAF_MEM_ID_COMP);
 	xf_pool_free(lib_info->data_section_pool, XAF_MEM_ID_COMP);
+	lib_info->code_section_pool = NULL;
+	lib_info->data_section_pool = NULL;
+
+	__xf_lock(&p_adev->lib_cache_lock);
+	xf_lib_cache_put(p_adev, lib_info->cache);
+	__xf_unlock(&p_adev->lib_cache_lock);
+	lib_info->cache = NULL;
 
 	return 0;
 }
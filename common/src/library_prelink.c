@@ -0,0 +1,313 @@
+/*****************************************************************
+ * Copyright 2018 NXP
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************/
+
+/*
+ * Pre-linked codec library images: offline builder (used by xtlib-prelink)
+ * and loader (used by library_load.c); see library_prelink.h
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <elf.h>
+#include "library_prelink.h"
+
+/* ...pil_info words depending on code and data buffer addresses */
+#define PIL_DST_ADDR		0
+#define PIL_DST_DATA_ADDR	2
+#define PIL_START_SYM		4
+#define PIL_TEXT_ADDR		5
+#define PIL_INIT		6
+#define PIL_FINI		7
+#define PIL_REL			8
+#define PIL_HASH		10
+#define PIL_SYMTAB		11
+#define PIL_STRTAB		12
+#define PIL_ALIGN		13
+
+static uint32_t align_addr(uint32_t addr, uint32_t align)
+{
+	return align ? (addr + align - 1) & ~(align - 1) : addr;
+}
+
+/* ...little-endian word access; byte-wise, as DSP memory is written by
+ * xtlib_load_seg(), and relocated words and fixups may be unaligned
+ */
+static uint32_t get_word(const unsigned char *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void put_word(unsigned char *p, uint32_t v)
+{
+	p[0] = v, p[1] = v >> 8, p[2] = v >> 16, p[3] = v >> 24;
+}
+
+/* ...maximal section alignment (as find_align() in library_load.c) */
+static uint32_t find_align(const unsigned char *image, size_t size)
+{
+	const Elf32_Ehdr *header = (const Elf32_Ehdr *)image;
+	const Elf32_Shdr *sheader;
+	uint32_t align = 0;
+	int sec;
+
+	if (header->e_shoff + (size_t)header->e_shnum * sizeof(Elf32_Shdr) > size)
+		return 0;
+
+	sheader = (const Elf32_Shdr *)(image + header->e_shoff);
+	for (sec = 0; sec < header->e_shnum; sec++)
+		if (sheader[sec].sh_type != SHT_NULL && sheader[sec].sh_size > 0 &&
+		    sheader[sec].sh_addralign > align)
+			align = sheader[sec].sh_addralign;
+
+	return align;
+}
+
+struct xtlib_prelink_header *xtlib_prelink_build(const unsigned char *image,
+						 size_t size,
+						 uint32_t code_addr,
+						 const char **err)
+{
+	const Elf32_Ehdr *header = (const Elf32_Ehdr *)image;
+	const Elf32_Phdr *pheader;
+	const Elf32_Dyn *dyn;
+	const Elf32_Rela *rela = NULL;
+	struct xtlib_prelink_header *plk;
+	unsigned char *code, *data, *fixup, *ptr;
+	uint32_t align, code_dst, code_offs, data_offs;
+	uint32_t relasz = 0, text_addr = 0, value, flags, i;
+
+	/* ...only little-endian split-load libraries (code, data, dynamic) */
+	if (size < sizeof(*header) || memcmp(header->e_ident, ELFMAG, SELFMAG) ||
+	    header->e_ident[EI_CLASS] != ELFCLASS32 ||
+	    header->e_ident[EI_DATA] != ELFDATA2LSB ||
+	    header->e_type != ET_DYN || header->e_phnum != 3 ||
+	    header->e_phoff + 3 * sizeof(Elf32_Phdr) > size) {
+		*err = "not a split-load PI library";
+		return NULL;
+	}
+
+	pheader = (const Elf32_Phdr *)(image + header->e_phoff);
+	if (pheader[0].p_type != PT_LOAD || pheader[1].p_type != PT_LOAD ||
+	    pheader[2].p_type != PT_DYNAMIC ||
+	    pheader[0].p_offset + pheader[0].p_filesz > size ||
+	    pheader[1].p_offset + pheader[1].p_filesz > size ||
+	    pheader[2].p_offset + pheader[2].p_filesz > size ||
+	    pheader[0].p_filesz > pheader[0].p_memsz ||
+	    pheader[1].p_filesz > pheader[1].p_memsz) {
+		*err = "not a split-load PI library";
+		return NULL;
+	}
+
+	align = find_align(image, size);
+	code_dst = align_addr(code_addr, align);
+	code_offs = pheader[0].p_paddr;
+	data_offs = pheader[1].p_paddr;
+
+	/* ...header, segment images zero-filled up to memory size, fixups */
+	plk = calloc(1, sizeof(*plk) + pheader[0].p_memsz + pheader[1].p_memsz +
+		     (pheader[1].p_filesz / sizeof(Elf32_Rela)) * sizeof(uint32_t));
+	if (!plk) {
+		*err = "out of memory";
+		return NULL;
+	}
+
+	code = (unsigned char *)(plk + 1);
+	data = code + pheader[0].p_memsz;
+	fixup = data + pheader[1].p_memsz;
+	memcpy(code, image + pheader[0].p_offset, pheader[0].p_filesz);
+	memcpy(data, image + pheader[1].p_offset, pheader[1].p_filesz);
+
+	/* ...pil_info as get_dyn_info() computes it; data buffer is at zero */
+	plk->pil_info[PIL_DST_ADDR] = code_dst;
+	plk->pil_info[1] = code_offs;				/* src_offs */
+	plk->pil_info[PIL_DST_DATA_ADDR] = data_offs;
+	plk->pil_info[3] = data_offs;				/* src_data_offs */
+	plk->pil_info[PIL_START_SYM] = code_dst - code_offs + header->e_entry;
+	plk->pil_info[PIL_ALIGN] = align;
+
+	for (dyn = (const Elf32_Dyn *)(image + pheader[2].p_offset);
+	     (const unsigned char *)(dyn + 1) <= image + size && dyn->d_tag != DT_NULL; dyn++) {
+		switch (dyn->d_tag) {
+		case DT_RELA:
+			if (dyn->d_un.d_ptr < data_offs ||
+			    dyn->d_un.d_ptr - data_offs >= pheader[1].p_filesz) {
+				*err = "relocations outside of data segment";
+				goto fail;
+			}
+			rela = (const Elf32_Rela *)(image + pheader[1].p_offset +
+						    dyn->d_un.d_ptr - data_offs);
+			plk->pil_info[PIL_REL] = dyn->d_un.d_ptr;
+			break;
+		case DT_RELASZ:
+			relasz = dyn->d_un.d_val;
+			break;
+		case DT_INIT:
+			plk->pil_info[PIL_INIT] = code_dst - code_offs + dyn->d_un.d_ptr;
+			break;
+		case DT_FINI:
+			plk->pil_info[PIL_FINI] = code_dst - code_offs + dyn->d_un.d_ptr;
+			break;
+		case DT_HASH:
+			plk->pil_info[PIL_HASH] = dyn->d_un.d_ptr;
+			break;
+		case DT_SYMTAB:
+			plk->pil_info[PIL_SYMTAB] = dyn->d_un.d_ptr;
+			break;
+		case DT_STRTAB:
+			plk->pil_info[PIL_STRTAB] = dyn->d_un.d_ptr;
+			break;
+		case DT_LOPROC + 2:
+			text_addr = code_dst - code_offs + dyn->d_un.d_ptr;
+			break;
+		default:
+			break;
+		}
+	}
+
+	plk->pil_info[PIL_TEXT_ADDR] = text_addr ? text_addr : code_dst;
+
+	if (rela && (const unsigned char *)rela - (image + pheader[1].p_offset) +
+		    relasz > pheader[1].p_filesz) {
+		*err = "relocations outside of data segment";
+		goto fail;
+	}
+
+	/* ...apply relocations as xtlib_relocate_pi_lib() does on DSP and
+	 * record every relocated word; rela_count stays zero
+	 */
+	for (i = 0; rela && i < relasz / sizeof(Elf32_Rela); i++) {
+		Elf32_Rela r = rela[i];
+		uint32_t r_type = ELF32_R_TYPE(r.r_info);
+		uint32_t in_data = (r.r_offset >= data_offs);
+
+		if (r_type == XTLIB_R_XTENSA_NONE)
+			continue;
+
+		if (r_type != XTLIB_R_XTENSA_RELATIVE || ELF32_R_SYM(r.r_info) != STN_UNDEF) {
+			*err = "relocation type cannot be pre-linked";
+			goto fail;
+		}
+
+		if (in_data ? r.r_offset - data_offs + 4 > pheader[1].p_memsz :
+		    r.r_offset < code_offs || r.r_offset - code_offs + 4 > pheader[0].p_memsz) {
+			*err = "relocation outside of segments";
+			goto fail;
+		}
+
+		ptr = in_data ? data + r.r_offset - data_offs : code + r.r_offset - code_offs;
+		value = get_word(ptr) + r.r_addend;
+
+		if (value >= data_offs) {
+			/* ...data buffer is at zero; loader adds its address */
+			flags = XTLIB_PRELINK_FIXUP_TO_DATA;
+		} else {
+			value += code_dst - code_offs;
+			flags = 0;
+		}
+
+		put_word(ptr, value);
+
+		flags |= in_data ? XTLIB_PRELINK_FIXUP_IN_DATA | (r.r_offset - data_offs) :
+				   r.r_offset - code_offs;
+		put_word(fixup + plk->fixup_count++ * sizeof(uint32_t), flags);
+	}
+
+	plk->magic = XTLIB_PRELINK_MAGIC;
+	plk->version = XTLIB_PRELINK_VERSION;
+	plk->lib_size = size;
+	plk->lib_checksum = xtlib_prelink_checksum(image, size, XTLIB_PRELINK_SEED);
+	plk->code_addr = code_addr;
+	plk->code_size = pheader[0].p_memsz;
+	plk->data_size = pheader[1].p_memsz;
+	plk->data_offs = data_offs;
+	plk->align = align;
+	plk->image_checksum = xtlib_prelink_checksum(plk + 1, xtlib_prelink_body_size(plk),
+						     XTLIB_PRELINK_SEED);
+
+	return plk;
+
+fail:
+	free(plk);
+	return NULL;
+}
+
+void xtlib_prelink_load(const struct xtlib_prelink_header *plk,
+			void **code_virt, uint32_t code_phys,
+			void **data_virt, uint32_t data_phys,
+			int load_code,
+			uint32_t pil_info[XTLIB_PRELINK_PIL_WORDS])
+{
+	const unsigned char *src = (const unsigned char *)(plk + 1);
+	const unsigned char *fixup = src + plk->code_size + plk->data_size;
+	uint32_t code_dst = align_addr(code_phys, plk->align);
+	uint32_t data_dst = align_addr(data_phys, plk->align);
+	uint32_t code_delta = code_dst - align_addr(plk->code_addr, plk->align);
+	unsigned char *code, *data, *ptr;
+	uint32_t i;
+
+	code = (unsigned char *)*code_virt + (code_dst - code_phys);
+	data = (unsigned char *)*data_virt + (data_dst - data_phys);
+	*code_virt = code;
+	*data_virt = data;
+
+	/* ...byte-wise copy, as xtlib_load_seg() does for DSP memory */
+	if (load_code)
+		for (i = 0; i < plk->code_size; i++)
+			code[i] = src[i];
+
+	src += plk->code_size;
+	for (i = 0; i < plk->data_size; i++)
+		data[plk->data_offs + i] = src[i];
+
+	/* ...rebase relocated words; shared code has no relocations */
+	for (i = 0; i < plk->fixup_count; i++) {
+		uint32_t f = get_word(fixup + i * sizeof(uint32_t));
+
+		if (f & XTLIB_PRELINK_FIXUP_IN_DATA)
+			ptr = data + plk->data_offs + XTLIB_PRELINK_FIXUP_OFFS(f);
+		else if (load_code)
+			ptr = code + XTLIB_PRELINK_FIXUP_OFFS(f);
+		else
+			continue;
+
+		if (f & XTLIB_PRELINK_FIXUP_TO_DATA)
+			put_word(ptr, get_word(ptr) + data_dst);
+		else if (code_delta)
+			put_word(ptr, get_word(ptr) + code_delta);
+	}
+
+	memcpy(pil_info, plk->pil_info, sizeof(plk->pil_info));
+
+	pil_info[PIL_DST_ADDR] += code_delta;
+	pil_info[PIL_START_SYM] += code_delta;
+	pil_info[PIL_TEXT_ADDR] += code_delta;
+	pil_info[PIL_INIT] += pil_info[PIL_INIT] ? code_delta : 0;
+	pil_info[PIL_FINI] += pil_info[PIL_FINI] ? code_delta : 0;
+
+	pil_info[PIL_DST_DATA_ADDR] += data_dst;
+	pil_info[PIL_REL] += pil_info[PIL_REL] ? data_dst : 0;
+	pil_info[PIL_HASH] += pil_info[PIL_HASH] ? data_dst : 0;
+	pil_info[PIL_SYMTAB] += pil_info[PIL_SYMTAB] ? data_dst : 0;
+	pil_info[PIL_STRTAB] += pil_info[PIL_STRTAB] ? data_dst : 0;
+}
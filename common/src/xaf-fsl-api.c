@@ -21,6 +21,7 @@
 * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 #include <stdbool.h>
+#include <fcntl.h>
 #include "library_load.h"
 #include "xaf-api.h"
 #include "xaf-version.h"
@@ -32,11 +33,24 @@
 /***** GLOBALS *****/
 /* Info table */
 
+extern const int xf_io_ports[XAF_MAX_COMPTYPE][2];
+
 #define TENA_2356   1
 
 #define XAF_4BYTE_ALIGN    4
 #define XAF_8BYTE_ALIGN    8
 #define XAF_32BYTE_ALIGN    32
+
+/* ...size of the first release of xaf_comp_config_ext_t (smallest one accepted) */
+#define XAF_COMP_CONFIG_EXT_SIZE_V1 \
+   (offset_of(xaf_comp_config_ext_t, pp_inbuf) + sizeof(pVOID *))
+
+/* ...field of extended configuration is known to the application */
+#define XAF_COMP_CONFIG_EXT_HAS(p, field) \
+   ((p)->config_size >= offset_of(xaf_comp_config_ext_t, field) + sizeof((p)->field))
+
+/* ...batched status wait timeout (ms), same as single response wait */
+#define XAF_STATUS_BATCH_TIMEOUT    10000
 #define XAF_DEV_AND_AP_STRUCT_MEM_SIZE \
    (sizeof(xf_ap_t) + (XAF_8BYTE_ALIGN-1) + \
    (sizeof(xaf_adev_t) + (XAF_4BYTE_ALIGN-1)))
@@ -660,6 +674,8 @@ XAF_ERR_CODE xaf_adev_open(pVOID *pp_adev, xaf_adev_config_t *pconfig)
 #endif
     xaf_sync_chain_init(&p_adev->comp_chain, (UWORD32)offset_of(xaf_comp_t, next));
 
+    __xf_lock_init(&p_adev->lib_cache_lock);
+
     return XAF_NO_ERR;
 }
 
@@ -802,6 +818,8 @@ XAF_ERR_CODE xaf_adev_open_deprecated(pVOID *pp_adev, WORD32 audio_frmwk_buf_siz
 #endif
     xaf_sync_chain_init(&p_adev->comp_chain, (UWORD32)offset_of(xaf_comp_t, next));
 
+    __xf_lock_init(&p_adev->lib_cache_lock);
+
     return XAF_NO_ERR;
 }
 #endif
@@ -842,6 +860,12 @@ XAF_ERR_CODE xaf_adev_close(pVOID adev_ptr, xaf_adev_close_flag flag)
 
     p_proxy = &p_adev->proxy;
 
+    /* ...finalize event trace file if tracing is still active */
+    xf_trace_stop(p_proxy);
+
+    /* ...release cached codec libraries */
+    xf_lib_cache_flush(p_adev);
+
     if(p_proxy->aux != NULL)
     {
 #if TENA_2356
@@ -891,6 +915,8 @@ XAF_ERR_CODE xaf_adev_close(pVOID adev_ptr, xaf_adev_close_flag flag)
         xaf_sync_chain_deinit(&p_adev->event_chain);
 #endif
         xaf_sync_chain_deinit(&p_adev->comp_chain);
+
+        __xf_lock_destroy(&p_adev->lib_cache_lock);
  
         {
           //ferret warning fix; not to use the memory allocated to function pointer xf_mem_free_fxn, after its freed(with free p_apMem).
@@ -946,6 +972,22 @@ XAF_ERR_CODE xaf_comp_config_default_init(xaf_comp_config_t *pcomp_config)
     return XAF_NO_ERR;
 }
 
+XAF_ERR_CODE xaf_comp_config_ext_default_init(xaf_comp_config_ext_t *pconfig_ext, UWORD32 config_size)
+{
+    XAF_CHK_PTR(pconfig_ext);
+
+    /* ...application may not know about trailing fields, but all known ones must be covered */
+    XAF_CHK_RANGE(config_size, XAF_COMP_CONFIG_EXT_SIZE_V1, sizeof(xaf_comp_config_ext_t));
+
+    /* ...initialize extended config params; same input buffers as basic config */
+    memset(pconfig_ext, 0, config_size);
+
+    pconfig_ext->config_size = config_size;
+    pconfig_ext->num_input_buffers = 2;
+
+    return XAF_NO_ERR;
+}
+
 #ifndef XA_DISABLE_EVENT
 static XAF_ERR_CODE xaf_setup_event_channel(xaf_comp_t *src_comp, UWORD32 src_config_param, xaf_comp_t *dest_comp, UWORD32 dst_config_param, UWORD32 nbuf, UWORD32 buf_size)
 {
@@ -1149,6 +1191,23 @@ XAF_ERR_CODE xaf_load_library(xaf_adev_t *p_adev, xaf_comp_t *p_comp, xf_id_t co
 }
 
 XAF_ERR_CODE xaf_comp_create(pVOID adev_ptr, pVOID *pp_comp, xaf_comp_config_t *pcomp_config)
+{
+    xaf_comp_config_ext_t config_ext;
+
+    XAF_CHK_PTR(pcomp_config);
+
+    /* ...basic configuration has at most XAF_MAX_INBUFS input buffers of default size */
+    XAF_CHK_RANGE(pcomp_config->num_input_buffers, 0, XAF_MAX_INBUFS);
+    if (pcomp_config->num_input_buffers) XAF_CHK_PTR(pcomp_config->pp_inbuf);
+
+    xaf_comp_config_ext_default_init(&config_ext, sizeof(config_ext));
+    config_ext.num_input_buffers = pcomp_config->num_input_buffers;
+    config_ext.pp_inbuf = (pcomp_config->num_input_buffers ? *pcomp_config->pp_inbuf : NULL);
+
+    return xaf_comp_create_ext(adev_ptr, pp_comp, pcomp_config, &config_ext);
+}
+
+XAF_ERR_CODE xaf_comp_create_ext(pVOID adev_ptr, pVOID *pp_comp, xaf_comp_config_t *pcomp_config, xaf_comp_config_ext_t *pconfig_ext)
 {
     xaf_adev_t *p_adev;
     xaf_comp_t *p_comp;
@@ -1158,11 +1217,14 @@ XAF_ERR_CODE xaf_comp_create(pVOID adev_ptr, pVOID *pp_comp, xaf_comp_config_t *
     UWORD32 i;
 
     XAF_CHK_PTR(pcomp_config);
+    XAF_CHK_PTR(pconfig_ext);
+    XAF_CHK_RANGE(pconfig_ext->config_size, XAF_COMP_CONFIG_EXT_SIZE_V1, sizeof(xaf_comp_config_ext_t));
 
     xf_id_t comp_id = pcomp_config->comp_id;
-    UWORD32 ninbuf = pcomp_config->num_input_buffers;
+    UWORD32 ninbuf = pconfig_ext->num_input_buffers;
     UWORD32 noutbuf = pcomp_config->num_output_buffers;
-    pVOID (*pp_inbuf)[XAF_MAX_INBUFS] = pcomp_config->pp_inbuf;
+    pVOID *pp_inbuf = pconfig_ext->pp_inbuf;
+    UWORD32 inbuf_size = pconfig_ext->input_buffer_size ? pconfig_ext->input_buffer_size : XAF_INBUF_SIZE;
     xaf_comp_type comp_type = pcomp_config->comp_type;
 
     p_adev = (xaf_adev_t *)adev_ptr;
@@ -1171,10 +1233,17 @@ XAF_ERR_CODE xaf_comp_create(pVOID adev_ptr, pVOID *pp_comp, xaf_comp_config_t *
     XAF_CHK_PTR(comp_id);
     if (ninbuf) XAF_CHK_PTR(pp_inbuf);
 
-    XAF_CHK_RANGE(ninbuf, 0, XAF_MAX_INBUFS);
+    XAF_CHK_RANGE(ninbuf, 0, XAF_MAX_INBUFS_EXT);
     XAF_CHK_RANGE(noutbuf, 0, 1);
     XAF_CHK_RANGE(comp_type, XAF_DECODER, XAF_MAX_COMPTYPE-1); 
 
+    /* ...mixer cannot have more tracks than host and DSP were built with */
+    if (comp_type == XAF_MIXER && XAF_COMP_CONFIG_EXT_HAS(pconfig_ext, num_input_ports) && pconfig_ext->num_input_ports > XA_MIXER_MAX_TRACK_NUMBER)
+    {
+        TRACE(ERROR, _x("mixer tracks requested: %u, built with XA_MIXER_MAX_TRACK_NUMBER=%u"), pconfig_ext->num_input_ports, XA_MIXER_MAX_TRACK_NUMBER);
+        return XAF_INVALIDVAL_ERR;
+    }
+
 #ifndef XA_DISABLE_EVENT
     XAF_CHK_RANGE(pcomp_config->error_channel_ctl, XAF_ERR_CHANNEL_DISABLE, XAF_ERR_CHANNEL_ALL);
     XAF_CHK_RANGE(pcomp_config->num_err_msg_buf, 1, 4);
@@ -1182,8 +1251,8 @@ XAF_ERR_CODE xaf_comp_create(pVOID adev_ptr, pVOID *pp_comp, xaf_comp_config_t *
 
     XAF_ADEV_STATE_CHK(p_adev, XAF_ADEV_RESET);
 
-    //Memory allocation for component struct pointer
-    size = (sizeof(xaf_comp_t) + (XAF_4BYTE_ALIGN-1));
+    //Memory allocation for component struct pointer, followed by input buffer pointers
+    size = (sizeof(xaf_comp_t) + ninbuf * sizeof(void *) + (XAF_4BYTE_ALIGN-1));
     ret = xaf_malloc(p_adev->xf_g_ap, &pTmp, size, XAF_MEM_ID_COMP);
     if(ret != XAF_NO_ERR)
         return ret;
@@ -1204,18 +1273,20 @@ XAF_ERR_CODE xaf_comp_create(pVOID adev_ptr, pVOID *pp_comp, xaf_comp_config_t *
     p_adev->n_comp += 1;
 
     p_comp->ninbuf = ninbuf;
+    p_comp->p_input = (void **)(p_comp + 1);
+    p_comp->inbuf_size = inbuf_size;
 
     /* ...allocate input buffer */
     if (ninbuf) 
     {
         xf_buffer_t *buf;
-        XF_CHK_API(xf_pool_alloc(&p_adev->proxy, ninbuf, XAF_INBUF_SIZE, XF_POOL_INPUT, &p_comp->inpool, XAF_MEM_ID_COMP));
+        XF_CHK_API(xf_pool_alloc(&p_adev->proxy, ninbuf, inbuf_size, XF_POOL_INPUT, &p_comp->inpool, XAF_MEM_ID_COMP));
         
         for (i=0; i<ninbuf; i++)
         {
             buf         = xf_buffer_get(p_comp->inpool);
             p_comp->p_input[i] = xf_buffer_data(buf);   //TENA-2196 saving the address of buffer allocated.
-            *(*pp_inbuf + i) = p_comp->p_input[i];
+            pp_inbuf[i] = p_comp->p_input[i];
         }
 
     }
@@ -1241,7 +1312,7 @@ XAF_ERR_CODE xaf_comp_create(pVOID adev_ptr, pVOID *pp_comp, xaf_comp_config_t *
         p_comp->inp_ports = 1; p_comp->out_ports = 1;
         break;
     case XAF_MIXER:
-        p_comp->inp_ports = 4; p_comp->out_ports = 1;
+        p_comp->inp_ports = XA_MIXER_MAX_TRACK_NUMBER; p_comp->out_ports = 1;
         break;
     case XAF_MIMO_PROC_12 ... (XAF_MAX_COMPTYPE-1):
 #if 0 /* by S.J*/
@@ -1308,8 +1379,8 @@ XAF_ERR_CODE xaf_comp_create_deprecated(pVOID adev_ptr, pVOID *pp_comp, xf_id_t
 
     XAF_ADEV_STATE_CHK(p_adev, XAF_ADEV_RESET);
 
-    //Memory allocation for component struct pointer
-    size = (sizeof(xaf_comp_t) + (XAF_4BYTE_ALIGN-1));
+    //Memory allocation for component struct pointer, followed by input buffer pointers
+    size = (sizeof(xaf_comp_t) + ninbuf * sizeof(void *) + (XAF_4BYTE_ALIGN-1));
     ret = xaf_malloc(p_adev->xf_g_ap, &pTmp, size, XAF_MEM_ID_COMP);
     if(ret != XAF_NO_ERR)
         return ret;
@@ -1330,12 +1401,14 @@ XAF_ERR_CODE xaf_comp_create_deprecated(pVOID adev_ptr, pVOID *pp_comp, xf_id_t
     p_adev->n_comp += 1;
 
     p_comp->ninbuf = ninbuf;
+    p_comp->p_input = (void **)(p_comp + 1);
+    p_comp->inbuf_size = XAF_INBUF_SIZE;
 
     /* ...allocate input buffer */
     if (ninbuf) 
     {
         xf_buffer_t *buf;
-        XF_CHK_API(xf_pool_alloc(&p_adev->proxy, ninbuf, XAF_INBUF_SIZE, XF_POOL_INPUT, &p_comp->inpool, XAF_MEM_ID_COMP));
+        XF_CHK_API(xf_pool_alloc(&p_adev->proxy, ninbuf, p_comp->inbuf_size, XF_POOL_INPUT, &p_comp->inpool, XAF_MEM_ID_COMP));
         
         for (i=0; i<ninbuf; i++)
         {
@@ -1367,7 +1440,7 @@ XAF_ERR_CODE xaf_comp_create_deprecated(pVOID adev_ptr, pVOID *pp_comp, xf_id_t
         p_comp->inp_ports = 1; p_comp->out_ports = 1;
         break;
     case XAF_MIXER:
-        p_comp->inp_ports = 4; p_comp->out_ports = 1;
+        p_comp->inp_ports = XA_MIXER_MAX_TRACK_NUMBER; p_comp->out_ports = 1;
         break;
     case XAF_MIMO_PROC_12 ... (XAF_MAX_COMPTYPE-1):
         p_comp->inp_ports  = xf_io_ports[comp_type][0];
@@ -1559,154 +1632,326 @@ XAF_ERR_CODE xaf_comp_get_config(pVOID comp_ptr, WORD32 num_param, pWORD32 p_par
     return XAF_NO_ERR;
 }
 
-
-XAF_ERR_CODE xaf_comp_get_status(pVOID adev_ptr, pVOID comp_ptr, xaf_comp_status *p_status, pVOID p_info)
+XAF_ERR_CODE xaf_comp_get_profile(pVOID comp_ptr, xaf_comp_profile_t *p_profile)
 {
-    xaf_adev_t *p_adev;
-    xaf_comp_t *p_comp;
-    xf_handle_t *p_handle;
+    xaf_comp_t             *p_comp;
+    xf_handle_t            *p_handle;
+    void                   *buf;
 
-    p_adev = (xaf_adev_t *)adev_ptr;
     p_comp = (xaf_comp_t *)comp_ptr;
 
     XAF_CHK_PTR(p_comp);
-    XAF_CHK_PTR(p_status);
-    XAF_CHK_PTR(p_info);
+    XAF_CHK_PTR(p_profile);
 
     XAF_COMP_STATE_CHK(p_comp);
 
-    if (!p_comp->init_done) XAF_CHK_PTR(p_adev);
+    p_handle = &p_comp->handle;
+    XAF_CHK_PTR(p_handle);
+
+    /* ...profile is delivered through component auxiliary buffer */
+    XF_CHK_ERR(xf_buffer_length(p_handle->aux) >= sizeof(*p_profile), XAF_MEMORY_ERR);
+
+    buf = xf_buffer_data(p_handle->aux);
+
+    XF_CHK_API(xf_get_profile(p_handle, buf, sizeof(*p_profile)));
+
+    memcpy(p_profile, buf, sizeof(*p_profile));
+
+    return XAF_NO_ERR;
+}
+
+/* ...latency below which "num" of all measured buffers fall; linear within histogram bin */
+static UWORD32 xaf_latency_percentile(xf_latency_msg_t *stats, UWORD64 num, UWORD64 den)
+{
+    UWORD64     rank = (stats->count * num + den - 1) / den;
+    UWORD64     seen = 0;
+    UWORD32     b, lo, width, e;
+
+    for (b = 0; b < XAF_LATENCY_HIST_BINS; b++)
+    {
+        if (seen + stats->hist[b] >= rank && stats->hist[b])
+            break;
+
+        seen += stats->hist[b];
+    }
+
+    if (b == XAF_LATENCY_HIST_BINS)
+        return stats->max_us;
+
+    /* ...bin boundaries: exact below 2^SUB_BITS, 2^SUB_BITS sub-bins per octave above */
+    if (b < (1 << XAF_LATENCY_HIST_SUB_BITS))
+    {
+        lo = b, width = 1;
+    }
+    else
+    {
+        e = (b >> XAF_LATENCY_HIST_SUB_BITS) + XAF_LATENCY_HIST_SUB_BITS - 1;
+        width = 1 << (e - XAF_LATENCY_HIST_SUB_BITS);
+        lo = ((b & ((1 << XAF_LATENCY_HIST_SUB_BITS) - 1)) + (1 << XAF_LATENCY_HIST_SUB_BITS)) * width;
+    }
+
+    lo += (UWORD32)((rank - seen) * width / stats->hist[b]);
+
+    /* ...never report outside of observed range */
+    return (lo < stats->min_us ? stats->min_us : (lo > stats->max_us ? stats->max_us : lo));
+}
+
+XAF_ERR_CODE xaf_comp_get_latency(pVOID comp_ptr, xaf_comp_latency_t *p_latency)
+{
+    xaf_comp_t             *p_comp;
+    xf_handle_t            *p_handle;
+    xf_pool_t              *pool;
+    xf_buffer_t            *b;
+    xf_latency_msg_t        stats;
+    int                     ret;
+
+    p_comp = (xaf_comp_t *)comp_ptr;
+
+    XAF_CHK_PTR(p_comp);
+    XAF_CHK_PTR(p_latency);
+
+    XAF_COMP_STATE_CHK(p_comp);
 
     p_handle = &p_comp->handle;
+    XAF_CHK_PTR(p_handle);
 
-    TRACE(INFO, _b("enter comp_get_status pending_resp=%d expect_out_cmd=%d"), p_comp->pending_resp, p_comp->expect_out_cmd);
-    if (p_comp->pending_resp)
+    /* ...histogram doesn't fit auxiliary buffer; use a temporary shared one */
+    XF_CHK_API(xf_pool_alloc(p_handle->proxy, 1, sizeof(stats), XF_POOL_AUX, &pool, XAF_MEM_ID_COMP));
+
+    b = xf_buffer_get(pool);
+
+    if ((ret = xf_get_latency(p_handle, xf_buffer_data(b), sizeof(stats))) == 0)
+        memcpy(&stats, xf_buffer_data(b), sizeof(stats));
+
+    xf_buffer_put(b);
+    xf_pool_free(pool, XAF_MEM_ID_COMP);
+
+    XF_CHK_API(ret);
+
+    memset(p_latency, 0, sizeof(*p_latency));
+
+    if ((p_latency->count = stats.count) != 0)
     {
-        xf_user_msg_t rmsg;
-        /* ...wait until result is delivered */
-        XF_CHK_API(xf_response_get(p_handle, &rmsg)); 
+        p_latency->min_us = stats.min_us;
+        p_latency->max_us = stats.max_us;
+        p_latency->mean_us = (UWORD32)(stats.total_us / stats.count);
+        p_latency->p50_us = xaf_latency_percentile(&stats, 50, 100);
+        p_latency->p90_us = xaf_latency_percentile(&stats, 90, 100);
+        p_latency->p99_us = xaf_latency_percentile(&stats, 99, 100);
+        p_latency->p999_us = xaf_latency_percentile(&stats, 999, 1000);
+    }
 
-        if (rmsg.opcode == XF_EVENT) {
-            long *p_buf = (long *) p_info;
-            p_buf[0] = (long) rmsg.buffer;
-            return 1;
-        }
+    return XAF_NO_ERR;
+}
+
+/* ...locate component buffer within shared memory dma-buf; another device or
+ * process may then fill (or drain) it in place instead of copying. The fd is
+ * a duplicate owned by the caller, who must close it */
+XAF_ERR_CODE xaf_comp_get_dmabuf(pVOID comp_ptr, pVOID p_buf, WORD32 *p_fd, UWORD32 *p_offset, UWORD32 *p_length)
+{
+    xaf_comp_t *p_comp;
+    xaf_adev_t *p_adev;
+    UWORD32     i, length;
+    int         fd;
+
+    p_comp = (xaf_comp_t *)comp_ptr;
+
+    XAF_CHK_PTR(p_comp);
+    XAF_CHK_PTR(p_buf);
+    XAF_CHK_PTR(p_fd);
+    XAF_CHK_PTR(p_offset);
+    XAF_CHK_PTR(p_length);
+
+    XAF_COMP_STATE_CHK(p_comp);
+
+    p_adev = (xaf_adev_t *)p_comp->p_adev;
 
-        if (rmsg.opcode == XF_FILL_THIS_BUFFER) 
+    /* ...only input and output buffers allocated by the library */
+    for (i = 0; i < p_comp->ninbuf; i++)
+        if (p_buf == p_comp->p_input[i])
+            break;
+
+    if (i < p_comp->ninbuf)
+        length = p_comp->inbuf_size;
+    else if (p_comp->outpool && p_buf == p_comp->pout_buf[0])
+        length = p_comp->out_format.output_length[0];
+    else
+        return XAF_INVALIDPTR_ERR;
+
+    /* ...library keeps its own descriptor */
+    fd = fcntl(p_adev->proxy.ipc.fd_mem, F_DUPFD_CLOEXEC, 0);
+    if (fd < 0)
+        return XAF_API_ERR;
+
+    *p_fd = fd;
+    *p_offset = xf_proxy_b2a(&p_adev->proxy, p_buf);
+    *p_length = length;
+
+    return XAF_NO_ERR;
+}
+
+
+/* ...update component state with a response received from DSP */
+static XAF_ERR_CODE xaf_comp_response_handle(xaf_adev_t *p_adev, xaf_comp_t *p_comp, xf_user_msg_t *rmsg, pVOID p_info)
+{
+    xf_handle_t *p_handle = &p_comp->handle;
+
+    if (rmsg->opcode == XF_EVENT) {
+        long *p_buf = (long *) p_info;
+        p_buf[0] = (long) rmsg->buffer;
+        return 1;
+    }
+
+    if (rmsg->opcode == XF_FILL_THIS_BUFFER) 
+    {
+        if (rmsg->buffer == p_comp->start_buf)
         {
-            if (rmsg.buffer == p_comp->start_buf)
-            {
-                int num_out_ports = p_comp->out_ports;
+            int num_out_ports = p_comp->out_ports;
+
+            /* ... response on first output port is received */
+            num_out_ports--;
+            p_comp->pending_resp--;
 
-                /* ... response on first output port is received */
+            while (num_out_ports)
+            {
+                /* ...wait until result is delivered */
+                XF_CHK_API(xf_response_get(p_handle, rmsg)); 
+        
+                /* ...make sure response is expected */
+                XF_CHK_ERR((rmsg->opcode == XF_FILL_THIS_BUFFER && rmsg->buffer == p_comp->start_buf), XAF_API_ERR);
+        
                 num_out_ports--;
                 p_comp->pending_resp--;
-
-                while (num_out_ports)
-                {
-                    /* ...wait until result is delivered */
-                    XF_CHK_API(xf_response_get(p_handle, &rmsg)); 
-            
-                    /* ...make sure response is expected */
-                    XF_CHK_ERR((rmsg.opcode == XF_FILL_THIS_BUFFER && rmsg.buffer == p_comp->start_buf), XAF_API_ERR);
-            
-                    num_out_ports--;
-                    p_comp->pending_resp--;
-                }
-
-                XF_CHK_API(xaf_comp_post_init_config(p_adev, p_comp, p_comp->start_buf));
             }
-            else 
-            {
-                long *p_buf = (long *) p_info;
-                p_buf[0] = (long) rmsg.buffer;
-                p_buf[1] = (long) rmsg.length;
 
-                p_comp->pending_resp--;
+            XF_CHK_API(xaf_comp_post_init_config(p_adev, p_comp, p_comp->start_buf));
+        }
+        else 
+        {
+            long *p_buf = (long *) p_info;
+            p_buf[0] = (long) rmsg->buffer;
+            p_buf[1] = (long) rmsg->length;
 
-                if (p_comp->inp_ports == XF_MSG_SRC_PORT(rmsg.id))
-                {
-                    if(rmsg.length == 0)
-                    {
-                    	p_comp->input_over = 0;
-                        p_comp->exec_cmd_issued = 0;
+            p_comp->pending_resp--;
 
-                        TRACE(INFO, _b("FTB R[%08x]:(%08x,%u,%p)"), rmsg.id, rmsg.opcode, rmsg.length, rmsg.buffer);
+            if (p_comp->inp_ports == XF_MSG_SRC_PORT(rmsg->id))
+            {
+                if(rmsg->length == 0)
+                {
+                	p_comp->input_over = 0;
+                    p_comp->exec_cmd_issued = 0;
 
-                        /* ...collect pending responses before declaring exec_done */
-                        if (p_comp->probe_enabled && p_comp->probe_started)
-                        {
-                            /* ...trigger probe buffer flush */
-                            XF_CHK_API(xf_pause(p_handle, (p_comp->inp_ports + p_comp->out_ports)));
+                    TRACE(INFO, _b("FTB R[%08x]:(%08x,%u,%p)"), rmsg->id, rmsg->opcode, rmsg->length, rmsg->buffer);
 
-                            p_comp->probe_started = 0;
-                        }
+                    /* ...collect pending responses before declaring exec_done */
+                    if (p_comp->probe_enabled && p_comp->probe_started)
+                    {
+                        /* ...trigger probe buffer flush */
+                        XF_CHK_API(xf_pause(p_handle, (p_comp->inp_ports + p_comp->out_ports)));
 
-                        while (p_comp->pending_resp)
-                        {
-                        	XF_CHK_API(xf_response_get(p_handle, &rmsg));
-                        	p_comp->pending_resp--;
+                        p_comp->probe_started = 0;
+                    }
 
-                        	TRACE(INFO, _b("FTB R[%08x]:(%08x,%u,%p)"), rmsg.id, rmsg.opcode, rmsg.length, rmsg.buffer);
-                        }
+                    while (p_comp->pending_resp)
+                    {
+                    	XF_CHK_API(xf_response_get(p_handle, rmsg));
+                    	p_comp->pending_resp--;
 
-                        p_comp->comp_status = XAF_EXEC_DONE;
+                    	TRACE(INFO, _b("FTB R[%08x]:(%08x,%u,%p)"), rmsg->id, rmsg->opcode, rmsg->length, rmsg->buffer);
                     }
-                    else
-                        p_comp->comp_status = XAF_OUTPUT_READY;
+
+                    p_comp->comp_status = XAF_EXEC_DONE;
                 }
                 else
+                    p_comp->comp_status = XAF_OUTPUT_READY;
+            }
+            else
+            {
+                if(rmsg->length == 0)
                 {
-                    if(rmsg.length == 0)
-                    {
-                        p_comp->comp_status = XAF_PROBE_DONE;
-                        TRACE(INFO, _b("PROBE R[%08x]:(%08x,%u,%p)"), rmsg.id, rmsg.opcode, rmsg.length, rmsg.buffer);
-                    }
-                    else
-                        p_comp->comp_status = XAF_PROBE_READY;
+                    p_comp->comp_status = XAF_PROBE_DONE;
+                    TRACE(INFO, _b("PROBE R[%08x]:(%08x,%u,%p)"), rmsg->id, rmsg->opcode, rmsg->length, rmsg->buffer);
                 }
-
-                p_comp->expect_out_cmd++;
+                else
+                    p_comp->comp_status = XAF_PROBE_READY;
             }
+
+            p_comp->expect_out_cmd++;
         }
-        else
+    }
+    else
+    {
+        /* ...make sure response is expected */
+        XF_CHK_ERR((rmsg->opcode == XF_EMPTY_THIS_BUFFER), XAF_API_ERR);
+        long *p_buf = (long *) p_info;
+        p_buf[0] = (long) rmsg->buffer;
+        p_buf[1] = (long) rmsg->length;
+        
+        p_comp->pending_resp--;
+        
+        if (p_comp->input_over && rmsg->buffer == NULL)
         {
-            /* ...make sure response is expected */
-            XF_CHK_ERR((rmsg.opcode == XF_EMPTY_THIS_BUFFER), XAF_API_ERR);
-            long *p_buf = (long *) p_info;
-            p_buf[0] = (long) rmsg.buffer;
-            p_buf[1] = (long) rmsg.length;
-            
-            p_comp->pending_resp--;
-            
-            if (p_comp->input_over && rmsg.buffer == NULL)
-            {
-            	p_comp->input_over = 0;
-            	p_comp->exec_cmd_issued = 0;
+        	p_comp->input_over = 0;
+        	p_comp->exec_cmd_issued = 0;
 
-                TRACE(INFO, _b("ETB R[%08x]:(%08x,%u,%p)"), rmsg.id, rmsg.opcode, rmsg.length, rmsg.buffer);
+            TRACE(INFO, _b("ETB R[%08x]:(%08x,%u,%p)"), rmsg->id, rmsg->opcode, rmsg->length, rmsg->buffer);
 
-                /* ...collect pending responses before declaring exec_done */
-                if (p_comp->probe_enabled && p_comp->probe_started)
-                {
-                    /* ...trigger probe buffer flush */
-                    XF_CHK_API(xf_pause(p_handle, (p_comp->inp_ports + p_comp->out_ports)));
-
-                    p_comp->probe_started = 0;
-                }
+            /* ...collect pending responses before declaring exec_done */
+            if (p_comp->probe_enabled && p_comp->probe_started)
+            {
+                /* ...trigger probe buffer flush */
+                XF_CHK_API(xf_pause(p_handle, (p_comp->inp_ports + p_comp->out_ports)));
 
-                while (p_comp->pending_resp)
-                {
-                	XF_CHK_API(xf_response_get(p_handle, &rmsg));
-                	p_comp->pending_resp--;
+                p_comp->probe_started = 0;
+            }
 
-                	TRACE(INFO, _b("ETB R[%08x]:(%08x,%u,%p)"), rmsg.id, rmsg.opcode, rmsg.length, rmsg.buffer);
-                }
+            while (p_comp->pending_resp)
+            {
+            	XF_CHK_API(xf_response_get(p_handle, rmsg));
+            	p_comp->pending_resp--;
 
-            	p_comp->comp_status = XAF_EXEC_DONE;
+            	TRACE(INFO, _b("ETB R[%08x]:(%08x,%u,%p)"), rmsg->id, rmsg->opcode, rmsg->length, rmsg->buffer);
             }
-            else p_comp->comp_status = XAF_NEED_INPUT;
+
+        	p_comp->comp_status = XAF_EXEC_DONE;
         }
+        else p_comp->comp_status = XAF_NEED_INPUT;
+    }
+
+    return XAF_NO_ERR;
+}
+
+XAF_ERR_CODE xaf_comp_get_status(pVOID adev_ptr, pVOID comp_ptr, xaf_comp_status *p_status, pVOID p_info)
+{
+    xaf_adev_t *p_adev;
+    xaf_comp_t *p_comp;
+    xf_handle_t *p_handle;
+
+    p_adev = (xaf_adev_t *)adev_ptr;
+    p_comp = (xaf_comp_t *)comp_ptr;
+
+    XAF_CHK_PTR(p_comp);
+    XAF_CHK_PTR(p_status);
+    XAF_CHK_PTR(p_info);
+
+    XAF_COMP_STATE_CHK(p_comp);
+
+    if (!p_comp->init_done) XAF_CHK_PTR(p_adev);
+
+    p_handle = &p_comp->handle;
+
+    TRACE(INFO, _b("enter comp_get_status pending_resp=%d expect_out_cmd=%d"), p_comp->pending_resp, p_comp->expect_out_cmd);
+    if (p_comp->pending_resp)
+    {
+        xf_user_msg_t rmsg;
+        XAF_ERR_CODE ret;
+
+        /* ...wait until result is delivered */
+        XF_CHK_API(xf_response_get(p_handle, &rmsg)); 
+
+        /* ...update component state; events are returned to caller as is */
+        if ((ret = xaf_comp_response_handle(p_adev, p_comp, &rmsg, p_info)) != XAF_NO_ERR)
+            return ret;
     }
     else if ((p_comp->comp_status == XAF_STARTING && p_comp->start_cmd_issued) ||
              (p_comp->comp_status == XAF_INIT_DONE && p_comp->exec_cmd_issued))
@@ -1729,7 +1974,16 @@ XAF_ERR_CODE xaf_comp_get_status(pVOID adev_ptr, pVOID comp_ptr, xaf_comp_status
     return XAF_NO_ERR;
 }
 
-XAF_ERR_CODE xaf_comp_process(pVOID adev_ptr, pVOID comp_ptr, pVOID p_buf, UWORD32 length, xaf_comp_flag flag)
+/* ...post command immediately or append it to a batch */
+static inline int xaf_comp_post(xf_cmd_batch_t *batch, xf_handle_t *p_handle, UWORD32 port, UWORD32 opcode, void *p_buf, UWORD32 length)
+{
+    if (batch)
+        return xf_command_batch_add(batch, p_handle, port, opcode, p_buf, length);
+    else
+        return xf_command(p_handle, port, opcode, p_buf, length);
+}
+
+static XAF_ERR_CODE xaf_comp_process_internal(pVOID adev_ptr, pVOID comp_ptr, pVOID p_buf, UWORD32 length, xaf_comp_flag flag, xf_cmd_batch_t *batch)
 {
     xaf_adev_t *p_adev;
     xaf_comp_t *p_comp;
@@ -1744,7 +1998,7 @@ XAF_ERR_CODE xaf_comp_process(pVOID adev_ptr, pVOID comp_ptr, pVOID p_buf, UWORD
 
     if (!p_comp->init_done) XAF_CHK_PTR(p_adev);
     XAF_CHK_RANGE(flag, XAF_START_FLAG, XAF_NEED_PROBE_FLAG);
-    if (flag == XAF_INPUT_READY_FLAG) XAF_CHK_RANGE(length, 0, XAF_INBUF_SIZE);
+    if (flag == XAF_INPUT_READY_FLAG) XAF_CHK_RANGE(length, 0, p_comp->inbuf_size);
 
     p_handle = &p_comp->handle;
     
@@ -1767,7 +2021,7 @@ XAF_ERR_CODE xaf_comp_process(pVOID adev_ptr, pVOID comp_ptr, pVOID p_buf, UWORD
         for(out_port_idx=0;out_port_idx<p_comp->out_ports;out_port_idx++)
 #endif
         {
-              XF_CHK_API(xf_command(p_handle, (p_comp->inp_ports + out_port_idx), XF_FILL_THIS_BUFFER, p_comp->start_buf, 0));
+              XF_CHK_API(xaf_comp_post(batch, p_handle, (p_comp->inp_ports + out_port_idx), XF_FILL_THIS_BUFFER, p_comp->start_buf, 0));
               p_comp->pending_resp++;
         }
             p_comp->start_cmd_issued = 1;
@@ -1794,10 +2048,11 @@ XAF_ERR_CODE xaf_comp_process(pVOID adev_ptr, pVOID comp_ptr, pVOID p_buf, UWORD
                 p_data = xf_buffer_data(p_buf);
 #endif
 
-                XF_CHK_API(xf_command(&p_comp->handle, (p_comp->inp_ports), XF_FILL_THIS_BUFFER, p_data, p_comp->out_format.output_length[0]));
+                XF_CHK_API(xaf_comp_post(batch, &p_comp->handle, (p_comp->inp_ports), XF_FILL_THIS_BUFFER, p_data, p_comp->out_format.output_length[0]));
+
+                /* ...count each posted buffer; a failure may stop the loop half-way */
+                p_comp->pending_resp++;
             }
-            
-            p_comp->pending_resp += p_comp->noutbuf;
         }
 #if 0
         if (p_comp->probepool)
@@ -1808,7 +2063,7 @@ XAF_ERR_CODE xaf_comp_process(pVOID adev_ptr, pVOID comp_ptr, pVOID p_buf, UWORD
             p_buf = xf_buffer_get(p_comp->probepool);
             p_data = xf_buffer_data(p_buf);
 
-            XF_CHK_API(xf_command(&p_comp->handle, (p_comp->inp_ports + p_comp->out_ports), XF_FILL_THIS_BUFFER, p_data, p_comp->probe_length));
+            XF_CHK_API(xaf_comp_post(batch, &p_comp->handle, (p_comp->inp_ports + p_comp->out_ports), XF_FILL_THIS_BUFFER, p_data, p_comp->probe_length));
 
             p_comp->pending_resp++;
         }
@@ -1818,7 +2073,7 @@ XAF_ERR_CODE xaf_comp_process(pVOID adev_ptr, pVOID comp_ptr, pVOID p_buf, UWORD
     case XAF_INPUT_OVER_FLAG:
         if (!p_comp->input_over)
         {
-            XF_CHK_API(xf_command(p_handle, 0, XF_EMPTY_THIS_BUFFER, NULL, 0));
+            XF_CHK_API(xaf_comp_post(batch, p_handle, 0, XF_EMPTY_THIS_BUFFER, NULL, 0));
             p_comp->input_over = 1;
             p_comp->pending_resp++;
         }
@@ -1841,7 +2096,7 @@ XAF_ERR_CODE xaf_comp_process(pVOID adev_ptr, pVOID comp_ptr, pVOID p_buf, UWORD
         if (!p_comp->input_over)
         {
             XAF_CHK_PTR(p_buf);
-            XF_CHK_API(xf_command(p_handle, 0, XF_EMPTY_THIS_BUFFER, p_buf, length));
+            XF_CHK_API(xaf_comp_post(batch, p_handle, 0, XF_EMPTY_THIS_BUFFER, p_buf, length));
             p_comp->pending_resp++;
         }
         break;
@@ -1850,7 +2105,7 @@ XAF_ERR_CODE xaf_comp_process(pVOID adev_ptr, pVOID comp_ptr, pVOID p_buf, UWORD
         if (p_comp->expect_out_cmd)
         {
             XAF_CHK_PTR(p_buf);
-            XF_CHK_API(xf_command(p_handle, (p_comp->inp_ports), XF_FILL_THIS_BUFFER, p_buf, length));
+            XF_CHK_API(xaf_comp_post(batch, p_handle, (p_comp->inp_ports), XF_FILL_THIS_BUFFER, p_buf, length));
             p_comp->expect_out_cmd--;
 
             p_comp->pending_resp++;
@@ -1861,7 +2116,7 @@ XAF_ERR_CODE xaf_comp_process(pVOID adev_ptr, pVOID comp_ptr, pVOID p_buf, UWORD
         if (p_comp->expect_out_cmd)
         {
             XAF_CHK_PTR(p_buf);
-            XF_CHK_API(xf_command(p_handle, (p_comp->inp_ports + p_comp->out_ports), XF_FILL_THIS_BUFFER, p_buf, length));
+            XF_CHK_API(xaf_comp_post(batch, p_handle, (p_comp->inp_ports + p_comp->out_ports), XF_FILL_THIS_BUFFER, p_buf, length));
             p_comp->expect_out_cmd--;
 
             p_comp->pending_resp++;
@@ -1871,6 +2126,112 @@ XAF_ERR_CODE xaf_comp_process(pVOID adev_ptr, pVOID comp_ptr, pVOID p_buf, UWORD
     return XAF_NO_ERR;
 }
 
+XAF_ERR_CODE xaf_comp_process(pVOID adev_ptr, pVOID comp_ptr, pVOID p_buf, UWORD32 length, xaf_comp_flag flag)
+{
+    return xaf_comp_process_internal(adev_ptr, comp_ptr, p_buf, length, flag, NULL);
+}
+
+XAF_ERR_CODE xaf_comp_process_batch(pVOID adev_ptr, xaf_comp_process_desc_t *p_desc, UWORD32 num)
+{
+    xf_cmd_batch_t batch;
+    XAF_ERR_CODE ret = XAF_NO_ERR;
+    xaf_comp_t *p_comp;
+    UWORD32 i, k;
+
+    XAF_CHK_PTR(p_desc);
+
+    xf_command_batch_init(&batch);
+
+    /* ...collect commands; batch is posted when full and at the end */
+    for (i = 0; i < num && !batch.error; i++)
+    {
+        batch.tag = i;
+        p_desc[i].err = xaf_comp_process_internal(adev_ptr, p_desc[i].comp_ptr, p_desc[i].p_buf, p_desc[i].length, p_desc[i].flag, &batch);
+        if (p_desc[i].err != XAF_NO_ERR)
+            ret = p_desc[i].err;
+    }
+
+    if (batch.error == 0 && xf_command_batch_submit(&batch) == 0)
+        return ret;
+
+    /* ...IPC failed; commands left in batch will not be answered, so do not wait for them */
+    for (k = 0; k < batch.num; k++)
+    {
+        p_comp = (xaf_comp_t *)p_desc[batch.msg_tag[k]].comp_ptr;
+        p_comp->pending_resp--;
+        p_desc[batch.msg_tag[k]].err = XAF_API_ERR;
+    }
+
+    /* ...entries after the failure are not processed */
+    for (; i < num; i++)
+        p_desc[i].err = XAF_API_ERR;
+
+    return XAF_API_ERR;
+}
+
+XAF_ERR_CODE xaf_comp_get_status_batch(pVOID adev_ptr, xaf_comp_status_desc_t *p_desc, UWORD32 num, UWORD32 *p_num_ready)
+{
+    xf_ipc_data_t *ipc[XF_CMD_BATCH_SIZE];
+    xaf_comp_t *p_comp;
+    xf_user_msg_t rmsg;
+    UWORD32 i, n_wait, ready;
+    int r;
+
+    XAF_CHK_PTR(p_desc);
+    XAF_CHK_PTR(p_num_ready);
+    XAF_CHK_RANGE(num, 1, XF_CMD_BATCH_SIZE);
+
+    for (;;)
+    {
+        /* ...drain whatever responses are already available */
+        for (i = 0, ready = 0, n_wait = 0; i < num; i++)
+        {
+            p_comp = (xaf_comp_t *)p_desc[i].comp_ptr;
+            p_desc[i].ready = 0;
+            p_desc[i].event = 0;
+            p_desc[i].err = XAF_NO_ERR;
+
+            XAF_CHK_PTR(p_comp);
+            XAF_COMP_STATE_CHK(p_comp);
+
+            if (!p_comp->pending_resp)
+                continue;
+
+            if ((r = xf_response_tryget(&p_comp->handle, &rmsg)) == -EAGAIN)
+            {
+                ipc[n_wait++] = &p_comp->handle.ipc;
+                continue;
+            }
+
+            if (r == 0)
+                p_desc[i].err = xaf_comp_response_handle((xaf_adev_t *)adev_ptr, p_comp, &rmsg, p_desc[i].info);
+            else
+                p_desc[i].err = XAF_API_ERR;
+
+            /* ...event is a regular outcome (not an error); its buffer is in info[0] */
+            if (p_desc[i].err == 1)
+            {
+                p_desc[i].event = 1;
+                p_desc[i].err = XAF_NO_ERR;
+            }
+
+            p_desc[i].status = p_comp->comp_status;
+            p_desc[i].ready = 1;
+            ready++;
+        }
+
+        if (ready || !n_wait)
+            break;
+
+        /* ...nothing available yet; sleep until any component gets a response */
+        XF_CHK_ERR(xf_ipc_response_wait_any(ipc, n_wait, XAF_STATUS_BATCH_TIMEOUT) == 0, XAF_TIMEOUT_ERR);
+    }
+
+    *p_num_ready = ready;
+
+    return XAF_NO_ERR;
+}
+
 XAF_ERR_CODE xaf_connect(pVOID p_src, WORD32 src_out_port, pVOID p_dest, WORD32 dest_in_port, WORD32 num_buf)
 {
     xaf_comp_t *src_comp;
@@ -2012,15 +2373,73 @@ XAF_ERR_CODE xaf_get_mem_stats(pVOID adev_ptr, WORD32 *pmem_info)
 
     /* mem stats info is complete only after components are initialzed. 
      * Recommended to capture stats before device is closed. */
-#if 0 /* by S.J */
-    *((WORD32 *)pmem_info + 0) = xf_g_dsp->dsp_comp_buf_size_peak;
-    *((WORD32 *)pmem_info + 1) = xf_g_dsp->dsp_frmwk_buf_size_peak;
-    *((WORD32 *)pmem_info + 2) = xf_g_ap->xaf_memory_used + XAF_DEV_AND_AP_STRUCT_MEM_SIZE -  (xf_g_dsp->xf_dsp_local_buffer_size + xf_g_dsp->xf_ap_shmem_buffer_size);
-#endif
-#if 0
-    *((WORD32 *)pmem_info + 3) = xf_g_dsp->dsp_comp_buf_size_curr;
-    *((WORD32 *)pmem_info + 4) = xf_g_dsp->dsp_frmwk_buf_size_curr;
-#endif    
+    {
+        xf_mem_stats_msg_t  stats;
+
+        XF_CHK_API(xf_get_mem_stats(&p_adev->proxy, 0, &stats));
+
+        *((WORD32 *)pmem_info + 0) = stats.comp_buf_size_peak;
+        *((WORD32 *)pmem_info + 1) = stats.frmwk_buf_size_peak;
+        *((WORD32 *)pmem_info + 2) = p_adev->xf_g_ap->xaf_memory_used;
+        *((WORD32 *)pmem_info + 3) = stats.comp_buf_size_curr;
+        *((WORD32 *)pmem_info + 4) = stats.frmwk_buf_size_curr;
+    }
+
+    return XAF_NO_ERR;
+}
+
+XAF_ERR_CODE xaf_get_mem_stats_ext(pVOID adev_ptr, xaf_mem_stats_t *p_stats)
+{
+    xaf_adev_t         *p_adev;
+    xf_mem_stats_msg_t  stats;
+
+    XAF_CHK_PTR(p_stats);
+    XAF_CHK_PTR(adev_ptr);
+
+    p_adev = (xaf_adev_t *)adev_ptr;
+
+    if((p_adev->adev_state < XAF_ADEV_INIT))
+    {
+        return XAF_API_ERR;
+    }
+
+    /* ...per-pool usage, high-water mark and fragmentation of DSP memory */
+    XF_CHK_API(xf_get_mem_stats(&p_adev->proxy, 0, &stats));
+
+    memcpy(p_stats, &stats.pools, sizeof(*p_stats));
+
+    return XAF_NO_ERR;
+}
+
+XAF_ERR_CODE xaf_trace_start(pVOID adev_ptr, const char *path)
+{
+    xaf_adev_t         *p_adev;
+
+    XAF_CHK_PTR(adev_ptr);
+    XAF_CHK_PTR(path);
+
+    p_adev = (xaf_adev_t *)adev_ptr;
+
+    if((p_adev->adev_state < XAF_ADEV_INIT))
+    {
+        return XAF_API_ERR;
+    }
+
+    /* ...records of DSP core 0 are drained into the file until xaf_trace_stop */
+    XF_CHK_API(xf_trace_start(&p_adev->proxy, 0, path));
+
+    return XAF_NO_ERR;
+}
+
+XAF_ERR_CODE xaf_trace_stop(pVOID adev_ptr)
+{
+    xaf_adev_t         *p_adev;
+
+    XAF_CHK_PTR(adev_ptr);
+
+    p_adev = (xaf_adev_t *)adev_ptr;
+
+    XF_CHK_API(xf_trace_stop(&p_adev->proxy));
 
     return XAF_NO_ERR;
 }
@@ -30,9 +30,15 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
+/* ...memfd_create() backs the emulator shared region */
+#define _GNU_SOURCE
+
 #include <errno.h>
 #include <fcntl.h>
+#include <linux/types.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <sys/eventfd.h>
 #include <sys/ioctl.h>
 #include <sys/mman.h>
 #include <sys/select.h>
@@ -42,6 +48,9 @@
 #include "xaf-api.h"
 #include "xaf-structs.h"
 #include "osal-msgq.h"
+#ifdef XF_IPC_EMULATOR
+#include "xf-emu-if.h"
+#endif
 
 /*******************************************************************************
  * Global Definitions
@@ -77,6 +86,181 @@ struct rpmsg_endpoint_info {
 
 #define EPT_NUM 2
 
+/* ...shared region size, need to match with firmware */
+#define SHMEM_SIZE 0xEF0000
+
+/*******************************************************************************
+ * Single-producer/single-consumer ring
+ ******************************************************************************/
+
+static int xf_ring_init(xf_ring_t *ring, UWORD32 item_size, UWORD32 n_items)
+{
+	/* ...power-of-two size lets free-running indices wrap naturally */
+	XF_CHK_ERR(n_items && (n_items & (n_items - 1)) == 0, -EINVAL);
+
+	memset(ring, 0, sizeof(*ring));
+	ring->mask = n_items - 1;
+	ring->item_size = item_size;
+
+	ring->data = malloc(n_items * item_size);
+	if (!ring->data)
+		return -ENOMEM;
+
+	ring->doorbell = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (ring->doorbell < 0) {
+		free(ring->data);
+		return -errno;
+	}
+
+	/* ...separate doorbell for the producer; a shared one could be drained by the wrong side */
+	ring->space = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (ring->space < 0) {
+		close(ring->doorbell);
+		free(ring->data);
+		return -errno;
+	}
+
+	return 0;
+}
+
+static void xf_ring_destroy(xf_ring_t *ring)
+{
+	close(ring->space);
+	close(ring->doorbell);
+	free(ring->data);
+	ring->data = NULL;
+}
+
+/* ...producer side; returns -EAGAIN if ring is full */
+static int xf_ring_put(xf_ring_t *ring, const void *item)
+{
+	UWORD32 head = ring->head;
+	uint64_t one = 1;
+
+	if (head - ring->tail_cache > ring->mask) {
+		ring->tail_cache = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+		if (head - ring->tail_cache > ring->mask)
+			return -EAGAIN;
+	}
+
+	memcpy(ring->data + (head & ring->mask) * ring->item_size, item, ring->item_size);
+	__atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+
+	/* ...ring doorbell only if consumer went to sleep on empty ring */
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&ring->waiting, __ATOMIC_RELAXED))
+		(void)write(ring->doorbell, &one, sizeof(one));
+
+	return 0;
+}
+
+/* ...consumer side; returns -EAGAIN if ring is empty */
+static int xf_ring_get(xf_ring_t *ring, void *item)
+{
+	UWORD32 tail = ring->tail;
+	uint64_t one = 1;
+
+	if (tail == ring->head_cache) {
+		ring->head_cache = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+		if (tail == ring->head_cache)
+			return -EAGAIN;
+	}
+
+	memcpy(item, ring->data + (tail & ring->mask) * ring->item_size, ring->item_size);
+	__atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+
+	/* ...wake producer only if it went to sleep on full ring */
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&ring->full_waiting, __ATOMIC_RELAXED))
+		(void)write(ring->space, &one, sizeof(one));
+
+	return 0;
+}
+
+static inline int xf_ring_empty(xf_ring_t *ring)
+{
+	ring->head_cache = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+	return ring->tail == ring->head_cache;
+}
+
+static inline int xf_ring_full(xf_ring_t *ring)
+{
+	ring->tail_cache = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+
+	return ring->head - ring->tail_cache > ring->mask;
+}
+
+/* ...consumer side; wait until ring is non-empty (timeout in ms, -1 = infinite) */
+static int xf_ring_wait(xf_ring_t *ring, int timeout)
+{
+	struct pollfd pollfd;
+	uint64_t count;
+	int ret;
+
+	pollfd.fd = ring->doorbell;
+	pollfd.events = POLLIN;
+
+	while (xf_ring_empty(ring)) {
+		/* ...announce sleep, then re-check to close race with producer */
+		__atomic_store_n(&ring->waiting, 1, __ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+		if (!xf_ring_empty(ring)) {
+			__atomic_store_n(&ring->waiting, 0, __ATOMIC_RELAXED);
+			break;
+		}
+
+		ret = poll(&pollfd, 1, timeout);
+		__atomic_store_n(&ring->waiting, 0, __ATOMIC_RELAXED);
+
+		if (ret == 0)
+			return -ETIMEDOUT;
+		if (ret < 0 && errno != EINTR)
+			return -errno;
+
+		/* ...consume doorbell */
+		(void)read(ring->doorbell, &count, sizeof(count));
+	}
+
+	return 0;
+}
+
+/* ...producer side; ring is sized for all outstanding buffers, so a full ring
+ * only means the consumer is momentarily behind; sleep until it takes an item
+ */
+static int xf_ring_put_wait(xf_ring_t *ring, const void *item)
+{
+	struct pollfd pollfd;
+	uint64_t count;
+	int ret;
+
+	pollfd.fd = ring->space;
+	pollfd.events = POLLIN;
+
+	while (xf_ring_put(ring, item) == -EAGAIN) {
+		/* ...announce sleep, then re-check to close race with consumer */
+		__atomic_store_n(&ring->full_waiting, 1, __ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+		if (!xf_ring_full(ring)) {
+			__atomic_store_n(&ring->full_waiting, 0, __ATOMIC_RELAXED);
+			continue;
+		}
+
+		ret = poll(&pollfd, 1, -1);
+		__atomic_store_n(&ring->full_waiting, 0, __ATOMIC_RELAXED);
+
+		if (ret < 0 && errno != EINTR)
+			return -errno;
+
+		/* ...consume doorbell */
+		(void)read(ring->space, &count, sizeof(count));
+	}
+
+	return 0;
+}
+
 /*******************************************************************************
  * Internal IPC API implementation
  ******************************************************************************/
@@ -84,28 +268,67 @@ struct rpmsg_endpoint_info {
 /* ...pass command to remote DSP */
 int xf_ipc_send(xf_proxy_ipc_data_t *ipc, xf_proxy_msg_t *msg, void *b)
 {
-	int     fd = ipc->fd;
 	int ret;
 
 	TRACE(CMD, _b("C[%08x]:(%x,%08x,%u)"), msg->id, msg->opcode, msg->address, msg->length);
 
+#ifdef XF_IPC_EMULATOR
+	/* ...pass message to in-process DSP emulator */
+	ret = xf_emu_dsp_command(msg, sizeof(*msg));
+	if (ret < 0)
+		return -EIO;
+#else
 	/* ...pass message to kernel driver */
-	ret = write(fd, msg, sizeof(*msg));
+	ret = write(ipc->fd, msg, sizeof(*msg));
 	if (ret < 0)
 		return -errno;
+#endif
 	/* ...communication mutex is still locked! */
 	return 0;
 }
 
+/* ...pass several commands to remote DSP */
+int xf_ipc_send_batch(xf_proxy_ipc_data_t *ipc, xf_proxy_msg_t *msg, UWORD32 num, UWORD32 *posted)
+{
+	int ret;
+	UWORD32 i;
+
+	*posted = 0;
+
+	for (i = 0; i < num; i++)
+		TRACE(CMD, _b("C[%08x]:(%x,%08x,%u)"), msg[i].id, msg[i].opcode, msg[i].address, msg[i].length);
+
+#ifdef XF_IPC_EMULATOR
+	/* ...queue all messages and kick DSP thread once; all or nothing */
+	ret = xf_emu_dsp_command(msg, num * sizeof(*msg));
+	if (ret < 0)
+		return -EIO;
+
+	*posted = num;
+#else
+	/* ...rpmsg device takes one message per write; earlier ones are already with DSP */
+	for (i = 0; i < num; i++, (*posted)++) {
+		ret = write(ipc->fd, &msg[i], sizeof(*msg));
+		if (ret < 0)
+			return -errno;
+	}
+#endif
+
+	return 0;
+}
+
 /* ...wait for response availability */
 int xf_ipc_wait(xf_proxy_ipc_data_t *ipc, UWORD32 timeout)
 {
-	int             fd = ipc->fd;
+#ifdef XF_IPC_EMULATOR
+	/* ...responses are posted to the ring directly by DSP thread */
+	return xf_ring_wait(&ipc->dsp_response, -1);
+#else
 	struct pollfd   pollfd;
 	int ret;
 
 	/* ...specify waiting set */
-	pollfd.fd = fd;
+	pollfd.fd = ipc->fd;
 	pollfd.events = POLLIN | POLLRDNORM;
 
 POLL_AGAIN:
@@ -119,17 +342,22 @@ POLL_AGAIN:
 		return -ETIMEDOUT;
 
 	return 0;
+#endif
 }
 
 /* ...read response from proxy */
 int xf_ipc_recv(xf_proxy_ipc_data_t *ipc, xf_proxy_msg_t *msg, void **buffer)
 {
-	int     fd = ipc->fd;
 	int     r;
 	xf_proxy_msg_t temp;
 
+#ifdef XF_IPC_EMULATOR
+	r = (xf_ring_get(&ipc->dsp_response, &temp) == 0 ? sizeof(temp) : -1);
+	errno = EAGAIN;
+#else
 	/* ...get message header from file */
-	r = read(fd, &temp, sizeof(xf_proxy_msg_t));
+	r = read(ipc->fd, &temp, sizeof(xf_proxy_msg_t));
+#endif
 	if (r == sizeof(xf_proxy_msg_t)) {
 		msg->id = temp.id;
 		msg->opcode = temp.opcode;
@@ -186,7 +414,6 @@ int file_read(char *path, char *str, size_t len)
 {
 	int fd;
 	ssize_t bytes_read;
-	size_t str_sz;
 
 	fd = open(path, O_RDONLY);
 	if (fd == -1) {
@@ -212,12 +439,11 @@ int file_read(char *path, char *str, size_t len)
 
 int xf_rproc_open(struct xf_proxy_ipc_data *ipc)
 {
-	struct rpmsg_endpoint_info eptinfo;
 	char path_buf[512];
 	char sbuf[32];
 	int  found = 0;
 	int rproc_flag = 0;
-	int  i, j, fd, ret;
+	int  i, j;
 
 	ipc->rproc_id = -1;
 
@@ -303,7 +529,7 @@ err_virtio:
 int xf_rproc_close(struct xf_proxy_ipc_data *ipc)
 {
 	char path_buf[512];
-	int  ret, i;
+	int  i;
 	int  fd[EPT_NUM];
 
 	close(ipc->fd);
@@ -341,7 +567,7 @@ int xf_dma_buf_open(struct xf_proxy_ipc_data *ipc) {
 	}
 
 	/* size need to match with firmware */
-	heap_data.len = 0xEF0000;
+	heap_data.len = SHMEM_SIZE;
 	heap_data.fd_flags = O_RDWR | O_CLOEXEC;
 	heap_data.heap_flags = 0;
 	heap_data.fd = 0;
@@ -378,6 +604,69 @@ int xf_dma_buf_close(struct xf_proxy_ipc_data *ipc) {
 	return 0;
 }
 
+#ifdef XF_IPC_EMULATOR
+/* ...response delivery from DSP thread (single producer) */
+static void xf_emu_response(void *arg, const void *msg, UWORD32 length)
+{
+	struct xf_proxy_ipc_data *ipc = arg;
+
+	xf_ring_put_wait(&ipc->dsp_response, msg);
+}
+
+/* ...start DSP emulator over anonymous shared memory */
+int xf_emu_open(struct xf_proxy_ipc_data *ipc)
+{
+	ipc->fd_mem = memfd_create("xf-shmem", MFD_CLOEXEC);
+	if (ipc->fd_mem < 0) {
+		printf("memfd_create fail %d\n", -errno);
+		return -1;
+	}
+
+	ipc->shmem_size = SHMEM_SIZE;
+	if (ftruncate(ipc->fd_mem, ipc->shmem_size) < 0) {
+		printf("ftruncate fail %d\n", -errno);
+		goto err_mem;
+	}
+
+	ipc->shmem = mmap(NULL, ipc->shmem_size,
+			  PROT_READ | PROT_WRITE, MAP_SHARED,
+			  ipc->fd_mem, 0);
+	if (ipc->shmem == MAP_FAILED) {
+		printf("mmap fail %d\n", -errno);
+		goto err_mem;
+	}
+
+	if (xf_ring_init(&ipc->dsp_response, sizeof(xf_proxy_msg_t), XF_IPC_RING_ENTRIES) < 0)
+		goto err_map;
+	ipc->fd = -1;
+
+	if (xf_emu_dsp_start(ipc->shmem, ipc->shmem_size, xf_emu_response, ipc) < 0) {
+		printf("DSP emulator start fail\n");
+		xf_ring_destroy(&ipc->dsp_response);
+		goto err_map;
+	}
+
+	return 0;
+
+err_map:
+	(void)munmap(ipc->shmem, ipc->shmem_size);
+err_mem:
+	close(ipc->fd_mem);
+	return -1;
+}
+
+int xf_emu_close(struct xf_proxy_ipc_data *ipc)
+{
+	xf_emu_dsp_stop();
+	xf_ring_destroy(&ipc->dsp_response);
+
+	(void)munmap(ipc->shmem, ipc->shmem_size);
+	close(ipc->fd_mem);
+
+	return 0;
+}
+#endif
+
 void sighand(int signo)
 {
 	pthread_exit(NULL);
@@ -386,8 +675,7 @@ void sighand(int signo)
 /* ...open proxy interface on proper DSP partition */
 int xf_ipc_open(struct xf_proxy_ipc_data *ipc, UWORD32 core)
 {
-	int ret, i;
-	char path[20];
+	int ret;
 	struct sigaction actions;
 
 	memset(&actions, 0, sizeof(actions));
@@ -398,6 +686,11 @@ int xf_ipc_open(struct xf_proxy_ipc_data *ipc, UWORD32 core)
 	/* set the handle function of SIGUSR1 */
 	sigaction(SIGUSR1, &actions, NULL);
 
+#ifdef XF_IPC_EMULATOR
+	ret = xf_emu_open(ipc);
+	if (ret < 0)
+		return ret;
+#else
 	/* ...open file handle */
 	ret = xf_rproc_open(ipc);
 	if (ret < 0)
@@ -408,9 +701,19 @@ int xf_ipc_open(struct xf_proxy_ipc_data *ipc, UWORD32 core)
 		xf_rproc_close(ipc);
 		return ret;
 	}
+#endif
 
-	/* ...create pipe for asynchronous response delivery */
-	XF_CHK_ERR(pipe(ipc->pipe) == 0, -errno);
+	/* ...create ring for asynchronous response delivery */
+	ret = xf_ring_init(&ipc->response, sizeof(xf_proxy_msg_t), XF_IPC_RING_ENTRIES);
+	if (ret < 0) {
+#ifdef XF_IPC_EMULATOR
+		xf_emu_close(ipc);
+#else
+		xf_dma_buf_close(ipc);
+		xf_rproc_close(ipc);
+#endif
+		return ret;
+	}
 
 	TRACE(INFO,_b("proxy interface opened\n"));
 
@@ -420,12 +723,16 @@ int xf_ipc_open(struct xf_proxy_ipc_data *ipc, UWORD32 core)
 /* ...close proxy handle */
 void xf_ipc_close(struct xf_proxy_ipc_data *ipc, UWORD32 core)
 {
-	/* ...close asynchronous response delivery pipe */
-	close(ipc->pipe[0]), close(ipc->pipe[1]);
+	/* ...close asynchronous response delivery ring */
+	xf_ring_destroy(&ipc->response);
 
+#ifdef XF_IPC_EMULATOR
+	xf_emu_close(ipc);
+#else
 	xf_dma_buf_close(ipc);
 	/* ...close proxy file handle */
 	xf_rproc_close(ipc);
+#endif
 
 	TRACE(INFO, _b("proxy interface closed\n"));
 }
@@ -445,97 +752,98 @@ void xf_ipc_close_set_event(xf_proxy_ipc_data_t *ipc, UWORD32 core)
 
 int xf_ipc_data_init(xf_ipc_data_t *ipc)
 {
-	/* ...initialize pipe */
-	if (pipe(ipc->pipe) == 0)
-		return 0;
-	else
-		return -errno;
-
-	return 0;
+	/* ...initialize ring */
+	return xf_ring_init(&ipc->ring, sizeof(struct xf_user_msg), XF_IPC_RING_ENTRIES);
 }
 
 int xf_ipc_data_destroy(xf_ipc_data_t *ipc)
 {
-	close(ipc->pipe[0]);
-	close(ipc->pipe[1]);
+	xf_ring_destroy(&ipc->ring);
 
 	return 0;
 }
 
+/* ...called from proxy thread only */
 int xf_ipc_response_put(xf_ipc_data_t *ipc, struct xf_user_msg *msg)
 {
-        if (write(ipc->pipe[1], msg, sizeof(*msg)) == sizeof(*msg))
-                return 0;
-        else
-                return -errno;
+	return xf_ring_put_wait(&ipc->ring, msg);
 }
 
+/* ...single consumer per component handle */
 int xf_ipc_response_get(xf_ipc_data_t *ipc, struct xf_user_msg *msg)
 {
-	int fd;
-	struct pollfd   pollfd;
-	UWORD32 timeout = TIMEOUT;
+	int ret;
+
+	/* ...wait until there is a message in ring */
+	ret = xf_ring_wait(&ipc->ring, TIMEOUT);
+	if (ret < 0)
+		return ret;
+
+	return xf_ring_get(&ipc->ring, msg);
+}
+
+
+/* ...non-blocking variant; returns -EAGAIN if no response is pending */
+int xf_ipc_response_tryget(xf_ipc_data_t *ipc, struct xf_user_msg *msg)
+{
+	return xf_ring_get(&ipc->ring, msg);
+}
+
+/* ...wait until any of given component rings has a response */
+int xf_ipc_response_wait_any(xf_ipc_data_t **ipc, UWORD32 num, UWORD32 timeout)
+{
+	struct pollfd pollfd[XF_CMD_BATCH_SIZE];
+	uint64_t count;
+	UWORD32 i;
 	int ret = 0;
 
-	/* ...read pipe */
-	fd = ipc->pipe[0];
+	XF_CHK_ERR(num > 0 && num <= XF_CMD_BATCH_SIZE, -EINVAL);
 
-	/* ...specify waiting set */
-	pollfd.fd = fd;
-	pollfd.events = POLLIN | POLLRDNORM;
+	/* ...announce sleep on all rings, then re-check (see xf_ring_wait) */
+	for (i = 0; i < num; i++) {
+		__atomic_store_n(&ipc[i]->ring.waiting, 1, __ATOMIC_RELAXED);
+		pollfd[i].fd = ipc[i]->ring.doorbell;
+		pollfd[i].events = POLLIN;
+	}
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
 
-	/* ...wait until there is a data in file */
-	ret = poll(&pollfd, 1, timeout);
-	if (ret > 0) {
-		if (read(ipc->pipe[0], msg, sizeof(*msg)) == sizeof(*msg))
-			return 0;
-		return -errno;
-	} else if (ret < 0)
-		return ret;
+	for (i = 0; i < num; i++)
+		if (!xf_ring_empty(&ipc[i]->ring))
+			goto out;
+
+	ret = poll(pollfd, num, timeout);
+	if (ret == 0)
+		ret = -ETIMEDOUT;
+	else if (ret < 0)
+		ret = (errno == EINTR ? 0 : -errno);
 	else
-		return -ETIMEDOUT;
-}
+		ret = 0;
 
+out:
+	for (i = 0; i < num; i++) {
+		__atomic_store_n(&ipc[i]->ring.waiting, 0, __ATOMIC_RELAXED);
+		(void)read(ipc[i]->ring.doorbell, &count, sizeof(count));
+	}
+
+	return ret;
+}
 
 /*******************************************************************************
  * Helpers for asynchronous response delivery
  ******************************************************************************/
 int xf_proxy_ipc_response_put(xf_proxy_ipc_data_t *ipc, xf_proxy_msg_t *msg)
 {
-	int ret;
-
-	ret = write((ipc)->pipe[1], (msg), sizeof(*(msg)));
-	if (ret == sizeof(*(msg)))
-		return 0;
-	else
-		return -errno;
+	return xf_ring_put_wait(&ipc->response, msg);
 }
 
+/* ...consumers are serialized by proxy lock */
 int xf_proxy_ipc_response_get(xf_proxy_ipc_data_t *ipc, xf_proxy_msg_t *msg)
 {
-        int fd;
-        struct pollfd   pollfd;
-        UWORD32 timeout = TIMEOUT;
-        int ret = 0;
-
-        /* ...read pipe */
-        fd = ipc->pipe[0];
-
-        /* ...specify waiting set */
-        pollfd.fd = fd;
-        pollfd.events = POLLIN | POLLRDNORM;
-
-        /* ...wait until there is a data in file */
-        ret = poll(&pollfd, 1, timeout);
-        if (ret > 0) {
-		ret = read((ipc)->pipe[0], (msg), sizeof(*(msg)));
-		if (ret == sizeof(*(msg)))
-			return 0;
-		else
-			return  -errno;
-	}
-        else if (ret < 0)
-                return ret;
-        else
-                return -ETIMEDOUT;
+	int ret;
+
+	ret = xf_ring_wait(&ipc->response, TIMEOUT);
+	if (ret < 0)
+		return ret;
+
+	return xf_ring_get(&ipc->response, msg);
 }
@@ -0,0 +1,106 @@
+/*****************************************************************
+ * Copyright 2018 NXP
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************/
+
+/*
+ * xtlib-prelink: offline pre-linker for split-load PI codec libraries
+ *
+ * Relocates code and data segments of a library for a DSP code buffer
+ * address, as reported by the host loader ("library ... loaded at code
+ * 0x..."), and writes "<library>.plk" next to it (see library_prelink.h).
+ * Data is relocated per instance by the loader; a different code address
+ * only costs a host-side rebase of the code image.
+ *
+ * Build: make XA_RTOS=linux xtlib-prelink (libxa_af_hostless/build)
+ * Usage: xtlib-prelink <library.so> <code-addr>
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "library_prelink.h"
+
+int main(int argc, char **argv)
+{
+	struct xtlib_prelink_header *plk;
+	const char *err = NULL;
+	unsigned char *image;
+	size_t body;
+	char *path;
+	FILE *f;
+	long size;
+
+	if (argc != 3) {
+		fprintf(stderr, "usage: %s <library.so> <code-addr>\n", argv[0]);
+		return 1;
+	}
+
+	f = fopen(argv[1], "rb");
+	if (!f) {
+		perror(argv[1]);
+		return 1;
+	}
+
+	fseek(f, 0, SEEK_END);
+	size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	image = malloc(size);
+	if (!image || fread(image, 1, size, f) != (size_t)size) {
+		fprintf(stderr, "%s: read error\n", argv[1]);
+		return 1;
+	}
+	fclose(f);
+
+	plk = xtlib_prelink_build(image, size, strtoul(argv[2], NULL, 0), &err);
+	if (!plk) {
+		fprintf(stderr, "%s: %s\n", argv[1], err);
+		return 1;
+	}
+
+	path = malloc(strlen(argv[1]) + sizeof(XTLIB_PRELINK_SUFFIX));
+	sprintf(path, "%s%s", argv[1], XTLIB_PRELINK_SUFFIX);
+
+	f = fopen(path, "wb");
+	if (!f) {
+		perror(path);
+		return 1;
+	}
+
+	body = xtlib_prelink_body_size(plk);
+	if (fwrite(plk, 1, sizeof(*plk) + body, f) != sizeof(*plk) + body) {
+		fprintf(stderr, "%s: write error\n", path);
+		fclose(f);
+		remove(path);
+		return 1;
+	}
+	fclose(f);
+
+	printf("code 0x%08x (%u bytes), data %u bytes, %u fixups\n",
+	       plk->pil_info[0], plk->code_size, plk->data_size, plk->fixup_count);
+
+	free(plk);
+	free(image);
+	free(path);
+
+	return 0;
+}
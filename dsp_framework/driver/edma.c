@@ -77,7 +77,7 @@
 #define EDMA_TCD_CSR_ACTIVE             BIT(6)
 #define EDMA_TCD_CSR_DONE               BIT(7)
 
-#define MAX_PERIOD_COUNT  8
+#define MAX_PERIOD_COUNT  DMA_MAX_PERIOD_COUNT
 
 #define MAX_EDMA_CHANNELS 32
 
@@ -458,6 +458,8 @@ int edma_chan_config(dmac_t *dma_chan, dmac_cfg_t *dmac_cfg)
 	edmac_t *edmac = NULL;
 	if (!dma_chan)
 		return -EINVAL;
+	if (dmac_cfg->period_count < 1 || dmac_cfg->period_count > MAX_PERIOD_COUNT)
+		return -EINVAL;
 
 	dma_chan->direction = dmac_cfg->direction;
 	dma_chan->src_addr = dmac_cfg->src_addr;
@@ -620,6 +620,8 @@ static int load_channel(dmac_t *dmac)
 	int type = dmac->direction;
 	void *src_addr = dmac->src_addr, *dest_addr = dmac->dest_addr;
 	int period_len = dmac->period_len;
+	int period_count = dmac->period_count;
+	int i;
 
 	int channel = sdmac->channel_id;
 	int ch_watermark = sdmac_cfg->watermark;
@@ -699,19 +701,16 @@ static int load_channel(dmac_t *dmac)
 	sdma_event_enable(sdma, event2, channel, done_cfg);
 
 	if (type == DMA_MEM_TO_DEV) {
-		sdma_channel_attach_bd(sdma, channel, 2);
-		/* set 2 bds for transmite data */
+		sdma_channel_attach_bd(sdma, channel, period_count);
+		/* set one bd per period for transmite data */
 		bd1 = sdmac->bd;
-		bd1->mode.command = 2;
-		bd1->mode.status = BD_DONE | BD_INTR | BD_CONT;
-		bd1->mode.count = period_len;
-		bd1->buffer_addr = (unsigned int)src_addr;
-
-		bd1 = &bd1[1];
-		bd1->mode.command = 2;
-		bd1->mode.status = BD_DONE | BD_WRAP | BD_CONT + BD_INTR;
-		bd1->mode.count = period_len;
-		bd1->buffer_addr = (unsigned int)(src_addr + period_len);
+		for (i = 0; i < period_count; i++) {
+			bd1[i].mode.command = 2;
+			bd1[i].mode.status = BD_DONE | BD_INTR | BD_CONT;
+			bd1[i].mode.count = period_len;
+			bd1[i].buffer_addr = (unsigned int)(src_addr + i * period_len);
+		}
+		bd1[period_count - 1].mode.status |= BD_WRAP;
 	} else if (type == DMA_DEV_TO_DEV) {
 		sdma_channel_attach_bd(sdma, channel, 1);
 		bd1 = sdmac->bd;
@@ -720,19 +719,16 @@ static int load_channel(dmac_t *dmac)
 		bd1->mode.status = BD_DONE | BD_WRAP | BD_CONT;
 		bd1->mode.count = 64;
 	} else if (type == DMA_DEV_TO_MEM) {
-		sdma_channel_attach_bd(sdma, channel, 2);
-		/* set 2 bds for transmite data */
+		sdma_channel_attach_bd(sdma, channel, period_count);
+		/* set one bd per period for receive data */
 		bd1 = sdmac->bd;
-		bd1->mode.command = 0;
-		bd1->mode.status = BD_DONE | BD_INTR | BD_CONT | BD_EXTD;
-		bd1->mode.count = period_len;
-		bd1->buffer_addr = (unsigned int)dest_addr;
-
-		bd1 = &bd1[1];
-		bd1->mode.command = 0;
-		bd1->mode.status = BD_DONE | BD_INTR | BD_CONT | BD_EXTD | BD_WRAP;
-		bd1->mode.count = period_len;
-		bd1->buffer_addr = (unsigned int)(dest_addr + period_len);
+		for (i = 0; i < period_count; i++) {
+			bd1[i].mode.command = 0;
+			bd1[i].mode.status = BD_DONE | BD_INTR | BD_CONT | BD_EXTD;
+			bd1[i].mode.count = period_len;
+			bd1[i].buffer_addr = (unsigned int)(dest_addr + i * period_len);
+		}
+		bd1[period_count - 1].mode.status |= BD_WRAP;
 	}
 
 	sdma_disable_channel(sdma, channel);
@@ -777,9 +773,14 @@ int sdma_chan_config(dmac_t *dma_chan, dmac_cfg_t *dmac_cfg)
 	dma_chan->src_width = dmac_cfg->src_width;
 	dma_chan->dest_width = dmac_cfg->dest_width;
 	dma_chan->period_len = dmac_cfg->period_len;
+	dma_chan->period_count = dmac_cfg->period_count;
 	dma_chan->callback = dmac_cfg->callback;
 	dma_chan->comp = dmac_cfg->comp;
 
+	if (dmac_cfg->period_count < 1 || dmac_cfg->period_count > DMA_MAX_PERIOD_COUNT ||
+	    dmac_cfg->period_len > DMA_MAX_PERIOD_LEN)
+		return -EINVAL;
+
 	if (dmac_cfg->peripheral_config)
 		memcpy(&sdmac->sdmac_cfg, dmac_cfg->peripheral_config, dmac_cfg->peripheral_size);
 
@@ -50,6 +50,10 @@ typedef struct {
 	struct sdma_audio_config        trans_cfg;
 } sdmac_cfg_t;
 
+/* cyclic transfer limits: EDMA TCD pool size, SDMA BD count field */
+#define DMA_MAX_PERIOD_COUNT	8
+#define DMA_MAX_PERIOD_LEN	0xffff
+
 typedef struct {
 	dma_trans_dir_t  direction;
 	void             *src_addr, *dest_addr;
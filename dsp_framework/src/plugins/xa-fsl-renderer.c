@@ -54,6 +54,7 @@
 #include "osal-timer.h"
 #include <stdio.h>
 #include "audio/xa-renderer-api.h"
+#include "xa-renderer-conceal.h"
 #include "xf-debug.h"
 #include <string.h>
 
@@ -82,28 +83,8 @@ extern clk_t renderer_cycles;
 
 #define HW_I2S_SF (44100)
 
-#define READ_FIFO(payload) {\
-        if(d->output)\
-        {\
-            /* ...write to optional output buffer */\
-            memcpy(d->output, d->pfifo_r, payload);\
-            d->bytes_produced = payload;\
-        }\
-        /* ...write to output file and increment read pointer */\
-        d->pfifo_r += payload;\
-        if((UWORD32)d->pfifo_r >= (UWORD32)&d->g_fifo_renderer[2*payload])\
-        {\
-            d->pfifo_r = (void*)d->g_fifo_renderer;\
-        }\
-    }
-
-#define UPDATE_WPTR(offset, payload) {\
-        d->pfifo_w += offset;\
-        if((UWORD32)d->pfifo_w >= (UWORD32)&d->g_fifo_renderer[2*payload])\
-        {\
-            d->pfifo_w = (void*)d->g_fifo_renderer;\
-        }\
-    }
+/* ...EDMA moves 8 bytes per minor loop, so period must be a multiple of that */
+#define PERIOD_ALIGN_IN_BYTES           8
 
 /*******************************************************************************
  * Local data definition
@@ -181,6 +162,41 @@ typedef struct XARenderer
     /* ...framesize in samples per channel */
     UWORD32     frame_size;
 
+    /* ...DMA period in samples per channel (0 - same as framesize) */
+    UWORD32     period_size;
+
+    /* ...requested ring latency in microseconds (0 - two periods) */
+    UWORD32     latency_us;
+
+    /* ...DMA period length in bytes (all channels) */
+    UWORD32     period_bytes;
+
+    /* ...number of DMA periods in the ring */
+    UWORD32     period_count;
+
+    /* ...total ring length in bytes (period_bytes * period_count) */
+    UWORD32     ring_bytes;
+
+    /* ...ring layout exported to the component class for buffer lending */
+    xa_renderer_dma_ring_t  dma_ring;
+
+    /* ...data is produced in-place into lent DMA periods */
+    UWORD32     inplace;
+
+    /* ...underrun handling mode */
+    UWORD32     underrun_mode;
+
+    /* ...number of underruns (updated from interrupt) */
+    UWORD32     xruns;
+
+    /* ...number of underruns reported to application */
+    UWORD32     xruns_reported;
+
+#ifndef XA_DISABLE_EVENT
+    /* ...event raising callback */
+    xa_raise_event_cb_t    *event_cb;
+#endif
+
 	void                  *dev_addr;
 	void                  *fe_dev_addr;
 
@@ -280,6 +296,31 @@ static inline void xa_hw_renderer_close(struct XARenderer *d)
 	d->fe_dev_stop(d->fe_dev_addr, 1);
 }
 
+/* ...advance read pointer by one DMA period */
+static inline void xa_hw_renderer_read_fifo(struct XARenderer *d)
+{
+	if (d->output) {
+		/* ...write to optional output buffer */
+		memcpy(d->output, d->pfifo_r, d->period_bytes);
+		d->bytes_produced = d->period_bytes;
+	}
+
+	d->pfifo_r += d->period_bytes;
+	if ((UWORD32)d->pfifo_r >= (UWORD32)&d->g_fifo_renderer[d->ring_bytes])
+		d->pfifo_r = (void *)d->g_fifo_renderer;
+}
+
+/* ...conceal underrun in the period after the playing one; runs from interrupt */
+static inline void xa_hw_renderer_conceal(struct XARenderer *d)
+{
+	/* ...DMA owns the period at read pointer; only the next one is written */
+	d->pfifo_w = xa_renderer_conceal(d->g_fifo_renderer, d->ring_bytes, d->period_bytes,
+					 d->pfifo_r, d->underrun_mode, d->pcm_width, d->channels);
+
+	/* ...playing and concealed periods are queued; next frame goes after them */
+	d->fifo_avail = d->ring_bytes - 2 * d->period_bytes;
+}
+
 /* ...emulation of renderer interrupt service routine */
 static void xa_hw_renderer_callback(void *arg)
 {
@@ -288,16 +329,28 @@ static void xa_hw_renderer_callback(void *arg)
 	u32     status;
 	u32     num;
 
-	READ_FIFO(d->frame_size_bytes * d->channels);
-	d->fifo_avail = d->fifo_avail + (d->frame_size_bytes * d->channels);
+	xa_hw_renderer_read_fifo(d);
+	d->fifo_avail = d->fifo_avail + d->period_bytes;
 	LOG2("fifo_avail %x, fifo_ptr_r %x\n", d->fifo_avail, d->pfifo_r);
 	/* ...notify user on input-buffer (idx = 0) consumption */
-	if((d->fifo_avail) >= d->frame_size_bytes * d->channels * 2)
+	if (d->underrun_mode != XA_RENDERER_UNDERRUN_STOP && !d->inplace && d->period_count > 2 &&
+	    d->fifo_avail >= d->ring_bytes - d->period_bytes)
+	{
+		/* ...nothing queued after playing period; conceal next one before DMA gets there */
+		LOG("isr under run\n");
+		d->xruns++;
+
+		/* ...keep DMA running; transient hiccup costs one period */
+		xa_hw_renderer_conceal(d);
+	} else if((d->fifo_avail) >= d->ring_bytes)
 	{
+		/* ...STOP mode, lent periods or double buffering; stop once ring is drained */
 		LOG("isr under run\n");
+		d->xruns++;
+
 		/*under run case*/
 		d->state ^= XA_RENDERER_FLAG_RUNNING | XA_RENDERER_FLAG_IDLE;
-		d->fifo_avail = d->frame_size_bytes * d->channels * 2;
+		d->fifo_avail = d->ring_bytes;
 		xa_hw_renderer_close(d);
 	} else if(((int)d-> fifo_avail) <= 0) {
 		/* over run */
@@ -331,6 +384,8 @@ static inline UWORD32 xa_fw_renderer_submit(XARenderer *d, void *b, UWORD32 byte
     UWORD32 k;
     UWORD32 zfill;
     UWORD32 payload;
+    UWORD32 tail;
+    UWORD8 *ring_end;
 
     fp      = d ->fw;
     payload = d->frame_size_bytes*d->channels;
@@ -347,26 +402,62 @@ static inline UWORD32 xa_fw_renderer_submit(XARenderer *d, void *b, UWORD32 byte
         zfill         = payload - k;
         d->fifo_avail = (avail -= payload);
 
+        /* ...frame does not have to be aligned to DMA periods; split it at ring end */
+        ring_end = d->g_fifo_renderer + d->ring_bytes;
+
+        /* ...data produced straight into a lent DMA period; follow its position */
+        d->inplace = ((UWORD8 *)b >= d->g_fifo_renderer && (UWORD8 *)b < ring_end);
+
+        if (d->inplace)
+        {
+            d->pfifo_w = b;
+        }
+
+        tail     = (UWORD32)(ring_end - (UWORD8 *)d->pfifo_w);
+
         /* ...write one frame worth data to FIFO */
-        memcpy((char *)d->pfifo_w, (char *)b, k);
+        if (b == d->pfifo_w)
+        {
+            /* ...data is already in place */
+        }
+        else if (k <= tail)
+        {
+            memcpy((char *)d->pfifo_w, (char *)b, k);
+        }
+        else
+        {
+            memcpy((char *)d->pfifo_w, (char *)b, tail);
+            memcpy((char *)d->g_fifo_renderer, (char *)b + tail, k - tail);
+        }
 
         if (zfill)
         {
             /* ...write zeros to complete one frame worth data to FIFO */
-            memset((char *)d->pfifo_w + k, 0, zfill);
+            if (k >= tail)
+            {
+                memset((char *)d->g_fifo_renderer + (k - tail), 0, zfill);
+            }
+            else if (payload <= tail)
+            {
+                memset((char *)d->pfifo_w + k, 0, zfill);
+            }
+            else
+            {
+                memset((char *)d->pfifo_w + k, 0, tail - k);
+                memset((char *)d->g_fifo_renderer, 0, payload - tail);
+            }
 
             TRACE(OUTPUT, _b("submitted zero-fill bytes:%d"), zfill);
         }
 
         /* ...update the write pointer */
-        UPDATE_WPTR(payload, payload);
+        d->pfifo_w = (payload < tail ? (UWORD8 *)d->pfifo_w + payload : d->g_fifo_renderer + (payload - tail));
 
         /* ...process buffer start-up */
         if (d->state & XA_RENDERER_FLAG_IDLE)
         {
-            /* ...start-up transmission if FIFO gets at least 2 frames */
-            //if (avail <= (HW_FIFO_LENGTH - (2 * payload)))
-            if (avail == 0)
+            /* ...start-up transmission once FIFO cannot take another frame */
+            if (avail < payload)
             {
 		/* trigger start*/
 		xa_hw_renderer_start(d);
@@ -415,6 +506,45 @@ static XA_ERRORCODE xa_renderer_get_api_size(XARenderer *d, WORD32 i_idx, pVOID
     return XA_NO_ERROR;
 }
 
+/* ...derive DMA period and ring geometry from frame size, period size and latency */
+static inline int xa_hw_renderer_ring_setup(struct XARenderer *d)
+{
+	UWORD32 frame_bytes = d->sample_size * d->channels;
+	UWORD32 payload = d->frame_size_bytes * d->channels;
+	UWORD32 latency_bytes;
+	UWORD32 count;
+
+	d->period_bytes = (d->period_size ? d->period_size * d->sample_size : d->frame_size_bytes) * d->channels;
+
+	if (d->period_bytes == 0 || d->period_bytes > DMA_MAX_PERIOD_LEN ||
+	    d->period_bytes % PERIOD_ALIGN_IN_BYTES)
+		return -1;
+
+	/* ...requested latency rounded up to whole periods; two periods by default */
+	latency_bytes = (UWORD32)(((UWORD64)d->rate * d->latency_us + 999999) / 1000000) * frame_bytes;
+	count = (latency_bytes + d->period_bytes - 1) / d->period_bytes;
+	if (count < 2)
+		count = 2;
+
+	/* ...concealment needs a period queued after the playing one to look ahead */
+	if (d->underrun_mode != XA_RENDERER_UNDERRUN_STOP && count < 3)
+		count = 3;
+
+	/* ...ring must hold one full frame on top of the period being played */
+	while (count * d->period_bytes < payload + d->period_bytes)
+		count++;
+
+	if (count > DMA_MAX_PERIOD_COUNT)
+		return -1;
+
+	d->period_count = count;
+	d->ring_bytes = count * d->period_bytes;
+
+	TRACE(INIT, _b("DMA ring: %u periods of %u bytes"), d->period_count, d->period_bytes);
+
+	return 0;
+}
+
 /* ...initialize hardware renderer */
 static inline int xa_hw_renderer_init(struct XARenderer *d)
 {
@@ -432,13 +562,16 @@ static inline int xa_hw_renderer_init(struct XARenderer *d)
 	d->dma = dsp->dma_device;
 	dma_init(d->dma);
 
-	/*initially FIFO will be empty so fifo_avail is 2x framesize bytes for ping and pong */
-	d->fifo_avail = d->frame_size_bytes * d->channels * 2;
-	/* ...make sure that the frame_size_bytes is within the FIFO length */
-	XF_CHK_ERR(d->fifo_avail <= HW_FIFO_LENGTH, XA_RENDERER_CONFIG_NONFATAL_RANGE);
+	/* ...size DMA ring; initially FIFO is empty so fifo_avail is the whole ring */
+	XF_CHK_ERR(xa_hw_renderer_ring_setup(d) == 0, XA_RENDERER_CONFIG_NONFATAL_RANGE);
+	d->fifo_avail = d->ring_bytes;
 
 	/* alloc internal buffer for DMA/SAI/ESAI*/
-	xaf_malloc((void **)&d->g_fifo_renderer, d->frame_size_bytes * d->channels * 2, 0);
+	xaf_malloc((void **)&d->g_fifo_renderer, d->ring_bytes, 0);
+
+	d->dma_ring.base = d->g_fifo_renderer;
+	d->dma_ring.period_bytes = d->period_bytes;
+	d->dma_ring.period_count = d->period_count;
 
 	/* ...initialize FIFO params, zero fill FIFO and init pointers to start of FIFO */
 	d->pfifo_w = d->pfifo_r = d->g_fifo_renderer;
@@ -476,8 +609,8 @@ static inline int xa_hw_renderer_init(struct XARenderer *d)
 		d->irq_2_dsp = INT_NUM_IRQSTR_DSP_6;
 
 		/* dma channel configuration */
-		audio_cfg.period_len = d->frame_size_bytes * d->channels;
-		audio_cfg.period_count = 2;
+		audio_cfg.period_len = d->period_bytes;
+		audio_cfg.period_count = d->period_count;
 		audio_cfg.direction = DMA_MEM_TO_DEV;
 		audio_cfg.src_addr = d->g_fifo_renderer;
 		audio_cfg.dest_addr = (void *)(ASRC_ADDR + REG_ASRDIA);
@@ -490,10 +623,11 @@ static inline int xa_hw_renderer_init(struct XARenderer *d)
 		d->dmac[0] = request_dma_chan(d->dma, dev_type);
 		if (!d->dmac[0])
 			return XA_FATAL_ERROR;
-		dma_chan_config(d->dmac[0], &audio_cfg);
+		if (dma_chan_config(d->dmac[0], &audio_cfg))
+			return XA_FATAL_ERROR;
 
-		audio_cfg.period_len = d->frame_size_bytes * d->channels;
-		audio_cfg.period_count = 2;
+		audio_cfg.period_len = d->period_bytes;
+		audio_cfg.period_count = d->period_count;
 		audio_cfg.direction = DMA_DEV_TO_DEV;
 		audio_cfg.src_addr = (void *)(ASRC_ADDR + REG_ASRDOA);
 		audio_cfg.dest_addr = (void *)(ESAI_ADDR + REG_ESAI_ETDR);
@@ -506,7 +640,8 @@ static inline int xa_hw_renderer_init(struct XARenderer *d)
 		d->dmac[1] = request_dma_chan(d->dma, dev_type);
 		if (!d->dmac[1])
 			return XA_FATAL_ERROR;
-		dma_chan_config(d->dmac[1], &audio_cfg);
+		if (dma_chan_config(d->dmac[1], &audio_cfg))
+			return XA_FATAL_ERROR;
 	} else {
 		sdmac_cfg_t sdmac_cfg;
 		memset(&d->easrc, 0, sizeof(struct fsl_easrc));
@@ -544,8 +679,8 @@ static inline int xa_hw_renderer_init(struct XARenderer *d)
 		d->irq_2_dsp = INT_NUM_IRQSTR_DSP_1;
 
 		/* dma channels configuration */
-		audio_cfg.period_len = d->frame_size_bytes * d->channels;
-		audio_cfg.period_count = 2;
+		audio_cfg.period_len = d->period_bytes;
+		audio_cfg.period_count = d->period_count;
 		audio_cfg.direction = DMA_MEM_TO_DEV;
 		audio_cfg.src_addr = d->g_fifo_renderer;
 		audio_cfg.dest_addr = (void *)(EASRC_ADDR + REG_EASRC_WRFIFO(0));
@@ -560,10 +695,11 @@ static inline int xa_hw_renderer_init(struct XARenderer *d)
 		audio_cfg.peripheral_size = sizeof(sdmac_cfg_t);
 
 		d->dmac[0] = request_dma_chan(d->dma, 0);
-		dma_chan_config(d->dmac[0], &audio_cfg);
+		if (!d->dmac[0] || dma_chan_config(d->dmac[0], &audio_cfg))
+			return XA_FATAL_ERROR;
 
-		audio_cfg.period_len = d->frame_size_bytes * d->channels;
-		audio_cfg.period_count = 2;
+		audio_cfg.period_len = d->period_bytes;
+		audio_cfg.period_count = d->period_count;
 		audio_cfg.direction = DMA_DEV_TO_DEV;
 		audio_cfg.src_addr = (void *)(EASRC_ADDR + REG_EASRC_RDFIFO(0));
 		audio_cfg.dest_addr = (void *)(SAI_ADDR + FSL_SAI_TDR0);
@@ -579,7 +715,8 @@ static inline int xa_hw_renderer_init(struct XARenderer *d)
 		audio_cfg.peripheral_size = sizeof(sdmac_cfg_t);
 
 		d->dmac[1] = request_dma_chan(d->dma, 0);
-		dma_chan_config(d->dmac[1], &audio_cfg);
+		if (!d->dmac[1] || dma_chan_config(d->dmac[1], &audio_cfg))
+			return XA_FATAL_ERROR;
 	}
 
 	irqstr_init(d->irqstr_addr, d->fe_dev_Int, d->fe_dma_Int);
@@ -661,6 +798,9 @@ static XA_ERRORCODE xa_renderer_init(XARenderer *d, WORD32 i_idx, pVOID pv_value
         /* ...post-configuration initialization (all parameters are set) */
         XF_CHK_ERR(d->state & XA_RENDERER_FLAG_PREINIT_DONE, XA_API_FATAL_INVALID_CMD_TYPE);
 
+        /* ...underrun mode may have been set before PCM width; recheck final format */
+        XF_CHK_ERR(d->underrun_mode != XA_RENDERER_UNDERRUN_REPEAT || d->pcm_width == 16, XA_RENDERER_CONFIG_NONFATAL_RANGE);
+
         XF_CHK_ERR(xa_fw_renderer_init(d) == 0, XA_RENDERER_CONFIG_FATAL_HW);
 
         /* ...mark post-initialization is complete */
@@ -710,8 +850,8 @@ static inline XA_ERRORCODE xa_hw_renderer_control(XARenderer *d, UWORD32 state)
         {
             UWORD32 payload = d->frame_size_bytes * d->channels;
 
-            /* ...start the FIFO from the pong buffer, hence adjust the read pointer and make it follow write pointer */
-            d->pfifo_r = d->pfifo_w;
+            /* ...read pointer tracks DMA period position; make write pointer follow it */
+            d->pfifo_w = d->pfifo_r;
 
             /* ...write one frame worth data written to FIFO to output file */
             //READ_FIFO(payload);
@@ -792,6 +932,15 @@ static XA_ERRORCODE xa_renderer_set_config_param(XARenderer *d, WORD32 i_idx, pV
 {
     UWORD32     i_value;
 
+#ifndef XA_DISABLE_EVENT
+    if (d && i_idx == XAF_COMP_CONFIG_PARAM_EVENT_CB)
+    {
+        /* ...set (or reset with NULL) event raising callback */
+        d->event_cb = (xa_raise_event_cb_t *)pv_value;
+        return XA_NO_ERROR;
+    }
+#endif
+
     /* ...sanity check - pointers must be sane */
     XF_CHK_ERR(d && pv_value, XA_API_FATAL_INVALID_CMD_TYPE);
     /* ...pre-initialization must be completed */
@@ -891,6 +1040,34 @@ static XA_ERRORCODE xa_renderer_set_config_param(XARenderer *d, WORD32 i_idx, pV
             
             return XA_NO_ERROR;
         }
+
+    case XA_RENDERER_CONFIG_PARAM_PERIOD_SIZE:
+        /* ...command is valid only in configuration state */
+        XF_CHK_ERR((d->state & XA_RENDERER_FLAG_POSTINIT_DONE) == 0, XA_RENDERER_CONFIG_FATAL_STATE);
+        /* ...get requested DMA period (samples per channel); 0 follows framesize */
+        i_value = (UWORD32) *(WORD32 *)pv_value;
+        XF_CHK_ERR(i_value * d->sample_size <= DMA_MAX_PERIOD_LEN, XA_RENDERER_CONFIG_NONFATAL_RANGE);
+        /* ...apply setting */
+        d->period_size = i_value;
+        return XA_NO_ERROR;
+
+    case XA_RENDERER_CONFIG_PARAM_LATENCY:
+        /* ...command is valid only in configuration state */
+        XF_CHK_ERR((d->state & XA_RENDERER_FLAG_POSTINIT_DONE) == 0, XA_RENDERER_CONFIG_FATAL_STATE);
+        /* ...get requested ring latency in microseconds; 0 selects double buffering */
+        d->latency_us = (UWORD32) *(WORD32 *)pv_value;
+        return XA_NO_ERROR;
+
+    case XA_RENDERER_CONFIG_PARAM_UNDERRUN_MODE:
+        /* ...get requested underrun handling; may be changed at run-time */
+        i_value = (UWORD32) *(WORD32 *)pv_value;
+        XF_CHK_ERR(i_value <= XA_RENDERER_UNDERRUN_REPEAT, XA_RENDERER_CONFIG_NONFATAL_RANGE);
+        /* ...fade-out of repeated period is implemented for 16-bit PCM only */
+        XF_CHK_ERR(i_value != XA_RENDERER_UNDERRUN_REPEAT || d->pcm_width == 16, XA_RENDERER_CONFIG_NONFATAL_RANGE);
+        /* ...apply setting */
+        d->underrun_mode = i_value;
+        return XA_NO_ERROR;
+
     default:
         /* ...unrecognized parameter */
         return XF_CHK_ERR(0, XA_API_FATAL_INVALID_CMD_TYPE);
@@ -954,6 +1131,43 @@ static XA_ERRORCODE xa_renderer_get_config_param(XARenderer *d, WORD32 i_idx, pV
         *(WORD32 *)pv_value = d->frame_size;
         return XA_NO_ERROR;
 
+    case XA_RENDERER_CONFIG_PARAM_PERIOD_SIZE:
+        /* ...return DMA period (in samples); resolved value after post-init */
+        if (d->state & XA_RENDERER_FLAG_POSTINIT_DONE)
+            *(WORD32 *)pv_value = d->period_bytes / (d->sample_size * d->channels);
+        else
+            *(WORD32 *)pv_value = d->period_size;
+        return XA_NO_ERROR;
+
+    case XA_RENDERER_CONFIG_PARAM_LATENCY:
+        /* ...return ring latency (in microseconds); actual ring length after post-init */
+        if (d->state & XA_RENDERER_FLAG_POSTINIT_DONE)
+            *(WORD32 *)pv_value = (WORD32)((UWORD64)d->ring_bytes / (d->sample_size * d->channels) * 1000000 / d->rate);
+        else
+            *(WORD32 *)pv_value = d->latency_us;
+        return XA_NO_ERROR;
+
+    case XA_RENDERER_CONFIG_PARAM_DMA_RING:
+        /* ...ring exists only after post-init */
+        XF_CHK_ERR(d->state & XA_RENDERER_FLAG_POSTINIT_DONE, XA_RENDERER_CONFIG_FATAL_STATE);
+        *(xa_renderer_dma_ring_t **)pv_value = &d->dma_ring;
+        return XA_NO_ERROR;
+
+    case XA_RENDERER_CONFIG_PARAM_FIFO_LEVEL:
+        /* ...return amount of data DMA has not played yet */
+        *(WORD32 *)pv_value = (d->state & XA_RENDERER_FLAG_POSTINIT_DONE ? d->ring_bytes - d->fifo_avail : 0);
+        return XA_NO_ERROR;
+
+    case XA_RENDERER_CONFIG_PARAM_UNDERRUN_MODE:
+        /* ...return current underrun handling mode */
+        *(WORD32 *)pv_value = d->underrun_mode;
+        return XA_NO_ERROR;
+
+    case XA_RENDERER_CONFIG_PARAM_XRUN_COUNT:
+        /* ...return number of underruns (also event payload) */
+        *(WORD32 *)pv_value = d->xruns;
+        return XA_NO_ERROR;
+
     default:
         /* ...unrecognized parameter */
         return XF_CHK_ERR(0, XA_API_FATAL_INVALID_CMD_TYPE);
@@ -962,6 +1176,15 @@ static XA_ERRORCODE xa_renderer_get_config_param(XARenderer *d, WORD32 i_idx, pV
 
 static XA_ERRORCODE xa_renderer_do_exec(XARenderer *d)
 {
+#ifndef XA_DISABLE_EVENT
+    /* ...report underruns counted by interrupt; events can't be raised from there */
+    if (d->xruns != d->xruns_reported && d->event_cb)
+    {
+        d->xruns_reported = d->xruns;
+        d->event_cb->cb(d->event_cb, XA_RENDERER_CONFIG_PARAM_XRUN_COUNT);
+    }
+#endif
+
     d->consumed = xa_fw_renderer_submit(d, d->input, d->submited_inbytes);
 
     d->cumulative_bytes_produced += d->consumed;
@@ -0,0 +1,79 @@
+/*
+* Copyright (c) 2015-2021 Cadence Design Systems Inc.
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/*******************************************************************************
+ * xa-renderer-conceal.h
+ *
+ * DMA ring underrun concealment
+ *
+ * When only the period DMA is playing is left in the ring, the period that
+ * follows it is filled with silence or with a faded-out copy of the playing
+ * one before DMA gets there. The playing period is only read, never written.
+ ******************************************************************************/
+
+#ifndef __XA_RENDERER_CONCEAL_H__
+#define __XA_RENDERER_CONCEAL_H__
+
+#include <string.h>
+
+#include "audio/xa-renderer-api.h"
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+/* ...conceal period after "playing"; returns ring position following it */
+static inline UWORD8 * xa_renderer_conceal(UWORD8 *ring, UWORD32 ring_bytes, UWORD32 period_bytes,
+                                           UWORD8 *playing, UWORD32 mode, UWORD32 pcm_width, UWORD32 channels)
+{
+    UWORD32     next = (UWORD32)(playing - ring) + period_bytes;
+    UWORD32     frames = period_bytes / (channels * sizeof(WORD16));
+    WORD16     *src = (WORD16 *)playing;
+    WORD16     *dst;
+    WORD32      gain = 0x7fff << 15, step;
+    UWORD32     i, c;
+
+    if (next >= ring_bytes)
+        next = 0;
+
+    dst = (WORD16 *)(ring + next);
+
+    if (mode == XA_RENDERER_UNDERRUN_REPEAT && pcm_width == 16 && frames > 0)
+    {
+        /* ...repeat playing period with linear fade-out (16-bit PCM only); Q30 gain ends near zero */
+        step = gain / frames;
+
+        for (i = 0; i < frames; i++, gain -= step)
+            for (c = 0; c < channels; c++, src++, dst++)
+                *dst = (WORD16)(((WORD32)*src * (gain >> 15)) >> 15);
+    }
+    else
+    {
+        memset(ring + next, 0, period_bytes);
+    }
+
+    next += period_bytes;
+
+    return ring + (next >= ring_bytes ? 0 : next);
+}
+
+#endif /* __XA_RENDERER_CONCEAL_H__ */
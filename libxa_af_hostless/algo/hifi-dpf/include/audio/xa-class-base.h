@@ -39,7 +39,10 @@
 #include "xa_error_standards.h"
 #include "xa_apicmd_standards.h"
 #include "xa_memory_standards.h"
+#if !defined(HAVE_LINUX)
+/* ...Xtensa PI library loader (not available on host build) */
 #include "dpu_lib_load.h"
+#endif
 
 /*******************************************************************************
  * Generic codec structure
@@ -94,6 +97,15 @@ struct XACodecBase
     /* ...scratch memory index of component */    
     int 					scratch_idx;
 
+    /* ...shared scratch memory is held, and priority level it belongs to */
+    UWORD32                 scratch_shared;
+    UWORD32                 scratch_priority;
+
+#if XF_CFG_WORKER_STEAL
+    /* ...private scratch memory (components of same priority may run concurrently) */
+    xf_mm_buffer_t          scratch_buf;
+#endif
+
     /* ...codec control state */
     UWORD32                     state;
 
@@ -290,7 +302,7 @@ do
         return XA_API_FATAL_MEM_ALLOC;                                          \
     }                                                                           \
                                                                                 \
-    if (((UWORD32)((p)->addr) & ((align) - 1)) != 0)                                \
+    if (((uintptr_t)((p)->addr) & ((align) - 1)) != 0)                               \
     {                                                                           \
         TRACE(ERROR, _x("Invalid %d-algnment: %p"), (align), (p)->addr);        \
         return XA_API_FATAL_MEM_ALIGN;                                          \
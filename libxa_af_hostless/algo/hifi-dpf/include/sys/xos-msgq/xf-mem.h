@@ -97,10 +97,10 @@ static inline void * xf_mem_alloc(UWORD32 size, UWORD32 align, UWORD32 core, UWO
     if (ptr == NULL) return ptr;
 
     /* ...align the buffer pointer */
-    aligned_ptr = (void *) (((UWORD32)ptr + align-1) & ~(align-1)); 
+    aligned_ptr = (void *) (((uintptr_t)ptr + align-1) & ~(uintptr_t)(align-1)); 
 
     /* ...store original buffer pointer and allocated size */
-    mem_info = (xf_mem_info_t *) ((UWORD32)aligned_ptr+size);
+    mem_info = (xf_mem_info_t *) ((uintptr_t)aligned_ptr+size);
     mem_info->buf_ptr = ptr;
     mem_info->alloc_size = aligned_size;
 
@@ -120,7 +120,7 @@ static inline void xf_mem_free(void *p, UWORD32 size, UWORD32 core, UWORD32 shar
 #endif
 
     /* ...fetch alignment metadata and free */
-    xf_mem_info_t *mem_info = (xf_mem_info_t *) ((UWORD32)p + size);
+    xf_mem_info_t *mem_info = (xf_mem_info_t *) ((uintptr_t)p + size);
     xf_mm_free(&XF_CORE_DATA(core)->local_pool, mem_info->buf_ptr, mem_info->alloc_size);
 }
 
@@ -165,6 +165,12 @@ static inline void * xf_scratch_mem_init(UWORD32 core, UWORD32 thread_priority)
     return xf_mem_alloc(XF_CORE_DATA(core)->worker_thread_scratch_size[thread_priority], XF_CFG_CODEC_SCRATCHMEM_ALIGN, core, 0);
 }
 
+static inline void xf_scratch_mem_free(void *p, UWORD32 core, UWORD32 thread_priority)
+{
+    /* ...return scratch memory to local DSP memory */
+    xf_mem_free(p, XF_CORE_DATA(core)->worker_thread_scratch_size[thread_priority], core, 0);
+}
+
 /*******************************************************************************
  * Helpers - hmm; they are platform-independent - tbd
  ******************************************************************************/
@@ -45,6 +45,17 @@
 #define barrier()                           \
     __asm__ __volatile__("": : : "memory")
 
+#if defined(HAVE_LINUX)
+/* ...host build is cache-coherent; full barrier only */
+#define XF_PROXY_BARRIER()                  \
+    __sync_synchronize()
+
+#define XF_PROXY_INVALIDATE(buf, length)    \
+    ({ barrier(); buf; })
+
+#define XF_PROXY_FLUSH(buf, length)         \
+    ({ XF_PROXY_BARRIER(); buf; })
+#else
 /* ...memory barrier */
 #define XF_PROXY_BARRIER()                  \
     __asm__ __volatile__("memw": : : "memory")
@@ -56,6 +67,7 @@
 /* ...memory flushing */
 #define XF_PROXY_FLUSH(buf, length)         \
     ({ if ((length)) { barrier(); xthal_dcache_region_writeback((buf), (length)); XF_PROXY_BARRIER(); } buf; })
+#endif
 
 /*******************************************************************************
  * Core-specific data accessor
@@ -51,11 +51,24 @@ typedef struct xf_component
 
     /* ...component destructor function */
     int                   (*exit)(struct xf_component *, xf_message_t *);
+
+    /* ...optional hook lending component-owned buffers to the output port routed into input "port" */
+    int                   (*lend)(struct xf_component *, UWORD32 port, UWORD32 n, UWORD32 length, void **buffers);
     
 #ifndef XA_DISABLE_EVENT
     /* ...component error handler function */
     int                   (*error_handler)(struct xf_component *, XA_ERRORCODE);
 #endif
+
+#if XF_CFG_PROFILE
+    /* ...execution profile */
+    xf_profile_t            profile;
+#endif
+
+#if XF_CFG_LATENCY
+    /* ...age of the data consumed by a sink */
+    xf_latency_msg_t        latency;
+#endif
 }   xf_component_t;
 
 /*******************************************************************************
@@ -72,7 +85,9 @@ static inline UWORD32 xf_component_core(xf_component_t *component)
 #define xf_component_schedule(c, dts)                                       \
 ({                                                                          \
     xf_sched_t *__sched = &XF_CORE_DATA(xf_component_core((c)))->sched;     \
-    xf_sched_put(__sched, &(c)->task, (dts)); \
+    xf_profile_schedule(&(c)->profile, (dts));                              \
+    xf_trace_event(xf_component_core(c), XAF_TRACE_EV_SCHEDULE, 0, (c)->id, (dts)); \
+    xf_sched_put(__sched, &(c)->task, (dts));                               \
     xf_ipi_resume_dsp_isr(xf_component_core(c));                            \
 })
 
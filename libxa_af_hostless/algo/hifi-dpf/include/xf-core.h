@@ -93,14 +93,46 @@ typedef union xf_cmap_link
 
 }   xf_cmap_link_t;
 
+/* ...several worker threads per priority level sharing ready components */
+#ifndef XF_CFG_WORKER_STEAL
+#define XF_CFG_WORKER_STEAL             0
+#endif
+
+/* ...number of worker threads per priority level in work-stealing mode */
+#ifndef XF_CFG_WORKER_STEAL_THREADS
+#define XF_CFG_WORKER_STEAL_THREADS     2
+#endif
+
+#if XF_CFG_WORKER_STEAL
+/* ...worker thread of a priority level */
+struct xf_worker_thread {
+    struct xf_worker *worker;
+    xf_thread_t thread;
+    void *stack;
+    UWORD32 index;
+
+    /* ...ready clients; owner takes from the head, siblings steal from the tail */
+    UWORD32 head;
+    UWORD32 tail;
+    UWORD8 deque[XF_CFG_MAX_CLIENTS];
+};
+#endif
+
 struct xf_worker {
     void *stack;
     void *scratch;
+    /* ...number of components holding the priority level scratch */
+    UWORD32 scratch_users;
     xf_msgq_t queue;
     xf_thread_t thread;
     UWORD32 core;
+#if XF_CFG_WORKER_STEAL
+    /* ...threads sharing the priority level; "queue" is their common doorbell */
+    struct xf_worker_thread steal[XF_CFG_WORKER_STEAL_THREADS];
+#else
     xf_msg_queue_t base_cancel_queue;
     xf_msg_pool_t base_cancel_pool;
+#endif
 };
 
 /* ...per-core local data */
@@ -199,6 +231,10 @@ typedef struct {
 
 extern xf_dsp_t *xf_g_dsp;
 
+/* ...number of components holding core scratch memory; kept outside of
+ * xf_core_data_t, whose size is part of AP-DSP layout (XF_DSP_OBJ_SIZE_CORE_DATA) */
+extern UWORD32 xf_core_scratch_users[XF_CFG_CORES_NUM];
+
 typedef struct xf_worker_msg {
     xf_component_t *component;
     xf_message_t *msg;
@@ -217,7 +253,15 @@ extern int xf_core_deinit(UWORD32 core);
 /* ...global data initialization function */
 extern int  xf_global_init(void);
 
+/* ...translate local client-id into component handle */
+extern xf_component_t * xf_core_component(UWORD32 core, UWORD32 client);
+
 /* ...process core events */
 extern void xf_core_service(UWORD32 core);
 extern void xf_core_process(xf_component_t *component);
-extern void xf_core_process_message(xf_component_t *component, xf_message_t *msg);
+extern int  xf_core_process_message(xf_component_t *component, xf_message_t *msg);
+
+#if XF_CFG_WORKER_STEAL
+/* ...cancel pending data-processing request queued for worker threads */
+extern void xf_core_steal_cancel(xf_component_t *component);
+#endif
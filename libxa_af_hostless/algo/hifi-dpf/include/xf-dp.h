@@ -91,6 +91,12 @@
 /* ...scheduler definition */
 #include "xf-sched.h"
 
+/* ...execution profiling */
+#include "xf-profile.h"
+
+/* ...end-to-end latency measurement */
+#include "xf-latency.h"
+
 /* ...component definition */
 #include "xf-component.h"
 
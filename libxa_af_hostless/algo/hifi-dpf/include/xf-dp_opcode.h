@@ -160,8 +160,17 @@
 /* ... system resume, pair to XF_SUSPEND */
 #define XF_SUSPEND_RESUME               __XF_OPCODE(0, 0, 22)
 
+/* ...memory statistics retrieval */
+#define XF_GET_MEM_STATS                __XF_OPCODE(0, 1, 23)
+
+/* ...component execution profile retrieval */
+#define XF_GET_PROFILE                  __XF_OPCODE(0, 1, 24)
+
+/* ...end-to-end latency statistics retrieval */
+#define XF_GET_LATENCY                  __XF_OPCODE(0, 1, 25)
+
 /* ...total amount of supported decoder commands */
-#define __XF_OP_NUM                     23
+#define __XF_OP_NUM                     26
 
 /*******************************************************************************
  * XF_START message definition
@@ -380,3 +389,67 @@ typedef struct xf_set_priorities_msg
     /* stack size for worker threads */
     UWORD32 stack_size;
 } xf_set_priorities_msg_t;
+
+/*******************************************************************************
+ * XF_GET_LATENCY definition
+ ******************************************************************************/
+
+/* ...latency of data reaching a sink, measured from its arrival at DSP */
+typedef struct xf_latency_msg
+{
+    /* ...number of buffers measured */
+    UWORD32                 count;
+
+    /* ...smallest, largest and last latency, microseconds */
+    UWORD32                 min_us;
+    UWORD32                 max_us;
+    UWORD32                 last_us;
+
+    /* ...sum of all latencies, microseconds */
+    UWORD64                 total_us;
+
+    /* ...log-linear histogram (XAF_LATENCY_HIST_SUB_BITS sub-bins per octave) */
+    UWORD32                 hist[XAF_LATENCY_HIST_BINS];
+
+}   __attribute__((__packed__)) xf_latency_msg_t;
+
+/*******************************************************************************
+ * XF_GET_MEM_STATS definition
+ ******************************************************************************/
+
+/* ...DSP memory usage report */
+typedef struct xf_mem_stats_msg
+{
+    /* ...component (local) and framework (shared) buffer usage, peak and current */
+    UWORD32                 comp_buf_size_peak;
+    UWORD32                 frmwk_buf_size_peak;
+    UWORD32                 comp_buf_size_curr;
+    UWORD32                 frmwk_buf_size_curr;
+
+    /* ...detailed statistics of local and shared pools */
+    xaf_mem_stats_t         pools;
+
+}   __attribute__((__packed__)) xf_mem_stats_msg_t;
+
+/*******************************************************************************
+ * XF_FILL_THIS_BUFFER to DSP proxy (event trace drain)
+ ******************************************************************************/
+
+/* ...event trace records delivered to App Interface Layer */
+typedef struct xf_trace_msg
+{
+    /* ...DSP counter frequency, Hz */
+    UWORD32                 clock_freq;
+
+    /* ...number of records in this buffer */
+    UWORD32                 count;
+
+    /* ...total number of records lost since tracing was armed */
+    UWORD32                 dropped;
+
+    UWORD32                 reserved;
+
+    /* ...trace records */
+    xaf_trace_event_t       event[0];
+
+}   __attribute__((__packed__)) xf_trace_msg_t;
@@ -30,6 +30,25 @@
 #error "xf-io.h mustn't be included directly"
 #endif
 
+/*******************************************************************************
+ * Configuration
+ ******************************************************************************/
+
+/* ...extra internal buffer space beyond port length; unconsumed data is moved
+ * back to the buffer head only when read position runs out of this headroom.
+ * Headroom is paid from DSP local memory for every buffered input port, so it
+ * is disabled by default (data is moved on every partial consume, as before);
+ * (length) removes almost all moves at the cost of doubling the port buffer,
+ * (length)/4 keeps most of the gain for a quarter of that memory */
+#ifndef XF_CFG_INPUT_PORT_HEADROOM
+#define XF_CFG_INPUT_PORT_HEADROOM(length)      0
+#endif
+
+/* ...maximal number of buffers a destination component may lend to an output port */
+#ifndef XF_CFG_PORT_LEND_MAX
+#define XF_CFG_PORT_LEND_MAX                    8
+#endif
+
 /*******************************************************************************
  * Types definitions
  ******************************************************************************/
@@ -58,6 +77,18 @@ typedef struct xf_input_port
     /* ...execution flags */
     UWORD32                     flags;
 
+    /* ...read position of buffered data */
+    UWORD32                     offset;
+
+    /* ...allocated size of internal buffer (length + headroom) */
+    UWORD32                     size;
+
+    /* ...required alignment of data passed to the plugin */
+    UWORD32                     align;
+
+    /* ...timestamp of the data at read position */
+    UWORD32                     ts;
+
 }   xf_input_port_t;
 
 /*******************************************************************************
@@ -79,11 +110,14 @@ typedef struct xf_input_port
 /* ...stream purging sequence */
 #define XF_INPUT_FLAG_PURGING           (1 << 4)
 
+/* ...data is accessed in-place in the input message (no copy) */
+#define XF_INPUT_FLAG_DIRECT            (1 << 5)
+
 /* ...base input port flags mask */
-#define __XF_INPUT_FLAGS(flags)         ((flags) & ((1 << 5) - 1))
+#define __XF_INPUT_FLAGS(flags)         ((flags) & ((1 << 6) - 1))
 
 /* ...custom input port flag */
-#define __XF_INPUT_FLAG(f)              ((f) << 5)
+#define __XF_INPUT_FLAG(f)              ((f) << 6)
 
 /*******************************************************************************
  * Helpers
@@ -131,6 +165,21 @@ static inline UWORD32 xf_input_port_level(xf_input_port_t *port)
     return port->filled;
 }
 
+/* ...get timestamp of the data to be processed (valid until next consume) */
+static inline UWORD32 xf_input_port_ts(xf_input_port_t *port)
+{
+    return port->ts;
+}
+
+/* ...get pointer to the data to be processed (valid until next consume) */
+static inline void * xf_input_port_buffer(xf_input_port_t *port)
+{
+    if (xf_input_port_bypass(port) || (port->flags & XF_INPUT_FLAG_DIRECT))
+        return port->access;
+    else
+        return (UWORD8 *)port->buffer + port->offset;
+}
+
 /*******************************************************************************
  * Output port data
  ******************************************************************************/
@@ -152,6 +201,9 @@ typedef struct xf_output_port
     /* ...output port flags */
     UWORD32                     flags;
 
+    /* ...timestamp attached to the next produced buffer */
+    UWORD32                     ts;
+
 }   xf_output_port_t;
 
 /*******************************************************************************
@@ -179,11 +231,14 @@ typedef struct xf_output_port
 /* ...port is being unrouted */
 #define XF_OUTPUT_FLAG_UNROUTING        (1 << 6)
 
+/* ...port buffers are lent by destination component (not allocated by port) */
+#define XF_OUTPUT_FLAG_LENT             (1 << 7)
+
 /* ...base output port flags accessor */
-#define __XF_OUTPUT_FLAGS(flags)        ((flags) & ((1 << 7) - 1))
+#define __XF_OUTPUT_FLAGS(flags)        ((flags) & ((1 << 8) - 1))
 
 /* ...custom output port flag */
-#define __XF_OUTPUT_FLAG(f)             ((f) << 7)
+#define __XF_OUTPUT_FLAG(f)             ((f) << 8)
 
 /*******************************************************************************
  * Helpers
@@ -225,6 +280,12 @@ static inline xf_message_t * xf_output_port_control_msg(xf_output_port_t *port)
     return xf_msg_pool_item(&port->pool, 0);
 }
 
+/* ...set timestamp of the data being produced (taken from the input it originates from) */
+static inline void xf_output_port_stamp(xf_output_port_t *port, UWORD32 ts)
+{
+    port->ts = ts;
+}
+
 /* ...check if port flushing is ongoing */
 static inline int xf_output_port_flushing(xf_output_port_t *port)
 {
@@ -247,6 +308,9 @@ extern int  xf_input_port_fill(xf_input_port_t *port);
 /* ...consume bytes from input buffer */
 extern void xf_input_port_consume(xf_input_port_t *port, UWORD32 n);
 
+/* ...consume bytes from input buffer; fully consumed messages are moved to "hold" queue */
+extern void xf_input_port_consume_hold(xf_input_port_t *port, UWORD32 n, xf_msg_queue_t *hold);
+
 /* ...purge input port queue */
 extern void xf_input_port_purge(xf_input_port_t *port);
 
@@ -0,0 +1,109 @@
+/*
+* Copyright (c) 2015-2021 Cadence Design Systems Inc.
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/*******************************************************************************
+ * xf-latency.h
+ *
+ * End-to-end latency measurement through the component graph
+ *
+ * Data buffers are stamped with a counter value when they enter the graph
+ * (host buffer arrival at DSP, or capture completion); the stamp follows the
+ * data through input and output ports and sink components account its age.
+ *******************************************************************************/
+
+#ifndef __XF_H
+#error "xf-latency.h mustn't be included directly"
+#endif
+
+/*******************************************************************************
+ * Local configuration
+ ******************************************************************************/
+
+/* ...buffer timestamping and sink latency histograms */
+#ifndef XF_CFG_LATENCY
+#define XF_CFG_LATENCY                  1
+#endif
+
+#if XF_CFG_LATENCY
+
+/* ...free-running counter */
+#include "osal-timer.h"
+
+/*******************************************************************************
+ * Helpers
+ ******************************************************************************/
+
+/* ...current counter value as a buffer stamp (never zero - zero is "not stamped") */
+static inline UWORD32 xf_latency_stamp(void)
+{
+    return (UWORD32)__xf_get_cycles() | 1;
+}
+
+/* ...select the older of two stamps (zero is ignored) */
+static inline UWORD32 xf_latency_oldest(UWORD32 a, UWORD32 b)
+{
+    if (!a || !b)
+        return a | b;
+
+    return ((WORD32)(a - b) < 0 ? a : b);
+}
+
+/* ...log-linear histogram bin of a latency */
+static inline UWORD32 xf_latency_bin(UWORD32 us)
+{
+    UWORD32     e, bin;
+
+    /* ...lowest octaves are exact */
+    if (us < (1 << XAF_LATENCY_HIST_SUB_BITS))
+        return us;
+
+    e = 31 - __builtin_clz(us);
+    bin = ((e - XAF_LATENCY_HIST_SUB_BITS + 1) << XAF_LATENCY_HIST_SUB_BITS) + (us >> (e - XAF_LATENCY_HIST_SUB_BITS)) - (1 << XAF_LATENCY_HIST_SUB_BITS);
+
+    return (bin < XAF_LATENCY_HIST_BINS ? bin : XAF_LATENCY_HIST_BINS - 1);
+}
+
+/* ...account age of the data stamped with "ts" */
+static inline void xf_latency_record(xf_latency_msg_t *stats, UWORD32 ts)
+{
+    UWORD32     us;
+
+    /* ...data entered the graph unstamped */
+    if (!ts)
+        return;
+
+    us = (UWORD32)((UWORD64)(xf_latency_stamp() - ts) * 1000000 / __xf_get_cycles_freq());
+
+    (stats->count++ == 0 || us < stats->min_us ? stats->min_us = us : 0);
+    (us > stats->max_us ? stats->max_us = us : 0);
+    stats->last_us = us;
+    stats->total_us += us;
+    stats->hist[xf_latency_bin(us)]++;
+}
+
+#else
+
+#define xf_latency_stamp()                  0
+#define xf_latency_oldest(a, b)             0
+#define xf_latency_record(stats, ts)        ((void)0)
+
+#endif  /* XF_CFG_LATENCY */
@@ -84,10 +84,40 @@ typedef union                                       \
 #define XF_IS_ALIGNED(p)                            \
     (((UWORD32)(p) & (XF_PROXY_ALIGNMENT - 1)) == 0)
 
+/*******************************************************************************
+ * Slab caches configuration
+ ******************************************************************************/
+
+/* ...size classes served from slab caches (multiples of allocation unit) */
+#ifndef XF_CFG_MM_SLAB_CLASSES
+#define XF_CFG_MM_SLAB_CLASSES          \
+    64, 128, 256, 384, 512, 768, 1024, 1536, 2048, 3072, 4096, 6144, 8192, 12288, 16384
+#endif
+
+/* ...number of bytes carved from the pool when slab cache is refilled */
+#ifndef XF_CFG_MM_SLAB_BYTES
+#define XF_CFG_MM_SLAB_BYTES            4096
+#endif
+
+/* ...number of size classes */
+#define XF_MM_SLAB_NUM                  \
+    (sizeof((UWORD32[]){ XF_CFG_MM_SLAB_CLASSES }) / sizeof(UWORD32))
+
 /*******************************************************************************
  * Memory pool description
  ******************************************************************************/
 
+/* ...slab cache of free objects of the same size class */
+typedef struct xf_mm_slab
+{
+    /* ...singly-linked list of cached objects */
+    void           *head;
+
+    /* ...number of cached objects */
+    UWORD32             cached;
+
+}   xf_mm_slab_t;
+
 /* ...memory allocator data */
 typedef struct xf_mm_pool
 {
@@ -106,6 +136,51 @@ typedef struct xf_mm_pool
     
 }   xf_mm_pool_t;
 
+/* ...slab caches and utilization counters of the pool; they are kept at the
+ * start of the pool memory, since xf_mm_pool_t is part of the AP-DSP shared
+ * layout (XF_DSP_OBJ_SIZE_CORE_DATA, XF_DSP_OBJ_SIZE_DSP_LOCAL_POOL) */
+typedef struct xf_mm_slab_data
+{
+    /* ...per-size-class caches of free objects */
+    xf_mm_slab_t        slab[XF_MM_SLAB_NUM];
+
+    /* ...bytes allocated by users (current and high-water mark) */
+    UWORD32             used;
+    UWORD32             peak;
+
+    /* ...slab cache hits and refills from the rb-tree maps */
+    UWORD32             slab_hits;
+    UWORD32             slab_refills;
+
+}   xf_mm_slab_data_t;
+
+/* ...pool memory reserved for slab data */
+#define XF_MM_SLAB_DATA_SIZE            XF_ALIGNED(sizeof(xf_mm_slab_data_t))
+
+/* ...memory pool statistics */
+typedef struct xf_mm_stats
+{
+    /* ...size of the pool available for allocation */
+    UWORD32             size;
+
+    /* ...bytes allocated by users (current and high-water mark) */
+    UWORD32             used;
+    UWORD32             peak;
+
+    /* ...bytes kept in slab caches */
+    UWORD32             cached;
+
+    /* ...free bytes in rb-tree maps, number of free blocks and largest one */
+    UWORD32             free;
+    UWORD32             free_blocks;
+    UWORD32             largest_free;
+
+    /* ...slab cache hits and refills */
+    UWORD32             slab_hits;
+    UWORD32             slab_refills;
+
+}   xf_mm_stats_t;
+
 /* ...descriptor of free memory block */
 typedef struct xf_mm_block
 {
@@ -176,3 +251,9 @@ extern void *   xf_mm_alloc(xf_mm_pool_t *pool, UWORD32 size);
 
 /* ...block deallocation */
 extern void     xf_mm_free(xf_mm_pool_t *pool, void *addr, UWORD32 size);
+
+/* ...return all slab-cached objects to the pool */
+extern void     xf_mm_reap(xf_mm_pool_t *pool);
+
+/* ...retrieve pool statistics */
+extern void     xf_mm_get_stats(xf_mm_pool_t *pool, xf_mm_stats_t *stats);
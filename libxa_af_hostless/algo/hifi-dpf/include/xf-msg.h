@@ -59,6 +59,9 @@ struct xf_message
 
     /* ...message buffer (translated virtual address) */
     void               *buffer;
+
+    /* ...data timestamp for latency measurement (0 - not stamped) */
+    UWORD32                 ts;
 };
 
 /* ...cache-line aligned message buffer */
@@ -38,7 +38,7 @@
 #define XF_ALIGNED_PROBE_SIZE(len)         (((len) + 2*sizeof(UWORD32) + 7) & ~7)
 
 /* ... align pointer to 8 bytes */
-#define XF_ALIGN_PROBE_8BYTES(ptr)         (((UWORD32)(ptr) + 7) & ~7)
+#define XF_ALIGN_PROBE_8BYTES(ptr)         (((uintptr_t)(ptr) + 7) & ~(uintptr_t)7)
 
 /*******************************************************************************
  * Port flag helper functions
@@ -0,0 +1,102 @@
+/*
+* Copyright (c) 2015-2021 Cadence Design Systems Inc.
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/*******************************************************************************
+ * xf-profile.h
+ *
+ * Per-component execution profiling
+ *******************************************************************************/
+
+#ifndef __XF_H
+#error "xf-profile.h mustn't be included directly"
+#endif
+
+/*******************************************************************************
+ * Local configuration
+ ******************************************************************************/
+
+/* ...framework-level component profiling (cost is a few counter reads per frame) */
+#ifndef XF_CFG_PROFILE
+#define XF_CFG_PROFILE                  1
+#endif
+
+/*******************************************************************************
+ * Types definitions
+ ******************************************************************************/
+
+#if XF_CFG_PROFILE
+
+/* ...free-running counter */
+#include "osal-timer.h"
+
+/* ...component profiling data */
+typedef struct xf_profile
+{
+    /* ...accumulated statistics as reported to App Interface Layer */
+    xaf_comp_profile_t      stats;
+
+    /* ...counter value at the time component was scheduled */
+    UWORD32                 sched_cycles;
+
+    /* ...scheduling period in timebase units (0 - data-driven execution) */
+    UWORD32                 sched_dts;
+
+}   xf_profile_t;
+
+/*******************************************************************************
+ * Helpers
+ ******************************************************************************/
+
+/* ...current counter value */
+static inline UWORD32 xf_profile_cycles(void)
+{
+    return (UWORD32)__xf_get_cycles();
+}
+
+/* ...log2 histogram bin of the duration */
+static inline UWORD32 xf_profile_bin(UWORD32 cycles)
+{
+    WORD32  bin = 31 - __builtin_clz(cycles | 1) - XAF_PROFILE_HIST_SHIFT;
+
+    return (bin < 0 ? 0 : (bin >= XAF_PROFILE_HIST_BINS ? XAF_PROFILE_HIST_BINS - 1 : bin));
+}
+
+/* ...account duration of a processing stage */
+static inline void xf_profile_stage(UWORD64 *total, UWORD32 *max, UWORD32 *hist, UWORD32 cycles)
+{
+    *total += cycles;
+    (cycles > *max ? *max = cycles : 0);
+    hist[xf_profile_bin(cycles)]++;
+}
+
+/* ...mark the moment component is put to the scheduler */
+static inline void xf_profile_schedule(xf_profile_t *profile, UWORD32 dts)
+{
+    profile->sched_cycles = xf_profile_cycles();
+    profile->sched_dts = dts;
+}
+
+#else
+
+#define xf_profile_schedule(profile, dts)   ((void)0)
+
+#endif  /* XF_CFG_PROFILE */
@@ -29,18 +29,65 @@
 #ifndef __XF_SCHED_H
 #define __XF_SCHED_H
 
+/*******************************************************************************
+ * Configuration
+ ******************************************************************************/
+
+/* ...use bucketed timing wheel instead of rb-tree */
+#ifndef XF_CFG_SCHED_WHEEL
+#define XF_CFG_SCHED_WHEEL              0
+#endif
+
+#if XF_CFG_SCHED_WHEEL
+/* ...number of wheel buckets (power of two, at least 32) */
+#ifndef XF_CFG_SCHED_WHEEL_SIZE
+#define XF_CFG_SCHED_WHEEL_SIZE         64
+#endif
+
+/* ...bucket covers 2^shift timebase ticks (~400us); wheel spans ~25ms */
+#ifndef XF_CFG_SCHED_WHEEL_SHIFT
+#define XF_CFG_SCHED_WHEEL_SHIFT        22
+#endif
+
+#if (XF_CFG_SCHED_WHEEL_SIZE & (XF_CFG_SCHED_WHEEL_SIZE - 1)) || (XF_CFG_SCHED_WHEEL_SIZE < 32)
+#error "XF_CFG_SCHED_WHEEL_SIZE must be a power of two not less than 32"
+#endif
+#endif
+
 /*******************************************************************************
  * Types definitions
  ******************************************************************************/
 
+/* ...scheduling item */
+typedef rb_node_t   xf_task_t;
+
+#if XF_CFG_SCHED_WHEEL
+/* ...list of tasks ordered by timestamp; task "parent" field points to list */
+typedef struct xf_sched_list {
+    xf_task_t      *head;
+    xf_task_t      *tail;
+} xf_sched_list_t;
+
+/* ...wheel buckets, allocated from core local pool */
+typedef struct xf_sched_wheel {
+    UWORD32         map[XF_CFG_SCHED_WHEEL_SIZE / 32];
+    xf_sched_list_t bucket[XF_CFG_SCHED_WHEEL_SIZE];
+} xf_sched_wheel_t;
+
+/* ...scheduler data; footprint matches rb-tree variant (XF_DSP_OBJ_SIZE_CORE_DATA) */
+typedef struct xf_sched {
+    xf_flx_lock_t       lock;
+    UWORD32             timestamp;
+    xf_sched_wheel_t   *wheel;
+    xf_sched_list_t     overflow;
+} xf_sched_t;
+#else
 /* ...scheduler data */
 typedef struct xf_sched {
     xf_flx_lock_t   lock;
     rb_tree_t       tree;
 } xf_sched_t;
-
-/* ...scheduling item */
-typedef rb_node_t   xf_task_t;
+#endif
    
 /*******************************************************************************
  * Helpers
@@ -81,12 +128,12 @@ extern xf_task_t * xf_sched_get(xf_sched_t *sched);
 extern UWORD32 xf_sched_cancel(xf_sched_t *sched, xf_task_t *t);
 
 /* ...initialize scheduler */
-extern void xf_sched_init(xf_sched_t *sched);
+extern int xf_sched_init(xf_sched_t *sched, UWORD32 core);
 
 /* ...reinitialize scheduler lock*/
 extern void xf_sched_preempt_reinit(xf_sched_t *sched);
 
 /* ...deinitialize scheduler */
-extern void xf_sched_deinit(xf_sched_t *sched);
+extern void xf_sched_deinit(xf_sched_t *sched, UWORD32 core);
 
 #endif  /* __XF_SCHED_H */
@@ -62,20 +62,80 @@ typedef UWORD32     xf_trace_data_t[0];
 
 #endif  /* XF_TRACE */
 
+/*******************************************************************************
+ * Binary event trace
+ ******************************************************************************/
+
+/* ...event tracing support (armed at run-time by App Interface Layer) */
+#ifndef XF_CFG_TRACE_EVENTS
+#define XF_CFG_TRACE_EVENTS             1
+#endif
+
+/* ...number of records in per-core ring */
+#ifndef XF_CFG_TRACE_EVENTS_NUM
+#define XF_CFG_TRACE_EVENTS_NUM         1024
+#endif
+
+#if XF_CFG_TRACE_EVENTS
+
+/* ...sequence number of a record is 16-bit; ring shall not wrap it */
+#if (XF_CFG_TRACE_EVENTS_NUM & (XF_CFG_TRACE_EVENTS_NUM - 1)) || (XF_CFG_TRACE_EVENTS_NUM > 32768)
+#error "XF_CFG_TRACE_EVENTS_NUM must be a power of two not exceeding 32768"
+#endif
+
+/* ...per-core ring of trace records */
+typedef struct xf_trace_ring
+{
+    /* ...records storage (allocated when tracing is armed for the first time) */
+    xaf_trace_event_t      *event;
+
+    /* ...producers record events only when tracing is armed */
+    volatile UWORD32        armed;
+
+    /* ...number of records claimed by producers */
+    volatile UWORD32        head;
+
+    /* ...number of records passed to App Interface Layer (or dropped) */
+    UWORD32                 tail;
+
+    /* ...number of records overwritten before they were drained */
+    UWORD32                 dropped;
+
+}   xf_trace_ring_t;
+
+/* ...per-core trace rings */
+extern xf_trace_ring_t      xf_trace_ring[XF_CFG_CORES_NUM];
+
+/* ...put record into the ring (lock-free; any context) */
+extern void __xf_trace_event(UWORD32 core, UWORD32 type, UWORD32 opcode, UWORD32 id, UWORD32 arg);
+
+/* ...record event if tracing is armed */
+static inline void xf_trace_event(UWORD32 core, UWORD32 type, UWORD32 opcode, UWORD32 id, UWORD32 arg)
+{
+    if (xf_trace_ring[core].armed)
+    {
+        __xf_trace_event(core, type, opcode, id, arg);
+    }
+}
+
 /*******************************************************************************
  * Internal API functions
  ******************************************************************************/
 
-#if XF_TRACE_REMOTE
 /* ...submit buffer for tracing */
 extern void xf_trace_submit(UWORD32 core, xf_message_t *m);
 
 /* ...flush current buffer */
 extern void xf_trace_flush(UWORD32 core, xf_message_t *m);
 
+/* ...release trace ring */
+extern void xf_trace_ring_deinit(UWORD32 core);
+
 #else
 
+#define xf_trace_event(core, type, opcode, id, arg)     (void)0
 #define xf_trace_submit(core, m)       (void)0
 #define xf_trace_flush(core, m)        (void)0
+#define xf_trace_ring_deinit(core)     (void)0
 
-#endif  /* XF_TRACE_REMOTE */
+#endif  /* XF_CFG_TRACE_EVENTS */
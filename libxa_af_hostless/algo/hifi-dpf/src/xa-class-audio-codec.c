@@ -904,6 +904,9 @@ static XA_ERRORCODE xa_codec_preprocess(XACodecBase *base)
             /* ...port is in non-bypass mode; try to fill internal buffer */
             if (xf_input_port_done(&codec->input) || xf_input_port_fill(&codec->input))
             {
+                /* ...data may be accessed in-place or at advanced buffer position */
+                XA_API(base, XA_API_CMD_SET_MEM_PTR, codec->in_idx, xf_input_port_buffer(&codec->input));
+
                 /* ...retrieve number of bytes in input buffer (not really - tbd) */
                 filled = xf_input_port_level(&codec->input);
             }
@@ -962,7 +965,7 @@ static XA_ERRORCODE xa_codec_postprocess(XACodecBase *base, int done)
         if (XF_CHK_PORT_MASK(codec->probe_enabled, 0))
         {
             /* ...copy input port data onto probe port */
-            probe_outptr = xf_copy_probe_data(probe_outptr, 0, consumed, codec->input.buffer);
+            probe_outptr = xf_copy_probe_data(probe_outptr, 0, consumed, xf_input_port_buffer(&codec->input));
 
             /* ...compute probe data length locally */
             probe_length += consumed;
@@ -985,6 +988,9 @@ static XA_ERRORCODE xa_codec_postprocess(XACodecBase *base, int done)
         {
             codec->consumed += consumed / codec->sample_size;
         }
+        /* ...output originates from the data at input read position */
+        xf_output_port_stamp(&codec->output, xf_input_port_ts(&codec->input));
+
         /* ...consume specified number of bytes from input port */
         xf_input_port_consume(&codec->input, consumed);
 
@@ -57,31 +57,86 @@ struct xf_channel_info
 /*******************************************************************************
  * Internal functions definitions
  ******************************************************************************/
+/* ...shared scratch memory of priority level and number of its users */
+static inline void ** xf_scratch_mem_slot(UWORD32 core, UWORD32 priority, UWORD32 **users)
+{
+    if ( (priority == 0) || (XF_CORE_DATA(core)->n_workers == 0) )
+    {
+        *users = &xf_core_scratch_users[core];
+        return &XF_CORE_DATA(core)->scratch;
+    }
+    else
+    {
+        struct xf_worker *worker = XF_CORE_DATA(core)->worker + priority;
+
+        *users = &worker->scratch_users;
+        return &worker->scratch;
+    }
+}
+
+/* ...drop shared scratch memory; it is freed with the last component holding it */
+static void xf_scratch_mem_release( XACodecBase *base, UWORD32 core )
+{
+    void      **scratch;
+    UWORD32    *users;
+
+    if ( !base->scratch_shared )
+        return;
+
+    scratch = xf_scratch_mem_slot(core, base->scratch_priority, &users);
+
+    if ( --(*users) == 0 )
+    {
+        xf_scratch_mem_free(*scratch, core, base->scratch_priority);
+        *scratch = NULL;
+
+        TRACE(INIT, _b("scratch memory of priority %u released"), base->scratch_priority);
+    }
+
+    base->scratch_shared = 0;
+    base->scratch = NULL;
+}
+
 /* ...scratch memory allocation if needed */
 static XA_ERRORCODE xf_scratch_mem_alloc( XACodecBase *base, UWORD32 core )
 {
-    if ( (base->component.priority == 0) || (XF_CORE_DATA(core)->n_workers == 0) )
+    void      **scratch;
+    UWORD32    *users;
+
+#if XF_CFG_WORKER_STEAL
+    if ( XF_CORE_DATA(core)->n_workers )
     {
-        if ( XF_CORE_DATA(core)->scratch == NULL )
-        {
-          XF_CHK_ERR( XF_CORE_DATA(core)->scratch = xf_scratch_mem_init(core, base->component.priority), XAF_MEMORY_ERR);  
-        }
-        base->scratch = XF_CORE_DATA(core)->scratch;
-       
+        /* ...worker threads of one priority run concurrently; scratch cannot be shared */
+        xf_mm_free_buffer(&base->scratch_buf, core);
+        base->scratch_buf.addr = NULL;
+
+        XF_CHK_API(xf_mm_alloc_buffer(XF_CORE_DATA(core)->worker_thread_scratch_size[base->component.priority], XF_CFG_CODEC_SCRATCHMEM_ALIGN, core, &base->scratch_buf));
+        base->scratch = base->scratch_buf.addr;
+
+        return XA_NO_ERROR;
     }
-    else
-    {   
-        struct xf_worker *worker = XF_CORE_DATA(core)->worker + base->component.priority;
+#endif
 
-        if ( worker->scratch == NULL )
-        {
-            XF_CHK_ERR( worker->scratch = xf_scratch_mem_init(core, base->component.priority), XAF_MEMORY_ERR);
-            
-        }   
-        base->scratch = worker->scratch;
+    /* ...components of one priority level never run concurrently and time-share its scratch */
+    if ( base->scratch_shared && base->scratch_priority == base->component.priority )
+        return XA_NO_ERROR;
+
+    /* ...priority has changed; leave scratch of former level */
+    xf_scratch_mem_release(base, core);
+
+    scratch = xf_scratch_mem_slot(core, base->component.priority, &users);
+
+    if ( *scratch == NULL )
+    {
+        XF_CHK_ERR( *scratch = xf_scratch_mem_init(core, base->component.priority), XAF_MEMORY_ERR);
     }
+
+    (*users)++;
+    base->scratch = *scratch;
+    base->scratch_shared = 1;
+    base->scratch_priority = base->component.priority;
+
     return XA_NO_ERROR;
-    
 }
 
 /* ...codec pre-initialization */
@@ -466,12 +521,24 @@ static XA_ERRORCODE xa_base_process(XACodecBase *base)
 {
     XA_ERRORCODE    error;
     WORD32          done=0;
+#if XF_CFG_PROFILE
+    xaf_comp_profile_t *stats = &base->component.profile.stats;
+    UWORD32         t0 = xf_profile_cycles(), t1;
+#endif
 
     /* ...clear internal scheduling flag */
     base->state &= ~XA_BASE_FLAG_SCHEDULE;
         
     /* ...codec-specific preprocessing (buffer maintenance) */
-    if ((error = CODEC_API(base, preprocess)) != XA_NO_ERROR)
+    error = CODEC_API(base, preprocess);
+
+#if XF_CFG_PROFILE
+    t1 = xf_profile_cycles();
+    xf_profile_stage(&stats->preprocess_cycles, &stats->preprocess_max, stats->preprocess_hist, t1 - t0);
+    t0 = t1;
+#endif
+
+    if (error != XA_NO_ERROR)
     {
         /* ...return non-fatal codec error */
         return error;
@@ -507,8 +574,66 @@ static XA_ERRORCODE xa_base_process(XACodecBase *base)
         (done ? base->state ^= XA_BASE_FLAG_EXECUTION | XA_BASE_FLAG_COMPLETED : 0);
     }
 
+#if XF_CFG_PROFILE
+    t1 = xf_profile_cycles();
+    xf_profile_stage(&stats->execute_cycles, &stats->execute_max, stats->execute_hist, t1 - t0);
+    t0 = t1;
+#endif
+
     /* ...codec-specific buffer post-processing */
-    return CODEC_API(base, postprocess, done);
+    error = CODEC_API(base, postprocess, done);
+
+#if XF_CFG_PROFILE
+    xf_profile_stage(&stats->postprocess_cycles, &stats->postprocess_max, stats->postprocess_hist, xf_profile_cycles() - t0);
+#endif
+
+    return error;
+}
+
+/* ...execution profile retrieval */
+static XA_ERRORCODE xa_base_get_profile(XACodecBase *base, xf_message_t *m)
+{
+#if XF_CFG_PROFILE
+    xaf_comp_profile_t *stats = &base->component.profile.stats;
+
+    /* ...check the message length is sane */
+    XF_CHK_ERR(m->length >= sizeof(*stats), XA_API_FATAL_INVALID_CMD_TYPE);
+
+    /* ...describe the counter */
+    stats->clock_freq = (UWORD32)__xf_get_cycles_freq();
+    stats->hist_shift = XAF_PROFILE_HIST_SHIFT;
+
+    memcpy(m->buffer, stats, sizeof(*stats));
+
+    /* ...complete message with profile data */
+    xf_response_data(m, sizeof(*stats));
+
+    return XA_NO_ERROR;
+#else
+    /* ...profiling is disabled in this build */
+    return XA_API_FATAL_INVALID_CMD;
+#endif
+}
+
+/* ...latency statistics retrieval */
+static XA_ERRORCODE xa_base_get_latency(XACodecBase *base, xf_message_t *m)
+{
+#if XF_CFG_LATENCY
+    xf_latency_msg_t   *stats = &base->component.latency;
+
+    /* ...check the message length is sane */
+    XF_CHK_ERR(m->length >= sizeof(*stats), XA_API_FATAL_INVALID_CMD_TYPE);
+
+    memcpy(m->buffer, stats, sizeof(*stats));
+
+    /* ...complete message with latency data */
+    xf_response_data(m, sizeof(*stats));
+
+    return XA_NO_ERROR;
+#else
+    /* ...latency measurement is disabled in this build */
+    return XA_API_FATAL_INVALID_CMD;
+#endif
 }
 
 #ifndef XA_DISABLE_EVENT
@@ -549,7 +674,7 @@ static XA_ERRORCODE xa_base_event_handler(XACodecBase *base, UWORD32 event_id, X
             if (error_code)
             {
                *(UWORD32 *)m->buffer = event_id;
-               memcpy((void *)(UWORD32)m->buffer + sizeof(channel_info->event_id_src), &error_code, sizeof(error_code));
+               memcpy((void *)(uintptr_t)m->buffer + sizeof(channel_info->event_id_src), &error_code, sizeof(error_code));
                channel_info->event_buf_count--;
             }
             else
@@ -566,7 +691,7 @@ static XA_ERRORCODE xa_base_event_handler(XACodecBase *base, UWORD32 event_id, X
 
                 if (channel_info->buf_size)
                 {
-                    XA_API(base, XA_API_CMD_GET_CONFIG_PARAM, event_id, (void *)((UWORD32)m->buffer + sizeof(channel_info->event_id_dst)));
+                    XA_API(base, XA_API_CMD_GET_CONFIG_PARAM, event_id, (void *)((uintptr_t)m->buffer + sizeof(channel_info->event_id_dst)));
                 }
             }
 
@@ -831,7 +956,7 @@ static XA_ERRORCODE xa_base_process_event(XACodecBase *base, xf_message_t *m)
     {
         /* ...even if actual buffer size is 0, extra bytes are allocated to carry the event_id, this check identifies that */
         if (m->length > sizeof(event_id)) 
-            XA_API(base, XA_API_CMD_SET_CONFIG_PARAM, event_id, (void *)((UWORD32)m->buffer + sizeof(event_id)));
+            XA_API(base, XA_API_CMD_SET_CONFIG_PARAM, event_id, (void *)((uintptr_t)m->buffer + sizeof(event_id)));
         else
             XA_API(base, XA_API_CMD_SET_CONFIG_PARAM, event_id, NULL);
 
@@ -959,6 +1084,22 @@ static int xa_base_command(xf_component_t *component, xf_message_t *m)
 
     }
 #endif 
+    if ((cmd = XF_OPCODE_TYPE(m->opcode)) == XF_OPCODE_TYPE(XF_GET_PROFILE))
+    {
+        if (xa_base_get_profile(base, m) != XA_NO_ERROR)
+            xf_response_err(m);
+
+        return 0;
+    }
+
+    if ((cmd = XF_OPCODE_TYPE(m->opcode)) == XF_OPCODE_TYPE(XF_GET_LATENCY))
+    {
+        if (xa_base_get_latency(base, m) != XA_NO_ERROR)
+            xf_response_err(m);
+
+        return 0;
+    }
+
     /* ...bail out if this is forced termination command (I do have a map; maybe I'd better have a hook? - tbd) */
     if ((cmd = XF_OPCODE_TYPE(m->opcode)) == XF_OPCODE_TYPE(XF_UNREGISTER))
     {
@@ -1029,6 +1170,13 @@ void xa_base_cancel(XACodecBase *base)
         if(xf_sched_cancel(&cd->sched, &base->component.task))
         {
             /* ...node is not on the schedule-tree, then it must be in workerQ */
+#if XF_CFG_WORKER_STEAL
+            if(cd->worker)
+            {
+                /* ...pending request is counted in the component slot of worker threads */
+                xf_core_steal_cancel(&base->component);
+            }
+#else
             while(cd->worker)
             {
                 xf_message_t *m;
@@ -1048,6 +1196,7 @@ void xa_base_cancel(XACodecBase *base)
 
                 return;
             }
+#endif
         }
 
         TRACE(EXEC, _b("codec[%p] processing cancelled"), base);
@@ -1061,6 +1210,10 @@ void xa_base_destroy(XACodecBase *base, UWORD32 size, UWORD32 core)
     xf_mm_free_buffer(&base->persist, core);
     xf_mm_free_buffer(&base->mem_tabs, core);
     xf_mm_free_buffer(&base->api, core);
+#if XF_CFG_WORKER_STEAL
+    xf_mm_free_buffer(&base->scratch_buf, core);
+#endif
+    xf_scratch_mem_release(base, core);
 
     /* ...destroy codec structure (and task) itself */
     xf_mem_free(base, size, core, 0);
@@ -517,6 +517,9 @@ static XA_ERRORCODE xa_capturer_postprocess(XACodecBase *base, int done)
 
     if (produced)
     {
+        /* ...captured data enters the graph now */
+        xf_output_port_stamp(&capturer->output, xf_latency_stamp());
+
         /* ...immediately complete output buffer (don't wait until it gets filled) */
         xf_output_port_produce(&capturer->output, produced);
     }
@@ -51,6 +51,11 @@ extern const int xf_io_ports[XAF_MAX_COMPTYPE][2];
 /* ...maximum out ports for mimo class */
 #define XA_MIMO_PROC_MAX_OUT_PORTS      XF_CFG_MAX_OUT_PORTS
 
+/* ...port state is kept as one bit per track in 32-bit masks */
+#if XA_MIMO_PROC_MAX_IN_PORTS > 32 || XA_MIMO_PROC_MAX_OUT_PORTS > 32
+#error "mimo class supports up to 32 input and 32 output ports"
+#endif
+
 /*******************************************************************************
  * Data structures
  ******************************************************************************/
@@ -184,6 +189,34 @@ typedef struct XAMimoProc
     /* ...component schedule relaxation */
     UWORD32                 relax_sched;
 
+    /***************************************************************************
+     * Port state bitmasks (bit per track, refreshed as track state changes)
+     **************************************************************************/
+
+    /* ...all input and output tracks */
+    UWORD32                 in_all, out_all;
+
+    /* ...schedule relaxation of input and output tracks */
+    UWORD32                 in_relax, out_relax;
+
+    /* ...input tracks that have received data or are active */
+    UWORD32                 in_live;
+
+    /* ...paused input tracks */
+    UWORD32                 in_paused;
+
+    /* ...input tracks with data queued */
+    UWORD32                 in_ready;
+
+    /* ...output tracks excluded from readiness check (paused or unrouted) */
+    UWORD32                 out_skip;
+
+    /* ...output tracks with buffer available */
+    UWORD32                 out_ready;
+
+    /* ...output tracks that completed flushing */
+    UWORD32                 out_flushed;
+
     /* ...probe enabled flag */
     UWORD32                    probe_enabled;
 
@@ -257,120 +290,87 @@ typedef struct XAMimoProc
 /* ...input track has received data */
 #define XA_IN_TRACK_FLAG_RECVD_DATA        __XF_INPUT_FLAG(1 << 4)
 
+/*******************************************************************************
+ * Port state bitmasks
+ ******************************************************************************/
+
+/* ...refresh state bits of input track after its flags or queue changed */
+static inline void xa_mimo_proc_in_sync(XAMimoProc *mimo_proc, XAInTrack *track)
+{
+    UWORD32     bit = 1 << (track - mimo_proc->in_track);
+
+    mimo_proc->in_live &= ~bit, mimo_proc->in_paused &= ~bit, mimo_proc->in_ready &= ~bit;
+
+    if (xa_in_track_test_flags(track, XA_IN_TRACK_FLAG_RECVD_DATA | XA_IN_TRACK_FLAG_ACTIVE))
+        mimo_proc->in_live |= bit;
+
+    if (xa_in_track_test_flags(track, XA_IN_TRACK_FLAG_PAUSED))
+        mimo_proc->in_paused |= bit;
+
+    if (xf_input_port_ready(&track->input))
+        mimo_proc->in_ready |= bit;
+}
+
+/* ...refresh state bits of output track after its flags or queue changed */
+static inline void xa_mimo_proc_out_sync(XAMimoProc *mimo_proc, XAOutTrack *track)
+{
+    UWORD32     bit = 1 << (track - mimo_proc->out_track);
+
+    mimo_proc->out_skip &= ~bit, mimo_proc->out_ready &= ~bit, mimo_proc->out_flushed &= ~bit;
+
+    if (xa_out_track_test_flags(track, XA_OUT_TRACK_FLAG_PAUSED) || !xa_out_track_test_flags(track, XA_OUT_TRACK_FLAG_ROUTED))
+        mimo_proc->out_skip |= bit;
+
+    if (xf_output_port_ready(&track->output))
+        mimo_proc->out_ready |= bit;
+
+    if (xa_out_track_test_flags(track, XA_OUT_TRACK_FLAG_FLUSHING_DONE))
+        mimo_proc->out_flushed |= bit;
+}
+
+/* ...split schedule relaxation mask into input and output tracks */
+static inline void xa_mimo_proc_relax_sync(XAMimoProc *mimo_proc)
+{
+    mimo_proc->in_relax = mimo_proc->relax_sched & mimo_proc->in_all;
+    mimo_proc->out_relax = (mimo_proc->relax_sched >> mimo_proc->num_in_ports) & mimo_proc->out_all;
+}
+
 /*******************************************************************************
  * Helper functions
  ******************************************************************************/
 /* ...Count the input tracks that have received data or are active*/
 static inline UWORD32 xa_mimo_proc_check_active(XAMimoProc *mimo_proc)
 {
-    XAInTrack      *track;
-    UWORD32        i;
-    UWORD32        cnt = 0;
-    
-    for (track = &mimo_proc->in_track[i = 0]; i < mimo_proc->num_in_ports; i++, track++)
-    {
-        if (xa_in_track_test_flags(track, XA_IN_TRACK_FLAG_RECVD_DATA | XA_IN_TRACK_FLAG_ACTIVE))
-            cnt++;
-    }
-    return cnt;
+    return __builtin_popcount(mimo_proc->in_live);
 }
 
+/* ...count input tracks that do not block processing (relaxed, paused or with data) */
 static inline UWORD32 xa_mimo_proc_input_port_ready(XAMimoProc *mimo_proc)
 {
-    XAInTrack      *track;
-    UWORD32        i;
-    UWORD32        ports_ready = 0;
-    
-    for (track = &mimo_proc->in_track[i = 0]; i < mimo_proc->num_in_ports; i++, track++)
-    {
-        /* ... skip port readiness check based on relax sched or if port is paused */
-        if (XF_CHK_PORT_MASK(mimo_proc->relax_sched, i) || xa_in_track_test_flags(track, XA_IN_TRACK_FLAG_PAUSED))
-        {
-            ports_ready++;
-            continue;
-        }
-
-        /* ...tbd - check only XA_IN_TRACK_FLAG_ACTIVE here? */
-        if (xa_in_track_test_flags(track, XA_IN_TRACK_FLAG_RECVD_DATA | XA_IN_TRACK_FLAG_ACTIVE) && xf_input_port_ready(&track->input))
-            ports_ready++;
-    }
-
-    return ports_ready;
+    return __builtin_popcount((mimo_proc->in_relax | mimo_proc->in_paused | (mimo_proc->in_live & mimo_proc->in_ready)) & mimo_proc->in_all);
 }
 
+/* ...check all routed, running and non-relaxed output tracks have a buffer */
 static inline UWORD32 xa_mimo_proc_output_port_ready(XAMimoProc *mimo_proc)
 {
-    XAOutTrack  *track;
-    UWORD32     i;
-
-    for (track = &mimo_proc->out_track[i = 0]; i < mimo_proc->num_out_ports; i++, track++)
-    {
-        /* ... skip port readiness check based on relax sched */
-        if ( XF_CHK_PORT_MASK(mimo_proc->relax_sched, (mimo_proc->num_in_ports+i)) )
-            continue;
-
-        /* ...skip paused ports */
-        if (xa_out_track_test_flags(track, XA_OUT_TRACK_FLAG_PAUSED))
-            continue;
-#if 1
-        /* ...skip unrouted ports */
-        if (!xa_out_track_test_flags(track, XA_OUT_TRACK_FLAG_ROUTED))
-            continue;
-#endif
-        /* ...TBD check if any output port is active (routed) */
-        if (!xf_output_port_ready(&track->output))
-            return 0;
-    }
-    return 1;
+    return ((mimo_proc->out_all & ~(mimo_proc->out_relax | mimo_proc->out_skip | mimo_proc->out_ready)) == 0);
 }
 
 #ifdef MIMO_AVOID_EXCESS_SCHED
 static inline UWORD32 xa_mimo_proc_input_port_reschedule_ready(XAMimoProc *mimo_proc)
 {
-    XAInTrack      *track;
-    UWORD32        i;
-    UWORD32        ports_ready = 0;
-    
-    for (track = &mimo_proc->in_track[i = 0]; i < mimo_proc->num_in_ports; i++, track++)
-    {
-        if (xf_input_port_ready(&track->input))
-        {
-            ++ports_ready;
-        }
-    }
-
-    return ports_ready;
+    return __builtin_popcount(mimo_proc->in_ready & mimo_proc->in_all);
 }
 
 static inline UWORD32 xa_mimo_proc_output_port_reschedule_ready(XAMimoProc *mimo_proc)
 {
-    XAOutTrack  *track;
-    UWORD32     i;
-    UWORD32     ports_ready = 0;
-
-    for (track = &mimo_proc->out_track[i = 0]; i < mimo_proc->num_out_ports; i++, track++)
-    {
-        if (xf_output_port_ready(&track->output))
-        {
-            ++ports_ready;
-        }
-    }
-    return ports_ready;
+    return __builtin_popcount(mimo_proc->out_ready & mimo_proc->out_all);
 }
 #endif //MIMO_AVOID_EXCESS_SCHED
 
 static inline UWORD32 xa_mimo_proc_output_port_flush_done(XAMimoProc *mimo_proc)
 {
-    XAOutTrack  *track;
-    UWORD32     i;
-    UWORD32        cnt = 0;
-
-    for (track = &mimo_proc->out_track[i = 0]; i < mimo_proc->num_out_ports; i++, track++)
-    {
-        if (xa_out_track_test_flags(track, XA_OUT_TRACK_FLAG_FLUSHING_DONE))
-            cnt++;
-    }
-    return (cnt == mimo_proc->num_out_ports);
+    return ((mimo_proc->out_flushed & mimo_proc->out_all) == mimo_proc->out_all);
 }
 
 /* ...prepare mimo_proc for steady operation */
@@ -527,6 +527,9 @@ static XA_ERRORCODE xa_mimo_proc_empty_this_buffer(XACodecBase *base, xf_message
             xa_base_schedule(base, 0);
         }
     }
+
+    /* ...track flags and queue have changed */
+    xa_mimo_proc_in_sync(mimo_proc, track);
     
     return XA_NO_ERROR;
 }
@@ -587,6 +590,7 @@ static XA_ERRORCODE xa_mimo_proc_fill_this_buffer(XACodecBase *base, xf_message_
 
         /* ... mark flushing sequence is done locally also */
         xa_out_track_set_flags(track, XA_OUT_TRACK_FLAG_FLUSHING_DONE);
+        xa_mimo_proc_out_sync(mimo_proc, track);
         
         TRACE(INFO, _b("out_track-%u flushed"), i);
 
@@ -598,6 +602,7 @@ static XA_ERRORCODE xa_mimo_proc_fill_this_buffer(XACodecBase *base, xf_message_
             {
                 /* ...input stream is over; return zero-length input back to caller */
                 xf_input_port_purge(&in_track->input);
+                xa_mimo_proc_in_sync(mimo_proc, in_track);
             }
 
             /* ...flush probe port */
@@ -625,6 +630,8 @@ static XA_ERRORCODE xa_mimo_proc_fill_this_buffer(XACodecBase *base, xf_message_
             TRACE(INFO, _b("mimo_proc[%p] completed internal unroute of out_track-%u"), mimo_proc, i);
         }
 
+        xa_mimo_proc_out_sync(mimo_proc, track);
+
         return XA_NO_ERROR;
     }
     else if ((base->state & XA_BASE_FLAG_COMPLETED) && !xf_output_port_routed(&track->output))
@@ -663,6 +670,7 @@ static XA_ERRORCODE xa_mimo_proc_fill_this_buffer(XACodecBase *base, xf_message_
             
             /* ...flushing sequence is started; wait until flow-control message returns */
             xa_out_track_set_flags(track, XA_OUT_TRACK_FLAG_FLUSHING);
+            xa_mimo_proc_out_sync(mimo_proc, track);
 
             if (xa_mimo_proc_output_port_ready(mimo_proc) 
                 && (xa_mimo_proc_input_port_ready(mimo_proc) || (base->state & XA_BASE_FLAG_RUNTIME_INIT)) 
@@ -717,6 +725,9 @@ static XA_ERRORCODE xa_mimo_proc_fill_this_buffer(XACodecBase *base, xf_message_
 #endif
         TRACE(OUTPUT, _b("received output buffer track-%u [%p]:%u"), i, m->buffer, m->length);
 
+        /* ...track flags and queue have changed */
+        xa_mimo_proc_out_sync(mimo_proc, track);
+
         /* ...put message into output port */
         /* ...check for readiness of both ports to avoid over-scheduling and allow scheduling at init without input */
         if (xa_mimo_proc_output_port_ready(mimo_proc) 
@@ -771,6 +782,7 @@ static XA_ERRORCODE xa_mimo_proc_port_route(XACodecBase *base, xf_message_t *m)
 
     /* ...set routed flag */
     xa_out_track_set_flags(&mimo_proc->out_track[i], XA_OUT_TRACK_FLAG_ROUTED);
+    xa_mimo_proc_out_sync(mimo_proc, &mimo_proc->out_track[i]);
 
     /* ...schedule processing instantly - tbd - check if we have anything pending on input */
     /* ...TBD - do we need to check if other output ports are ready? */
@@ -829,6 +841,7 @@ static XA_ERRORCODE xa_mimo_proc_port_unroute(XACodecBase *base, xf_message_t *m
 
         /* ...flushing sequence is not needed; command may be satisfied instantly */
         xf_output_port_unroute(port);
+        xa_mimo_proc_out_sync(mimo_proc, &mimo_proc->out_track[i]);
     
         /* ...schedule processing if other output ports are ready */
         if (xa_mimo_proc_output_port_ready(mimo_proc))
@@ -847,6 +860,7 @@ static XA_ERRORCODE xa_mimo_proc_port_unroute(XACodecBase *base, xf_message_t *m
 
         /* ...flushing sequence is started; save flow-control message */
         xf_output_port_unroute_start(port, m);
+        xa_mimo_proc_out_sync(mimo_proc, &mimo_proc->out_track[i]);
     }
 
     return XA_NO_ERROR;
@@ -882,6 +896,7 @@ static XA_ERRORCODE xa_mimo_proc_flush(XACodecBase *base, xf_message_t *m)
 
             /* ...and enter into idle state */
             xa_in_track_set_flags(in_track, XA_IN_TRACK_FLAG_IDLE);
+            xa_mimo_proc_in_sync(mimo_proc, in_track);
             
             /* ...pass resume info to component. Clear paused status at component, so that reconnect wont be affected with the previous pause */    
             XA_API(base, XA_API_CMD_SET_CONFIG_PARAM, XA_MIMO_PROC_CONFIG_PARAM_PORT_RESUME, &i);
@@ -920,6 +935,7 @@ static XA_ERRORCODE xa_mimo_proc_flush(XACodecBase *base, xf_message_t *m)
 
             /* ... mark flushing sequence is done locally also */
             xa_out_track_set_flags(out_track, XA_OUT_TRACK_FLAG_FLUSHING_DONE);
+            xa_mimo_proc_out_sync(mimo_proc, out_track);
 
             /* ...complete original flow-control command */
             if ((base->state & XA_BASE_FLAG_COMPLETED) && (xa_mimo_proc_output_port_flush_done(mimo_proc)))
@@ -930,11 +946,13 @@ static XA_ERRORCODE xa_mimo_proc_flush(XACodecBase *base, xf_message_t *m)
                 {
                     /* ...input stream is over; return zero-length input back to caller */
                     xf_input_port_purge(&in_track->input);
+                    xa_mimo_proc_in_sync(mimo_proc, in_track);
                 }
             }
 
             /* ...flushing during port unrouting; complete unroute sequence */
             xf_output_port_unroute_done(&out_track->output);
+            xa_mimo_proc_out_sync(mimo_proc, out_track);
 
             TRACE(INFO, _b("port is unrouted"));
         }
@@ -962,6 +980,8 @@ static XA_ERRORCODE xa_mimo_proc_flush(XACodecBase *base, xf_message_t *m)
 
             }
 
+            xa_mimo_proc_out_sync(mimo_proc, out_track);
+
             /* ...complete original flow-control command */
             if (xa_mimo_proc_output_port_flush_done(mimo_proc))
             {
@@ -971,11 +991,13 @@ static XA_ERRORCODE xa_mimo_proc_flush(XACodecBase *base, xf_message_t *m)
                 {
                     /* ...input stream is over; return zero-length input back to caller */
                     xf_input_port_purge(&in_track->input);
+                    xa_mimo_proc_in_sync(mimo_proc, in_track);
                 }
             }
 
             /* ...clear output-setup condition */
             xa_out_track_clear_flags(out_track, XA_OUT_TRACK_FLAG_PAUSED | XA_OUT_TRACK_FLAG_OUTPUT_SETUP);
+            xa_mimo_proc_out_sync(mimo_proc, out_track);
         }
     }
 
@@ -1017,6 +1039,7 @@ static XA_ERRORCODE xa_mimo_proc_memtab(XACodecBase *base, WORD32 idx, WORD32 ty
     
         /* ...put track into idle state (will start as soon as we receive data) */
         xa_in_track_set_flags(track, XA_IN_TRACK_FLAG_IDLE);
+        xa_mimo_proc_in_sync(mimo_proc, track);
         
         XA_API(base, XA_API_CMD_SET_CONFIG_PARAM, XA_MIMO_PROC_CONFIG_PARAM_PORT_DISCONNECT, &i);
 
@@ -1050,6 +1073,7 @@ static XA_ERRORCODE xa_mimo_proc_memtab(XACodecBase *base, WORD32 idx, WORD32 ty
 
         /* ...set routed flag */
         xa_out_track_set_flags(track, XA_OUT_TRACK_FLAG_ROUTED);
+        xa_mimo_proc_out_sync(mimo_proc, track);
 
         TRACE(INIT, _b("mimo_proc[%p]::out_track[%u] output port created - size=%u"), mimo_proc, i, size);
     }
@@ -1158,7 +1182,7 @@ static XA_ERRORCODE xa_mimo_proc_preprocess(XACodecBase *base)
             else if ((output = xf_output_port_data(&out_track->output)) == NULL)
             {
                 /* ...no output buffer available */
-                if ( !XF_CHK_PORT_MASK(mimo_proc->relax_sched, (mimo_proc->num_in_ports+i)) )
+                if (!(mimo_proc->out_relax & (1 << i)))
                     return e;
             }
 
@@ -1204,18 +1228,23 @@ static XA_ERRORCODE xa_mimo_proc_preprocess(XACodecBase *base)
             {
                 /* ...take actual data from input port (mimo_proc is always using internal buffer) */
                 xf_input_port_fill(&in_track->input);
+                xa_mimo_proc_in_sync(mimo_proc, in_track);
             }
 
+            /* ...data may be accessed in-place or at advanced buffer position */
+            XA_API(base, XA_API_CMD_SET_MEM_PTR, in_track->idx, xf_input_port_buffer(&in_track->input));
+
             /* ...retrieve number of bytes available */
             filled = xf_input_port_level(&in_track->input);
            
             /* ...allow partially filled inputs to components */ 
             if (!xf_input_port_done(&in_track->input) && !filled && !xa_in_track_test_flags(in_track, XA_IN_TRACK_FLAG_PAUSED))
             {
-                if ( !XF_CHK_PORT_MASK(mimo_proc->relax_sched, i) )
+                if (!(mimo_proc->in_relax & (1 << i)))
                 {
-                    inport_nodata++; 
-                    if (inport_nodata == xa_mimo_proc_check_active(mimo_proc))
+                    /* ...bail out once none of the live tracks has data */
+                    inport_nodata |= 1 << i;
+                    if (inport_nodata == mimo_proc->in_live)
                     {
                         return XA_MIMO_PROC_EXEC_NONFATAL_NO_DATA;
                     }
@@ -1261,6 +1290,7 @@ static XA_ERRORCODE xa_mimo_proc_postprocess(XACodecBase *base, int done)
     UWORD32         i;
     UWORD32         probe_length = 0;
     void           *probe_outptr = mimo_proc->probe_output;
+    UWORD32         ts = 0;
 
     /* ...input ports maintenance; process all tracks */
     for (in_track = &mimo_proc->in_track[i = 0]; i < mimo_proc->num_in_ports; i++, in_track++)
@@ -1279,7 +1309,7 @@ static XA_ERRORCODE xa_mimo_proc_postprocess(XACodecBase *base, int done)
             if (XF_CHK_PORT_MASK(mimo_proc->probe_enabled, i))
             {
                 /* ...copy input port data onto probe port */
-                probe_outptr = xf_copy_probe_data(probe_outptr, i, consumed, in_track->input.buffer);
+                probe_outptr = xf_copy_probe_data(probe_outptr, i, consumed, xf_input_port_buffer(&in_track->input));
 
                 /* ...compute probe data length locally */
                 probe_length += consumed;
@@ -1289,6 +1319,10 @@ static XA_ERRORCODE xa_mimo_proc_postprocess(XACodecBase *base, int done)
         if (consumed)
         {
             input_consumed = consumed;
+
+            /* ...outputs are as old as the oldest input data */
+            ts = xf_latency_oldest(ts, xf_input_port_ts(&in_track->input));
+
             /* ...consume that amount from input port */
             xf_input_port_consume(&in_track->input, consumed);
             
@@ -1307,6 +1341,7 @@ static XA_ERRORCODE xa_mimo_proc_postprocess(XACodecBase *base, int done)
         {
             /* ...switch to idle state */
             xa_in_track_toggle_flags(in_track, XA_IN_TRACK_FLAG_ACTIVE | XA_IN_TRACK_FLAG_IDLE);
+            xa_mimo_proc_in_sync(mimo_proc, in_track);
 
             /* ...pass input port disconnect to component */
             XA_API(base, XA_API_CMD_SET_CONFIG_PARAM, XA_MIMO_PROC_CONFIG_PARAM_PORT_DISCONNECT, &i);
@@ -1323,6 +1358,8 @@ static XA_ERRORCODE xa_mimo_proc_postprocess(XACodecBase *base, int done)
                 xf_input_port_purge(&in_track->input);
             }
         }
+
+        xa_mimo_proc_in_sync(mimo_proc, in_track);
     }
 
     /* ...output ports maintenance; process all tracks */
@@ -1368,6 +1405,9 @@ static XA_ERRORCODE xa_mimo_proc_postprocess(XACodecBase *base, int done)
                 output_produced = produced;
             }
 
+            /* ...keep previous stamp if output comes from data buffered in plugin */
+            (ts ? xf_output_port_stamp(&out_track->output, ts) : (void)0);
+
             /* ...push data from output port */
             xf_output_port_produce(&out_track->output, produced);
 
@@ -1379,6 +1419,8 @@ static XA_ERRORCODE xa_mimo_proc_postprocess(XACodecBase *base, int done)
             /* ...clear output-setup condition with relax schedule on output port. TENA-2543 */
             xa_out_track_clear_flags(out_track, XA_OUT_TRACK_FLAG_OUTPUT_SETUP);
         }
+
+        xa_mimo_proc_out_sync(mimo_proc, out_track);
     }
 
     if (probe_length)
@@ -1417,6 +1459,7 @@ static XA_ERRORCODE xa_mimo_proc_postprocess(XACodecBase *base, int done)
 
                 /* ...reset routed flag */
                 xa_out_track_clear_flags(out_track, XA_OUT_TRACK_FLAG_ROUTED);
+                xa_mimo_proc_out_sync(mimo_proc, out_track);
 
                 port = i + mimo_proc->num_in_ports;
 
@@ -1448,6 +1491,8 @@ static XA_ERRORCODE xa_mimo_proc_postprocess(XACodecBase *base, int done)
                     TRACE(INFO, _b("mimo_proc[%p]:out_track[%u] propagate end-of-stream condition"), mimo_proc, i);
                 }
 
+                xa_mimo_proc_out_sync(mimo_proc, out_track);
+
             }
             
             if (xa_mimo_proc_output_port_flush_done(mimo_proc))
@@ -1456,6 +1501,7 @@ static XA_ERRORCODE xa_mimo_proc_postprocess(XACodecBase *base, int done)
                 {
                     /* ...input stream is over; return zero-length input back to caller */
                     xf_input_port_purge(&in_track->input);
+                    xa_mimo_proc_in_sync(mimo_proc, in_track);
                 }
 
                 /* ...flush probe port */
@@ -1529,6 +1575,7 @@ static XA_ERRORCODE xa_mimo_proc_setparam(XACodecBase *base, WORD32 id, pVOID va
     else if (id == XAF_COMP_CONFIG_PARAM_RELAX_SCHED)
     {
         mimo_proc->relax_sched = *(UWORD32 *) value;
+        xa_mimo_proc_relax_sync(mimo_proc);
         return XA_NO_ERROR;
     }
     else
@@ -1569,6 +1616,7 @@ static XA_ERRORCODE xa_mimo_proc_port_pause(XACodecBase *base, xf_message_t *m)
         {
             /* ...mark the port as paused */
             xa_in_track_set_flags(in_track, XA_IN_TRACK_FLAG_PAUSED);
+            xa_mimo_proc_in_sync(mimo_proc, in_track);
 
             /* ... pass port pause info to component */
             XA_API(base, XA_API_CMD_SET_CONFIG_PARAM, XA_MIMO_PROC_CONFIG_PARAM_PORT_PAUSE, &i);
@@ -1595,6 +1643,7 @@ static XA_ERRORCODE xa_mimo_proc_port_pause(XACodecBase *base, xf_message_t *m)
         {
             /* ...mark the port as paused */
             xa_out_track_set_flags(out_track, XA_OUT_TRACK_FLAG_PAUSED);
+            xa_mimo_proc_out_sync(mimo_proc, out_track);
             
             /* ... pass port pause info to component */
             XA_API(base, XA_API_CMD_SET_CONFIG_PARAM, XA_MIMO_PROC_CONFIG_PARAM_PORT_PAUSE, &i);
@@ -1674,6 +1723,7 @@ static XA_ERRORCODE xa_mimo_proc_port_resume(XACodecBase *base, xf_message_t *m)
         {
             /* ...mark the port as resumed */
             xa_in_track_clear_flags(in_track, XA_IN_TRACK_FLAG_PAUSED);
+            xa_mimo_proc_in_sync(mimo_proc, in_track);
 
             /* ... pass port resume info to component */
             XA_API(base, XA_API_CMD_SET_CONFIG_PARAM, XA_MIMO_PROC_CONFIG_PARAM_PORT_RESUME, &i);
@@ -1700,6 +1750,7 @@ static XA_ERRORCODE xa_mimo_proc_port_resume(XACodecBase *base, xf_message_t *m)
         {
             /* ...mark the port as resumed */
             xa_out_track_clear_flags(out_track, XA_OUT_TRACK_FLAG_PAUSED);
+            xa_mimo_proc_out_sync(mimo_proc, out_track);
             
             /* ... pass port resume info to component */
             XA_API(base, XA_API_CMD_SET_CONFIG_PARAM, XA_MIMO_PROC_CONFIG_PARAM_PORT_RESUME, &i);
@@ -1809,6 +1860,7 @@ static int xa_mimo_proc_terminate(xf_component_t *component, xf_message_t *m)
         /* ...output port flushing complete; mark port is idle and terminate */
         xf_output_port_flush_done(&track->output);
         xa_out_track_set_flags(track, XA_OUT_TRACK_FLAG_FLUSHING_DONE);
+        xa_mimo_proc_out_sync(mimo_proc, track);
         TRACE(OUTPUT, _b("mimo_proc[%p] flush completed for port[%d] in terminate"), mimo_proc, i);
         if (xa_mimo_proc_output_port_flush_done(mimo_proc))
             return -1;
@@ -1891,6 +1943,7 @@ static int xa_mimo_proc_cleanup(xf_component_t *component, xf_message_t *m)
     for (i = 0; i < mimo_proc->num_in_ports; i++)
     {
         xf_input_port_purge(&mimo_proc->in_track[i].input);
+        xa_mimo_proc_in_sync(mimo_proc, &mimo_proc->in_track[i]);
     }
 
     /* ...flush all output ports */
@@ -1909,6 +1962,8 @@ static int xa_mimo_proc_cleanup(xf_component_t *component, xf_message_t *m)
             xa_out_track_set_flags(out_track, XA_OUT_TRACK_FLAG_FLUSHING); 
             TRACE(INFO, _b("mimo_proc[%p]:out_track[%u] cleanup - propagate end-of-stream condition"), mimo_proc, i);
         }
+
+        xa_mimo_proc_out_sync(mimo_proc, out_track);
     }
 
     /* ...save command message to send response after flush completes */
@@ -1945,6 +2000,7 @@ static int xa_mimo_proc_cleanup(xf_component_t *component, xf_message_t *m)
 xf_component_t * xa_mimo_proc_factory(UWORD32 core, xa_codec_func_t process, xaf_comp_type comp_type)
 {
     XAMimoProc    *mimo_proc;
+    UWORD32        i;
 
     /* ...construct generic audio component */
     XF_CHK_ERR(mimo_proc = (XAMimoProc *)xa_base_factory(core, XF_MM(sizeof(*mimo_proc)), process), NULL);
@@ -1971,6 +2027,17 @@ xf_component_t * xa_mimo_proc_factory(UWORD32 core, xa_codec_func_t process, xaf
     /* ...set num IO ports */
     mimo_proc->num_in_ports  = xf_io_ports[comp_type][0];
     mimo_proc->num_out_ports = xf_io_ports[comp_type][1];
+
+    /* ...initialize port state bitmasks */
+    mimo_proc->in_all  = (1 << mimo_proc->num_in_ports) - 1;
+    mimo_proc->out_all = (1 << mimo_proc->num_out_ports) - 1;
+    xa_mimo_proc_relax_sync(mimo_proc);
+
+    for (i = 0; i < mimo_proc->num_in_ports; i++)
+        xa_mimo_proc_in_sync(mimo_proc, &mimo_proc->in_track[i]);
+
+    for (i = 0; i < mimo_proc->num_out_ports; i++)
+        xa_mimo_proc_out_sync(mimo_proc, &mimo_proc->out_track[i]);
     
     TRACE(INIT, _b("MimoProc[%p] with %d input and %d output ports is created"), mimo_proc, mimo_proc->num_in_ports, mimo_proc->num_out_ports);
 
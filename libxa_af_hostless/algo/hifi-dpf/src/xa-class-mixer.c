@@ -929,6 +929,9 @@ static XA_ERRORCODE xa_mixer_preprocess(XACodecBase *base)
             }
             else
             {
+                /* ...data may be accessed in-place or at advanced buffer position */
+                XA_API(base, XA_API_CMD_SET_MEM_PTR, i, xf_input_port_buffer(&track->input));
+
                 /* ...retrieve number of bytes available */
                 filled = xf_input_port_level(&track->input);
             }
@@ -970,6 +973,7 @@ static XA_ERRORCODE xa_mixer_postprocess(XACodecBase *base, int done)
     UWORD8              i;
     UWORD32         probe_length = 0;
     void           *probe_outptr = mixer->probe_output;
+    UWORD32         ts = 0;
 
     if (done)
     {
@@ -1012,13 +1016,16 @@ static XA_ERRORCODE xa_mixer_postprocess(XACodecBase *base, int done)
             if (XF_CHK_PORT_MASK(mixer->probe_enabled, i))
             {
                 /* ...copy input port data onto probe port */
-                probe_outptr = xf_copy_probe_data(probe_outptr, i, consumed, track->input.buffer);
+                probe_outptr = xf_copy_probe_data(probe_outptr, i, consumed, xf_input_port_buffer(&track->input));
        
                 /* ...compute probe data length locally */
                 probe_length += consumed;
             }
         }
 
+        /* ...mixed output is as old as the oldest track data */
+        (consumed ? ts = xf_latency_oldest(ts, xf_input_port_ts(&track->input)) : 0);
+
         /* ...consume that amount from input port (may be zero) */
         xf_input_port_consume(&track->input, consumed);
         
@@ -1066,6 +1073,7 @@ static XA_ERRORCODE xa_mixer_postprocess(XACodecBase *base, int done)
         mixer->pts += mixer->frame_size;
 
         /* ...push data from output port */
+        xf_output_port_stamp(&mixer->output, ts);
         xf_output_port_produce(&mixer->output, produced);
 
         /* ...clear output-setup condition */
@@ -80,6 +80,16 @@ typedef struct XARenderer
 
     /* ...internal message scheduling flag (shared with interrupt) */
     UWORD32                 schedule;
+
+    /***************************************************************************
+     * Zero-copy playback
+     **************************************************************************/
+
+    /* ...hardware ring whose periods are lent to upstream output port */
+    xa_renderer_dma_ring_t *dma_ring;
+
+    /* ...consumed input messages still referenced by DMA */
+    xf_msg_queue_t          dma_queue;
     
     /***************************************************************************
      * response message pointer 
@@ -108,6 +118,31 @@ typedef struct XARenderer
  * Internal helpers
  ******************************************************************************/
 
+/* ...check if buffer is one of DMA periods lent to upstream component */
+static inline int xa_renderer_lent(XARenderer *renderer, void *b)
+{
+    xa_renderer_dma_ring_t *ring = renderer->dma_ring;
+
+    return (ring && (UWORD8 *)b >= (UWORD8 *)ring->base &&
+            (UWORD8 *)b < (UWORD8 *)ring->base + ring->period_bytes * ring->period_count);
+}
+
+/* ...return held input messages to upstream, keeping at most "keep" ones */
+static void xa_renderer_release(XARenderer *renderer, UWORD32 keep)
+{
+    xf_message_t   *m;
+    UWORD32         n = 0;
+
+    for (m = xf_msg_queue_head(&renderer->dma_queue); m; m = m->next)
+        n++;
+
+    while (n-- > keep)
+    {
+        /* ...period is played out; upstream may write into it again */
+        xf_response(xf_msg_dequeue(&renderer->dma_queue));
+    }
+}
+
 /* ...prepare renderer for steady operation */
 static inline XA_ERRORCODE xa_renderer_prepare_runtime(XARenderer *renderer)
 {
@@ -319,6 +354,9 @@ static XA_ERRORCODE xa_renderer_flush(XACodecBase *base, xf_message_t *m)
         /* ...input port flushing; purge content of input buffer */
         xf_input_port_purge(&renderer->input);
 
+        /* ...return lent periods as well */
+        xa_renderer_release(renderer, 0);
+
         /* ...pass response to caller */
         xf_response(m);
     }
@@ -449,6 +487,16 @@ static XA_ERRORCODE xa_renderer_preprocess(XACodecBase *base)
         return XA_NO_ERROR;
     }
 
+    /* ...return lent periods DMA has completed */
+    if (!xf_msg_queue_empty(&renderer->dma_queue))
+    {
+        UWORD32     level;
+
+        XA_API(base, XA_API_CMD_GET_CONFIG_PARAM, XA_RENDERER_CONFIG_PARAM_FIFO_LEVEL, &level);
+
+        xa_renderer_release(renderer, (level + renderer->dma_ring->period_bytes - 1) / renderer->dma_ring->period_bytes);
+    }
+
     /* ...submit input buffer to the renderer */
     if (xf_input_port_bypass(&renderer->input))
     {
@@ -495,6 +543,9 @@ static XA_ERRORCODE xa_renderer_preprocess(XACodecBase *base)
             }
         }
 
+        /* ...data may be accessed in-place or at advanced buffer position */
+        XA_API(base, XA_API_CMD_SET_MEM_PTR, 0, xf_input_port_buffer(&renderer->input));
+
         /* ...retrieve number of bytes put in buffer */
         filled = xf_input_port_level(&renderer->input);
     }
@@ -567,8 +618,19 @@ static XA_ERRORCODE xa_renderer_postprocess(XACodecBase *base, int done)
     /* ...input buffer maintenance; consume that amount from input port */
     if (consumed)
     {
-        /* ...consume bytes from input buffer */
-        xf_input_port_consume(&renderer->input, consumed);
+        /* ...data is handed to the output device; account its age */
+        xf_latency_record(&base->component.latency, xf_input_port_ts(&renderer->input));
+
+        if (xa_renderer_lent(renderer, xf_input_port_buffer(&renderer->input)))
+        {
+            /* ...data was produced into DMA period; keep message until it is played */
+            xf_input_port_consume_hold(&renderer->input, consumed, &renderer->dma_queue);
+        }
+        else
+        {
+            /* ...consume bytes from input buffer */
+            xf_input_port_consume(&renderer->input, consumed);
+        }
     }
 
     /* ...reset output-ready state */
@@ -594,6 +656,9 @@ static XA_ERRORCODE xa_renderer_postprocess(XACodecBase *base, int done)
         }
         else
         {
+            /* ...hardware is stopped; nothing references lent periods anymore */
+            xa_renderer_release(renderer, 0);
+
             /* ...output stream is over; propagate condition to sink port */
             if (xf_output_port_flush(&renderer->output, XF_FILL_THIS_BUFFER))
             {
@@ -827,6 +892,7 @@ static int xa_renderer_cleanup(xf_component_t *component, xf_message_t *m)
     XARenderer     *renderer = (XARenderer *) component;
     XACodecBase    *base = (XACodecBase *) renderer;
     UWORD32             state = XA_RENDERER_STATE_IDLE;
+    xf_message_t   *m_held;
 
     /* ...cancel component task execution if needed */
     xa_base_cancel(base);
@@ -837,6 +903,14 @@ static int xa_renderer_cleanup(xf_component_t *component, xf_message_t *m)
     /* ...purge input port */
     xf_input_port_purge(&renderer->input);
 
+    /* ...lent periods go away with the renderer; make upstream unroute its port */
+    while ((m_held = xf_msg_dequeue(&renderer->dma_queue)) != NULL)
+    {
+        xf_response_failure(m_held);
+    }
+
+    renderer->dma_ring = NULL;
+
     /* ...save command message to send response after flush completes */
     renderer->m_response = m;
 
@@ -859,6 +933,41 @@ static int xa_renderer_cleanup(xf_component_t *component, xf_message_t *m)
     }
 }
 
+/* ...lend DMA periods as output buffers of upstream component (zero-copy playback) */
+static int xa_renderer_lend(xf_component_t *component, UWORD32 port, UWORD32 n, UWORD32 length, void **buffers)
+{
+    XARenderer             *renderer = (XARenderer *) component;
+    XACodecBase            *base = (XACodecBase *) renderer;
+    xa_renderer_dma_ring_t *ring = NULL;
+    UWORD32                 i;
+
+    /* ...only input port of configured renderer may be backed by DMA memory */
+    if (port != 0 || (base->state & XA_BASE_FLAG_POSTINIT) == 0)
+        return -1;
+
+    /* ...plugin without hardware ring doesn't support lending */
+    if (XA_API_NORET(base, XA_API_CMD_GET_CONFIG_PARAM, XA_RENDERER_CONFIG_PARAM_DMA_RING, &ring) != XA_NO_ERROR || ring == NULL)
+        return -1;
+
+    /* ...buffers are recycled in order, so they must map one-to-one onto periods and whole frames */
+    if (n != ring->period_count || length != ring->period_bytes || renderer->input.length != length)
+    {
+        TRACE(INIT, _b("renderer[%p]: no lending - %u x %u vs %u x %u periods"), renderer, n, length, ring->period_count, ring->period_bytes);
+        return -1;
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        buffers[i] = (UWORD8 *)ring->base + i * ring->period_bytes;
+    }
+
+    renderer->dma_ring = ring;
+
+    TRACE(INIT, _b("renderer[%p]: %u DMA periods lent to upstream"), renderer, n);
+
+    return 0;
+}
+
 /* ...renderer class factory */
 xf_component_t * xa_renderer_factory(UWORD32 core, xa_codec_func_t process,xaf_comp_type comp_type)
 {
@@ -879,6 +988,10 @@ xf_component_t * xa_renderer_factory(UWORD32 core, xa_codec_func_t process,xaf_c
     /* ...set component destructor hook */
     renderer->base.component.exit = xa_renderer_cleanup;
 
+    /* ...DMA periods may back upstream output buffers */
+    renderer->base.component.lend = xa_renderer_lend;
+    xf_msg_queue_init(&renderer->dma_queue);
+
     /* ...set notification callback data */
     renderer->cdata.cb = xa_renderer_callback;
     renderer->base.comp_type = comp_type;
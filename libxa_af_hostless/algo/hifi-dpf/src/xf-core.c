@@ -31,13 +31,31 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
-
+#include <stddef.h>
 #include "xf-dp.h"
-#include <xtensa/config/core.h>
 #include <osal-isr.h>
 #include <osal-timer.h>
+#if defined(HAVE_LINUX)
+/* ...host build has no interrupt controller configuration */
+#define XCHAL_NUM_INTERRUPTS            XF_NUM_INTERRUPTS
+#else
+#include <xtensa/config/core.h>
+#endif
 #include "board.h"
 #include "debug.h"
+
+/*******************************************************************************
+ * Global data definition
+ ******************************************************************************/
+
+UWORD32 xf_core_scratch_users[XF_CFG_CORES_NUM];
+
+/* ...DSP objects must match the sizes the AP side reserves for them */
+C_BUG(offsetof(xf_dsp_t, xf_dsp_local_pool) - offsetof(xf_dsp_t, xf_core_data) != XF_DSP_OBJ_SIZE_CORE_DATA);
+C_BUG(offsetof(xf_dsp_t, xf_core_ro_data) - offsetof(xf_dsp_t, xf_dsp_local_pool) != XF_DSP_OBJ_SIZE_DSP_LOCAL_POOL);
+C_BUG(offsetof(xf_dsp_t, xf_core_rw_data) - offsetof(xf_dsp_t, xf_core_ro_data) != XF_DSP_OBJ_SIZE_CORE_RO_DATA);
+C_BUG(offsetof(xf_dsp_t, xf_ap_shmem_buffer) - offsetof(xf_dsp_t, xf_core_rw_data) != XF_DSP_OBJ_SIZE_CORE_RW_DATA);
+
 /*******************************************************************************
  * Internal helpers
  ******************************************************************************/
@@ -51,6 +69,12 @@ static inline xf_component_t * xf_client_lookup(xf_core_data_t *cd, UWORD32 clie
     return (link->next > XF_CFG_MAX_CLIENTS ? link->c : NULL);
 }
 
+/* ...translate local client-id into component handle (used for buffer lending) */
+xf_component_t * xf_core_component(UWORD32 core, UWORD32 client)
+{
+    return (client < XF_CFG_MAX_CLIENTS ? xf_client_lookup(XF_CORE_DATA(core), client) : NULL);
+}
+
 /* ...allocate client-id */
 static inline UWORD32 xf_client_alloc(xf_core_data_t *cd)
 {
@@ -145,6 +169,44 @@ static int xf_proxy_free(UWORD32 core, xf_message_t *m)
     return 0;
 }
 
+/* ...copy pool statistics into message */
+static inline void xf_proxy_pool_stats(xf_mm_pool_t *pool, xaf_mem_pool_stats_t *s)
+{
+    xf_mm_stats_t   stats;
+
+    xf_mm_get_stats(pool, &stats);
+
+    s->size = stats.size, s->used = stats.used, s->peak = stats.peak;
+    s->cached = stats.cached, s->free = stats.free;
+    s->free_blocks = stats.free_blocks, s->largest_free = stats.largest_free;
+    s->slab_hits = stats.slab_hits, s->slab_refills = stats.slab_refills;
+}
+
+/* ...memory statistics request */
+static int xf_proxy_mem_stats(UWORD32 core, xf_message_t *m)
+{
+    xf_core_data_t     *cd = XF_CORE_DATA(core);
+    xf_mem_stats_msg_t *msg = m->buffer;
+    xaf_mem_stats_t     pools;
+
+    /* ...check message buffer is sane */
+    XF_CHK_ERR(msg && m->length >= sizeof(*msg), XAF_INVALIDVAL_ERR);
+
+    msg->comp_buf_size_peak = xf_g_dsp->dsp_comp_buf_size_peak;
+    msg->frmwk_buf_size_peak = xf_g_dsp->dsp_frmwk_buf_size_peak;
+    msg->comp_buf_size_curr = xf_g_dsp->dsp_comp_buf_size_curr;
+    msg->frmwk_buf_size_curr = xf_g_dsp->dsp_frmwk_buf_size_curr;
+
+    xf_proxy_pool_stats(&cd->local_pool, &pools.local);
+    xf_proxy_pool_stats(&cd->shared_pool, &pools.shared);
+    msg->pools = pools;
+
+    /* ...pass statistics to App Interface Layer */
+    xf_response_data(m, sizeof(*msg));
+
+    return 0;
+}
+
 #if 0
 /* ...port routing command processing */
 static int xf_proxy_route(UWORD32 core, xf_message_t *m)
@@ -242,7 +304,7 @@ static int xf_proxy_output(UWORD32 core, xf_message_t *m)
     /* ...determine destination "client" */
     switch (XF_MSG_SRC_CLIENT(m->id))
     {
-#if XF_TRACE_REMOTE
+#if XF_CFG_TRACE_EVENTS
     case 0:
         /* ...destination is a tracer facility; submit buffer to tracer */
         xf_trace_submit(core, m);
@@ -261,7 +323,7 @@ static int xf_proxy_flush(UWORD32 core, xf_message_t *m)
     /* ...determine destination "client" */
     switch (XF_MSG_SRC_CLIENT(m->id))
     {
-#if XF_TRACE_REMOTE
+#if XF_CFG_TRACE_EVENTS
     case 0:
         /* ...destination is a tracer facility; flush current buffer */
         xf_trace_flush(core, m);
@@ -274,6 +336,239 @@ static int xf_proxy_flush(UWORD32 core, xf_message_t *m)
     }
 }
 
+/* ...pass message to a component on worker thread; returns non-zero if component is gone */
+static int xf_worker_process_message(xf_core_data_t *cd, UWORD32 core, xf_message_t *m)
+{
+    UWORD32 client      = XF_MSG_DST_CLIENT(m->id);
+    xf_component_t *component;
+
+    if ((component = xf_client_lookup(cd, client)) != NULL)
+    {
+        return xf_core_process_message(component, m);
+    }
+
+    /* ...client look-up failed */
+    if (XF_MSG_SRC_PROXY(m->id))
+    {
+        TRACE(DISP, _b("In worker entry Error response to message id=%08x - client %u:%u not registered"), m->id, core, client);
+        xf_response_err(m);
+    }
+    else if(XF_MSG_SRC_CLIENT(m->id))
+    {
+        TRACE(DISP, _b("In worker entry, Lookup failure response to message id=%08x - client %u:%u not registered"), m->id, core, client);
+        xf_response_failure(m);
+    }
+    else
+    {
+        TRACE(DISP, _b("In worker entry, Discard message id=%08x - both dest client %u:%u and src client:%u not registered"), m->id, core, client, XF_MSG_SRC_CLIENT(m->id));
+    }
+
+    return 1;
+}
+
+#if XF_CFG_WORKER_STEAL
+/*******************************************************************************
+ * Work-stealing worker threads
+ *
+ * Threads of one priority level wait on a common doorbell queue, and the unit
+ * of work they exchange is a ready component rather than a message. Requests
+ * addressed to a component are collected in its slot; the component is put
+ * into the deque of the thread that executed it last only when it becomes
+ * ready, so it is never executed by two threads at once and its messages keep
+ * their order. A thread takes components from the head of its own deque and
+ * steals from the tail of the longest sibling deque when its own is empty.
+ ******************************************************************************/
+
+typedef struct xf_steal_slot
+{
+    /* ...component requests are addressed to */
+    xf_component_t     *component;
+
+    /* ...messages pending execution */
+    xf_msg_queue_t      queue;
+
+    /* ...number of pending data-processing requests */
+    UWORD32             process;
+
+    /* ...component is in a deque or being executed */
+    UWORD32             busy;
+
+    /* ...thread that executed the component last */
+    UWORD32             owner;
+
+}   xf_steal_slot_t;
+
+/* ...per-client slots and the lock protecting slots and deques */
+static xf_steal_slot_t  xf_steal_slot[XF_CFG_CORES_NUM][XF_CFG_MAX_CLIENTS];
+static xf_lock_t        xf_steal_lock[XF_CFG_CORES_NUM];
+
+/* ...deque index wraps by masking; it is sized by the number of clients */
+#if (XF_CFG_MAX_CLIENTS & (XF_CFG_MAX_CLIENTS - 1))
+#error "XF_CFG_MAX_CLIENTS must be a power of two"
+#endif
+
+#define XF_STEAL_DEQUE_MASK             (XF_CFG_MAX_CLIENTS - 1)
+
+/* ...put ready client to the tail of thread deque; lock must be held */
+static inline void xf_steal_push(struct xf_worker_thread *t, UWORD32 client)
+{
+    t->deque[t->tail++ & XF_STEAL_DEQUE_MASK] = (UWORD8)client;
+}
+
+/* ...take ready client from own deque or steal it from a sibling; lock must be held */
+static UWORD32 xf_steal_take(struct xf_worker_thread *self)
+{
+    struct xf_worker   *worker = self->worker;
+    struct xf_worker_thread *victim = NULL;
+    UWORD32             i, n, max = 0;
+
+    if (self->head != self->tail)
+    {
+        return self->deque[self->head++ & XF_STEAL_DEQUE_MASK];
+    }
+
+    for (i = 0; i < XF_CFG_WORKER_STEAL_THREADS; i++)
+    {
+        if ((n = worker->steal[i].tail - worker->steal[i].head) > max)
+        {
+            victim = &worker->steal[i], max = n;
+        }
+    }
+
+    /* ...doorbell is rung once per queued client; deque cannot be empty */
+    BUG(victim == NULL, _x("worker[%p]: no ready client"), worker);
+
+    TRACE(DISP, _b("worker[%p]:%u steals from thread %u"), worker, self->index, victim->index);
+
+    return victim->deque[--victim->tail & XF_STEAL_DEQUE_MASK];
+}
+
+/* ...queue request for execution on worker threads of given priority level */
+static void xf_steal_send(UWORD32 core, struct xf_worker *worker, xf_component_t *component, xf_message_t *msg)
+{
+    UWORD32             client = XF_PORT_CLIENT(component->id);
+    xf_steal_slot_t    *slot = &xf_steal_slot[core][client];
+    UWORD32             ready;
+
+    __xf_lock(&xf_steal_lock[core]);
+
+    slot->component = component;
+
+    (msg ? (void)xf_msg_enqueue(&slot->queue, msg) : (void)slot->process++);
+
+    /* ...component becomes ready; prefer the thread that executed it last */
+    if ((ready = !slot->busy) != 0)
+    {
+        slot->busy = 1;
+        xf_steal_push(&worker->steal[slot->owner], client);
+    }
+
+    __xf_unlock(&xf_steal_lock[core]);
+
+    if (ready)
+    {
+        xf_worker_msg_t token = {
+            .component = component,
+            .msg = NULL,
+        };
+
+        __xf_msgq_send(worker->queue, &token, sizeof(token));
+    }
+}
+
+/* ...cancel pending data-processing request */
+void xf_core_steal_cancel(xf_component_t *component)
+{
+    UWORD32             core = xf_component_core(component);
+    xf_steal_slot_t    *slot = &xf_steal_slot[core][XF_PORT_CLIENT(component->id)];
+
+    __xf_lock(&xf_steal_lock[core]);
+
+    if (slot->component == component && slot->process)
+    {
+        slot->process--;
+    }
+
+    __xf_unlock(&xf_steal_lock[core]);
+}
+
+static void *dsp_worker_entry(void *arg)
+{
+    struct xf_worker_thread *self = arg;
+    struct xf_worker   *worker = self->worker;
+    UWORD32             core = worker->core;
+    xf_core_data_t     *cd = XF_CORE_DATA(core);
+    xf_lock_t          *lock = &xf_steal_lock[core];
+
+    for (;;) {
+        xf_worker_msg_t     token;
+        xf_steal_slot_t    *slot;
+        xf_component_t     *component;
+        xf_message_t       *m;
+        UWORD32             client, run = 0, gone = 0, ready = 0;
+        int rc = __xf_msgq_recv_blocking(worker->queue, &token, sizeof(token));
+
+        if (rc || !token.component)
+        {
+            TRACE(DISP, _b("dsp_worker_entry thread_exit, worker:%p:%u msgq_err:%x"), worker, self->index, rc);
+            break;
+        }
+
+        /* ...take one request of a ready component */
+        __xf_lock(lock);
+
+        client = xf_steal_take(self);
+        slot = &xf_steal_slot[core][client];
+        slot->owner = self->index;
+        component = slot->component;
+
+        if ((m = xf_msg_dequeue(&slot->queue)) == NULL && slot->process)
+        {
+            slot->process--, run = 1;
+        }
+
+        __xf_unlock(lock);
+
+        if (m)
+        {
+            gone = xf_worker_process_message(cd, core, m);
+        }
+        else if (run)
+        {
+            xf_core_process(component);
+        }
+
+        /* ...requeue the component if it has more requests */
+        __xf_lock(lock);
+
+        /* ...data-processing requests of destroyed component are void */
+        if (gone)
+        {
+            slot->process = 0;
+        }
+
+        if (xf_msg_queue_empty(&slot->queue) && slot->process == 0)
+        {
+            slot->busy = 0;
+        }
+        else
+        {
+            xf_steal_push(self, client), ready = 1;
+        }
+
+        __xf_unlock(lock);
+
+        if (ready)
+        {
+            __xf_msgq_send(worker->queue, &token, sizeof(token));
+        }
+    }
+
+    return NULL;
+}
+
+#else
+
 static void *dsp_worker_entry(void *arg)
 {
     struct xf_worker *worker = arg;
@@ -292,29 +587,7 @@ static void *dsp_worker_entry(void *arg)
 
         if (msg.msg)
         {
-            UWORD32 client      = XF_MSG_DST_CLIENT(msg.msg->id);
-            if (xf_client_lookup(cd, client))
-            {
-                xf_core_process_message(msg.component, msg.msg);
-            }
-            else
-            {
-                /* ...client look-up failed */
-                if (XF_MSG_SRC_PROXY(msg.msg->id))
-                {
-                    TRACE(DISP, _b("In worker entry Error response to message id=%08x - client %u:%u not registered"), msg.msg->id, core, client);
-                    xf_response_err(msg.msg);
-                }
-                else if(XF_MSG_SRC_CLIENT(msg.msg->id))
-                {
-                    TRACE(DISP, _b("In worker entry, Lookup failure response to message id=%08x - client %u:%u not registered"), msg.msg->id, core, client);
-                    xf_response_failure(msg.msg);
-                }
-                else
-                {
-                    TRACE(DISP, _b("In worker entry, Discard message id=%08x - both dest client %u:%u and src client:%u not registered"), msg.msg->id, core, client, XF_MSG_SRC_CLIENT(msg.msg->id));
-                }
-            }
+            xf_worker_process_message(cd, core, msg.msg);
         }
         else
         {
@@ -364,6 +637,84 @@ static void *dsp_worker_entry(void *arg)
     }
     return NULL;
 }
+#endif  /* XF_CFG_WORKER_STEAL */
+
+#if XF_CFG_WORKER_STEAL
+/* ...stop first "num" threads of a priority level and release its resources */
+static void xaf_proxy_destroy_worker(struct xf_worker *worker, UWORD32 num, UWORD32 stack_size)
+{
+    xf_worker_msg_t worker_msg = {
+        .component = NULL,
+        .msg = NULL,
+    };
+    UWORD32 i;
+
+    /* ...every thread exits on its own NULL token once pending work is done */
+    for (i = 0; i < num; ++i)
+    {
+        __xf_msgq_send(worker->queue, &worker_msg, sizeof(worker_msg));
+    }
+
+    for (i = 0; i < num; ++i)
+    {
+        struct xf_worker_thread *t = &worker->steal[i];
+
+        __xf_thread_join(&t->thread, NULL);
+        __xf_thread_destroy(&t->thread);
+
+#if !defined(HAVE_FREERTOS)
+        xf_mem_free(t->stack, stack_size, 0, 0);
+#endif /* HAVE_FREERTOS */
+    }
+
+    __xf_msgq_destroy(worker->queue);
+}
+
+static int xaf_proxy_create_worker(struct xf_worker *worker,
+                                   UWORD32 priority, UWORD32 stack_size)
+{
+    UWORD32 i;
+    int ret;
+
+    /* ...doorbell is rung at most once per client, plus exit tokens */
+    worker->queue = __xf_msgq_create(XF_CFG_MAX_CLIENTS + XF_CFG_WORKER_STEAL_THREADS, sizeof(xf_worker_msg_t));
+    if (!worker->queue)
+        return XAF_INVALIDPTR_ERR;
+
+    for (i = 0; i < XF_CFG_WORKER_STEAL_THREADS; ++i) {
+        struct xf_worker_thread *t = &worker->steal[i];
+
+        t->worker = worker, t->index = i;
+        t->head = t->tail = 0;
+
+#if !defined(HAVE_FREERTOS)
+        t->stack = xf_mem_alloc(stack_size, 4, 0, 0);
+        if (t->stack == NULL) {
+            ret = XAF_MEMORY_ERR;
+            goto err;
+        }
+#else /* HAVE_FREERTOS */
+        t->stack = NULL;
+#endif /* HAVE_FREERTOS */
+
+        if (__xf_thread_create(&t->thread, dsp_worker_entry, t,
+                               "DSP-worker", t->stack, stack_size, priority)) {
+#if !defined(HAVE_FREERTOS)
+            xf_mem_free(t->stack, stack_size, 0, 0);
+#endif /* HAVE_FREERTOS */
+            ret = XAF_INVALIDVAL_ERR;
+            goto err;
+        }
+    }
+
+    return 0;
+
+err:
+    xaf_proxy_destroy_worker(worker, i, stack_size);
+    return ret;
+}
+
+#else
 
 static int xaf_proxy_create_worker(struct xf_worker *worker,
                                    UWORD32 priority, UWORD32 stack_size)
@@ -409,6 +760,7 @@ err_queue:
 #endif /* HAVE_FREERTOS */
     return ret;
 }
+#endif  /* XF_CFG_WORKER_STEAL */
 
 static int xf_proxy_set_priorities(UWORD32 core, xf_message_t *m)
 {
@@ -447,6 +799,7 @@ static int xf_proxy_set_priorities(UWORD32 core, xf_message_t *m)
     {
     	 struct xf_worker *worker = cd->worker + i;
     	 worker->scratch = NULL;
+    	 worker->scratch_users = 0;
     }
 
 /*...reinitializing locks */
@@ -496,7 +849,9 @@ static int xf_proxy_suspend(UWORD32 core, xf_message_t *m)
 	xf_cmap_link_t *link;
 	xf_component_t *component;
 	UWORD32 i;
+#if defined(HAVE_XOS)
 	int32_t rc;
+#endif
 
 	TRACE(info, _b("Process XF_SUSPEND command\n"));
 	/* ...call suspend of each component */
@@ -508,25 +863,39 @@ static int xf_proxy_suspend(UWORD32 core, xf_message_t *m)
 		}
 	}
 
+#if defined(HAVE_XOS)
 	if (cd->n_workers) {
 		for (i = 0; i < cd->n_workers; i++) {
 			struct xf_worker *worker = cd->worker + i;
+#if XF_CFG_WORKER_STEAL
+			UWORD32 j;
+
+			for (j = 0; j < XF_CFG_WORKER_STEAL_THREADS; j++) {
+				rc = xos_thread_suspend(&worker->steal[j].thread);
+				if (rc != XOS_OK)
+					LOG("thread suspend fail\n");
+			}
+#else
 			rc = xos_thread_suspend(&worker->thread);
 			/* If the thread is already blocked on some other
 			 * condition, then this function will return an
 			 * error. */
 			if (rc != XOS_OK)
 				LOG("thread suspend fail\n");
+#endif
 		}
 	}
+#endif
 	/* ???? */
 	xf_msg_pool_put(&XF_CORE_RO_DATA(core)->pool, m);
 
+#if defined(HAVE_XOS)
 	/* send message back*/
 	platform_notify(RP_MBOX_SUSPEND_ACK);
 
 	/* dead loop wait DSP reset.*/
 	while(1);
+#endif
 
 	return 0;
 }
@@ -537,7 +906,9 @@ static int xf_proxy_suspend_resume(UWORD32 core, xf_message_t *m)
 	xf_cmap_link_t *link;
 	xf_component_t *component;
 	UWORD32 i;
+#if defined(HAVE_XOS)
 	int32_t rc;
+#endif
 
 	TRACE(info, _b("Process XF_RESUME command\n"));
 
@@ -550,14 +921,26 @@ static int xf_proxy_suspend_resume(UWORD32 core, xf_message_t *m)
 		}
 	}
 
+#if defined(HAVE_XOS)
 	if (cd->n_workers) {
 		for (i = 0; i < cd->n_workers; i++) {
 			struct xf_worker *worker = cd->worker + i;
+#if XF_CFG_WORKER_STEAL
+			UWORD32 j;
+
+			for (j = 0; j < XF_CFG_WORKER_STEAL_THREADS; j++) {
+				rc = xos_thread_resume(&worker->steal[j].thread);
+				if (rc != XOS_OK)
+					LOG("thread resume fail\n");
+			}
+#else
 			rc = xos_thread_resume(&worker->thread);
 			if (rc != XOS_OK)
 				LOG("thread resume fail\n");
+#endif
 		}
 	}
+#endif
 
 	xf_msg_pool_put(&XF_CORE_RO_DATA(core)->pool, m);
 
@@ -580,6 +963,7 @@ static int (* const xf_proxy_cmd[])(UWORD32, xf_message_t *) =
     [XF_OPCODE_TYPE(XF_SET_PRIORITIES)] = xf_proxy_set_priorities,
     [XF_OPCODE_TYPE(XF_SUSPEND)] = xf_proxy_suspend,
     [XF_OPCODE_TYPE(XF_SUSPEND_RESUME)] = xf_proxy_suspend_resume,
+    [XF_OPCODE_TYPE(XF_GET_MEM_STATS)] = xf_proxy_mem_stats,
 };
 
 /* ...total number of commands supported */
@@ -722,14 +1106,51 @@ static inline xf_message_t * xf_msg_local_response_get(UWORD32 core)
 }
 #endif
 
+#if XF_CFG_PROFILE
+/* ...account component processing invocation */
+static void xf_core_profile(xf_component_t *component, UWORD32 start, UWORD32 end)
+{
+    xf_profile_t       *profile = &component->profile;
+    xaf_comp_profile_t *stats = &profile->stats;
+    UWORD32             wait = start - profile->sched_cycles;
+    UWORD32             cycles = end - start;
+
+    stats->frames++;
+
+    stats->cycles += cycles;
+    (cycles > stats->cycles_max ? stats->cycles_max = cycles : 0);
+
+    stats->wait_cycles += wait;
+    (wait > stats->wait_max ? stats->wait_max = wait : 0);
+
+    /* ...time-driven component must complete within its scheduling period */
+    if (profile->sched_dts)
+    {
+        UWORD64     budget = (UWORD64)profile->sched_dts * __xf_get_cycles_freq() / XF_TIMEBASE_FREQ;
+
+        if ((UWORD64)wait + cycles > budget)
+        {
+            stats->missed_deadlines++;
+
+            TRACE(PROCESS, _b("client[%u]: deadline missed (wait=%u, cycles=%u, budget=%u)"), XF_PORT_CLIENT(component->id), wait, cycles, (UWORD32)budget);
+        }
+    }
+}
+#endif
+
 /* ...call component data processing function */
 void xf_core_process(xf_component_t *component)
 {
     XA_ERRORCODE error_code = 0;
+#if XF_CFG_PROFILE
+    UWORD32     start = xf_profile_cycles();
+#endif
 
     /* ...client look-up successfull */
     TRACE(DISP, _b("core[%u]::client[%u]::process"), XF_PORT_CORE(component->id), XF_PORT_CLIENT(component->id));
 
+    xf_trace_event(XF_PORT_CORE(component->id), XAF_TRACE_EV_PROCESS_START, 0, component->id, 0);
+
     /* ...call data-processing interface */
     if ((error_code = component->entry(component, NULL)) < 0)
     {
@@ -739,9 +1160,16 @@ void xf_core_process(xf_component_t *component)
         TRACE(ERROR, _b("execution error =%08x from component =%p (ignored)"), error_code, component);
 #endif
     }
+
+    xf_trace_event(XF_PORT_CORE(component->id), XAF_TRACE_EV_PROCESS_END, 0, component->id, (UWORD32)error_code);
+
+#if XF_CFG_PROFILE
+    xf_core_profile(component, start, xf_profile_cycles());
+#endif
 }
 
-void xf_core_process_message(xf_component_t *component, xf_message_t *m)
+/* ...pass message to component; returns non-zero if component has been destroyed */
+int xf_core_process_message(xf_component_t *component, xf_message_t *m)
 {
     UWORD32 core = XF_MSG_DST_CORE(m->id);
     UWORD32 client = XF_MSG_DST_CLIENT(m->id);
@@ -755,8 +1183,11 @@ void xf_core_process_message(xf_component_t *component, xf_message_t *m)
             xf_core_data_t *cd = XF_CORE_DATA(core);
             /* ...component cleanup completed; recycle component-id */
             xf_client_free(cd, client);
+            return 1;
         }
     }
+
+    return 0;
 }
 
 static void xf_comp_send(xf_component_t *component, xf_message_t *msg)
@@ -769,18 +1200,23 @@ static void xf_comp_send(xf_component_t *component, xf_message_t *msg)
         else
             xf_core_process(component);
     } else {
-        xf_msgq_t q;
+        struct xf_worker *worker;
+
+        if (component->priority < cd->n_workers)
+            worker = &cd->worker[component->priority];
+        else
+            worker = &cd->worker[cd->n_workers - 1];
+
+#if XF_CFG_WORKER_STEAL
+        xf_steal_send(xf_component_core(component), worker, component, msg);
+#else
         xf_worker_msg_t worker_msg = {
             .component = component,
             .msg = msg,
         };
 
-        if (component->priority < cd->n_workers)
-            q = cd->worker[component->priority].queue;
-        else
-            q = cd->worker[cd->n_workers - 1].queue;
-
-        __xf_msgq_send(q, &worker_msg, sizeof(worker_msg));
+        __xf_msgq_send(worker->queue, &worker_msg, sizeof(worker_msg));
+#endif
     }
 }
 
@@ -800,6 +1236,8 @@ static inline void xf_core_dispatch(xf_core_data_t *cd, UWORD32 core, xf_message
     UWORD32             client;
     xf_component_t *component;
 
+    xf_trace_event(core, XAF_TRACE_EV_DISPATCH, XF_OPCODE_TYPE(m->opcode), m->id, m->length);
+
     /* ...do client-id/component lookup */
     if (XF_MSG_DST_PROXY(m->id))
     {
@@ -930,6 +1368,7 @@ struct xf_irq_handler {
 static xf_lock_t xf_irq_lock;
 static struct xf_irq_handler irq_table[XCHAL_NUM_INTERRUPTS];
 
+#if !defined(HAVE_LINUX)
 static void xf_process_irqs(void)
 {
     int i;
@@ -956,6 +1395,7 @@ static void xf_process_irqs(void)
     }
     __xf_unlock(&xf_irq_lock);
 }
+#endif
 
 #ifndef IRQ_THREAD_STACK_SIZE
 #define IRQ_THREAD_STACK_SIZE 1024
@@ -1177,6 +1617,58 @@ static void xf_irq_deinit_backend(void)
     __xf_lock_destroy(&xf_timer_lock);
     xos_sem_delete(&xf_irq_semaphore);
 }
+#elif defined(HAVE_LINUX)
+/* ...interrupt masking emulation (see osal-isr.h) */
+pthread_mutex_t __xf_isr_lock;
+
+int __xf_set_threaded_irq_handler(int irq,
+                                  xf_isr *irq_handler,
+                                  xf_isr *threaded_handler,
+                                  void *arg)
+{
+    if (irq < 0 || irq >= XCHAL_NUM_INTERRUPTS)
+        return 0;
+
+    /* ...no interrupt sources on a host; just record the handlers */
+    __xf_lock(&xf_irq_lock);
+    irq_table[irq] = (struct xf_irq_handler){
+        .irq_handler = irq_handler,
+        .threaded_handler = threaded_handler,
+        .arg = arg,
+    };
+    __xf_unlock(&xf_irq_lock);
+    return 1;
+}
+
+int __xf_unset_threaded_irq_handler(int irq)
+{
+    if (irq < 0 || irq >= XCHAL_NUM_INTERRUPTS)
+        return 0;
+
+    __xf_lock(&xf_irq_lock);
+    memset(&irq_table[irq], 0, sizeof(struct xf_irq_handler));
+    __xf_unlock(&xf_irq_lock);
+    return 1;
+}
+
+static void xf_irq_init_backend(void)
+{
+    pthread_mutexattr_t attr;
+
+    /* ...critical sections may nest, as interrupt masking does */
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&__xf_isr_lock, &attr);
+    pthread_mutexattr_destroy(&attr);
+
+    __xf_lock_init(&xf_irq_lock);
+}
+
+static void xf_irq_deinit_backend(void)
+{
+    __xf_lock_destroy(&xf_irq_lock);
+    pthread_mutex_destroy(&__xf_isr_lock);
+}
 #else
 #error Unrecognized RTOS
 #endif
@@ -1200,7 +1692,7 @@ int xf_core_init(UWORD32 core)
     cd->free = 0;
     
     /* ...initialize local queue scheduler */
-    xf_sched_init(&cd->sched);
+    XF_CHK_API(xf_sched_init(&cd->sched, core));
     xf_sync_queue_init(&cd->queue);
 #if 0
     xf_sync_queue_init(&cd->response);
@@ -1213,6 +1705,13 @@ int xf_core_init(UWORD32 core)
 
     /* ...initialize scratch memory to NULL */
     cd->scratch = NULL;
+    xf_core_scratch_users[core] = 0;
+
+#if XF_CFG_WORKER_STEAL
+    /* ...no requests are queued for worker threads */
+    memset(xf_steal_slot[core], 0, sizeof(xf_steal_slot[core]));
+    __xf_lock_init(&xf_steal_lock[core]);
+#endif
     
     /* ...okay... it's all good */
     TRACE(INIT, _b("core-%u initialized"), core);
@@ -1226,11 +1725,15 @@ int xf_core_deinit(UWORD32 core)
 
     if (cd->n_workers) {
         UWORD32 i;
-#if !defined(HAVE_FREERTOS)
+#if defined(HAVE_XOS) && !XF_CFG_WORKER_STEAL
         UWORD32 stack_size = cd->worker_stack_size;
-#endif /* HAVE_FREERTOS */
+#endif /* HAVE_XOS */
 
-#if defined(HAVE_XOS)
+#if XF_CFG_WORKER_STEAL
+        for (i = 0; i < cd->n_workers; ++i) {
+            xaf_proxy_destroy_worker(cd->worker + i, XF_CFG_WORKER_STEAL_THREADS, cd->worker_stack_size);
+        }
+#elif defined(HAVE_XOS)
         /* ...TENX-51553,TENA-2580: RI.2 temporary fix for XOS thread behaving inorrectly if they never execute */
         xf_worker_msg_t worker_msg = {
             .component = NULL,
@@ -1270,18 +1773,25 @@ int xf_core_deinit(UWORD32 core)
         cd->n_workers = 0;
     }
 
+#if XF_CFG_WORKER_STEAL
+    __xf_lock_destroy(&xf_steal_lock[core]);
+#endif
+
     /* ...deinitialize shared read-write memory */
     XF_CHK_API(xf_shmem_enabled(core) ? xf_shmem_deinit(core) : 0);
 
     /* ...deinitialize IPI subsystem */
     XF_CHK_API(xf_ipi_deinit(core));
+
+    /* ...release event trace ring */
+    xf_trace_ring_deinit(core);
  
 #if 0
     xf_sync_queue_deinit(&cd->response);
 #endif
     xf_sync_queue_deinit(&cd->queue);
 
-    xf_sched_deinit(&cd->sched);
+    xf_sched_deinit(&cd->sched, core);
 
     xf_irq_deinit_backend();
 
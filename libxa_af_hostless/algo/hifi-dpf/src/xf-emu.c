@@ -0,0 +1,272 @@
+/*
+* Copyright (c) 2015-2021 Cadence Design Systems Inc.
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/*******************************************************************************
+ * xf-emu.c
+ *
+ * In-process DSP emulator for host-native Linux build. Runs DSP core executive
+ * in a separate thread over shared memory region provided by the host proxy;
+ * replaces rpmsg transport of DSP firmware with message queues and a direct
+ * response callback.
+ ******************************************************************************/
+
+#define MODULE_TAG                      EMU
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+
+#include "xf-dp.h"
+#include "xf-emu-if.h"
+
+/*******************************************************************************
+ * Global data definition
+ ******************************************************************************/
+
+xf_dsp_t *xf_g_dsp;
+
+/* ...emulator state */
+static struct {
+    /* ...DSP core executive thread */
+    xf_thread_t     thread;
+
+    /* ...command/response message queues */
+    ipc_msgq_t      msgq;
+
+    /* ...response delivery callback */
+    xf_emu_response_cb *response;
+    void               *response_arg;
+
+    /* ...DSP context */
+    xf_dsp_t        dsp;
+
+}   xf_emu;
+
+/*******************************************************************************
+ * IPC layer
+ ******************************************************************************/
+
+int ipc_msgq_init(xf_msgq_t *cmdq, xf_msgq_t *respq, xf_event_t **msgq_event)
+{
+    ipc_msgq_t *q = &xf_emu.msgq;
+
+    /* ...queues are created before DSP thread is started */
+    XF_CHK_ERR(q->init_done, XAF_INVALIDVAL_ERR);
+
+    *cmdq       = q->cmd_msgq;
+    *respq      = q->resp_msgq;
+    *msgq_event = &q->msgq_event;
+
+    return 0;
+}
+
+int ipc_msgq_delete(xf_msgq_t *cmdq, xf_msgq_t *respq)
+{
+    *cmdq = *respq = NULL;
+
+    return 0;
+}
+
+/* ...system-specific IPC layer initialization */
+int xf_ipc_init(UWORD32 core)
+{
+    xf_core_data_t     *cd = XF_CORE_DATA(core);
+    xf_core_ro_data_t  *ro = XF_CORE_RO_DATA(core);
+    xf_shmem_data_t    *shmem = (xf_shmem_data_t *) xf_g_dsp->xf_ap_shmem_buffer;
+
+    /* ...initialize pointer to shared memory */
+    cd->shmem = (xf_shmem_handle_t *)shmem;
+
+    /* ...global memory pool initialization */
+    XF_CHK_API(xf_mm_init(&cd->shared_pool, (shmem->buffer),
+                          (xf_g_dsp->xf_ap_shmem_buffer_size - (sizeof(xf_shmem_data_t) - XF_CFG_REMOTE_IPC_POOL_SIZE))));
+
+    /* ...open message queue interface */
+    XF_CHK_API(ipc_msgq_init(&ro->ipc.cmd_msgq, &ro->ipc.resp_msgq, &ro->ipc.msgq_event));
+
+    return 0;
+}
+
+/* ...system-specific IPC layer deinitialization */
+int xf_ipc_deinit(UWORD32 core)
+{
+    xf_core_data_t     *cd = XF_CORE_DATA(core);
+    xf_core_ro_data_t  *ro = XF_CORE_RO_DATA(core);
+
+    XF_CHK_API(xf_mm_deinit(&cd->shared_pool));
+
+    ipc_msgq_delete(&ro->ipc.cmd_msgq, &ro->ipc.resp_msgq);
+
+    return 0;
+}
+
+/* ...forward pending responses to the host proxy */
+void rpmsg_response(UWORD32 core)
+{
+    xf_core_ro_data_t  *ro = XF_CORE_RO_DATA(core);
+    xf_proxy_message_t  msg;
+
+    while (!__xf_msgq_empty(ro->ipc.resp_msgq))
+    {
+        if (__xf_msgq_recv(ro->ipc.resp_msgq, &msg, sizeof(msg)) != XAF_NO_ERR)
+            return;
+
+        TRACE(RSP, _b("resp... %x, %x, %x"), msg.session_id, msg.opcode, msg.length);
+
+        xf_emu.response(xf_emu.response_arg, &msg, sizeof(msg));
+    }
+}
+
+/*******************************************************************************
+ * DSP core thread
+ ******************************************************************************/
+
+static void *xf_emu_dsp_entry(void *arg)
+{
+    UWORD32     core = 0;
+
+    /* ...service commands until host requests shutdown */
+    while (xf_ipi_wait(core))
+    {
+        xf_core_service(core);
+    }
+
+    xf_core_deinit(core);
+
+    return NULL;
+}
+
+/*******************************************************************************
+ * API functions
+ ******************************************************************************/
+
+int xf_emu_dsp_start(void *shmem, UWORD32 size, xf_emu_response_cb *response, void *arg)
+{
+    ipc_msgq_t *q = &xf_emu.msgq;
+    int         i;
+
+    XF_CHK_ERR(size > XF_EMU_LOCAL_POOL_SIZE + sizeof(xf_shmem_data_t), XAF_INVALIDVAL_ERR);
+
+    memset(&xf_emu.dsp, 0, sizeof(xf_emu.dsp));
+    xf_g_dsp = &xf_emu.dsp;
+    xf_emu.response = response;
+    xf_emu.response_arg = arg;
+
+    /* ...split region into shared pool and DSP local pool as firmware does */
+    xf_g_dsp->xf_ap_shmem_buffer       = (UWORD8 *)shmem;
+    xf_g_dsp->xf_ap_shmem_buffer_size  = size - XF_EMU_LOCAL_POOL_SIZE;
+    xf_g_dsp->xf_dsp_local_buffer      = (UWORD8 *)shmem + size - XF_EMU_LOCAL_POOL_SIZE;
+    xf_g_dsp->xf_dsp_local_buffer_size = XF_EMU_LOCAL_POOL_SIZE;
+
+    XF_CHK_API(xf_mm_init(&(xf_g_dsp->xf_core_data[0]).local_pool, xf_g_dsp->xf_dsp_local_buffer, xf_g_dsp->xf_dsp_local_buffer_size));
+
+    /* ...message queues must exist before host may post commands */
+    q->cmd_msgq = __xf_msgq_create(SEND_MSGQ_ENTRIES, sizeof(xf_proxy_message_t));
+    q->resp_msgq = __xf_msgq_create(RECV_MSGQ_ENTRIES, sizeof(xf_proxy_message_t));
+    if (q->cmd_msgq == NULL || q->resp_msgq == NULL)
+    {
+        TRACE(ERROR, _x("Out-of-memory"));
+        goto err_msgq;
+    }
+
+    __xf_event_init(&q->msgq_event, 0xffff);
+    q->init_done = 1;
+
+    for (i = 0; i < XAF_MAX_WORKER_THREADS; i++)
+    {
+        xf_g_dsp->xf_core_data[0].worker_thread_scratch_size[i] = 1024*4*16;
+    }
+
+    if (xf_core_init(0) != 0)
+    {
+        TRACE(ERROR, _x("DSP core initialization failed"));
+        goto err_core;
+    }
+
+    if (__xf_thread_create(&xf_emu.thread, xf_emu_dsp_entry, NULL,
+                           "DSP-emulator", NULL, 0, 0))
+    {
+        TRACE(ERROR, _x("DSP thread creation failed"));
+        xf_core_deinit(0);
+        goto err_core;
+    }
+
+    TRACE(INFO, _b("DSP emulator started"));
+
+    return 0;
+
+err_core:
+    __xf_event_destroy(&q->msgq_event);
+    q->init_done = 0;
+err_msgq:
+    if (q->cmd_msgq)
+        __xf_msgq_destroy(q->cmd_msgq);
+    if (q->resp_msgq)
+        __xf_msgq_destroy(q->resp_msgq);
+    q->cmd_msgq = q->resp_msgq = NULL;
+    return XAF_INVALIDVAL_ERR;
+}
+
+int xf_emu_dsp_command(const void *msg, UWORD32 length)
+{
+    ipc_msgq_t         *q = &xf_emu.msgq;
+    const UWORD8       *m = msg;
+    int                 r = XAF_NO_ERR;
+
+    XF_CHK_ERR(length && (length % sizeof(xf_proxy_message_t)) == 0, XAF_INVALIDVAL_ERR);
+
+    /* ...pass messages to DSP */
+    for ( ; length; m += sizeof(xf_proxy_message_t), length -= sizeof(xf_proxy_message_t))
+    {
+        /* ...queue is shorter than batch; let DSP drain it before blocking */
+        if (__xf_msgq_full(q->cmd_msgq))
+            __xf_event_set(&q->msgq_event, CMD_MSGQ_READY);
+
+        if ((r = __xf_msgq_send(q->cmd_msgq, m, sizeof(xf_proxy_message_t))) != XAF_NO_ERR)
+            break;
+    }
+
+    /* ...kick core executive once for the whole batch */
+    __xf_event_set(&q->msgq_event, CMD_MSGQ_READY);
+
+    return r;
+}
+
+void xf_emu_dsp_stop(void)
+{
+    ipc_msgq_t *q = &xf_emu.msgq;
+
+    if (!q->init_done)
+        return;
+
+    /* ...let DSP thread leave service loop and deinitialize core */
+    __xf_event_set(&q->msgq_event, DSP_DIE_MSGQ_ENTRY);
+    __xf_thread_join(&xf_emu.thread, NULL);
+
+    __xf_msgq_destroy(q->cmd_msgq);
+    __xf_msgq_destroy(q->resp_msgq);
+    __xf_event_destroy(&q->msgq_event);
+    q->cmd_msgq = q->resp_msgq = NULL;
+    q->init_done = 0;
+
+    TRACE(INFO, _b("DSP emulator stopped"));
+}
@@ -41,11 +41,14 @@
 /* ...initialize input port structure */
 int xf_input_port_init(xf_input_port_t *port, UWORD32 size, UWORD32 align, UWORD32 core)
 {
+    /* ...internal buffer has a headroom to avoid moving data on every consume */
+    port->size = (size ? size + XF_CFG_INPUT_PORT_HEADROOM(size) : 0);
+
     /* ...allocate local internal buffer of particular size and alignment */
     if (size)
     {
         /* ...internal buffer is used */
-        XF_CHK_ERR(port->buffer = xf_mem_alloc(size, align, core, 0), XAF_MEMORY_ERR);
+        XF_CHK_ERR(port->buffer = xf_mem_alloc(port->size, align, core, 0), XAF_MEMORY_ERR);
     }
     else
     {
@@ -58,12 +61,15 @@ int xf_input_port_init(xf_input_port_t *port, UWORD32 size, UWORD32 align, UWORD
     
     /* ...set buffer size */
     port->length = size;
+
+    /* ...save alignment requirement of data start */
+    port->align = (align ? align : 1);
     
     /* ...enable input by default */
     port->flags = XF_INPUT_FLAG_ENABLED | XF_INPUT_FLAG_CREATED;
 
     /* ...mark buffer is empty */
-    port->filled = 0, port->access = NULL;
+    port->filled = 0, port->offset = 0, port->access = NULL, port->ts = 0;
     
     TRACE(INIT, _b("input-port[%p] created - %p@%u[%u]"), port, port->buffer, align, size);
 
@@ -107,6 +113,9 @@ int xf_input_port_put(xf_input_port_t *port, xf_message_t *m)
         /* ...first message put - set access pointer and length */
         port->access = m->buffer, port->remaining = m->length;
 
+        /* ...nothing buffered - data at read position comes from this message */
+        (port->filled == 0 ? port->ts = m->ts : 0);
+
 #if 1
         /* ...if first message is empty, mark port is done */
         /* ...The state change is not required here and is done in input_port_fill */
@@ -123,8 +132,8 @@ int xf_input_port_put(xf_input_port_t *port, xf_message_t *m)
     }
 }
 
-/* ...internal helper - input message completion */
-static inline int xf_input_port_complete(xf_input_port_t *port)
+/* ...internal helper - input message completion (or hand-over to "hold" queue) */
+static inline int __xf_input_port_complete(xf_input_port_t *port, xf_msg_queue_t *hold)
 {
     /* ...dequeue message from queue */
     xf_message_t   *m = xf_msg_dequeue(&port->queue);
@@ -133,7 +142,7 @@ static inline int xf_input_port_complete(xf_input_port_t *port)
     BUG(m == NULL, _x("invalid port state"));
 
     /* ...complete current message (EMPTY-THIS-BUFFER always; no length adjustment) */
-    xf_response(m);
+    (hold ? (void)xf_msg_enqueue(hold, m) : xf_response(m));
 
     /* ...set up next head */
     if ((m = xf_msg_queue_head(&port->queue)) != NULL)
@@ -141,6 +150,9 @@ static inline int xf_input_port_complete(xf_input_port_t *port)
         /* ...set new access pointers */
         port->access = m->buffer, port->remaining = m->length;
 
+        /* ...read position moves to the next message unless buffered data precedes it */
+        (port->filled == 0 ? port->ts = m->ts : 0);
+
         /* ...return indication that there is an input message */
         return 1;
     }
@@ -154,6 +166,12 @@ static inline int xf_input_port_complete(xf_input_port_t *port)
     }
 }
 
+/* ...internal helper - input message completion */
+static inline int xf_input_port_complete(xf_input_port_t *port)
+{
+    return __xf_input_port_complete(port, NULL);
+}
+
 /* ...fill-in required amount of data into input port buffer */
 int xf_input_port_fill(xf_input_port_t *port)
 {
@@ -161,17 +179,47 @@ int xf_input_port_fill(xf_input_port_t *port)
     UWORD32     remaining = port->remaining;
     UWORD32     copied = 0;
     WORD32     n;
+    xf_message_t   *m;
+    UWORD32     ts;
 
     /* ...function shall not be called if no internal buffering is used */
     BUG(xf_input_port_bypass(port), _x("Invalid transaction"));
 
     /* ...if there is no message pending, bail out */
-    if (!xf_msg_queue_head(&port->queue))
+    if ((m = xf_msg_queue_head(&port->queue)) == NULL)
     {
         TRACE(INPUT, _b("No message ready"));
         return 0;
     }
     
+    /* ...data is already accessed in-place */
+    if (port->flags & XF_INPUT_FLAG_DIRECT)
+    {
+        return 1;
+    }
+
+    /* ...buffered frame is stamped with its oldest data */
+    ts = (filled ? port->ts : m->ts);
+
+    /* ...nothing buffered and current message has a full frame - use it in-place */
+    if (filled == 0 && remaining >= port->length && ((UWORD32)(uintptr_t)port->access & (port->align - 1)) == 0)
+    {
+        port->flags ^= XF_INPUT_FLAG_DIRECT, port->filled = port->length;
+
+        TRACE(INPUT, _b("input-port[%p]: direct access %p"), port, port->access);
+
+        xf_trace_event(XF_MSG_DST_CORE(m->id), XAF_TRACE_EV_PORT_FILL, 1, m->id, port->length);
+
+        return 1;
+    }
+
+    /* ...move buffered data to the head if frame doesn't fit or start is misaligned */
+    if (port->offset + port->length > port->size || (port->offset & (port->align - 1)))
+    {
+        memmove(port->buffer, port->buffer + port->offset, filled);
+        port->offset = 0;
+    }
+
     /* ...calculate total amount of bytes we need to copy */
     n = (WORD32)(port->length - filled);
     
@@ -206,7 +254,7 @@ int xf_input_port_fill(xf_input_port_t *port)
         BUG(!port->access, _x("invalid port state"));
             
         /* ...get required amount from input buffer */
-        memcpy(port->buffer + filled, port->access, k), port->access += k;
+        memcpy(port->buffer + port->offset + filled, port->access, k), port->access += k;
         
         /* ...advance buffer positions */
         filled += k, copied += k, n -= k;
@@ -229,13 +277,16 @@ int xf_input_port_fill(xf_input_port_t *port)
 
     /* ...update buffer positions */
     port->filled = filled, port->remaining = remaining;
+    port->ts = ts;
+
+    xf_trace_event(XF_MSG_DST_CORE(m->id), XAF_TRACE_EV_PORT_FILL, 0, m->id, copied);
     
     /* ...return indicator whether input buffer is prefilled */
     return (n == 0);
 }
 
 /* ...consume input buffer data */
-void xf_input_port_consume(xf_input_port_t *port, UWORD32 n)
+static inline void __xf_input_port_consume(xf_input_port_t *port, UWORD32 n, xf_msg_queue_t *hold)
 {
     /* ...check whether input port is in bypass mode */
     if (xf_input_port_bypass(port))
@@ -244,7 +295,7 @@ void xf_input_port_consume(xf_input_port_t *port, UWORD32 n)
         if ((port->remaining -= n) == 0)
         {
             /* ...complete message and try to rearm input port */
-            xf_input_port_complete(port);
+            __xf_input_port_complete(port, hold);
 
             /* ...check if end-of-stream flag is set */
             if (xf_msg_queue_head(&port->queue) && !port->access)
@@ -263,23 +314,46 @@ void xf_input_port_consume(xf_input_port_t *port, UWORD32 n)
             port->access += n;
         }
     }
-    else if (port->filled > n)
+    else if (port->flags & XF_INPUT_FLAG_DIRECT)
     {
-        UWORD32     k = port->filled - n;
-        
-        /* ...move tail of buffer to the head (safe to use memcpy) */
-        memcpy(port->buffer, port->buffer + n, k);        
+        /* ...in-place access is over; unconsumed data stays in the message */
+        port->flags ^= XF_INPUT_FLAG_DIRECT, port->filled = 0;
 
-        /* ...adjust filled position */
-        port->filled = k;
+        if ((port->remaining -= n) == 0)
+        {
+            /* ...complete message; zero-length one is processed by next fill */
+            __xf_input_port_complete(port, hold);
+        }
+        else
+        {
+            /* ...advance message buffer pointer */
+            port->access += n;
+        }
+    }
+    else if (port->filled > n)
+    {
+        /* ...advance read position; data is moved on next fill only if needed */
+        port->offset += n, port->filled -= n;
     }
     else
     {
         /* ...entire buffer is consumed; reset fill level */
-        port->filled = 0;
+        port->filled = 0, port->offset = 0;
     }
 }
 
+void xf_input_port_consume(xf_input_port_t *port, UWORD32 n)
+{
+    __xf_input_port_consume(port, n, NULL);
+}
+
+/* ...consume input data accessed in-place, keeping completed messages in "hold" queue;
+ * the sink returns them once it no longer references the buffers (e.g. DMA played them) */
+void xf_input_port_consume_hold(xf_input_port_t *port, UWORD32 n, xf_msg_queue_t *hold)
+{
+    __xf_input_port_consume(port, n, hold);
+}
+
 /* ...purge input port queue */
 void xf_input_port_purge(xf_input_port_t *port)
 {
@@ -295,7 +369,7 @@ void xf_input_port_purge(xf_input_port_t *port)
     }
 
     /* ...reset internal buffer position */
-    port->filled = 0, port->access = NULL;
+    port->filled = 0, port->offset = 0, port->access = NULL;
     
     /* ...reset port flags */
     port->flags = (port->flags & ~__XF_INPUT_FLAGS(~0)) | XF_INPUT_FLAG_ENABLED | XF_INPUT_FLAG_CREATED;
@@ -340,7 +414,7 @@ void xf_input_port_destroy(xf_input_port_t *port, UWORD32 core)
     if (!xf_input_port_created(port))   return;
     
     /* ...deallocate input buffer if needed */
-    (port->buffer ? xf_mem_free(port->buffer, port->length, core, 0), port->buffer = NULL : 0);
+    (port->buffer ? xf_mem_free(port->buffer, port->size, core, 0), port->buffer = NULL : 0);
 
     /* ...reset input port flags */
     port->flags = 0;
@@ -364,6 +438,9 @@ int xf_output_port_init(xf_output_port_t *port, UWORD32 size)
     /* ...mark port is created */
     port->flags = XF_OUTPUT_FLAG_CREATED | XF_OUTPUT_FLAG_IDLE;
 
+    /* ...no data timestamp yet */
+    port->ts = 0;
+
     TRACE(INIT, _b("output-port[%p] initialized"), port);
 
     return 0;
@@ -374,9 +451,20 @@ int xf_output_port_route(xf_output_port_t *port, UWORD32 id, UWORD32 n, UWORD32
 {
     UWORD32             core = XF_MSG_DST_CORE(id);
     UWORD32             shared = XF_MSG_SHARED(id);
+    xf_component_t     *sink;
+    void               *lent[XF_CFG_PORT_LEND_MAX];
+    UWORD32             lend = 0;
     xf_message_t   *m;
     UWORD32             i;
     
+    /* ...destination on the same core may offer its own buffers (e.g. DMA periods) */
+    if (!shared && n <= XF_CFG_PORT_LEND_MAX &&
+        (sink = xf_core_component(core, XF_MSG_SRC_CLIENT(id))) != NULL && sink->lend &&
+        sink->lend(sink, XF_MSG_SRC_PORT(id), n, length, lent) == 0)
+    {
+        lend = 1;
+    }
+
     /* ...allocate message pool for a port; extra message for control */
     XF_CHK_API(xf_msg_pool_init(&port->pool, n + 1, core));
 
@@ -393,7 +481,7 @@ int xf_output_port_route(xf_output_port_t *port, UWORD32 id, UWORD32 n, UWORD32
         m->id = id;
         m->opcode = XF_FILL_THIS_BUFFER;
         m->length = length;
-        m->buffer = xf_mem_alloc(length, align, core, shared);
+        m->buffer = (lend ? lent[i - 1] : xf_mem_alloc(length, align, core, shared));
 
         /* ...if allocation failed, do a cleanup */
         if (!m->buffer)     goto error;
@@ -415,12 +503,12 @@ int xf_output_port_route(xf_output_port_t *port, UWORD32 id, UWORD32 n, UWORD32
     port->length = length;
 
     /* ...mark port is routed */
-    port->flags |= XF_OUTPUT_FLAG_ROUTED;
+    port->flags |= XF_OUTPUT_FLAG_ROUTED | (lend ? XF_OUTPUT_FLAG_LENT : 0);
 
     /* ...clear port idle flag */
     port->flags &= ~XF_OUTPUT_FLAG_IDLE;
 
-    TRACE(ROUTE, _b("output-port[%p] routed: %03x -> %03x"), port, XF_MSG_DST(id), XF_MSG_SRC(id));
+    TRACE(ROUTE, _b("output-port[%p] routed: %03x -> %03x%s"), port, XF_MSG_DST(id), XF_MSG_SRC(id), (lend ? " (lent buffers)" : ""));
 
     return 0;
 
@@ -483,8 +571,8 @@ void xf_output_port_unroute(xf_output_port_t *port)
     UWORD32             n = port->pool.n - 1;
     UWORD32             i;
     
-    /* ...free all messages (we are running on "dst" core) */
-    for (i = 1; i <= n; i++)
+    /* ...free all messages (we are running on "dst" core); lent buffers belong to the sink */
+    for (i = 1; i <= n && !(port->flags & XF_OUTPUT_FLAG_LENT); i++)
     {
         /* ...directly obtain message item */
         m = xf_msg_pool_item(&port->pool, i);
@@ -541,6 +629,11 @@ int xf_output_port_produce(xf_output_port_t *port, UWORD32 n)
     /* ...it is not permitted to invoke this when port is being unrouted (or flushed - tbd) */
     BUG(xf_output_port_unrouting(port), _x("invalid transaction"));
 
+    xf_trace_event(XF_MSG_DST_CORE(m->id), XAF_TRACE_EV_PORT_PRODUCE, 0, m->id, n);
+
+    /* ...pass data timestamp to the consumer */
+    m->ts = port->ts;
+
     /* ...complete message with specified amount of bytes produced */
     xf_response_data(m, n);
 
@@ -44,6 +44,8 @@ void xf_msg_schedule_isr(xf_message_t *m)
     UWORD32                 core = XF_MSG_DST_CORE(m->id);
     xf_core_data_t     *cd = XF_CORE_DATA(core);
     
+    xf_trace_event(core, XAF_TRACE_EV_IRQ, XF_OPCODE_TYPE(m->opcode), m->id, m->length);
+
     /* ...interrupt masking protocol is used for protecting local message queue */
     xf_sync_enqueue(&cd->queue, m);
     /* ...resume local scheduler */
@@ -150,7 +150,7 @@ static void xf_mm_find_by_addr(xf_mm_pool_t *pool, void *addr, xf_mm_block_t **n
         BUG(i > XF_DEBUG_MEM_MAX_ITERATIONS, _x("find_by_addr exceeded %d iterations"), XF_DEBUG_MEM_MAX_ITERATIONS);
 
         /* ...only "is less than" comparison is valid (as "a_node" pointer is biased) */
-        if ((UWORD32)p_idx < (UWORD32)addr)
+        if ((uintptr_t)p_idx < (uintptr_t)addr)
         {
             /* ...update lower neighbour */
             l_idx = p_idx;
@@ -219,7 +219,7 @@ static void xf_mm_insert_addr(xf_mm_pool_t *pool, xf_mm_block_t *b)
     for (p_idx = rb_root(tree); p_idx != rb_null(tree); p_idx = t_idx)
     {
         /* ...check for the address (only "is less than" comparison is valid) */
-        if ((UWORD32)p_idx < (UWORD32)b)
+        if ((uintptr_t)p_idx < (uintptr_t)b)
         {
             /* ...move towards higher addresses */
             if ((t_idx = rb_right(tree, p_idx)) == rb_null(tree))
@@ -249,44 +249,22 @@ static void xf_mm_insert_addr(xf_mm_pool_t *pool, xf_mm_block_t *b)
  * Entry points
  ******************************************************************************/
 
-/* ...block allocation */
-void * xf_mm_alloc(xf_mm_pool_t *pool, UWORD32 size)
+/* ...rb-tree block allocation (called with pool lock held) */
+static void * __xf_mm_alloc(xf_mm_pool_t *pool, UWORD32 size)
 {
-#if defined (XF_TRACE)    
-    UWORD32 osize = size;
-#endif    
     xf_mm_block_t  *b;
 
-    xf_flx_lock(&pool->lock);
-
     /* ...find best-fit free block */
     b = xf_mm_find_by_size(pool, size);
 
     /* ...check block received */
     if (b == NULL)
     {
-        xf_flx_unlock(&pool->lock);
-        TRACE(WARNING, _b("Allocation failed - out of memory: pool=%p size=%d"), pool, size);
-        return b;
+        return NULL;
     }
 
     /* ...remove the block from the L-map */
     rb_delete(&pool->l_map, &b->l_node);
-    
-    /* update the buffer utilization counters for DSP's component and framework buffers */
-    if(pool->addr == ((xf_shmem_data_t *)(xf_g_dsp->xf_ap_shmem_buffer))->buffer)
-    {
-        xf_g_dsp->dsp_frmwk_buf_size_curr += size;
-        if (xf_g_dsp->dsp_frmwk_buf_size_curr > xf_g_dsp->dsp_frmwk_buf_size_peak)
-            xf_g_dsp->dsp_frmwk_buf_size_peak = xf_g_dsp->dsp_frmwk_buf_size_curr;
-        
-    }
-    else if(pool->addr == xf_g_dsp->xf_dsp_local_buffer)
-    {
-        xf_g_dsp->dsp_comp_buf_size_curr += size;
-        if (xf_g_dsp->dsp_comp_buf_size_curr > xf_g_dsp->dsp_comp_buf_size_peak)
-            xf_g_dsp->dsp_comp_buf_size_peak = xf_g_dsp->dsp_comp_buf_size_curr;
-    }
 
     /* ...check if the size is exactly the same as requested */
     if ((size = xf_mm_block_length_sub(b, size)) == 0)
@@ -294,9 +272,7 @@ void * xf_mm_alloc(xf_mm_pool_t *pool, UWORD32 size)
         /* ...the block needs to be removed from the A-map as well */
         rb_delete(&pool->a_map, &b->a_node);
 
-        xf_flx_unlock(&pool->lock);
         /* ...entire block goes to user */
-        TRACE(INFO, _b("Allocated exact size: pool=%p buffer=%p size=%d"), pool, b, osize);
         return (void *) b;
     }
     else
@@ -304,35 +280,17 @@ void * xf_mm_alloc(xf_mm_pool_t *pool, UWORD32 size)
         /* ...insert the block into L-map */
         xf_mm_insert_size(pool, b, size);
 
-        xf_flx_unlock(&pool->lock);
-        TRACE(INFO, _b("Allocated: pool=%p buffer=%p size=%d"), pool, b, osize);
         /* ...A-map remains intact; tail of the block goes to user */
         return (void *) b + size;
     }
 }
 
-/* ...block deallocation */
-void xf_mm_free(xf_mm_pool_t *pool, void *addr, UWORD32 size)
+/* ...rb-tree block deallocation (called with pool lock held) */
+static void __xf_mm_free(xf_mm_pool_t *pool, void *addr, UWORD32 size)
 {
-#if defined (XF_TRACE)    
-    UWORD32 osize = size;
-#endif    
     xf_mm_block_t  *b = xf_mm_block_init(addr, size);
     xf_mm_block_t  *n[2];
 
-    xf_flx_lock(&pool->lock);
-
-#if 1 //TENA-2491
-    if(pool->addr == ((xf_shmem_data_t *)(xf_g_dsp->xf_ap_shmem_buffer))->buffer)
-    {
-        xf_g_dsp->dsp_frmwk_buf_size_curr -= size;
-    }
-    else if(pool->addr == xf_g_dsp->xf_dsp_local_buffer)
-    {
-        xf_g_dsp->dsp_comp_buf_size_curr -= size;
-    }
-#endif    
-
     /* ...find block neighbours in A-map */
     xf_mm_find_by_addr(pool, addr, n);
 
@@ -392,19 +350,258 @@ void xf_mm_free(xf_mm_pool_t *pool, void *addr, UWORD32 size)
     
     /* ...add (new or adjusted) block into L-map */
     xf_mm_insert_size(pool, b, size);
+}
+
+/*******************************************************************************
+ * Slab caches
+ ******************************************************************************/
+
+/* ...size classes table */
+static const UWORD32 xf_mm_slab_size[XF_MM_SLAB_NUM] = { XF_CFG_MM_SLAB_CLASSES };
+
+/* ...pool memory past slab data must stay descriptor-aligned */
+C_BUG(XF_MM_SLAB_DATA_SIZE % sizeof(xf_mm_block_t));
+
+/* ...slab data of the pool */
+static inline xf_mm_slab_data_t * xf_mm_slab_data(xf_mm_pool_t *pool)
+{
+    return (xf_mm_slab_data_t *)pool->addr;
+}
+
+/* ...find size class of the block; return -1 if block is not cached */
+static inline WORD32 xf_mm_slab_class(UWORD32 size)
+{
+    WORD32  i;
+
+    for (i = 0; i < (WORD32)XF_MM_SLAB_NUM; i++)
+        if (size <= xf_mm_slab_size[i])
+            return i;
+
+    return -1;
+}
+
+/* ...return cached objects of all classes to rb-tree maps (called with pool lock held) */
+static void __xf_mm_reap(xf_mm_pool_t *pool)
+{
+    xf_mm_slab_t   *slab;
+    void           *p;
+    UWORD32         i;
+
+    for (slab = &xf_mm_slab_data(pool)->slab[i = 0]; i < XF_MM_SLAB_NUM; i++, slab++)
+    {
+        while ((p = slab->head) != NULL)
+        {
+            slab->head = *(void **)p, slab->cached--;
+            __xf_mm_free(pool, p, xf_mm_slab_size[i]);
+        }
+    }
+}
+
+/* ...allocate from rb-tree maps, releasing slab caches if pool is exhausted */
+static void * __xf_mm_alloc_reap(xf_mm_pool_t *pool, UWORD32 size)
+{
+    void   *p;
+
+    if ((p = __xf_mm_alloc(pool, size)) == NULL)
+    {
+        __xf_mm_reap(pool);
+        p = __xf_mm_alloc(pool, size);
+    }
+
+    return p;
+}
+
+/* ...allocate object of given class (called with pool lock held) */
+static void * __xf_mm_slab_alloc(xf_mm_pool_t *pool, WORD32 i)
+{
+    xf_mm_slab_data_t  *sd = xf_mm_slab_data(pool);
+    xf_mm_slab_t   *slab = &sd->slab[i];
+    UWORD32         size = xf_mm_slab_size[i];
+    UWORD32         n;
+    void           *p;
+
+    /* ...fast path - take cached object */
+    if ((p = slab->head) != NULL)
+    {
+        slab->head = *(void **)p, slab->cached--;
+        sd->slab_hits++;
+        return p;
+    }
+
+    /* ...carve a run of objects so that they stay adjacent in memory */
+    n = (size < XF_CFG_MM_SLAB_BYTES ? XF_CFG_MM_SLAB_BYTES / size : 1);
+
+    if ((p = __xf_mm_alloc(pool, n * size)) == NULL)
+    {
+        /* ...fallback to single object */
+        if ((p = __xf_mm_alloc_reap(pool, size)) == NULL)
+            return NULL;
+
+        n = 1;
+    }
+
+    sd->slab_refills++;
+
+    /* ...first object goes to user, the rest is cached */
+    while (--n)
+    {
+        void   *q = p + n * size;
+
+        *(void **)q = slab->head, slab->head = q, slab->cached++;
+    }
+
+    return p;
+}
+
+/* ...return object of given class to cache (called with pool lock held) */
+static inline void __xf_mm_slab_free(xf_mm_pool_t *pool, WORD32 i, void *p)
+{
+    xf_mm_slab_t   *slab = &xf_mm_slab_data(pool)->slab[i];
+
+    *(void **)p = slab->head, slab->head = p, slab->cached++;
+}
+
+/*******************************************************************************
+ * Entry points
+ ******************************************************************************/
+
+/* ...block allocation */
+void * xf_mm_alloc(xf_mm_pool_t *pool, UWORD32 size)
+{
+    xf_mm_slab_data_t  *sd = xf_mm_slab_data(pool);
+    void   *p;
+    WORD32  i;
+
+    xf_flx_lock(&pool->lock);
+
+    /* ...common sizes are served from slab caches; others go to rb-tree maps */
+    if ((i = xf_mm_slab_class(size)) >= 0)
+        p = __xf_mm_slab_alloc(pool, i);
+    else
+        p = __xf_mm_alloc_reap(pool, size);
+
+    /* ...check block received */
+    if (p == NULL)
+    {
+        xf_flx_unlock(&pool->lock);
+        TRACE(WARNING, _b("Allocation failed - out of memory: pool=%p size=%d"), pool, size);
+        return p;
+    }
+
+    /* ...update pool utilization counters */
+    if ((sd->used += size) > sd->peak)
+        sd->peak = sd->used;
+
+    /* update the buffer utilization counters for DSP's component and framework buffers */
+    if(pool->addr == ((xf_shmem_data_t *)(xf_g_dsp->xf_ap_shmem_buffer))->buffer)
+    {
+        xf_g_dsp->dsp_frmwk_buf_size_curr += size;
+        if (xf_g_dsp->dsp_frmwk_buf_size_curr > xf_g_dsp->dsp_frmwk_buf_size_peak)
+            xf_g_dsp->dsp_frmwk_buf_size_peak = xf_g_dsp->dsp_frmwk_buf_size_curr;
+        
+    }
+    else if(pool->addr == xf_g_dsp->xf_dsp_local_buffer)
+    {
+        xf_g_dsp->dsp_comp_buf_size_curr += size;
+        if (xf_g_dsp->dsp_comp_buf_size_curr > xf_g_dsp->dsp_comp_buf_size_peak)
+            xf_g_dsp->dsp_comp_buf_size_peak = xf_g_dsp->dsp_comp_buf_size_curr;
+    }
+
+    xf_flx_unlock(&pool->lock);
+    TRACE(INFO, _b("Allocated: pool=%p buffer=%p size=%d"), pool, p, size);
+    return p;
+}
+
+/* ...block deallocation */
+void xf_mm_free(xf_mm_pool_t *pool, void *addr, UWORD32 size)
+{
+    WORD32  i;
+
+    xf_flx_lock(&pool->lock);
+
+    /* ...update pool utilization counters */
+    xf_mm_slab_data(pool)->used -= size;
+
+#if 1 //TENA-2491
+    if(pool->addr == ((xf_shmem_data_t *)(xf_g_dsp->xf_ap_shmem_buffer))->buffer)
+    {
+        xf_g_dsp->dsp_frmwk_buf_size_curr -= size;
+    }
+    else if(pool->addr == xf_g_dsp->xf_dsp_local_buffer)
+    {
+        xf_g_dsp->dsp_comp_buf_size_curr -= size;
+    }
+#endif    
+
+    /* ...put block back to slab cache or to rb-tree maps */
+    if ((i = xf_mm_slab_class(size)) >= 0)
+        __xf_mm_slab_free(pool, i, addr);
+    else
+        __xf_mm_free(pool, addr, size);
+
+    xf_flx_unlock(&pool->lock);
+    TRACE(INFO, _b("Freed: pool=%p addr=%p size=%d"), pool, addr, size);
+}
+
+/* ...return all slab-cached objects to the pool */
+void xf_mm_reap(xf_mm_pool_t *pool)
+{
+    xf_flx_lock(&pool->lock);
+    __xf_mm_reap(pool);
+    xf_flx_unlock(&pool->lock);
+}
+
+/* ...accumulate free blocks statistics over L-map subtree */
+static void xf_mm_stats_walk(rb_tree_t *tree, rb_idx_t idx, xf_mm_stats_t *stats)
+{
+    UWORD32     length;
+
+    for (; idx != rb_null(tree); idx = rb_right(tree, idx))
+    {
+        length = xf_mm_block_length(container_of(idx, xf_mm_block_t, l_node));
+
+        stats->free += length, stats->free_blocks++;
+        (length > stats->largest_free ? stats->largest_free = length : 0);
+
+        xf_mm_stats_walk(tree, rb_left(tree, idx), stats);
+    }
+}
+
+/* ...retrieve pool statistics */
+void xf_mm_get_stats(xf_mm_pool_t *pool, xf_mm_stats_t *stats)
+{
+    xf_mm_slab_data_t  *sd = xf_mm_slab_data(pool);
+    UWORD32     i;
+
+    memset(stats, 0, sizeof(*stats));
+
+    xf_flx_lock(&pool->lock);
+
+    stats->size = pool->size - XF_MM_SLAB_DATA_SIZE;
+    stats->used = sd->used;
+    stats->peak = sd->peak;
+    stats->slab_hits = sd->slab_hits;
+    stats->slab_refills = sd->slab_refills;
+
+    for (i = 0; i < XF_MM_SLAB_NUM; i++)
+        stats->cached += sd->slab[i].cached * xf_mm_slab_size[i];
+
+    xf_mm_stats_walk(&pool->l_map, rb_root(&pool->l_map), stats);
 
     xf_flx_unlock(&pool->lock);
-    TRACE(INFO, _b("Freed: pool=%p addr=%p size=%d"), pool, addr, osize);
 }
 
 /* ...initialize memory allocator */
 int xf_mm_init(xf_mm_pool_t *pool, void *addr, UWORD32 size)
 {
     /* ...check pool alignment validity */
-    XF_CHK_ERR(((UWORD32)addr & (sizeof(xf_mm_block_t) - 1)) == 0, XAF_INVALIDVAL_ERR);
+    XF_CHK_ERR(((uintptr_t)addr & (sizeof(xf_mm_block_t) - 1)) == 0, XAF_INVALIDVAL_ERR);
 
     /* ...check pool size validity */
     XF_CHK_ERR(((size) & (sizeof(xf_mm_block_t) - 1)) == 0, XAF_INVALIDVAL_ERR);
+
+    /* ...pool must hold slab data and at least one block */
+    XF_CHK_ERR(size > XF_MM_SLAB_DATA_SIZE, XAF_INVALIDVAL_ERR);
     
     /* ...set pool parameters (need that stuff at all? - tbd) */    
     pool->addr = addr, pool->size = size;
@@ -412,10 +609,13 @@ int xf_mm_init(xf_mm_pool_t *pool, void *addr, UWORD32 size)
     /* ...initialize rb-trees */
     rb_init(&pool->l_map), rb_init(&pool->a_map);
 
+    /* ...slab caches are empty */
+    memset(xf_mm_slab_data(pool), 0, XF_MM_SLAB_DATA_SIZE);
+
     xf_flx_lock_init(&pool->lock, XF_DUMMY_LOCK);
 
-    /* ..."free" the entire block */
-    xf_mm_free(pool, addr, size);
+    /* ..."free" the entire block past slab data */
+    __xf_mm_free(pool, addr + XF_MM_SLAB_DATA_SIZE, size - XF_MM_SLAB_DATA_SIZE);
 
     TRACE(INIT, _b("memory allocator initialized: [%p..%p)"), addr, addr + size);
 
@@ -156,6 +156,9 @@ static UWORD32 xf_shmem_process_input(UWORD32 core)
         m->length = command.length;
         m->buffer = xf_ipc_a2b(core, command.address);
 
+        /* ...data enters the graph; stamp it for latency measurement */
+        m->ts = (m->opcode == XF_EMPTY_THIS_BUFFER ? xf_latency_stamp() : 0);
+
         TRACE(CMD, _b("C[%08x]:(%08x,%u,%p)"), m->id, m->opcode, m->length, m->buffer);
 
         /* ...invalidate message buffer contents as required - not here - tbd */
@@ -150,6 +150,19 @@ int xf_ipc_send(xf_proxy_ipc_data_t *ipc, xf_proxy_msg_t *msg, void *b)
     return 0;
 }
 
+/* ...pass several commands to remote DSP; message queue takes them one by one */
+int xf_ipc_send_batch(xf_proxy_ipc_data_t *ipc, xf_proxy_msg_t *msg, UWORD32 num, UWORD32 *posted)
+{
+    UWORD32     i;
+
+    for (i = 0; i < num; i++)
+        xf_ipc_send(ipc, &msg[i], NULL);
+
+    *posted = num;
+
+    return 0;
+}
+
 int xf_ipc_wait(xf_proxy_ipc_data_t *ipc, UWORD32 timeout)
 {
     __xf_event_wait_any(ipc->msgq_event, RESP_MSGQ_READY | DIE_MSGQ_ENTRY);
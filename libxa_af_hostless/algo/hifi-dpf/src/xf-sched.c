@@ -34,6 +34,7 @@
 
 #include "xf-dp.h"
 
+#if !XF_CFG_SCHED_WHEEL
 
 /* ...current scheduler timestamp */
 static inline UWORD32 xf_sched_timestamp(xf_sched_t *sched)
@@ -174,12 +175,235 @@ UWORD32 xf_sched_cancel(xf_sched_t *sched, xf_task_t *t)
 }
 
 /* ...initialize scheduler data */
-void xf_sched_init(xf_sched_t *sched)
+int xf_sched_init(xf_sched_t *sched, UWORD32 core)
 {
     xf_flx_lock_init(&sched->lock, XF_DUMMY_LOCK);
     rb_init(&sched->tree);
+
+    return 0;
+}
+
+#else
+
+/*******************************************************************************
+ * Timing wheel
+ *
+ * Tasks are hashed into buckets by timestamp bits [shift, shift + log2(size));
+ * non-empty buckets are tracked in a bitmap, so that the earliest bucket is
+ * found with a couple of count-trailing-zeroes operations. Every bucket keeps
+ * its tasks sorted by timestamp (FIFO for equal timestamps). Tasks scheduled
+ * beyond the wheel horizon are kept in a sorted overflow list. The rb-node
+ * fields of the task are reused: "parent" points to the owning list (NULL if
+ * task is not scheduled), "left"/"right" are previous/next list items.
+ ******************************************************************************/
+
+#define XF_SCHED_WHEEL_MASK             (XF_CFG_SCHED_WHEEL_SIZE - 1)
+#define XF_SCHED_WHEEL_SPAN             ((UWORD32)XF_CFG_SCHED_WHEEL_SIZE << XF_CFG_SCHED_WHEEL_SHIFT)
+#define XF_SCHED_MAP_WORDS              (XF_CFG_SCHED_WHEEL_SIZE / 32)
+
+/* ...bucket index of the timestamp */
+static inline UWORD32 xf_sched_bucket_idx(UWORD32 ts)
+{
+    return (ts >> XF_CFG_SCHED_WHEEL_SHIFT) & XF_SCHED_WHEEL_MASK;
+}
+
+/* ...insert task into sorted list, after all tasks with same timestamp */
+static inline void xf_sched_list_insert(xf_sched_list_t *list, xf_task_t *t, UWORD32 ts)
+{
+    xf_task_t  *p;
+
+    /* ...most tasks go to the tail; search backward */
+    for (p = list->tail; p && xf_timestamp_before(ts, xf_task_timestamp(p)); p = p->left)
+        ;
+
+    t->parent = (rb_idx_t)list;
+    t->left = p;
+
+    if (p)
+    {
+        t->right = p->right, p->right = t;
+    }
+    else
+    {
+        t->right = list->head, list->head = t;
+    }
+
+    if (t->right)
+        t->right->left = t;
+    else
+        list->tail = t;
+}
+
+/* ...remove task from its list */
+static inline void xf_sched_list_remove(xf_sched_list_t *list, xf_task_t *t)
+{
+    if (t->left)
+        t->left->right = t->right;
+    else
+        list->head = t->right;
+
+    if (t->right)
+        t->right->left = t->left;
+    else
+        list->tail = t->left;
+
+    /* ...mark task as not scheduled */
+    t->parent = t->left = t->right = NULL;
+}
+
+/* ...find first non-empty bucket starting from bucket "idx" (wrapping) */
+static inline WORD32 xf_sched_map_scan(xf_sched_t *sched, UWORD32 idx)
+{
+    UWORD32     w = idx >> 5, bit = idx & 31;
+    UWORD32     k, m;
+
+    /* ...first word is scanned twice: high bits at start, low bits at wrap */
+    for (k = 0; k <= XF_SCHED_MAP_WORDS; k++, w = (w + 1) % XF_SCHED_MAP_WORDS)
+    {
+        m = sched->wheel->map[w];
+
+        if (k == 0)
+            m &= ~0U << bit;
+        else if (k == XF_SCHED_MAP_WORDS)
+            m &= ~(~0U << bit);
+
+        if (m)
+            return (WORD32)((w << 5) + __builtin_ctz(m));
+    }
+
+    return -1;
+}
+
+/*******************************************************************************
+ * Global functions definitions
+ ******************************************************************************/
+
+/* ...place task into scheduler queue */
+void xf_sched_put(xf_sched_t *sched, xf_task_t *t, UWORD32 dts)
+{
+    UWORD32     ts, base, b;
+
+    xf_flx_lock(&sched->lock);
+
+    /* ...set scheduling timestamp (last bit is not used) */
+    xf_task_timestamp_set(t, sched->timestamp + dts);
+    ts = xf_task_timestamp(t);
+
+    /* ...wheel is anchored at the bucket of current timestamp */
+    base = sched->timestamp & ~(((UWORD32)1 << XF_CFG_SCHED_WHEEL_SHIFT) - 1);
+
+    if (ts - base < XF_SCHED_WHEEL_SPAN)
+    {
+        b = xf_sched_bucket_idx(ts);
+        xf_sched_list_insert(&sched->wheel->bucket[b], t, ts);
+        sched->wheel->map[b >> 5] |= 1U << (b & 31);
+    }
+    else
+    {
+        /* ...too far in the future */
+        xf_sched_list_insert(&sched->overflow, t, ts);
+    }
+
+    TRACE(DEBUG, _b("in:  %08x:[%p] (ts:%08x)"), ts, t, sched->timestamp);
+    xf_flx_unlock(&sched->lock);
 }
 
+/* ...get first item from the scheduler */
+xf_task_t * xf_sched_get(xf_sched_t *sched)
+{
+    xf_sched_list_t    *list = NULL;
+    xf_task_t          *t;
+    WORD32              b;
+    UWORD32             ts;
+
+    xf_flx_lock(&sched->lock);
+
+    /* ...earliest non-empty bucket */
+    if ((b = xf_sched_map_scan(sched, xf_sched_bucket_idx(sched->timestamp))) >= 0)
+    {
+        list = &sched->wheel->bucket[b];
+    }
+
+    /* ...overflow tasks of equal timestamp were scheduled earlier */
+    if ((t = sched->overflow.head) != NULL)
+    {
+        if (!list || !xf_timestamp_before(xf_task_timestamp(list->head), xf_task_timestamp(t)))
+        {
+            list = &sched->overflow, b = -1;
+        }
+    }
+
+    if (list)
+    {
+        t = list->head;
+        xf_sched_list_remove(list, t);
+
+        /* ...clear bucket bit if needed */
+        if (b >= 0 && !list->head)
+            sched->wheel->map[b >> 5] &= ~(1U << (b & 31));
+
+        /* ...advance scheduler timestamp */
+        ts = xf_task_timestamp(t);
+        sched->timestamp = ts;
+
+        TRACE(DEBUG, _b("out: %08x:[%p]"), ts, t);
+    }
+    else
+    {
+        t = NULL;
+    }
+
+    xf_flx_unlock(&sched->lock);
+    return t;
+}
+
+/* ...cancel specified task execution (returns 1 if task is not scheduled) */
+UWORD32 xf_sched_cancel(xf_sched_t *sched, xf_task_t *t)
+{
+    xf_sched_list_t    *list;
+    UWORD32             b;
+    UWORD32             err;
+
+    xf_flx_lock(&sched->lock);
+
+    if ((list = (xf_sched_list_t *)t->parent) == NULL)
+    {
+        /* ...task is not in the queue */
+        err = 1;
+    }
+    else
+    {
+        xf_sched_list_remove(list, t);
+
+        /* ...update bucket map */
+        if (list != &sched->overflow && !list->head)
+        {
+            b = (UWORD32)(list - sched->wheel->bucket);
+            sched->wheel->map[b >> 5] &= ~(1U << (b & 31));
+        }
+
+        err = 0;
+    }
+
+    xf_flx_unlock(&sched->lock);
+    return err;
+}
+
+/* ...initialize scheduler data */
+int xf_sched_init(xf_sched_t *sched, UWORD32 core)
+{
+    memset(sched, 0, sizeof(*sched));
+    xf_flx_lock_init(&sched->lock, XF_DUMMY_LOCK);
+
+    /* ...buckets are kept out of core data, which is shared with host */
+    XF_CHK_ERR(sched->wheel = xf_mem_alloc(sizeof(xf_sched_wheel_t), sizeof(UWORD32), core, 0), XAF_MEMORY_ERR);
+    memset(sched->wheel, 0, sizeof(xf_sched_wheel_t));
+
+    return 0;
+}
+
+#endif  /* XF_CFG_SCHED_WHEEL */
+
 /* ...reinitialize scheduler lock */
 void xf_sched_preempt_reinit(xf_sched_t *sched)
 {
@@ -187,7 +411,14 @@ void xf_sched_preempt_reinit(xf_sched_t *sched)
 }
 
 /* ...deinit scheduler data */
-void xf_sched_deinit(xf_sched_t *sched)
+void xf_sched_deinit(xf_sched_t *sched, UWORD32 core)
 {
+#if XF_CFG_SCHED_WHEEL
+    if (sched->wheel)
+    {
+        xf_mem_free(sched->wheel, sizeof(xf_sched_wheel_t), core, 0);
+        sched->wheel = NULL;
+    }
+#endif
     xf_flx_lock_destroy(&sched->lock);
 }
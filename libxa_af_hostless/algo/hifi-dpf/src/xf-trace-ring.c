@@ -0,0 +1,190 @@
+/*
+* Copyright (c) 2015-2021 Cadence Design Systems Inc.
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/*******************************************************************************
+ * xf-trace-ring.c
+ *
+ * Binary event trace ring
+ *
+ * Producers claim a slot with an atomic increment of ring head, fill the record
+ * and publish it by writing sequence number last; they never block and never
+ * wait for consumer, so the oldest records are overwritten if the ring is not
+ * drained fast enough. The only consumer is the DSP proxy, which copies
+ * completed records into the buffers submitted by App Interface Layer.
+ ******************************************************************************/
+
+#define MODULE_TAG                      TRACE_RING
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+
+#include "xf-dp.h"
+#include "osal-timer.h"
+
+#if XF_CFG_TRACE_EVENTS
+
+/*******************************************************************************
+ * Local definitions
+ ******************************************************************************/
+
+#define XF_TRACE_RING_MASK              (XF_CFG_TRACE_EVENTS_NUM - 1)
+
+/* ...per-core trace rings */
+xf_trace_ring_t     xf_trace_ring[XF_CFG_CORES_NUM];
+
+/*******************************************************************************
+ * Internal helpers
+ ******************************************************************************/
+
+/* ...allocate records storage; no record is valid initially */
+static int xf_trace_ring_init(xf_trace_ring_t *ring, UWORD32 core)
+{
+    UWORD32     i;
+
+    XF_CHK_ERR(ring->event = xf_mem_alloc(XF_CFG_TRACE_EVENTS_NUM * sizeof(xaf_trace_event_t), sizeof(UWORD32), core, 0), XAF_MEMORY_ERR);
+
+    /* ...mark every slot as written on the previous lap */
+    for (i = 0; i < XF_CFG_TRACE_EVENTS_NUM; i++)
+    {
+        ring->event[i].seq = (UWORD16)(i - XF_CFG_TRACE_EVENTS_NUM);
+    }
+
+    ring->head = ring->tail = ring->dropped = 0;
+
+    return 0;
+}
+
+/*******************************************************************************
+ * API functions definitions
+ ******************************************************************************/
+
+/* ...put record into the ring */
+void __xf_trace_event(UWORD32 core, UWORD32 type, UWORD32 opcode, UWORD32 id, UWORD32 arg)
+{
+    xf_trace_ring_t    *ring = &xf_trace_ring[core];
+    UWORD32             idx = __sync_fetch_and_add(&ring->head, 1);
+    xaf_trace_event_t  *ev = &ring->event[idx & XF_TRACE_RING_MASK];
+
+    ev->ts = (UWORD32)__xf_get_cycles();
+    ev->type = (UWORD8)type;
+    ev->opcode = (UWORD8)opcode;
+    ev->id = id;
+    ev->arg = arg;
+
+    /* ...publish the record */
+    __sync_synchronize();
+    ev->seq = (UWORD16)idx;
+}
+
+/* ...drain completed records into the buffer; arm tracing if required */
+void xf_trace_submit(UWORD32 core, xf_message_t *m)
+{
+    xf_trace_ring_t    *ring = &xf_trace_ring[core];
+    xf_trace_msg_t     *msg = m->buffer;
+    UWORD32             head, tail, max, n = 0;
+
+    /* ...buffer shall hold the header at least */
+    if (msg == NULL || m->length < sizeof(*msg) || (ring->event == NULL && xf_trace_ring_init(ring, core) != 0))
+    {
+        TRACE(ERROR, _x("trace buffer rejected: %p:%u"), m->buffer, m->length);
+        xf_response_err(m);
+        return;
+    }
+
+    /* ...start from the current position when (re-)armed */
+    if (!ring->armed)
+    {
+        ring->tail = ring->head, ring->armed = 1;
+
+        TRACE(INFO, _b("core[%u]: event tracing armed"), core);
+    }
+
+    max = (m->length - sizeof(*msg)) / sizeof(xaf_trace_event_t);
+    head = ring->head, tail = ring->tail;
+
+    /* ...skip records already overwritten by producers */
+    if (head - tail > XF_CFG_TRACE_EVENTS_NUM)
+    {
+        ring->dropped += head - tail - XF_CFG_TRACE_EVENTS_NUM;
+        tail = head - XF_CFG_TRACE_EVENTS_NUM;
+    }
+
+    for (; tail != head && n < max; tail++)
+    {
+        xaf_trace_event_t  *ev = &ring->event[tail & XF_TRACE_RING_MASK];
+
+        /* ...stop at the record that is still being written */
+        if (ev->seq != (UWORD16)tail)
+        {
+            break;
+        }
+
+        memcpy(&msg->event[n], ev, sizeof(*ev));
+
+        /* ...discard the copy if producers have wrapped over the slot meanwhile */
+        __sync_synchronize();
+        if (ring->head - tail > XF_CFG_TRACE_EVENTS_NUM)
+        {
+            ring->dropped++;
+            continue;
+        }
+
+        n++;
+    }
+
+    ring->tail = tail;
+
+    msg->clock_freq = (UWORD32)__xf_get_cycles_freq();
+    msg->count = n;
+    msg->dropped = ring->dropped;
+    msg->reserved = 0;
+
+    /* ...pass records to App Interface Layer */
+    xf_response_data(m, sizeof(*msg) + n * sizeof(xaf_trace_event_t));
+}
+
+/* ...disarm tracing; not drained records are discarded on next arming */
+void xf_trace_flush(UWORD32 core, xf_message_t *m)
+{
+    xf_trace_ring[core].armed = 0;
+
+    TRACE(INFO, _b("core[%u]: event tracing disarmed"), core);
+
+    xf_response_ok(m);
+}
+
+/* ...release records storage (core is being shut down) */
+void xf_trace_ring_deinit(UWORD32 core)
+{
+    xf_trace_ring_t    *ring = &xf_trace_ring[core];
+
+    ring->armed = 0;
+
+    if (ring->event)
+    {
+        xf_mem_free(ring->event, XF_CFG_TRACE_EVENTS_NUM * sizeof(xaf_trace_event_t), core, 0);
+        ring->event = NULL;
+    }
+}
+
+#endif  /* XF_CFG_TRACE_EVENTS */
@@ -34,6 +34,43 @@
  * Types definitions
  ******************************************************************************/
 
+/* ...number of entries in response rings (must be a power of two) */
+#define XF_IPC_RING_ENTRIES             256
+
+/* ...spacing of producer/consumer ring indices to avoid false sharing */
+#define XF_IPC_CACHE_LINE               64
+
+/* ...single-producer/single-consumer message ring
+ *
+ * Indices are free-running; each side keeps a cached copy of the other side's
+ * index and only touches the shared one when the cache says full/empty. The
+ * doorbell (eventfd) is written only if the consumer has gone to sleep on an
+ * empty ring, so a busy consumer costs no system calls. A producer facing a
+ * full ring sleeps on the "space" eventfd the same way.
+ */
+typedef struct xf_ring
+{
+        /* ...producer-owned index, cached consumer index and sleep flag */
+        UWORD32                 head;
+        UWORD32                 tail_cache;
+        UWORD32                 full_waiting;
+        UWORD8                  pad0[XF_IPC_CACHE_LINE - 3 * sizeof(UWORD32)];
+
+        /* ...consumer-owned index, cached producer index and sleep flag */
+        UWORD32                 tail;
+        UWORD32                 head_cache;
+        UWORD32                 waiting;
+        UWORD8                  pad1[XF_IPC_CACHE_LINE - 3 * sizeof(UWORD32)];
+
+        /* ...read-only after initialization */
+        UWORD32                 mask;
+        UWORD32                 item_size;
+        int                     doorbell;
+        int                     space;
+        unsigned char          *data;
+
+}   xf_ring_t;
+
 /* ...proxy IPC data */
 typedef struct xf_proxy_ipc_data
 {
@@ -54,8 +91,11 @@ typedef struct xf_proxy_ipc_data
 
         int                     rproc_id;
 
-        /* ...pipe for asynchronous response delivery */
-        int                     pipe[2];
+        /* ...ring for asynchronous response delivery */
+        xf_ring_t               response;
+
+        /* ...ring for DSP responses (in-process DSP emulator only) */
+        xf_ring_t               dsp_response;
 
 }   xf_proxy_ipc_data_t;
 
@@ -81,8 +121,8 @@ static inline UWORD32 xf_ipc_b2a(xf_proxy_ipc_data_t *ipc, void *b)
 
 typedef struct xf_ipc_data
 {
-    /* ...asynchronous response delivery pipe */
-    int                 pipe[2];
+    /* ...asynchronous response delivery ring */
+    xf_ring_t           ring;
 
 }   xf_ipc_data_t;
 
@@ -94,6 +134,8 @@ extern int xf_proxy_ipc_response_put(xf_proxy_ipc_data_t *ipc, xf_proxy_msg_t *m
 extern int xf_proxy_ipc_response_get(xf_proxy_ipc_data_t *ipc, xf_proxy_msg_t *msg);
 extern int xf_ipc_response_put(xf_ipc_data_t *ipc, xf_user_msg_t *msg);
 extern int xf_ipc_response_get(xf_ipc_data_t *ipc, xf_user_msg_t *msg);
+extern int xf_ipc_response_tryget(xf_ipc_data_t *ipc, xf_user_msg_t *msg);
+extern int xf_ipc_response_wait_any(xf_ipc_data_t **ipc, UWORD32 num, UWORD32 timeout);
 extern int xf_ipc_data_init(xf_ipc_data_t *ipc);
 extern int xf_ipc_data_destroy(xf_ipc_data_t *ipc);
 
@@ -104,6 +146,10 @@ extern int xf_ipc_data_destroy(xf_ipc_data_t *ipc);
 /* ...send asynchronous command */
 extern int  xf_ipc_send(xf_proxy_ipc_data_t *ipc, xf_proxy_msg_t *msg, void *b);
 
+/* ...send several asynchronous commands at once; number of commands passed to
+ * DSP is returned in "posted", also on failure */
+extern int  xf_ipc_send_batch(xf_proxy_ipc_data_t *ipc, xf_proxy_msg_t *msg, UWORD32 num, UWORD32 *posted);
+
 /* ...wait for response from DSP Interface Layer */
 extern int  xf_ipc_wait(xf_proxy_ipc_data_t *ipc, UWORD32 timeout);
 
@@ -92,6 +92,10 @@ extern int xf_ipc_data_destroy(xf_ipc_data_t *ipc);
 /* ...send asynchronous command */
 extern int  xf_ipc_send(xf_proxy_ipc_data_t *ipc, xf_proxy_msg_t *msg, void *b);
 
+/* ...send several asynchronous commands at once; number of commands passed to
+ * DSP is returned in "posted", also on failure */
+extern int  xf_ipc_send_batch(xf_proxy_ipc_data_t *ipc, xf_proxy_msg_t *msg, UWORD32 num, UWORD32 *posted);
+
 /* ...wait for response from DSP Interface Layer */
 extern int  xf_ipc_wait(xf_proxy_ipc_data_t *ipc, UWORD32 timeout);
 
@@ -105,8 +105,9 @@ struct xaf_comp {
     xf_pool_t       *inpool;
     xf_pool_t       *outpool;
     void                *pout_buf[1];
-    void                *p_input[XAF_MAX_INBUFS];   //TENA-2196
+    void               **p_input;   //TENA-2196; ninbuf entries following the structure
     UWORD32                ninbuf;
+    UWORD32             inbuf_size;
     UWORD32             noutbuf;
 
     xaf_comp_t      *next;
@@ -152,4 +153,8 @@ typedef struct xaf_adev_s {
 #endif
 
     UWORD32 dsp_thread_priority;
+
+    /* ...loadable codec libraries cache (see library_load.c) */
+    void *lib_cache;
+    xf_lock_t lib_cache_lock;
 } xaf_adev_t;
@@ -55,6 +55,18 @@ typedef struct xf_user_msg      xf_user_msg_t;
 /* ...proxy-message */
 typedef struct xf_proxy_msg     xf_proxy_msg_t;
 
+/* ...batch of proxy commands */
+typedef struct xf_cmd_batch     xf_cmd_batch_t;
+
+/* ...DSP memory statistics message */
+typedef struct xf_mem_stats_msg xf_mem_stats_msg_t;
+
+/* ...DSP event trace message */
+typedef struct xf_trace_msg     xf_trace_msg_t;
+
+/* ...component latency statistics message */
+typedef struct xf_latency_msg   xf_latency_msg_t;
+
 /* ...response callback */
 typedef void (*xf_response_cb)(xf_handle_t *h, xf_user_msg_t *msg);
 
@@ -66,13 +78,21 @@ typedef void (*xf_response_cb)(xf_handle_t *h, xf_user_msg_t *msg);
 extern int      xf_open(xf_proxy_t *proxy, xf_handle_t *handle, xf_id_t id, UWORD32 core, xf_response_cb cb);
 extern void     xf_close(xf_handle_t *handle);
 extern int      xf_command(xf_handle_t *handle, UWORD32 dst, UWORD32 opcode, void *buf, UWORD32 length);
+extern void     xf_command_batch_init(xf_cmd_batch_t *batch);
+extern int      xf_command_batch_add(xf_cmd_batch_t *batch, xf_handle_t *handle, UWORD32 dst, UWORD32 opcode, void *buf, UWORD32 length);
+extern int      xf_command_batch_submit(xf_cmd_batch_t *batch);
 extern int      xf_route(xf_handle_t *src, UWORD32 s_port, xf_handle_t *dst, UWORD32 d_port, UWORD32 num, UWORD32 size, UWORD32 align);
 extern int      xf_unroute(xf_handle_t *src, UWORD32 s_port);
 extern int      xf_pause(xf_handle_t *comp, WORD32 port);
 extern int      xf_resume(xf_handle_t *comp, WORD32 port);
 extern int      xf_set_config(xf_handle_t *comp, void *buffer, UWORD32 length);
 extern int      xf_get_config(xf_handle_t *comp, void *buffer, UWORD32 length);
+extern int      xf_get_profile(xf_handle_t *comp, void *buffer, UWORD32 length);
+extern int      xf_get_latency(xf_handle_t *comp, void *buffer, UWORD32 length);
 extern int      xf_set_priorities(xf_proxy_t *proxy, UWORD32 core, UWORD32 n_rt_priorities, UWORD32 rt_priority_base, UWORD32 bg_priority);
+extern int      xf_get_mem_stats(xf_proxy_t *proxy, UWORD32 core, xf_mem_stats_msg_t *stats);
+extern int      xf_trace_start(xf_proxy_t *proxy, UWORD32 core, const char *path);
+extern int      xf_trace_stop(xf_proxy_t *proxy);
 
 /* ...shared buffers operations */
 extern int      xf_pool_alloc(xf_proxy_t *proxy, UWORD32 number, UWORD32 length, xf_pool_type_t type, xf_pool_t **pool, WORD32 id);
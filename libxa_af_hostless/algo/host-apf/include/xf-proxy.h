@@ -67,6 +67,29 @@ struct xf_proxy_msg
 
 }   __attribute__((__packed__));
 
+/* ...maximal number of commands posted with a single IPC doorbell */
+#define XF_CMD_BATCH_SIZE               32
+
+/* ...batch of commands collected for single submission */
+struct xf_cmd_batch
+{
+    /* ...proxy the commands are posted to */
+    xf_proxy_t         *proxy;
+
+    /* ...number of collected commands */
+    UWORD32             num;
+
+    /* ...sticky IPC failure; commands left in the batch never reached DSP */
+    int                 error;
+
+    /* ...caller tag recorded with each command added from now on */
+    UWORD32             tag;
+
+    /* ...command messages and their caller tags */
+    xf_proxy_msg_t      msg[XF_CMD_BATCH_SIZE];
+    UWORD32             msg_tag[XF_CMD_BATCH_SIZE];
+};
+
 /*******************************************************************************
  * Buffer pools
  ******************************************************************************/
@@ -149,6 +172,34 @@ typedef union xf_proxy_cmap_link
 
 }   xf_proxy_cmap_link_t;
 
+/* ...event trace drain (see xf_trace_start) */
+typedef struct xf_trace_drain
+{
+    /* ...shared buffer records are collected into */
+    xf_pool_t              *pool;
+
+    /* ...output file (FILE *) */
+    void                   *file;
+
+    /* ...drain thread handle and stack */
+    xf_thread_t             thread;
+    void                   *stack;
+
+    /* ...drain thread run flag */
+    volatile UWORD32        active;
+
+    /* ...traced DSP core */
+    UWORD32                 core;
+
+    /* ...number of records written and dropped by DSP */
+    UWORD32                 events;
+    UWORD32                 dropped;
+
+    /* ...frequency of DSP timestamps */
+    UWORD32                 clock_freq;
+
+}   xf_trace_drain_t;
+
 /* ...proxy data structure */
 struct xf_proxy
 {
@@ -171,6 +222,9 @@ struct xf_proxy
     xf_proxy_cmap_link_t    cmap[XF_CFG_PROXY_MAX_CLIENTS];
 
     UWORD32 proxy_thread_priority;
+
+    /* ...event trace drain */
+    xf_trace_drain_t        trace;
 };
 
 /*******************************************************************************
@@ -355,3 +409,9 @@ static inline int xf_response_get(xf_handle_t *handle, xf_user_msg_t *msg)
 {
 	return xf_ipc_response_get(&handle->ipc, msg);
 }
+
+/* ...get asynchronous response if available (non-blocking) */
+static inline int xf_response_tryget(xf_handle_t *handle, xf_user_msg_t *msg)
+{
+	return xf_ipc_response_tryget(&handle->ipc, msg);
+}
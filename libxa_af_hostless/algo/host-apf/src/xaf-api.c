@@ -36,6 +36,15 @@
 #define XAF_4BYTE_ALIGN    4
 #define XAF_8BYTE_ALIGN    8
 #define XAF_32BYTE_ALIGN    32
+
+/* ...size of the first release of xaf_comp_config_ext_t (smallest one accepted) */
+#define XAF_COMP_CONFIG_EXT_SIZE_V1 \
+   (offset_of(xaf_comp_config_ext_t, pp_inbuf) + sizeof(pVOID *))
+
+/* ...field of extended configuration is known to the application */
+#define XAF_COMP_CONFIG_EXT_HAS(p, field) \
+   ((p)->config_size >= offset_of(xaf_comp_config_ext_t, field) + sizeof((p)->field))
+
 #define XAF_DEV_AND_AP_STRUCT_MEM_SIZE \
    (sizeof(xf_ap_t) + (XAF_8BYTE_ALIGN-1) + \
    (sizeof(xaf_adev_t) + (XAF_4BYTE_ALIGN-1)))
@@ -926,6 +935,22 @@ XAF_ERR_CODE xaf_comp_config_default_init(xaf_comp_config_t *pcomp_config)
     return XAF_NO_ERR;
 }
 
+XAF_ERR_CODE xaf_comp_config_ext_default_init(xaf_comp_config_ext_t *pconfig_ext, UWORD32 config_size)
+{
+    XAF_CHK_PTR(pconfig_ext);
+
+    /* ...application may not know about trailing fields, but all known ones must be covered */
+    XAF_CHK_RANGE(config_size, XAF_COMP_CONFIG_EXT_SIZE_V1, sizeof(xaf_comp_config_ext_t));
+
+    /* ...initialize extended config params; same input buffers as basic config */
+    memset(pconfig_ext, 0, config_size);
+
+    pconfig_ext->config_size = config_size;
+    pconfig_ext->num_input_buffers = 2;
+
+    return XAF_NO_ERR;
+}
+
 #ifndef XA_DISABLE_EVENT
 static XAF_ERR_CODE xaf_setup_event_channel(xaf_comp_t *src_comp, UWORD32 src_config_param, xaf_comp_t *dest_comp, UWORD32 dst_config_param, UWORD32 nbuf, UWORD32 buf_size)
 {
@@ -1023,6 +1048,23 @@ static XAF_ERR_CODE xaf_destroy_event_channel(xaf_comp_t *src_comp, UWORD32 src_
 #endif /* XA_DISABLE_EVENT */
 
 XAF_ERR_CODE xaf_comp_create(pVOID adev_ptr, pVOID *pp_comp, xaf_comp_config_t *pcomp_config)
+{
+    xaf_comp_config_ext_t config_ext;
+
+    XAF_CHK_PTR(pcomp_config);
+
+    /* ...basic configuration has at most XAF_MAX_INBUFS input buffers of default size */
+    XAF_CHK_RANGE(pcomp_config->num_input_buffers, 0, XAF_MAX_INBUFS);
+    if (pcomp_config->num_input_buffers) XAF_CHK_PTR(pcomp_config->pp_inbuf);
+
+    xaf_comp_config_ext_default_init(&config_ext, sizeof(config_ext));
+    config_ext.num_input_buffers = pcomp_config->num_input_buffers;
+    config_ext.pp_inbuf = (pcomp_config->num_input_buffers ? *pcomp_config->pp_inbuf : NULL);
+
+    return xaf_comp_create_ext(adev_ptr, pp_comp, pcomp_config, &config_ext);
+}
+
+XAF_ERR_CODE xaf_comp_create_ext(pVOID adev_ptr, pVOID *pp_comp, xaf_comp_config_t *pcomp_config, xaf_comp_config_ext_t *pconfig_ext)
 {
     xaf_adev_t *p_adev;
     xaf_comp_t *p_comp;
@@ -1032,11 +1074,14 @@ XAF_ERR_CODE xaf_comp_create(pVOID adev_ptr, pVOID *pp_comp, xaf_comp_config_t *
     UWORD32 i;
 
     XAF_CHK_PTR(pcomp_config);
+    XAF_CHK_PTR(pconfig_ext);
+    XAF_CHK_RANGE(pconfig_ext->config_size, XAF_COMP_CONFIG_EXT_SIZE_V1, sizeof(xaf_comp_config_ext_t));
 
     xf_id_t comp_id = pcomp_config->comp_id;
-    UWORD32 ninbuf = pcomp_config->num_input_buffers;
+    UWORD32 ninbuf = pconfig_ext->num_input_buffers;
     UWORD32 noutbuf = pcomp_config->num_output_buffers;
-    pVOID (*pp_inbuf)[XAF_MAX_INBUFS] = pcomp_config->pp_inbuf;
+    pVOID *pp_inbuf = pconfig_ext->pp_inbuf;
+    UWORD32 inbuf_size = pconfig_ext->input_buffer_size ? pconfig_ext->input_buffer_size : XAF_INBUF_SIZE;
     xaf_comp_type comp_type = pcomp_config->comp_type;
 
     p_adev = (xaf_adev_t *)adev_ptr;
@@ -1045,10 +1090,17 @@ XAF_ERR_CODE xaf_comp_create(pVOID adev_ptr, pVOID *pp_comp, xaf_comp_config_t *
     XAF_CHK_PTR(comp_id);
     if (ninbuf) XAF_CHK_PTR(pp_inbuf);
 
-    XAF_CHK_RANGE(ninbuf, 0, XAF_MAX_INBUFS);
+    XAF_CHK_RANGE(ninbuf, 0, XAF_MAX_INBUFS_EXT);
     XAF_CHK_RANGE(noutbuf, 0, 1);
     XAF_CHK_RANGE(comp_type, XAF_DECODER, XAF_MAX_COMPTYPE-1); 
 
+    /* ...mixer cannot have more tracks than host and DSP were built with */
+    if (comp_type == XAF_MIXER && XAF_COMP_CONFIG_EXT_HAS(pconfig_ext, num_input_ports) && pconfig_ext->num_input_ports > XA_MIXER_MAX_TRACK_NUMBER)
+    {
+        TRACE(ERROR, _x("mixer tracks requested: %u, built with XA_MIXER_MAX_TRACK_NUMBER=%u"), pconfig_ext->num_input_ports, XA_MIXER_MAX_TRACK_NUMBER);
+        return XAF_INVALIDVAL_ERR;
+    }
+
 #ifndef XA_DISABLE_EVENT
     XAF_CHK_RANGE(pcomp_config->error_channel_ctl, XAF_ERR_CHANNEL_DISABLE, XAF_ERR_CHANNEL_ALL);
     XAF_CHK_RANGE(pcomp_config->num_err_msg_buf, 1, 4);
@@ -1056,8 +1108,8 @@ XAF_ERR_CODE xaf_comp_create(pVOID adev_ptr, pVOID *pp_comp, xaf_comp_config_t *
 
     XAF_ADEV_STATE_CHK(p_adev, XAF_ADEV_RESET);
 
-    //Memory allocation for component struct pointer
-    size = (sizeof(xaf_comp_t) + (XAF_4BYTE_ALIGN-1));
+    //Memory allocation for component struct pointer, followed by input buffer pointers
+    size = (sizeof(xaf_comp_t) + ninbuf * sizeof(void *) + (XAF_4BYTE_ALIGN-1));
     ret = xaf_malloc(&pTmp, size, XAF_MEM_ID_COMP);
     if(ret != XAF_NO_ERR)
         return ret;
@@ -1078,18 +1130,20 @@ XAF_ERR_CODE xaf_comp_create(pVOID adev_ptr, pVOID *pp_comp, xaf_comp_config_t *
     p_adev->n_comp += 1;
 
     p_comp->ninbuf = ninbuf;
+    p_comp->p_input = (void **)(p_comp + 1);
+    p_comp->inbuf_size = inbuf_size;
 
     /* ...allocate input buffer */
     if (ninbuf) 
     {
         xf_buffer_t *buf;
-        XF_CHK_API(xf_pool_alloc(&p_adev->proxy, ninbuf, XAF_INBUF_SIZE, XF_POOL_INPUT, &p_comp->inpool, XAF_MEM_ID_COMP));
+        XF_CHK_API(xf_pool_alloc(&p_adev->proxy, ninbuf, inbuf_size, XF_POOL_INPUT, &p_comp->inpool, XAF_MEM_ID_COMP));
         
         for (i=0; i<ninbuf; i++)
         {
             buf         = xf_buffer_get(p_comp->inpool);
             p_comp->p_input[i] = xf_buffer_data(buf);   //TENA-2196 saving the address of buffer allocated.
-            *(*pp_inbuf + i) = p_comp->p_input[i];
+            pp_inbuf[i] = p_comp->p_input[i];
         }
 
     }
@@ -1115,7 +1169,7 @@ XAF_ERR_CODE xaf_comp_create(pVOID adev_ptr, pVOID *pp_comp, xaf_comp_config_t *
         p_comp->inp_ports = 1; p_comp->out_ports = 1;
         break;
     case XAF_MIXER:
-        p_comp->inp_ports = 4; p_comp->out_ports = 1;
+        p_comp->inp_ports = XA_MIXER_MAX_TRACK_NUMBER; p_comp->out_ports = 1;
         break;
     case XAF_MIMO_PROC_12 ... (XAF_MAX_COMPTYPE-1):
         p_comp->inp_ports  = xf_io_ports[comp_type][0];
@@ -1180,8 +1234,8 @@ XAF_ERR_CODE xaf_comp_create_deprecated(pVOID adev_ptr, pVOID *pp_comp, xf_id_t
 
     XAF_ADEV_STATE_CHK(p_adev, XAF_ADEV_RESET);
 
-    //Memory allocation for component struct pointer
-    size = (sizeof(xaf_comp_t) + (XAF_4BYTE_ALIGN-1));
+    //Memory allocation for component struct pointer, followed by input buffer pointers
+    size = (sizeof(xaf_comp_t) + ninbuf * sizeof(void *) + (XAF_4BYTE_ALIGN-1));
     ret = xaf_malloc(&pTmp, size, XAF_MEM_ID_COMP);
     if(ret != XAF_NO_ERR)
         return ret;
@@ -1202,12 +1256,14 @@ XAF_ERR_CODE xaf_comp_create_deprecated(pVOID adev_ptr, pVOID *pp_comp, xf_id_t
     p_adev->n_comp += 1;
 
     p_comp->ninbuf = ninbuf;
+    p_comp->p_input = (void **)(p_comp + 1);
+    p_comp->inbuf_size = XAF_INBUF_SIZE;
 
     /* ...allocate input buffer */
     if (ninbuf) 
     {
         xf_buffer_t *buf;
-        XF_CHK_API(xf_pool_alloc(&p_adev->proxy, ninbuf, XAF_INBUF_SIZE, XF_POOL_INPUT, &p_comp->inpool, XAF_MEM_ID_COMP));
+        XF_CHK_API(xf_pool_alloc(&p_adev->proxy, ninbuf, p_comp->inbuf_size, XF_POOL_INPUT, &p_comp->inpool, XAF_MEM_ID_COMP));
         
         for (i=0; i<ninbuf; i++)
         {
@@ -1239,7 +1295,7 @@ XAF_ERR_CODE xaf_comp_create_deprecated(pVOID adev_ptr, pVOID *pp_comp, xf_id_t
         p_comp->inp_ports = 1; p_comp->out_ports = 1;
         break;
     case XAF_MIXER:
-        p_comp->inp_ports = 4; p_comp->out_ports = 1;
+        p_comp->inp_ports = XA_MIXER_MAX_TRACK_NUMBER; p_comp->out_ports = 1;
         break;
     case XAF_MIMO_PROC_12 ... (XAF_MAX_COMPTYPE-1):
         p_comp->inp_ports  = xf_io_ports[comp_type][0];
@@ -1424,6 +1480,18 @@ XAF_ERR_CODE xaf_comp_get_config(pVOID comp_ptr, WORD32 num_param, pWORD32 p_par
     return XAF_NO_ERR;
 }
 
+XAF_ERR_CODE xaf_comp_get_dmabuf(pVOID comp_ptr, pVOID p_buf, WORD32 *p_fd, UWORD32 *p_offset, UWORD32 *p_length)
+{
+    XAF_CHK_PTR(comp_ptr);
+    XAF_CHK_PTR(p_buf);
+    XAF_CHK_PTR(p_fd);
+    XAF_CHK_PTR(p_offset);
+    XAF_CHK_PTR(p_length);
+
+    /* ...shared memory is not a dma-buf in this configuration */
+    return XAF_API_ERR;
+}
+
 
 XAF_ERR_CODE xaf_comp_get_status(pVOID adev_ptr, pVOID comp_ptr, xaf_comp_status *p_status, pVOID p_info)
 {
@@ -1603,7 +1671,7 @@ XAF_ERR_CODE xaf_comp_process(pVOID adev_ptr, pVOID comp_ptr, pVOID p_buf, UWORD
 
     if (!p_comp->init_done) XAF_CHK_PTR(p_adev);
     XAF_CHK_RANGE(flag, XAF_START_FLAG, XAF_NEED_PROBE_FLAG);
-    if (flag == XAF_INPUT_READY_FLAG) XAF_CHK_RANGE(length, 0, XAF_INBUF_SIZE);
+    if (flag == XAF_INPUT_READY_FLAG) XAF_CHK_RANGE(length, 0, p_comp->inbuf_size);
 
     p_handle = &p_comp->handle;
     
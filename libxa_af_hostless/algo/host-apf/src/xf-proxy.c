@@ -32,6 +32,8 @@
  * Includes
  ******************************************************************************/
 
+#include <stdio.h>
+
 #include "xf.h"
 #include "xaf-structs.h"
 #include "xaf-threads-priority.h"
@@ -678,6 +680,82 @@ int xf_command(xf_handle_t *handle, UWORD32 port, UWORD32 opcode, void *buffer,
     return XF_CHK_API(xf_ipc_send(&proxy->ipc, &msg, buffer));
 }
 
+/* ...reset command batch */
+void xf_command_batch_init(xf_cmd_batch_t *batch)
+{
+    batch->proxy = NULL;
+    batch->num = 0;
+    batch->error = 0;
+    batch->tag = 0;
+}
+
+/* ...append command to batch; full batch is posted immediately */
+int xf_command_batch_add(xf_cmd_batch_t *batch, xf_handle_t *handle, UWORD32 port, UWORD32 opcode, void *buffer, UWORD32 length)
+{
+    xf_proxy_t     *proxy = handle->proxy;
+    xf_proxy_msg_t *msg;
+
+    /* ...nothing is posted after IPC failure */
+    XF_CHK_ERR(batch->error == 0, batch->error);
+
+    /* ...commands to different proxy cannot share doorbell */
+    if (batch->num == XF_CMD_BATCH_SIZE || (batch->num && batch->proxy != proxy))
+    {
+        XF_CHK_API(xf_command_batch_submit(batch));
+    }
+
+    msg = &batch->msg[batch->num];
+
+    /* ...fill-in message parameters */
+    msg->id = __XF_MSG_ID(__XF_AP_CLIENT(proxy->core, handle->client), __XF_PORT_SPEC2(handle->id, port));
+    msg->opcode = opcode;
+    msg->length = length;
+    XF_CHK_ERR((msg->address = xf_proxy_b2a(proxy, buffer)) != XF_PROXY_BADADDR, XAF_INVALIDVAL_ERR);
+
+    TRACE(CMD, _b("[%p]:[%08x]:(%08x,%u,%p) batched"), handle, msg->id, opcode, length, buffer);
+
+    batch->msg_tag[batch->num] = batch->tag;
+    batch->proxy = proxy;
+    batch->num++;
+
+    return 0;
+}
+
+/* ...post all collected commands under single proxy lock and IPC doorbell; on
+ * failure the commands not passed to DSP stay in the batch (with their tags) */
+int xf_command_batch_submit(xf_cmd_batch_t *batch)
+{
+    xf_proxy_t     *proxy = batch->proxy;
+    UWORD32         posted;
+    int             r;
+
+    XF_CHK_ERR(batch->error == 0, batch->error);
+
+    if (batch->num == 0)
+        return 0;
+
+    xf_proxy_lock(proxy);
+    r = xf_ipc_send_batch(&proxy->ipc, batch->msg, batch->num, &posted);
+    xf_proxy_unlock(proxy);
+
+    TRACE(CMD, _b("proxy[%p]: posted %u of %u commands: %d"), proxy, posted, batch->num, r);
+
+    if (r < 0)
+    {
+        /* ...keep unsent commands for caller to account */
+        batch->num -= posted;
+        memmove(batch->msg, batch->msg + posted, batch->num * sizeof(batch->msg[0]));
+        memmove(batch->msg_tag, batch->msg_tag + posted, batch->num * sizeof(batch->msg_tag[0]));
+        batch->error = r;
+
+        return XF_CHK_API(r);
+    }
+
+    batch->num = 0;
+
+    return 0;
+}
+
 /* ...port pause function */
 int xf_pause(xf_handle_t *comp, WORD32 port)
 {
@@ -762,6 +840,46 @@ int xf_get_config(xf_handle_t *comp, void *buffer, UWORD32 length)
 	return 0;
 }
 
+int xf_get_profile(xf_handle_t *comp, void *buffer, UWORD32 length)
+{
+    xf_proxy_t             *proxy = comp->proxy;
+    xf_user_msg_t           msg;
+
+    /* ...profile request is addressed to component itself (port 0) */
+    msg.id = __XF_MSG_ID(__XF_AP_PROXY(proxy->core), __XF_PORT_SPEC2(comp->id, 0));
+    msg.opcode = XF_GET_PROFILE;
+    msg.length = length;
+    msg.buffer = buffer;
+
+    /* ...synchronously execute command on DSP Interface Layer */
+    XF_CHK_API(xf_proxy_cmd_exec_with_lock(proxy, &msg));
+
+    /* ...check result is successful */
+    XF_CHK_ERR(msg.opcode == XF_GET_PROFILE && msg.length == length, XAF_INVALIDVAL_ERR);
+
+    return 0;
+}
+
+int xf_get_latency(xf_handle_t *comp, void *buffer, UWORD32 length)
+{
+    xf_proxy_t             *proxy = comp->proxy;
+    xf_user_msg_t           msg;
+
+    /* ...latency request is addressed to component itself (port 0) */
+    msg.id = __XF_MSG_ID(__XF_AP_PROXY(proxy->core), __XF_PORT_SPEC2(comp->id, 0));
+    msg.opcode = XF_GET_LATENCY;
+    msg.length = length;
+    msg.buffer = buffer;
+
+    /* ...synchronously execute command on DSP Interface Layer */
+    XF_CHK_API(xf_proxy_cmd_exec_with_lock(proxy, &msg));
+
+    /* ...check result is successful */
+    XF_CHK_ERR(msg.opcode == XF_GET_LATENCY && msg.length == length, XAF_INVALIDVAL_ERR);
+
+    return 0;
+}
+
 int xf_flush(xf_handle_t *comp, WORD32 port)
 {
     xf_proxy_t             *proxy = comp->proxy;
@@ -823,6 +941,252 @@ int xf_set_priorities(xf_proxy_t *proxy, UWORD32 core, UWORD32 n_rt_priorities,
     return 0;
 }
 
+/* ...retrieve DSP memory statistics */
+int xf_get_mem_stats(xf_proxy_t *proxy, UWORD32 core, xf_mem_stats_msg_t *stats)
+{
+    xf_user_msg_t msg;
+    xf_buffer_t *b;
+    int         r;
+
+    XF_CHK_ERR(b = xf_buffer_get(proxy->aux), XAF_MEMORY_ERR);
+
+    /* ...set session-id: source is proxy at App Interface Layer, destination is proxy at DSP Interface Layer */
+    msg.id = __XF_MSG_ID(__XF_AP_PROXY(proxy->core), __XF_DSP_PROXY(core));
+    msg.opcode = XF_GET_MEM_STATS;
+    msg.buffer = xf_buffer_data(b);
+    msg.length = sizeof(*stats);
+
+    /* ...execute command synchronously */
+    r = xf_proxy_cmd_exec_with_lock(proxy, &msg);
+
+    /* ...copy statistics out of shared buffer */
+    if (r == 0 && msg.opcode == XF_GET_MEM_STATS && msg.length == sizeof(*stats))
+        memcpy(stats, msg.buffer, sizeof(*stats));
+
+    /* ...return buffer to proxy */
+    xf_buffer_put(b);
+
+    /* ...check command execution is successful */
+    XF_CHK_API(r);
+
+    /* ...check operation is successfull */
+    XF_CHK_ERR(msg.opcode == XF_GET_MEM_STATS && msg.length == sizeof(*stats), XAF_INVALIDVAL_ERR);
+
+    return 0;
+}
+
+/*******************************************************************************
+ * Event trace API
+ ******************************************************************************/
+
+/* ...number of records collected per request */
+#define XF_TRACE_DRAIN_EVENTS           256
+
+/* ...polling period of drain thread when DSP ring is nearly empty */
+#define XF_TRACE_DRAIN_PERIOD_MSEC      5
+
+#define XF_TRACE_THREAD_STACK_SIZE      4096
+
+/* ...collect available records from DSP ring; returns number of records or negative error */
+static int xf_trace_drain(xf_proxy_t *proxy, UWORD32 opcode)
+{
+    xf_trace_drain_t   *trace = &proxy->trace;
+    xf_buffer_t        *b;
+    xf_trace_msg_t     *hdr;
+    xf_user_msg_t       msg;
+    int                 r;
+
+    XF_CHK_ERR(b = xf_buffer_get(trace->pool), XAF_MEMORY_ERR);
+
+    /* ...set session-id: source is proxy at App Interface Layer, destination is proxy at DSP Interface Layer */
+    msg.id = __XF_MSG_ID(__XF_AP_PROXY(proxy->core), __XF_DSP_PROXY(trace->core));
+    msg.opcode = opcode;
+    msg.buffer = xf_buffer_data(b);
+    msg.length = (opcode == XF_FILL_THIS_BUFFER ? xf_buffer_length(b) : 0);
+
+    /* ...execute command synchronously */
+    r = xf_proxy_cmd_exec_with_lock(proxy, &msg);
+
+    if (r == 0 && msg.opcode != opcode)
+    {
+        r = XAF_INVALIDVAL_ERR;
+    }
+    else if (r == 0 && opcode == XF_FILL_THIS_BUFFER)
+    {
+        hdr = msg.buffer;
+
+        if (msg.length < sizeof(*hdr) || msg.length != sizeof(*hdr) + hdr->count * sizeof(xaf_trace_event_t))
+        {
+            r = XAF_INVALIDVAL_ERR;
+        }
+        else
+        {
+            /* ...append records to the file */
+            fwrite(hdr->event, sizeof(xaf_trace_event_t), hdr->count, trace->file);
+
+            trace->events += hdr->count, trace->dropped = hdr->dropped;
+            trace->clock_freq = hdr->clock_freq;
+            r = (int)hdr->count;
+        }
+    }
+
+    xf_buffer_put(b);
+
+    return r;
+}
+
+/* ...drain thread */
+static void * xf_trace_thread(void *arg)
+{
+    xf_proxy_t     *proxy = arg;
+    int             r;
+
+    while (proxy->trace.active)
+    {
+        if ((r = xf_trace_drain(proxy, XF_FILL_THIS_BUFFER)) < 0)
+        {
+            TRACE(ERROR, _x("trace drain failed: %d"), r);
+            break;
+        }
+
+        /* ...give DSP time to produce more records unless we are lagging behind */
+        if (r < XF_TRACE_DRAIN_EVENTS / 2)
+        {
+            __xf_thread_sleep_msec(XF_TRACE_DRAIN_PERIOD_MSEC);
+        }
+    }
+
+    return NULL;
+}
+
+/* ...write trace file header */
+static void xf_trace_file_header(xf_trace_drain_t *trace)
+{
+    xaf_trace_file_hdr_t    hdr;
+
+    hdr.magic = XAF_TRACE_FILE_MAGIC;
+    hdr.version = XAF_TRACE_FILE_VERSION;
+    hdr.clock_freq = trace->clock_freq;
+    hdr.event_size = sizeof(xaf_trace_event_t);
+    hdr.events = trace->events;
+    hdr.dropped = trace->dropped;
+
+    fseek(trace->file, 0, SEEK_SET);
+    fwrite(&hdr, sizeof(hdr), 1, trace->file);
+}
+
+/* ...arm DSP event tracing and start draining records into a file */
+int xf_trace_start(xf_proxy_t *proxy, UWORD32 core, const char *path)
+{
+    xaf_adev_t         *p_adev = container_of(proxy, xaf_adev_t, proxy);
+    xf_trace_drain_t   *trace = &proxy->trace;
+    int                 r;
+
+    XF_CHK_ERR(trace->file == NULL, XAF_API_ERR);
+
+    memset(trace, 0, sizeof(*trace));
+    trace->core = core;
+
+    XF_CHK_ERR(trace->file = fopen(path, "wb"), XAF_INVALIDVAL_ERR);
+
+    /* ...reserve space for the header; it is finalized when tracing stops */
+    xf_trace_file_header(trace);
+
+    /* ...one buffer is enough as the drain is synchronous */
+    if ((r = xf_pool_alloc(proxy, 1, sizeof(xf_trace_msg_t) + XF_TRACE_DRAIN_EVENTS * sizeof(xaf_trace_event_t), XF_POOL_AUX, &trace->pool, XAF_MEM_ID_DEV)) < 0)
+    {
+        goto err;
+    }
+
+    /* ...first request arms tracing on DSP */
+    if ((r = xf_trace_drain(proxy, XF_FILL_THIS_BUFFER)) < 0)
+    {
+        goto err_pool;
+    }
+
+#if defined(HAVE_XOS)
+    if ((r = xaf_malloc(p_adev->xf_g_ap, &trace->stack, XF_TRACE_THREAD_STACK_SIZE, XAF_MEM_ID_DEV)) != XAF_NO_ERR)
+    {
+        goto err_disarm;
+    }
+#else
+    (void)p_adev;
+#endif
+
+    trace->active = 1;
+
+    if ((r = __xf_thread_create(&trace->thread, xf_trace_thread, proxy, "traceDrain", trace->stack, XF_TRACE_THREAD_STACK_SIZE, proxy->proxy_thread_priority)) < 0)
+    {
+        trace->active = 0;
+        goto err_stack;
+    }
+
+    TRACE(INIT, _b("proxy-%u[%p]: tracing core %u into %s"), proxy->core, proxy, core, path);
+
+    return 0;
+
+err_stack:
+    if (trace->stack)
+    {
+        p_adev->xf_g_ap->xf_mem_free_fxn(p_adev->xf_g_ap->g_mem_obj, trace->stack, XAF_MEM_ID_DEV);
+    }
+#if defined(HAVE_XOS)
+err_disarm:
+#endif
+    xf_trace_drain(proxy, XF_FLUSH);
+err_pool:
+    xf_pool_free(trace->pool, XAF_MEM_ID_DEV);
+err:
+    fclose(trace->file);
+    memset(trace, 0, sizeof(*trace));
+    return r;
+}
+
+/* ...stop draining, disarm DSP event tracing and finalize the file */
+int xf_trace_stop(xf_proxy_t *proxy)
+{
+    xaf_adev_t         *p_adev = container_of(proxy, xaf_adev_t, proxy);
+    xf_trace_drain_t   *trace = &proxy->trace;
+    int                 r;
+
+    /* ...tracing is not active */
+    if (trace->file == NULL)
+    {
+        return 0;
+    }
+
+    trace->active = 0;
+    __xf_thread_join(&trace->thread, NULL);
+    __xf_thread_destroy(&trace->thread);
+
+    /* ...collect what is left in the ring */
+    while ((r = xf_trace_drain(proxy, XF_FILL_THIS_BUFFER)) == XF_TRACE_DRAIN_EVENTS)
+        ;
+
+    /* ...disarm tracing on DSP */
+    xf_trace_drain(proxy, XF_FLUSH);
+
+    xf_trace_file_header(trace);
+    fclose(trace->file);
+
+    if (trace->dropped)
+    {
+        TRACE(INFO, _b("proxy-%u[%p]: %u trace records dropped"), proxy->core, proxy, trace->dropped);
+    }
+
+    TRACE(INIT, _b("proxy-%u[%p]: tracing stopped, %u records"), proxy->core, proxy, trace->events);
+
+    if (trace->stack)
+    {
+        p_adev->xf_g_ap->xf_mem_free_fxn(p_adev->xf_g_ap->g_mem_obj, trace->stack, XAF_MEM_ID_DEV);
+    }
+
+    xf_pool_free(trace->pool, XAF_MEM_ID_DEV);
+    memset(trace, 0, sizeof(*trace));
+
+    return (r < 0 ? r : 0);
+}
+
 /*******************************************************************************
  * Buffer pool API
  ******************************************************************************/
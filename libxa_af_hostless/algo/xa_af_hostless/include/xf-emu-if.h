@@ -0,0 +1,55 @@
+/*
+* Copyright (c) 2015-2021 Cadence Design Systems Inc.
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/*******************************************************************************
+ * xf-emu-if.h
+ *
+ * In-process DSP emulator interface (host-native Linux build)
+ ******************************************************************************/
+
+#ifndef __XF_EMU_IF_H
+#define __XF_EMU_IF_H
+
+/*******************************************************************************
+ * Global Definitions
+ ******************************************************************************/
+
+/* ...part of shared region reserved for DSP local pool (matches firmware) */
+#define XF_EMU_LOCAL_POOL_SIZE          0x6F0000
+
+/* ...response delivery callback (invoked from DSP core thread only) */
+typedef void xf_emu_response_cb(void *arg, const void *msg, UWORD32 length);
+
+/*******************************************************************************
+ * API functions
+ ******************************************************************************/
+
+/* ...start DSP core thread over shared region */
+int xf_emu_dsp_start(void *shmem, UWORD32 size, xf_emu_response_cb *response, void *arg);
+
+/* ...pass command message(s) to emulated DSP; length is a multiple of message size */
+int xf_emu_dsp_command(const void *msg, UWORD32 length);
+
+/* ...stop DSP core thread and release emulator resources */
+void xf_emu_dsp_stop(void);
+
+#endif /* __XF_EMU_IF_H */
@@ -46,3 +46,6 @@ typedef struct IPC_MSGQ {
 
 int ipc_msgq_init(xf_msgq_t *cmdq, xf_msgq_t *respq, xf_event_t **msgq_event);
 int ipc_msgq_delete(xf_msgq_t *cmdq, xf_msgq_t *respq);
+
+/* ...forward pending responses from response queue to the App Interface Layer */
+void rpmsg_response(UWORD32 core);
@@ -40,6 +40,7 @@ ifeq ($(CPU), gcc)
     RM_R = rm -rf
     MKPATH = mkdir -p
     CP = cp -f
+    RELOC_LDFLAGS = -no-pie
     INCLUDES += \
     -I$(ROOTDIR)/test/include
 else
@@ -57,7 +58,9 @@ endif
 #CFLAGS += -Wno-unused -DXF_TRACE=1
 CFLAGS += -DHIFI_ONLY_XAF
 
+ifneq ($(CPU), gcc)
 ISR_SAFE_CFLAGS = -mcoproc
+endif
 
 OBJDIR = objs$(S)$(CODEC_NAME)
 LIBDIR = $(ROOTDIR)$(S)lib
@@ -110,13 +113,13 @@ $(OBJDIR):
 ifeq ($(NOSTRIP), 1)
 $(LIBOBJ): $(OBJ_LIBO2OBJS) $(OBJ_LIBOSOBJS) $(OBJ_LIBISROBJS) $(OBJS_LIST)
 	@echo "Linking Objects"
-	$(QUIET) $(CC) -o $@ $^ \
+	$(QUIET) $(CC) $(RELOC_LDFLAGS) -o $@ $^ \
 	-Wl,-r,-Map,$(MAPFILE) --no-standard-libraries \
 	-Wl,--script,$(LDSCRIPT)
 else
 $(LIBOBJ): $(OBJ_LIBO2OBJS) $(OBJ_LIBOSOBJS) $(OBJ_LIBISROBJS) $(OBJS_LIST)
 	@echo "Linking Objects"
-	$(QUIET) $(CC) -o $@ $^ \
+	$(QUIET) $(CC) $(RELOC_LDFLAGS) -o $@ $^ \
 	-Wl,-r,-Map,$(MAPFILE) --no-standard-libraries \
 	-Wl,--retain-symbols-file,$(SYMFILE) \
 	-Wl,--script,$(LDSCRIPT)
@@ -48,7 +48,9 @@ enum xa_config_param_capturer {
     XA_CAPTURER_CONFIG_PARAM_BYTES_PRODUCED  = 6,
     XA_CAPTURER_CONFIG_PARAM_SAMPLE_END      = 7,
     XA_CAPTURER_CONFIG_PARAM_FRAME_SIZE_IN_SAMPLES = 8,    /* frame size per channel in samples */
-    XA_CAPTURER_CONFIG_PARAM_NUM            = 9
+    XA_CAPTURER_CONFIG_PARAM_XRUN_COUNT     = 9,    /* number of overruns, read-only; also raised as event (software-timed capturer) */
+    XA_CAPTURER_CONFIG_PARAM_TIMER_JITTER   = 10,   /* worst period deadline lateness in microseconds, read-only (software-timed capturer) */
+    XA_CAPTURER_CONFIG_PARAM_NUM            = 11
 };
 
 /* ...XA_CAPTURER_CONFIG_PARAM_CB: compound parameters data structure */
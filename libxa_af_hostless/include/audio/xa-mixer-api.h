@@ -58,14 +58,31 @@ enum xa_config_param_mixer {
     XA_MIXER_CONFIG_PARAM_BUFFER_SIZE       = 6,
     XA_MIXER_CONFIG_PARAM_VOLUME            = 7,
     XA_MIXER_CONFIG_PARAM_FRAME_SIZE_IN_SAMPLES = 8,    /* frame size per channel in samples */
-    XA_MIXER_CONFIG_PARAM_NUM               = 9
+    XA_MIXER_CONFIG_PARAM_SAMPLE_FORMAT     = 9,    /* XA_MIXER_SAMPLE_FORMAT_INT or XA_MIXER_SAMPLE_FORMAT_FLOAT */
+    XA_MIXER_CONFIG_PARAM_NUM               = 10
+};
+
+/* ...sample formats; floating-point samples require PCM width 32 */
+enum xa_mixer_sample_format {
+    XA_MIXER_SAMPLE_FORMAT_INT              = 0,
+    XA_MIXER_SAMPLE_FORMAT_FLOAT            = 1
 };
 
 /* ...component identifier (informative) */
 #define XA_CODEC_MIXER                  2
 
-/* ...global limitation - maximal mixer track number */
+/* ...global limitation - maximal mixer track number, within 1..14: tracks take
+ * port ids 0..N-1, output port follows the last track and probe port follows
+ * the output, so all of them must fit 4-bit port id. Host and DSP sides must be
+ * built with the same value; xaf_comp_create_ext() rejects a mixer requesting
+ * more tracks (xaf_comp_config_ext_t.num_input_ports) than were built in */
+#ifndef XA_MIXER_MAX_TRACK_NUMBER
 #define XA_MIXER_MAX_TRACK_NUMBER       4
+#endif
+
+#if XA_MIXER_MAX_TRACK_NUMBER < 1 || XA_MIXER_MAX_TRACK_NUMBER > 14
+#error "XA_MIXER_MAX_TRACK_NUMBER must be within 1..14"
+#endif
 
 /* ...volume representation */
 #define __XA_MIXER_VOLUME(v)            \
@@ -75,6 +92,10 @@ enum xa_config_param_mixer {
 #define XA_MIXER_VOLUME(track, channel, volume) \
     (__XA_MIXER_VOLUME(volume) | ((track) << 16) | ((channel) << 20))
 
+/* ...track index of master volume, and channel index addressing all channels */
+#define XA_MIXER_VOLUME_MASTER          XA_MIXER_MAX_TRACK_NUMBER
+#define XA_MIXER_VOLUME_ALL_CHANNELS    0xF
+
 /*******************************************************************************
  * Class 0: API Errors
  ******************************************************************************/
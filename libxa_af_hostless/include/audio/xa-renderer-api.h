@@ -47,7 +47,21 @@ enum xa_config_param_renderer {
     XA_RENDERER_CONFIG_PARAM_FRAME_SIZE     = 5,    /* frame size per channel in bytes. Deprecated, use XA_RENDERER_CONFIG_PARAM_FRAME_SIZE_IN_SAMPLES instead. */
 	XA_RENDERER_CONFIG_PARAM_BYTES_PRODUCED = 6,
     XA_RENDERER_CONFIG_PARAM_FRAME_SIZE_IN_SAMPLES = 7,    /* frame size per channel in samples */
-    XA_RENDERER_CONFIG_PARAM_NUM            = 8
+    XA_RENDERER_CONFIG_PARAM_PERIOD_SIZE    = 8,    /* DMA period per channel in samples, 0 - same as frame size */
+    XA_RENDERER_CONFIG_PARAM_LATENCY        = 9,    /* output ring latency in microseconds, 0 - two periods */
+    XA_RENDERER_CONFIG_PARAM_DMA_RING       = 10,   /* pointer to DMA ring layout (xa_renderer_dma_ring_t *), read-only */
+    XA_RENDERER_CONFIG_PARAM_FIFO_LEVEL     = 11,   /* bytes queued in DMA ring (including playing period), read-only */
+    XA_RENDERER_CONFIG_PARAM_UNDERRUN_MODE  = 12,   /* underrun handling, see xa_renderer_underrun_mode */
+    XA_RENDERER_CONFIG_PARAM_XRUN_COUNT     = 13,   /* number of underruns, read-only; also raised as event */
+    XA_RENDERER_CONFIG_PARAM_TIMER_JITTER   = 14,   /* worst period deadline lateness in microseconds, read-only (software-timed renderer) */
+    XA_RENDERER_CONFIG_PARAM_NUM            = 15
+};
+
+/* ...XA_RENDERER_CONFIG_PARAM_UNDERRUN_MODE values; DMA renderer reserves a third ring period to conceal */
+enum xa_renderer_underrun_mode {
+    XA_RENDERER_UNDERRUN_STOP    = 0,   /* stop hardware and restart after prefill (default) */
+    XA_RENDERER_UNDERRUN_SILENCE = 1,   /* keep DMA running, play a period of silence */
+    XA_RENDERER_UNDERRUN_REPEAT  = 2    /* keep DMA running, repeat last period fading out */
 };
 
 /* ...XA_RENDERER_CONFIG_PARAM_CB: compound parameters data structure */
@@ -56,6 +70,19 @@ typedef struct xa_renderer_cb_s {
     void      (*cb)(struct xa_renderer_cb_s *, WORD32 idx);
 
 }   xa_renderer_cb_t;
+
+/* ...XA_RENDERER_CONFIG_PARAM_DMA_RING: period buffers of hardware ring */
+typedef struct xa_renderer_dma_ring_s {
+    /* ...ring start; period "i" is at base + i * period_bytes */
+    void       *base;
+
+    /* ...length of one DMA period in bytes */
+    UWORD32     period_bytes;
+
+    /* ...number of periods in the ring */
+    UWORD32     period_count;
+
+}   xa_renderer_dma_ring_t;
     
 
 /* ...renderer states  */
@@ -35,6 +35,7 @@
 
 #include <FreeRTOS.h>
 #include <timers.h>
+#include <xtensa/hal.h>
 
 /*******************************************************************************
  * Timer support
@@ -87,6 +88,21 @@ static inline int __xf_timer_destroy(xf_timer_t *timer)
     return xTimerDelete(timer->timer, portMAX_DELAY) == pdPASS ? 0 : -1;
 }
 
+/*******************************************************************************
+ * Free-running counter (profiling)
+ ******************************************************************************/
+
+/* ...core cycle counter */
+static inline unsigned long __xf_get_cycles(void)
+{
+    return xthal_get_ccount();
+}
+
+static inline unsigned long __xf_get_cycles_freq(void)
+{
+    return configCPU_CLOCK_HZ;
+}
+
 #if 0
 static inline void __xf_sleep(unsigned long period)
 {
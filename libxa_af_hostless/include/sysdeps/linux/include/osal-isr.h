@@ -0,0 +1,68 @@
+/*
+* Copyright (c) 2015-2021 Cadence Design Systems Inc.
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#ifndef _OSAL_ISR_H
+#define _OSAL_ISR_H
+
+#include <pthread.h>
+
+/* ...there is no interrupt controller on a host; size of IRQ table only */
+#define XF_NUM_INTERRUPTS       32
+
+typedef void xf_isr(void *arg);
+
+/*
+ * Set ISR and threaded handler for an IRQ.
+ *
+ * There are no hardware interrupts when the DSP core runs as a host process,
+ * so handlers are only recorded; irq must be below XF_NUM_INTERRUPTS.
+ */
+int __xf_set_threaded_irq_handler(int irq,
+                                  xf_isr *irq_handler,
+                                  xf_isr *threaded_handler,
+                                  void *arg);
+
+int __xf_unset_threaded_irq_handler(int irq);
+
+/* ...interrupt masking is emulated with a process-wide recursive mutex */
+extern pthread_mutex_t __xf_isr_lock;
+
+static inline unsigned long __xf_disable_interrupts(void)
+{
+    pthread_mutex_lock(&__xf_isr_lock);
+    return 0;
+}
+
+static inline void __xf_restore_interrupts(unsigned long prev)
+{
+    pthread_mutex_unlock(&__xf_isr_lock);
+}
+
+static inline void __xf_enable_interrupt(int irq)
+{
+}
+
+static inline void __xf_disable_interrupt(int irq)
+{
+}
+
+#endif
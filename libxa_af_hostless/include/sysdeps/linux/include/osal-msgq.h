@@ -23,46 +23,161 @@
 #ifndef _OSAL_MSGQ_H
 #define _OSAL_MSGQ_H
 
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include "xaf-api.h"
+
+/*******************************************************************************
+ * Global Definitions
+ ******************************************************************************/
+
+/* ...bounded FIFO of fixed-size items guarded by a mutex */
 typedef struct {
-    size_t  size;
+    pthread_mutex_t     lock;
+    pthread_cond_t      not_empty;
+    pthread_cond_t      not_full;
+    size_t              n_items;
+    size_t              item_size;
+    size_t              head;
+    size_t              count;
+    unsigned char       data[];
 } *xf_msgq_t;
 
 /* ...open proxy interface on proper DSP partition */
 static inline xf_msgq_t __xf_msgq_create(size_t n_items, size_t item_size)
 {
-    return NULL;
+    xf_msgq_t q;
+    pthread_condattr_t attr;
+
+    q = malloc(sizeof(*q) + n_items * item_size);
+    if (!q)
+        return NULL;
+
+    /* ...timed waits are measured against monotonic clock */
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_mutex_init(&q->lock, NULL);
+    pthread_cond_init(&q->not_empty, &attr);
+    pthread_cond_init(&q->not_full, &attr);
+    pthread_condattr_destroy(&attr);
+
+    q->n_items = n_items;
+    q->item_size = item_size;
+    q->head = q->count = 0;
+
+    return q;
 }
 
 /* ...close proxy handle */
 static inline void __xf_msgq_destroy(xf_msgq_t q)
 {
+    pthread_cond_destroy(&q->not_full);
+    pthread_cond_destroy(&q->not_empty);
+    pthread_mutex_destroy(&q->lock);
+    free(q);
 }
 
 static inline int __xf_msgq_send(xf_msgq_t q, const void *data, size_t sz)
 {
-	return 0;
+    size_t tail;
+
+    pthread_mutex_lock(&q->lock);
+    while (q->count == q->n_items)
+        pthread_cond_wait(&q->not_full, &q->lock);
+
+    tail = (q->head + q->count) % q->n_items;
+    memcpy(q->data + tail * q->item_size, data, q->item_size);
+    q->count++;
+
+    pthread_cond_signal(&q->not_empty);
+    pthread_mutex_unlock(&q->lock);
+
+    return XAF_NO_ERR;
 }
 
 #define MAXIMUM_TIMEOUT 10000
 
+/* ...take item at the head of the queue; lock must be held */
+static inline void __xf_msgq_pop(xf_msgq_t q, void *data)
+{
+    memcpy(data, q->data + q->head * q->item_size, q->item_size);
+    q->head = (q->head + 1) % q->n_items;
+    q->count--;
+    pthread_cond_signal(&q->not_full);
+}
+
+/* ...release queue lock if waiting thread gets cancelled */
+static inline void __xf_msgq_unlock(void *arg)
+{
+    pthread_mutex_unlock(arg);
+}
+
 static inline int __xf_msgq_recv_blocking(xf_msgq_t q, void *data, size_t sz)
 {
-	return 0;
+    pthread_mutex_lock(&q->lock);
+    pthread_cleanup_push(__xf_msgq_unlock, &q->lock);
+    while (q->count == 0)
+        pthread_cond_wait(&q->not_empty, &q->lock);
+
+    __xf_msgq_pop(q, data);
+    pthread_cleanup_pop(1);
+
+    return XAF_NO_ERR;
 }
 
 static inline int __xf_msgq_recv(xf_msgq_t q, void *data, size_t sz)
 {
-	return 0;
+    struct timespec ts;
+    int ret = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    ts.tv_sec += MAXIMUM_TIMEOUT / 1000;
+    ts.tv_nsec += (MAXIMUM_TIMEOUT % 1000) * 1000000;
+    if (ts.tv_nsec >= 1000000000)
+    {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000;
+    }
+
+    pthread_mutex_lock(&q->lock);
+    while (q->count == 0 && ret == 0)
+        ret = pthread_cond_timedwait(&q->not_empty, &q->lock, &ts);
+
+    if (q->count == 0)
+    {
+        pthread_mutex_unlock(&q->lock);
+        return (ret == ETIMEDOUT ? XAF_TIMEOUT_ERR : XAF_RTOS_ERR);
+    }
+
+    __xf_msgq_pop(q, data);
+    pthread_mutex_unlock(&q->lock);
+
+    return XAF_NO_ERR;
 }
 
 static inline int __xf_msgq_empty(xf_msgq_t q)
 {
-	return 0;
+    int empty;
+
+    pthread_mutex_lock(&q->lock);
+    empty = (q->count == 0);
+    pthread_mutex_unlock(&q->lock);
+
+    return empty;
 }
 
 static inline int __xf_msgq_full(xf_msgq_t q)
 {
-	return 0;
+    int full;
+
+    pthread_mutex_lock(&q->lock);
+    full = (q->count == q->n_items);
+    pthread_mutex_unlock(&q->lock);
+
+    return full;
 }
 
 #endif
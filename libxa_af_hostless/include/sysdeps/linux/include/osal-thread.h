@@ -36,6 +36,8 @@
 #include <stdint.h>
 #include <semaphore.h>
 #include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
 /*******************************************************************************
  * Tracing primitive
  ******************************************************************************/
@@ -79,41 +81,73 @@ static inline void __xf_unlock(xf_lock_t *lock)
  * Event support
  ******************************************************************************/
 
-typedef int     xf_event_t;
+/* ...event bits protected by a mutex; waiters are woken up on every update */
+typedef struct {
+    pthread_mutex_t     lock;
+    pthread_cond_t      cond;
+    uint32_t            bits;
+    uint32_t            mask;
+} xf_event_t;
 
 static inline void __xf_event_init(xf_event_t *event, uint32_t mask)
 {
+    pthread_mutex_init(&event->lock, NULL);
+    pthread_cond_init(&event->cond, NULL);
+    event->bits = 0;
+    event->mask = mask;
 }
 
 static inline void __xf_event_destroy(xf_event_t *event)
 {
+    pthread_cond_destroy(&event->cond);
+    pthread_mutex_destroy(&event->lock);
 }
 
 static inline uint32_t __xf_event_get(xf_event_t *event)
 {
-    uint32_t rv = 0;
+    uint32_t rv;
+
+    pthread_mutex_lock(&event->lock);
+    rv = event->bits;
+    pthread_mutex_unlock(&event->lock);
 
     return rv;
 }
 
 static inline void __xf_event_set(xf_event_t *event, uint32_t mask)
 {
+    pthread_mutex_lock(&event->lock);
+    event->bits |= mask & event->mask;
+    pthread_cond_broadcast(&event->cond);
+    pthread_mutex_unlock(&event->lock);
 }
 
 static inline void __xf_event_set_isr(xf_event_t *event, uint32_t mask)
 {
+    __xf_event_set(event, mask);
 }
 
 static inline void __xf_event_clear(xf_event_t *event, uint32_t mask)
 {
+    pthread_mutex_lock(&event->lock);
+    event->bits &= ~mask;
+    pthread_mutex_unlock(&event->lock);
 }
 
 static inline void __xf_event_wait_any(xf_event_t *event, uint32_t mask)
 {
+    pthread_mutex_lock(&event->lock);
+    while ((event->bits & mask) == 0)
+        pthread_cond_wait(&event->cond, &event->lock);
+    pthread_mutex_unlock(&event->lock);
 }
 
 static inline void __xf_event_wait_all(xf_event_t *event, uint32_t mask)
 {
+    pthread_mutex_lock(&event->lock);
+    while ((event->bits & mask) != mask)
+        pthread_cond_wait(&event->cond, &event->lock);
+    pthread_mutex_unlock(&event->lock);
 }
 
 
@@ -160,10 +194,19 @@ static inline int __xf_thread_cancel(xf_thread_t *thread)
 /* TENA-2117*/
 static inline int __xf_thread_join(xf_thread_t *thread, int32_t * p_exitcode)
 {
-    int    r;
+    int    r = 0;
+    void  *status;
 
     if (*thread != 0UL)
-        r = pthread_join(*thread, (void **)&p_exitcode);
+    {
+        r = pthread_join(*thread, &status);
+
+        /* ...thread handle is no longer valid; destroy becomes a no-op */
+        *thread = 0UL;
+
+        if (r == 0 && p_exitcode)
+            *p_exitcode = (status == PTHREAD_CANCELED ? -1 : (int32_t)(intptr_t)status);
+    }
 
     return r;
 }
@@ -171,7 +214,7 @@ static inline int __xf_thread_join(xf_thread_t *thread, int32_t * p_exitcode)
 /* ...terminate thread operation */
 static inline int __xf_thread_destroy(xf_thread_t *thread)
 {
-    int    r;
+    int    r = 0;
     
     if (*thread != 0UL)
         r = pthread_kill(*thread, SIGUSR1);
@@ -190,7 +233,7 @@ static inline int32_t __xf_thread_sleep_msec(uint64_t msecs)
 {
     int32_t    r;
     
-    usleep(msecs * 1000);
+    r = usleep(msecs * 1000);
     
     /* ...return final status */
     return r;
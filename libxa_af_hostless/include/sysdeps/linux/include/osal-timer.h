@@ -0,0 +1,128 @@
+/*
+* Copyright (c) 2015-2021 Cadence Design Systems Inc.
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/*******************************************************************************
+ * osal-timer.h
+ *
+ * OS absraction layer (minimalistic) for Linux
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#ifndef _OSAL_TIMER_H
+#define _OSAL_TIMER_H
+
+#include <stddef.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+
+/*******************************************************************************
+ * Timer support
+ ******************************************************************************/
+
+typedef void xf_timer_fn_t(void *arg);
+typedef struct xf_timer {
+    timer_t timer;
+    xf_timer_fn_t *fn;
+    void *arg;
+    int autoreload;
+} xf_timer_t;
+
+/* ...timer expiration is delivered in a helper thread (thread context) */
+static inline void __xf_linux_timer_wrapper(union sigval v)
+{
+    xf_timer_t *timer = v.sival_ptr;
+
+    timer->fn(timer->arg);
+}
+
+static inline int __xf_timer_init(xf_timer_t *timer, xf_timer_fn_t *fn,
+                                  void *arg, int autoreload)
+{
+    struct sigevent sev;
+
+    timer->fn = fn;
+    timer->arg = arg;
+    timer->autoreload = autoreload;
+
+    memset(&sev, 0, sizeof(sev));
+    sev.sigev_notify = SIGEV_THREAD;
+    sev.sigev_notify_function = __xf_linux_timer_wrapper;
+    sev.sigev_value.sival_ptr = timer;
+
+    return timer_create(CLOCK_MONOTONIC, &sev, &timer->timer);
+}
+
+/* ...timer period is expressed in nanoseconds */
+static inline unsigned long __xf_timer_ratio_to_period(unsigned long numerator,
+                                                       unsigned long denominator)
+{
+    return numerator * 1000000000ull / denominator;
+}
+
+static inline int __xf_timer_start(xf_timer_t *timer, unsigned long period)
+{
+    struct itimerspec its;
+
+    its.it_value.tv_sec = period / 1000000000ul;
+    its.it_value.tv_nsec = period % 1000000000ul;
+    its.it_interval = (timer->autoreload ? its.it_value : (struct timespec){0, 0});
+
+    return timer_settime(timer->timer, 0, &its, NULL);
+}
+
+static inline int __xf_timer_stop(xf_timer_t *timer)
+{
+    struct itimerspec its;
+
+    memset(&its, 0, sizeof(its));
+
+    return timer_settime(timer->timer, 0, &its, NULL);
+}
+
+static inline int __xf_timer_destroy(xf_timer_t *timer)
+{
+    return timer_delete(timer->timer);
+}
+
+/*******************************************************************************
+ * Free-running counter (profiling)
+ ******************************************************************************/
+
+/* ...counter ticks in nanoseconds on a host */
+static inline unsigned long __xf_get_cycles(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (unsigned long)(ts.tv_sec * 1000000000ull + ts.tv_nsec);
+}
+
+static inline unsigned long __xf_get_cycles_freq(void)
+{
+    return 1000000000ul;
+}
+
+#endif
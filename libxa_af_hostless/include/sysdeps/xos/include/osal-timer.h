@@ -79,6 +79,20 @@ static inline int __xf_timer_destroy(xf_timer_t *timer)
     return 0;
 }
 
+/*******************************************************************************
+ * Free-running counter (profiling)
+ ******************************************************************************/
+
+static inline unsigned long __xf_get_cycles(void)
+{
+    return (unsigned long)xos_get_system_cycles();
+}
+
+static inline unsigned long __xf_get_cycles_freq(void)
+{
+    return xos_get_clock_freq();
+}
+
 #if 0
 static inline void __xf_sleep(unsigned long period)
 {
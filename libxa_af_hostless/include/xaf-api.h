@@ -28,7 +28,8 @@
 
 /* Constants */
 #define XAF_MAX_INBUFS                      2
-#define XAF_INBUF_SIZE                      4096
+#define XAF_MAX_INBUFS_EXT                  16      /* ...input buffers with xaf_comp_create_ext() */
+#define XAF_INBUF_SIZE                      4096    /* ...default input buffer size */
 #define XAF_SHMEM_STRUCT_SIZE               12288
 
 /* Port BITMASK creation macro */
@@ -36,6 +37,11 @@
 
 #define XAF_MAX_WORKER_THREADS              16
 
+/* ...mixer input tracks (1..14, see xa-mixer-api.h); mixer output port follows the last track (DSP build must use the same value) */
+#ifndef XA_MIXER_MAX_TRACK_NUMBER
+#define XA_MIXER_MAX_TRACK_NUMBER           4
+#endif
+
 /* ...num thread arguments to DSP */
 #define XAF_NUM_THREAD_ARGS                 16
 
@@ -166,6 +172,131 @@ typedef struct xaf_comp_config_s{
 #endif
 }xaf_comp_config_t;
 
+/* ...extended component configuration (xaf_comp_create_ext); config_size is the
+ * size of the structure the application was built with, and fields past it
+ * take their default values, so that fields may be appended in later releases */
+typedef struct xaf_comp_config_ext_s{
+	UWORD32 config_size;
+	UWORD32 num_input_buffers;  /* ...0..XAF_MAX_INBUFS_EXT; replaces xaf_comp_config_t value */
+	UWORD32 input_buffer_size;  /* ...size of each input buffer; 0 (default) selects XAF_INBUF_SIZE */
+	pVOID *pp_inbuf;            /* ...array of num_input_buffers pointers, filled by create */
+	UWORD32 num_input_ports;    /* ...mixer tracks needed, up to XA_MIXER_MAX_TRACK_NUMBER; 0 (default) selects all */
+}xaf_comp_config_ext_t;
+
+/* ...descriptor of one xaf_comp_process() call in a batch */
+typedef struct xaf_comp_process_desc_s{
+	pVOID comp_ptr;
+	pVOID p_buf;
+	UWORD32 length;
+	xaf_comp_flag flag;
+	XAF_ERR_CODE err;           /* ...result of this entry (output) */
+}xaf_comp_process_desc_t;
+
+/* ...descriptor of one xaf_comp_get_status() call in a batch */
+typedef struct xaf_comp_status_desc_s{
+	pVOID comp_ptr;
+	UWORD32 ready;              /* ...set if a response was consumed (output) */
+	xaf_comp_status status;     /* ...component status (output) */
+	long info[2];               /* ...same as p_info of xaf_comp_get_status (output) */
+	UWORD32 event;              /* ...set if the response was an event; status is unchanged (output) */
+	XAF_ERR_CODE err;           /* ...result of this entry (output) */
+}xaf_comp_status_desc_t;
+
+/* ...statistics of one DSP memory pool */
+typedef struct xaf_mem_pool_stats_s{
+	UWORD32 size;               /* ...total pool size */
+	UWORD32 used;               /* ...bytes allocated */
+	UWORD32 peak;               /* ...high-water mark of allocated bytes */
+	UWORD32 cached;             /* ...bytes held in slab caches for reuse */
+	UWORD32 free;               /* ...bytes in free blocks */
+	UWORD32 free_blocks;        /* ...number of free blocks */
+	UWORD32 largest_free;       /* ...largest free block; free / largest_free shows fragmentation */
+	UWORD32 slab_hits;          /* ...allocations served from slab caches */
+	UWORD32 slab_refills;       /* ...slab cache refills from the pool */
+}xaf_mem_pool_stats_t;
+
+/* ...DSP memory statistics */
+typedef struct xaf_mem_stats_s{
+	xaf_mem_pool_stats_t local;     /* ...DSP local memory (component buffers) */
+	xaf_mem_pool_stats_t shared;    /* ...AP-DSP shared memory (framework buffers) */
+}xaf_mem_stats_t;
+
+/* ...component profile histograms: log2 bins, bin 0 below 2^(XAF_PROFILE_HIST_SHIFT + 1) cycles */
+#define XAF_PROFILE_HIST_BINS       14
+#define XAF_PROFILE_HIST_SHIFT      10
+
+/* ...per-component execution profile (counter ticks at clock_freq) */
+typedef struct xaf_comp_profile_s{
+	UWORD64 cycles;             /* ...total processing time, framework overhead included */
+	UWORD64 preprocess_cycles;  /* ...total time in component preprocessing */
+	UWORD64 execute_cycles;     /* ...total time in plugin init/execute calls */
+	UWORD64 postprocess_cycles; /* ...total time in component postprocessing */
+	UWORD64 wait_cycles;        /* ...total time between scheduling and execution */
+	UWORD32 clock_freq;         /* ...counter frequency, Hz */
+	UWORD32 hist_shift;         /* ...XAF_PROFILE_HIST_SHIFT of DSP build */
+	UWORD32 frames;             /* ...number of processing invocations */
+	UWORD32 missed_deadlines;   /* ...invocations completed later than scheduling period */
+	UWORD32 cycles_max;
+	UWORD32 preprocess_max;
+	UWORD32 execute_max;
+	UWORD32 postprocess_max;
+	UWORD32 wait_max;
+	UWORD32 preprocess_hist[XAF_PROFILE_HIST_BINS];
+	UWORD32 execute_hist[XAF_PROFILE_HIST_BINS];
+	UWORD32 postprocess_hist[XAF_PROFILE_HIST_BINS];
+}xaf_comp_profile_t;
+
+/* ...latency histogram: 2^XAF_LATENCY_HIST_SUB_BITS linear sub-bins per octave of microseconds, up to ~2 sec */
+#define XAF_LATENCY_HIST_SUB_BITS   3
+#define XAF_LATENCY_HIST_BINS       152
+
+/* ...end-to-end latency of data reaching a sink (renderer), from the buffer arrival at DSP */
+typedef struct xaf_comp_latency_s{
+	UWORD32 count;              /* ...number of buffers measured */
+	UWORD32 min_us;
+	UWORD32 max_us;
+	UWORD32 mean_us;
+	UWORD32 p50_us;             /* ...percentiles, interpolated within histogram bin */
+	UWORD32 p90_us;
+	UWORD32 p99_us;
+	UWORD32 p999_us;
+}xaf_comp_latency_t;
+
+/* ...event trace record types */
+enum xaf_trace_event_type {
+    XAF_TRACE_EV_DISPATCH       = 0,    /* ...message passed to component: id = message id, arg = length */
+    XAF_TRACE_EV_PROCESS_START  = 1,    /* ...component data processing started: id = component id */
+    XAF_TRACE_EV_PROCESS_END    = 2,    /* ...component data processing completed: id = component id */
+    XAF_TRACE_EV_SCHEDULE       = 3,    /* ...component scheduled: id = component id, arg = dts */
+    XAF_TRACE_EV_PORT_FILL      = 4,    /* ...input port filled: id = message id, arg = bytes, opcode = 1 if in-place */
+    XAF_TRACE_EV_PORT_PRODUCE   = 5,    /* ...output port produced: id = message id, arg = bytes */
+    XAF_TRACE_EV_IRQ            = 6,    /* ...message posted from interrupt: id = message id, arg = length */
+    XAF_TRACE_EV_NUM
+};
+
+/* ...event trace record */
+typedef struct xaf_trace_event_s{
+	UWORD32 ts;                 /* ...DSP counter value (clock_freq of file header) */
+	UWORD8  type;               /* ...xaf_trace_event_type */
+	UWORD8  opcode;             /* ...message opcode type, if any */
+	UWORD16 seq;                /* ...record sequence number (gaps show lost records) */
+	UWORD32 id;
+	UWORD32 arg;
+}xaf_trace_event_t;
+
+/* ...event trace file: header followed by records */
+#define XAF_TRACE_FILE_MAGIC        0x52544658      /* "XFTR" */
+#define XAF_TRACE_FILE_VERSION      1
+
+typedef struct xaf_trace_file_hdr_s{
+	UWORD32 magic;
+	UWORD32 version;
+	UWORD32 clock_freq;         /* ...DSP counter frequency, Hz */
+	UWORD32 event_size;         /* ...sizeof(xaf_trace_event_t) */
+	UWORD32 events;             /* ...number of records in the file */
+	UWORD32 dropped;            /* ...records overwritten before they were drained */
+}xaf_trace_file_hdr_t;
+
 /* Function prototypes */
 XAF_ERR_CODE xaf_adev_config_default_init(xaf_adev_config_t *pconfig);
 XAF_ERR_CODE xaf_adev_open(pVOID *pp_adev, xaf_adev_config_t *pconfig);
@@ -174,6 +305,10 @@ XAF_ERR_CODE xaf_adev_set_priorities(pVOID p_adev, WORD32 n_rt_priorities, WORD3
 
 XAF_ERR_CODE xaf_comp_config_default_init(xaf_comp_config_t *pconfig);
 XAF_ERR_CODE xaf_comp_create(pVOID p_adev, pVOID *pp_comp, xaf_comp_config_t *pconfig);
+/* ...config_size is sizeof(xaf_comp_config_ext_t) as seen by the application */
+XAF_ERR_CODE xaf_comp_config_ext_default_init(xaf_comp_config_ext_t *pconfig_ext, UWORD32 config_size);
+/* ...input buffers are described by pconfig_ext; num_input_buffers and pp_inbuf of pconfig are ignored */
+XAF_ERR_CODE xaf_comp_create_ext(pVOID p_adev, pVOID *pp_comp, xaf_comp_config_t *pconfig, xaf_comp_config_ext_t *pconfig_ext);
 XAF_ERR_CODE xaf_comp_delete(pVOID p_comp);
 XAF_ERR_CODE xaf_comp_set_config(pVOID p_comp, WORD32 num_param, pWORD32 p_param);
 XAF_ERR_CODE xaf_comp_get_config(pVOID p_comp, WORD32 num_param, pWORD32 p_param);
@@ -181,8 +316,19 @@ XAF_ERR_CODE xaf_comp_process(pVOID p_adev, pVOID p_comp, pVOID p_buf, UWORD32 l
 XAF_ERR_CODE xaf_connect(pVOID p_src, WORD32 src_out_port, pVOID p_dest, WORD32 dest_in_port, WORD32 num_buf);
 XAF_ERR_CODE xaf_disconnect(pVOID p_src, WORD32 src_out_port, pVOID p_dest, WORD32 dest_in_port);
 XAF_ERR_CODE xaf_get_mem_stats(pVOID p_dev, WORD32 *pmem_info);
+XAF_ERR_CODE xaf_get_mem_stats_ext(pVOID p_dev, xaf_mem_stats_t *p_stats);
+XAF_ERR_CODE xaf_trace_start(pVOID p_adev, const char *path);
+XAF_ERR_CODE xaf_trace_stop(pVOID p_adev);
 
 XAF_ERR_CODE xaf_comp_get_status(pVOID p_adev, pVOID p_comp, xaf_comp_status *p_status, pVOID p_info);
+/* ...on IPC failure, entries whose commands did not reach DSP (and all entries after them)
+ * get XAF_API_ERR; only entries with XAF_NO_ERR will be answered by xaf_comp_get_status() */
+XAF_ERR_CODE xaf_comp_process_batch(pVOID p_adev, xaf_comp_process_desc_t *p_desc, UWORD32 num);
+XAF_ERR_CODE xaf_comp_get_status_batch(pVOID p_adev, xaf_comp_status_desc_t *p_desc, UWORD32 num, UWORD32 *p_num_ready);
+XAF_ERR_CODE xaf_comp_get_profile(pVOID p_comp, xaf_comp_profile_t *p_profile);
+XAF_ERR_CODE xaf_comp_get_latency(pVOID p_comp, xaf_comp_latency_t *p_latency);
+/* ...returns a new dma-buf fd (caller owns it and must close it), and offset and length of the buffer in it */
+XAF_ERR_CODE xaf_comp_get_dmabuf(pVOID p_comp, pVOID p_buf, WORD32 *p_fd, UWORD32 *p_offset, UWORD32 *p_length);
 XAF_ERR_CODE xaf_get_verinfo(pUWORD8 ver_info[3]);
 
 XAF_ERR_CODE xaf_pause(pVOID p_comp, WORD32 port);
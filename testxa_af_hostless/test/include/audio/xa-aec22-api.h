@@ -58,6 +58,9 @@ enum xa_config_param_aec22 {
     XA_AEC22_CONFIG_PARAM_PORT_RESUME       = 5,
     XA_AEC22_CONFIG_PARAM_PORT_CONNECT      = 6,
     XA_AEC22_CONFIG_PARAM_PORT_DISCONNECT   = 7,
+    XA_AEC22_CONFIG_PARAM_TAIL_LENGTH       = 8,
+    XA_AEC22_CONFIG_PARAM_ERLE              = 9,
+    XA_AEC22_CONFIG_PARAM_DOUBLE_TALK       = 10,
 };
 
 /* ...component identifier (informative) */
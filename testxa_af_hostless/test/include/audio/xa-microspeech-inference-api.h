@@ -58,7 +58,15 @@ enum xa_config_param_microspeech {
     XA_MICROSPEECH_INFERENCE_CONFIG_PARAM_SAMPLE_RATE       = XA_INFERENCE_CONFIG_PARAM_SAMPLE_RATE,
     XA_MICROSPEECH_INFERENCE_CONFIG_PARAM_PCM_WIDTH         = XA_INFERENCE_CONFIG_PARAM_PCM_WIDTH,
     XA_MICROSPEECH_INFERENCE_CONFIG_PARAM_PRODUCED          = XA_INFERENCE_CONFIG_PARAM_PRODUCED,
-    XA_MICROSPEECH_INFERENCE_CONFIG_PARAM_FRAME_SIZE        = XA_INFERENCE_CONFIG_PARAM_FRAME_SIZE
+    XA_MICROSPEECH_INFERENCE_CONFIG_PARAM_FRAME_SIZE        = XA_INFERENCE_CONFIG_PARAM_FRAME_SIZE,
+    XA_MICROSPEECH_INFERENCE_CONFIG_PARAM_HOP_SIZE          = XA_INFERENCE_CONFIG_PARAM_HOP_SIZE,
+    XA_MICROSPEECH_INFERENCE_CONFIG_PARAM_BATCH_SIZE        = XA_INFERENCE_CONFIG_PARAM_BATCH_SIZE,
+    XA_MICROSPEECH_INFERENCE_CONFIG_PARAM_GATE_THRESHOLD    = XA_INFERENCE_CONFIG_PARAM_GATE_THRESHOLD,
+    XA_MICROSPEECH_INFERENCE_CONFIG_PARAM_INFERENCES        = XA_INFERENCE_CONFIG_PARAM_INFERENCES,
+    XA_MICROSPEECH_INFERENCE_CONFIG_PARAM_SKIPPED           = XA_INFERENCE_CONFIG_PARAM_SKIPPED,
+    XA_MICROSPEECH_INFERENCE_CONFIG_PARAM_CYCLES            = XA_INFERENCE_CONFIG_PARAM_CYCLES,
+    XA_MICROSPEECH_INFERENCE_CONFIG_PARAM_CYCLES_AVG        = XA_INFERENCE_CONFIG_PARAM_CYCLES_AVG,
+    XA_MICROSPEECH_INFERENCE_CONFIG_PARAM_SHARED_ARENA      = XA_INFERENCE_CONFIG_PARAM_SHARED_ARENA
 };
 
 /* ...microspeech component identifier (informative) */
@@ -58,7 +58,8 @@ enum xa_config_param_person_detect {
     XA_PERSON_DETECT_INFERENCE_CONFIG_PARAM_SAMPLE_RATE       = XA_INFERENCE_CONFIG_PARAM_SAMPLE_RATE,
     XA_PERSON_DETECT_INFERENCE_CONFIG_PARAM_PCM_WIDTH         = XA_INFERENCE_CONFIG_PARAM_PCM_WIDTH,
     XA_PERSON_DETECT_INFERENCE_CONFIG_PARAM_PRODUCED          = XA_INFERENCE_CONFIG_PARAM_PRODUCED,
-    XA_PERSON_DETECT_INFERENCE_CONFIG_PARAM_FRAME_SIZE        = XA_INFERENCE_CONFIG_PARAM_FRAME_SIZE
+    XA_PERSON_DETECT_INFERENCE_CONFIG_PARAM_FRAME_SIZE        = XA_INFERENCE_CONFIG_PARAM_FRAME_SIZE,
+    XA_PERSON_DETECT_INFERENCE_CONFIG_PARAM_SHARED_ARENA      = XA_INFERENCE_CONFIG_PARAM_SHARED_ARENA
 };
 
 /* ...person detect component identifier (informative) */
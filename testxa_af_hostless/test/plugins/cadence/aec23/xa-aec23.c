@@ -24,6 +24,10 @@
  * xa-aec23.c
  *
  * Sample aec23 plugin
+ *
+ * Acoustic echo canceller: mic (port 0) and far-end reference (port 1) in,
+ * echo-cancelled mic and reference passthrough out. Echo is removed by a
+ * partitioned-block frequency-domain NLMS filter per channel (xa-aec-fdaf.c).
  ******************************************************************************/
 
 #define MODULE_TAG                     AEC23 
@@ -37,6 +41,9 @@
 
 #include "audio/xa-aec23-api.h"
 
+/* ...echo canceller engine */
+#include "xa-aec-fdaf.h"
+
 /* ...debugging facility */
 #include "xf-debug.h"
 
@@ -112,6 +119,9 @@ typedef struct XAPcmAec
     UWORD32                 pcm_width;
     UWORD32                 channels;
 
+    /* ...echo tail length in samples */
+    UWORD32                 tail;
+
     WORD16		    port_state[XA_MIMO_IN_PORTS + XA_MIMO_OUT_PORTS];
 
 }   XAPcmAec;
@@ -130,24 +140,6 @@ typedef struct XAPcmAec
 #define XA_AEC_FLAG_PORT_PAUSED       (1 << 7)
 #define XA_AEC_FLAG_PORT_CONNECTED    (1 << 8)
 
-/****************************************************************************
- * Gain multiplier table
- ******************************************************************************/
-/*
-
-0db = 1
-
--6db = 0.50118723362727228500155418688495
--12db = 0.25118864315095801110850320677993
--18db = 0.12589254117941672104239541063958
-
-6db = 1.9952623149688796013524553967395
-12db = 3.9810717055349725077025230508775
-18db = 7.9432823472428150206591828283639
-*/
-
-static const WORD16 pcm_gains_aec[7]    = {4096, 2053, 1029, 516, 8173, 16306, 32536};    // Q12 format
-
 #define MAX_16BIT (32767)
 #define MIN_16BIT (-32768)
 
@@ -172,15 +164,27 @@ static inline void xa_aec_preinit(XAPcmAec *d)
     d->out_buffer_size 	= XA_MIMO_CFG_FRAME_SIZE_BYTES;
     d->persist_size 	= XA_MIMO_CFG_PERSIST_SIZE;
     d->scratch_size 	= XA_MIMO_CFG_SCRATCH_SIZE;
+    d->tail             = XA_AEC_FDAF_TAIL_DEFAULT;
 
     //d->port_state[4]    = XA_AEC_FLAG_PORT_PAUSED;
 }
 
-/* ...do pcm-gain scaling of stereo PCM-16 streams */
+/* ...reset echo canceller of every channel */
+static inline void xa_aec_reset(XAPcmAec *d)
+{
+    UWORD32     size = xa_aec_fdaf_persist_size(d->tail);
+    UWORD32     i;
+
+    for (i = 0; i < d->channels; i++)
+    {
+        xa_aec_fdaf_init((UWORD8 *)d->persist + i * size, d->tail);
+    }
+}
+
+/* ...cancel echo of stereo PCM-16 streams */
 static XA_ERRORCODE xa_aec_do_execute_stereo_16bit(XAPcmAec *d)
 {
     WORD32     i, nSize, in_length;
-    WORD32     product0, product1;
 
     if((d->num_in_ports == 2) && (d->num_out_ports == 3))
     {
@@ -190,7 +194,7 @@ static XA_ERRORCODE xa_aec_do_execute_stereo_16bit(XAPcmAec *d)
       WORD16    *pOut0 = (WORD16 *) d->output[0];
       WORD16    *pOut1 = (WORD16 *) d->output[1];
       WORD16    *pOut2 = (WORD16 *) d->output[2];
-      WORD16    gain0 = pcm_gains_aec[0], gain1 = pcm_gains_aec[0];
+      UWORD32   size = xa_aec_fdaf_persist_size(d->tail);
 
       /* reset consumed/produced counters */
       for (i = 0;i < (d->num_in_ports); i++)
@@ -272,43 +276,13 @@ static XA_ERRORCODE xa_aec_do_execute_stereo_16bit(XAPcmAec *d)
 
       nSize = XA_MIMO_CFG_FRAME_SIZE_BYTES >> 1;    //size of each sample is 2 bytes    
 
-      for (i=0;(i < d->input_length[0]>>1); i++)
-      {
-          WORD16   input0;
-          input0 = *pIn0++;
-          product0 = (WORD32)input0*gain0;
-          product0 = product0 >> 12;
-          
-          product0 = _MIN(MAX_16BIT, _MAX(product0, MIN_16BIT));
-          
-          *pOut0++ = (WORD16)product0;
-      }
-      for (;i < nSize; i++)
-      {
-          *pOut0++ = 0;
-      }
-      /* ...save total number of consumed bytes */
-      d->consumed[0] = d->input_length[0];
-      d->input_length[0] = 0;
-      d->produced[0] = XA_MIMO_CFG_FRAME_SIZE_BYTES;
-
       /* zero feed if FEEDBACK input port is paused OR not connected */
-      in_length = ((d->port_state[1] & XA_AEC_FLAG_PORT_PAUSED) || !(d->port_state[1] & XA_AEC_FLAG_PORT_CONNECTED))? 0 :(d->input_length[1]>>1);
-      for (i=0;(i < in_length); i++)
-      {
-          WORD16   input1;
-          input1 = *pIn1++;
-          product1 = (WORD32)input1 * gain1;
-          product1 = product1 >> 12;
-          
-          product1 = _MIN(MAX_16BIT, _MAX(product1, MIN_16BIT));
-          
-          *pOut1++ = (WORD16)product1;
-      }
-      for (;i < nSize; i++)
-      {
-          *pOut1++ = 0;
-      }
+      in_length = ((d->port_state[1] & XA_AEC_FLAG_PORT_PAUSED) || !(d->port_state[1] & XA_AEC_FLAG_PORT_CONNECTED))? 0 :_MIN(d->input_length[1]>>1, nSize);
+
+      /* ...reference passthrough, zero-padded to full frame */
+      memcpy(pOut1, pIn1, in_length << 1);
+      memset(pOut1 + in_length, 0, (nSize - in_length) << 1);
+
       /* ...save total number of consumed bytes */
       if(in_length)
       {
@@ -319,24 +293,24 @@ static XA_ERRORCODE xa_aec_do_execute_stereo_16bit(XAPcmAec *d)
       
       if(!(d->port_state[4] & XA_AEC_FLAG_PORT_PAUSED) && (d->port_state[4] & XA_AEC_FLAG_PORT_CONNECTED))
       {
-        WORD16    *pIn1 = (WORD16 *) d->input[1];
-        for (i=0;(i < in_length); i++)
-        {
-            WORD16   input1;
-            input1 = *pIn1++;
-            product1 = (WORD32)input1 * gain1;
-            product1 = product1 >> 12;
-            
-            product1 = _MIN(MAX_16BIT, _MAX(product1, MIN_16BIT));
-            
-            *pOut2++ = (WORD16)product1;
-        }
-        for (;i < nSize; i++)
-        {
-            *pOut2++ = 0;
-        }
+        memcpy(pOut2, pOut1, nSize << 1);
         d->produced[2] = XA_MIMO_CFG_FRAME_SIZE_BYTES;
       }
+
+      /* ...mic frame, zero-padded; echo is cancelled in place per channel */
+      i = _MIN(d->input_length[0]>>1, nSize);
+      memcpy(pOut0, pIn0, i << 1);
+      memset(pOut0 + i, 0, (nSize - i) << 1);
+
+      for (i = 0; i < d->channels; i++)
+      {
+        xa_aec_fdaf_process((UWORD8 *)d->persist + i * size, d->scratch, pOut0 + i, pOut0 + i, (in_length ? pOut1 + i : NULL), d->channels, nSize / d->channels);
+      }
+
+      /* ...save total number of consumed bytes */
+      d->consumed[0] = d->input_length[0];
+      d->input_length[0] = 0;
+      d->produced[0] = XA_MIMO_CFG_FRAME_SIZE_BYTES;
       
       /* ...put flag saying we have output buffer */
       d->state |= XA_AEC_FLAG_OUTPUT;
@@ -380,7 +354,9 @@ static XA_ERRORCODE xa_aec_do_execute_stereo_16bit(XAPcmAec *d)
 /* ...runtime reset */
 static XA_ERRORCODE xa_aec_do_runtime_init(XAPcmAec *d)
 {
-    /* ...no special processing is needed here */
+    /* ...restart adaptation from scratch */
+    xa_aec_reset(d);
+
     return XA_NO_ERROR;
 }
 
@@ -425,6 +401,10 @@ static XA_ERRORCODE xa_aec_init(XAPcmAec *d, WORD32 i_idx, pVOID pv_value)
     
         /* ...calculate input/output buffer size in bytes */
         //d->in_buffer_size = d->channels * d->frame_size * (d->pcm_width == 16 ? sizeof(WORD16) : sizeof(WORD32));
+
+        /* ...one echo canceller per channel; scratch is shared */
+        d->persist_size = d->channels * xa_aec_fdaf_persist_size(d->tail);
+        d->scratch_size = xa_aec_fdaf_scratch_size();
         
         /* ...mark post-initialization is complete */
         d->state |= XA_AEC_FLAG_POSTINIT_DONE;
@@ -437,6 +417,12 @@ static XA_ERRORCODE xa_aec_init(XAPcmAec *d, WORD32 i_idx, pVOID pv_value)
         /* ...kick run-time initialization process; make sure aec is setup */
         XF_CHK_ERR(d->state & XA_AEC_FLAG_POSTINIT_DONE, XA_API_FATAL_INVALID_CMD_TYPE);
 
+        /* ...persistent and scratch memory must be set */
+        XF_CHK_ERR(d->persist && d->scratch, XA_API_FATAL_INVALID_CMD_TYPE);
+
+        /* ...reset echo cancellers */
+        xa_aec_reset(d);
+
         /* ...enter into execution stage */
         d->state |= XA_AEC_FLAG_RUNNING;
         
@@ -516,9 +502,18 @@ static XA_ERRORCODE xa_aec_set_config_param(XAPcmAec *d, WORD32 i_idx, pVOID pv_
     case XA_AEC23_CONFIG_PARAM_CHANNELS:
         /* ...allow stereo only */
         XF_CHK_ERR((i_value <= 2) && (i_value > 0), XA_AEC23_CONFIG_FATAL_RANGE);
+        /* ...persistent memory is sized at post-initialization */
+        XF_CHK_ERR(!(d->state & XA_AEC_FLAG_POSTINIT_DONE), XA_AEC23_CONFIG_FATAL_RANGE);
         d->channels = (UWORD32)i_value;
 	break;
 
+    case XA_AEC23_CONFIG_PARAM_TAIL_LENGTH:
+        /* ...echo tail is a multiple of block length; fixed after post-initialization */
+        XF_CHK_ERR((i_value >= XA_AEC_FDAF_TAIL_MIN) && (i_value <= XA_AEC_FDAF_TAIL_MAX) && (i_value % XA_AEC_FDAF_BLOCK == 0), XA_AEC23_CONFIG_FATAL_RANGE);
+        XF_CHK_ERR(!(d->state & XA_AEC_FLAG_POSTINIT_DONE), XA_AEC23_CONFIG_FATAL_RANGE);
+        d->tail = (UWORD32)i_value;
+	break;
+
     case XA_AEC23_CONFIG_PARAM_PORT_PAUSE:
         {
           XF_CHK_ERR((i_value < (d->num_in_ports + d->num_out_ports)), XA_AEC23_CONFIG_FATAL_RANGE);
@@ -586,6 +581,35 @@ static XA_ERRORCODE xa_aec_get_config_param(XAPcmAec *d, WORD32 i_idx, pVOID pv_
         *(WORD32 *)pv_value = d->channels;
         return XA_NO_ERROR;
 
+    case XA_AEC23_CONFIG_PARAM_TAIL_LENGTH:
+        /* ...return echo tail length in samples */
+        *(WORD32 *)pv_value = d->tail;
+        return XA_NO_ERROR;
+
+    case XA_AEC23_CONFIG_PARAM_ERLE:
+    case XA_AEC23_CONFIG_PARAM_DOUBLE_TALK:
+    {
+        UWORD32     size = xa_aec_fdaf_persist_size(d->tail);
+        WORD32      i, value = 0;
+
+        /* ...echo cancellers must be running */
+        XF_CHK_ERR(d->state & XA_AEC_FLAG_RUNNING, XA_AEC23_EXEC_FATAL_STATE);
+
+        /* ...average ERLE / any-channel double talk */
+        for (i = 0; i < d->channels; i++)
+        {
+            void   *s = (UWORD8 *)d->persist + i * size;
+
+            if ((i_idx & 0xF) == XA_AEC23_CONFIG_PARAM_ERLE)
+                value += xa_aec_fdaf_erle(s) / (WORD32)d->channels;
+            else
+                value |= xa_aec_fdaf_double_talk(s);
+        }
+
+        *(WORD32 *)pv_value = value;
+        return XA_NO_ERROR;
+    }
+
     default:
         TRACE(ERROR, _x("Invalid parameter: %X"), i_idx);
         return XA_API_FATAL_INVALID_CMD_TYPE;
@@ -818,8 +842,8 @@ static XA_ERRORCODE xa_aec_get_mem_info_alignment(XAPcmAec *d, WORD32 i_idx, pVO
     /* ...return frame buffer minimal size only after post-initialization is done */
     XF_CHK_ERR(d->state & XA_AEC_FLAG_POSTINIT_DONE, XA_API_FATAL_INVALID_CMD_TYPE);
 
-    /* ...all buffers are 4-bytes aligned */
-    *(WORD32 *)pv_value = 4;
+    /* ...all buffers are 8-bytes aligned (float pairs of echo canceller) */
+    *(WORD32 *)pv_value = 8;
         
     return XA_NO_ERROR;
 }
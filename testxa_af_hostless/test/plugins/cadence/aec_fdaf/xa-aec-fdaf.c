@@ -0,0 +1,584 @@
+/*
+* Copyright (c) 2015-2021 Cadence Design Systems Inc.
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/*******************************************************************************
+ * xa-aec-fdaf.c
+ *
+ * Partitioned-block frequency-domain NLMS echo canceller
+ *
+ * Real FFT of 2*BLOCK points is computed as BLOCK-point complex FFT (radix-2,
+ * split re/im arrays) followed by split step. Spectra are kept in split form
+ * too, so that per-bin loops map onto 2-way float SIMD of HiFi4 VFPU; generic
+ * code is used on host as a reference build.
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+
+#include "xa-aec-fdaf.h"
+
+/* ...SIMD flavour of FFT and spectral kernels */
+#ifdef __XCC__
+#include <xtensa/config/core-isa.h>
+#endif
+
+#if defined(__XCC__) && XCHAL_HAVE_HIFI4 && XCHAL_HAVE_HIFI4_VFPU
+#include <xtensa/tie/xt_hifi4.h>
+#define XA_AEC_FDAF_HIFI4               1
+#endif
+
+/*******************************************************************************
+ * Local definitions
+ ******************************************************************************/
+
+/* ...real FFT length, complex FFT length and number of bins */
+#define N                               (2 * XA_AEC_FDAF_BLOCK)
+#define M                               XA_AEC_FDAF_BLOCK
+#define K                               (M + 1)
+
+/* ...bins padded to vector multiple */
+#define KP                              ((K + 3) & ~3)
+
+/* ...maximal number of partitions */
+#define P_MAX                           (XA_AEC_FDAF_TAIL_MAX / XA_AEC_FDAF_BLOCK)
+
+/* ...adaptation step size (normalized) */
+#define XA_AEC_FDAF_MU                  0.5f
+
+/* ...reference power smoothing factor */
+#define XA_AEC_FDAF_ALPHA               0.25f
+
+/* ...regularization per bin (16-bit full-scale samples) */
+#define XA_AEC_FDAF_DELTA               (N * 64.0f * 64.0f)
+
+/* ...Geigel double-talk threshold (assumes echo path loss of at least 6dB) and hangover in blocks */
+#define XA_AEC_FDAF_GEIGEL              0.5f
+#define XA_AEC_FDAF_HANGOVER            8
+
+/* ...reference considered silent below this block peak */
+#define XA_AEC_FDAF_SILENCE             16.0f
+
+/* ...robust adaptation: error clipped at multiple of tracked mean magnitude */
+#define XA_AEC_FDAF_CLIP                2.5f
+#define XA_AEC_FDAF_SCALE_INIT          32768.0f
+
+/* ...energy smoothing for ERLE */
+#define XA_AEC_FDAF_BETA                0.05f
+
+/* ...cos/sin of 2*pi/N (twiddles are generated by rotation) */
+#define XA_AEC_FDAF_COS1                0.99969881869620422
+#define XA_AEC_FDAF_SIN1                0.024541228522912288
+
+/* ...canceller state of one channel */
+typedef struct xa_aec_fdaf
+{
+    /* ...number of partitions */
+    UWORD32                 partitions;
+
+    /* ...index of newest reference spectrum */
+    UWORD32                 head;
+
+    /* ...partition to constrain next */
+    UWORD32                 cpart;
+
+    /* ...double-talk hangover counter */
+    UWORD32                 hangover;
+
+    /* ...smoothed mic and error energies */
+    FLOAT32                 pmic, perr;
+
+    /* ...residual error scale for clipping */
+    FLOAT32                 escale;
+
+    /* ...reference block peaks over the tail (indexed as spectra) */
+    FLOAT32                 xmax[P_MAX];
+
+    /* ...bit-reversal permutation */
+    UWORD8                  rev[M];
+
+    /* ...split twiddles W_N^k, k = 0..M */
+    FLOAT32                 tw_r[KP] __attribute__((aligned(8)));
+    FLOAT32                 tw_i[KP] __attribute__((aligned(8)));
+
+    /* ...complex FFT stage twiddles; stage of half-size h starts at index h */
+    FLOAT32                 st_r[M] __attribute__((aligned(8)));
+    FLOAT32                 st_i[M] __attribute__((aligned(8)));
+
+    /* ...smoothed reference power per bin */
+    FLOAT32                 pxx[KP] __attribute__((aligned(8)));
+
+    /* ...previous reference block */
+    FLOAT32                 xold[XA_AEC_FDAF_BLOCK] __attribute__((aligned(8)));
+
+    /* ...reference spectra and filter partitions: Xr, Xi, Wr, Wi [partitions][KP] */
+    FLOAT32                 data[0] __attribute__((aligned(8)));
+
+}   xa_aec_fdaf_t;
+
+/* ...scratch layout */
+typedef struct xa_aec_fdaf_scratch
+{
+    /* ...time-domain buffer */
+    FLOAT32                 t[N] __attribute__((aligned(8)));
+
+    /* ...complex FFT work buffers */
+    FLOAT32                 zr[M] __attribute__((aligned(8)));
+    FLOAT32                 zi[M] __attribute__((aligned(8)));
+
+    /* ...echo estimate and error spectra */
+    FLOAT32                 yr[KP] __attribute__((aligned(8)));
+    FLOAT32                 yi[KP] __attribute__((aligned(8)));
+    FLOAT32                 er[KP] __attribute__((aligned(8)));
+    FLOAT32                 ei[KP] __attribute__((aligned(8)));
+
+    /* ...mic block */
+    FLOAT32                 d[XA_AEC_FDAF_BLOCK] __attribute__((aligned(8)));
+
+}   xa_aec_fdaf_scratch_t;
+
+/* ...spectra accessors */
+#define XR(s, p)        ((s)->data + (0 * (s)->partitions + (p)) * KP)
+#define XI(s, p)        ((s)->data + (1 * (s)->partitions + (p)) * KP)
+#define WR(s, p)        ((s)->data + (2 * (s)->partitions + (p)) * KP)
+#define WI(s, p)        ((s)->data + (3 * (s)->partitions + (p)) * KP)
+
+/*******************************************************************************
+ * FFT
+ ******************************************************************************/
+
+/* ...in-place radix-2 complex FFT of M points; input is in bit-reversed order */
+static void xa_aec_fdaf_cfft(const xa_aec_fdaf_t *s, FLOAT32 * restrict zr, FLOAT32 * restrict zi)
+{
+    UWORD32     h, g, j;
+    FLOAT32     tr, ti, wr, wi;
+
+    /* ...first stage has unity twiddle */
+    for (g = 0; g < M; g += 2)
+    {
+        tr = zr[g + 1], ti = zi[g + 1];
+        zr[g + 1] = zr[g] - tr, zi[g + 1] = zi[g] - ti;
+        zr[g] += tr, zi[g] += ti;
+    }
+
+    for (h = 2; h < M; h <<= 1)
+    {
+        const FLOAT32  *st_r = s->st_r + h;
+        const FLOAT32  *st_i = s->st_i + h;
+
+        for (g = 0; g < M; g += 2 * h)
+        {
+            FLOAT32    *ar = zr + g, *ai = zi + g;
+            FLOAT32    *br = zr + g + h, *bi = zi + g + h;
+
+#if XA_AEC_FDAF_HIFI4
+            /* ...two butterflies per iteration; all arrays are 8-bytes aligned */
+            for (j = 0; j < h; j += 2)
+            {
+                xtfloatx2   w_r = *(const xtfloatx2 *)(st_r + j), w_i = *(const xtfloatx2 *)(st_i + j);
+                xtfloatx2   b_r = *(xtfloatx2 *)(br + j), b_i = *(xtfloatx2 *)(bi + j);
+                xtfloatx2   a_r = *(xtfloatx2 *)(ar + j), a_i = *(xtfloatx2 *)(ai + j);
+                xtfloatx2   t_r, t_i;
+
+                t_r = XT_MUL_SX2(b_r, w_r);
+                XT_MSUB_SX2(t_r, b_i, w_i);
+                t_i = XT_MUL_SX2(b_r, w_i);
+                XT_MADD_SX2(t_i, b_i, w_r);
+
+                *(xtfloatx2 *)(br + j) = XT_SUB_SX2(a_r, t_r);
+                *(xtfloatx2 *)(bi + j) = XT_SUB_SX2(a_i, t_i);
+                *(xtfloatx2 *)(ar + j) = XT_ADD_SX2(a_r, t_r);
+                *(xtfloatx2 *)(ai + j) = XT_ADD_SX2(a_i, t_i);
+            }
+#else
+            for (j = 0; j < h; j++)
+            {
+                wr = st_r[j], wi = st_i[j];
+                tr = br[j] * wr - bi[j] * wi;
+                ti = br[j] * wi + bi[j] * wr;
+                br[j] = ar[j] - tr, bi[j] = ai[j] - ti;
+                ar[j] += tr, ai[j] += ti;
+            }
+#endif
+        }
+    }
+}
+
+/* ...real FFT of N points from t[] into bins 0..M of (xr, xi) */
+static void xa_aec_fdaf_rfft(const xa_aec_fdaf_t *s, xa_aec_fdaf_scratch_t *w, const FLOAT32 *t, FLOAT32 * restrict xr, FLOAT32 * restrict xi)
+{
+    FLOAT32    *zr = w->zr, *zi = w->zi;
+    FLOAT32     ar, ai, br, bi, er, ei, or, oi;
+    UWORD32     k;
+
+    /* ...pack even/odd samples as complex sequence in bit-reversed order */
+    for (k = 0; k < M; k++)
+    {
+        zr[s->rev[k]] = t[2 * k], zi[s->rev[k]] = t[2 * k + 1];
+    }
+
+    xa_aec_fdaf_cfft(s, zr, zi);
+
+    /* ...split spectra of even and odd samples and combine */
+    for (k = 0; k <= M; k++)
+    {
+        ar = zr[k & (M - 1)], ai = zi[k & (M - 1)];
+        br = zr[(M - k) & (M - 1)], bi = -zi[(M - k) & (M - 1)];
+        er = 0.5f * (ar + br), ei = 0.5f * (ai + bi);
+        or = 0.5f * (ai - bi), oi = -0.5f * (ar - br);
+        xr[k] = er + s->tw_r[k] * or - s->tw_i[k] * oi;
+        xi[k] = ei + s->tw_r[k] * oi + s->tw_i[k] * or;
+    }
+
+    /* ...keep padding bins clean */
+    for (; k < KP; k++)
+    {
+        xr[k] = xi[k] = 0;
+    }
+}
+
+/* ...inverse real FFT of bins 0..M of (xr, xi) into N points of t[] */
+static void xa_aec_fdaf_irfft(const xa_aec_fdaf_t *s, xa_aec_fdaf_scratch_t *w, const FLOAT32 *xr, const FLOAT32 *xi, FLOAT32 *t)
+{
+    FLOAT32    *zr = w->zr, *zi = w->zi;
+    FLOAT32     ar, ai, br, bi, er, ei, dr, di, or, oi;
+    UWORD32     k, r;
+
+    /* ...recombine into complex spectrum, conjugated for forward transform */
+    for (k = 0; k < M; k++)
+    {
+        ar = xr[k], ai = xi[k];
+        br = xr[M - k], bi = -xi[M - k];
+        er = 0.5f * (ar + br), ei = 0.5f * (ai + bi);
+        dr = 0.5f * (ar - br), di = 0.5f * (ai - bi);
+
+        /* ...multiply by conjugated twiddle */
+        or = dr * s->tw_r[k] + di * s->tw_i[k];
+        oi = di * s->tw_r[k] - dr * s->tw_i[k];
+
+        r = s->rev[k];
+        zr[r] = er - oi, zi[r] = -(ei + or);
+    }
+
+    xa_aec_fdaf_cfft(s, zr, zi);
+
+    /* ...conjugate back, scale and unpack */
+    for (k = 0; k < M; k++)
+    {
+        t[2 * k] = zr[k] * (1.0f / M), t[2 * k + 1] = -zi[k] * (1.0f / M);
+    }
+}
+
+/*******************************************************************************
+ * Spectral kernels
+ ******************************************************************************/
+
+/* ...y += w * x (complex, per bin) */
+static void xa_aec_fdaf_cmac(FLOAT32 * restrict yr, FLOAT32 * restrict yi, const FLOAT32 * restrict wr, const FLOAT32 * restrict wi, const FLOAT32 * restrict xr, const FLOAT32 * restrict xi)
+{
+    UWORD32     k;
+
+#if XA_AEC_FDAF_HIFI4
+    for (k = 0; k < KP; k += 2)
+    {
+        xtfloatx2   w_r = *(const xtfloatx2 *)(wr + k), w_i = *(const xtfloatx2 *)(wi + k);
+        xtfloatx2   x_r = *(const xtfloatx2 *)(xr + k), x_i = *(const xtfloatx2 *)(xi + k);
+        xtfloatx2   y_r = *(xtfloatx2 *)(yr + k), y_i = *(xtfloatx2 *)(yi + k);
+
+        XT_MADD_SX2(y_r, w_r, x_r);
+        XT_MSUB_SX2(y_r, w_i, x_i);
+        XT_MADD_SX2(y_i, w_r, x_i);
+        XT_MADD_SX2(y_i, w_i, x_r);
+
+        *(xtfloatx2 *)(yr + k) = y_r, *(xtfloatx2 *)(yi + k) = y_i;
+    }
+#else
+    for (k = 0; k < KP; k++)
+    {
+        yr[k] += wr[k] * xr[k] - wi[k] * xi[k];
+        yi[k] += wr[k] * xi[k] + wi[k] * xr[k];
+    }
+#endif
+}
+
+/* ...w += conj(x) * g (complex, per bin) */
+static void xa_aec_fdaf_update(FLOAT32 * restrict wr, FLOAT32 * restrict wi, const FLOAT32 * restrict xr, const FLOAT32 * restrict xi, const FLOAT32 * restrict gr, const FLOAT32 * restrict gi)
+{
+    UWORD32     k;
+
+#if XA_AEC_FDAF_HIFI4
+    for (k = 0; k < KP; k += 2)
+    {
+        xtfloatx2   g_r = *(const xtfloatx2 *)(gr + k), g_i = *(const xtfloatx2 *)(gi + k);
+        xtfloatx2   x_r = *(const xtfloatx2 *)(xr + k), x_i = *(const xtfloatx2 *)(xi + k);
+        xtfloatx2   w_r = *(xtfloatx2 *)(wr + k), w_i = *(xtfloatx2 *)(wi + k);
+
+        XT_MADD_SX2(w_r, x_r, g_r);
+        XT_MADD_SX2(w_r, x_i, g_i);
+        XT_MADD_SX2(w_i, x_r, g_i);
+        XT_MSUB_SX2(w_i, x_i, g_r);
+
+        *(xtfloatx2 *)(wr + k) = w_r, *(xtfloatx2 *)(wi + k) = w_i;
+    }
+#else
+    for (k = 0; k < KP; k++)
+    {
+        wr[k] += xr[k] * gr[k] + xi[k] * gi[k];
+        wi[k] += xr[k] * gi[k] - xi[k] * gr[k];
+    }
+#endif
+}
+
+/* ...fast log2 approximation (about 0.01 accuracy) */
+static inline FLOAT32 xa_aec_fdaf_log2(FLOAT32 x)
+{
+    union { FLOAT32 f; UWORD32 u; } v = { .f = x };
+    WORD32      e = (WORD32)((v.u >> 23) & 0xFF) - 127;
+
+    v.u = (v.u & 0x7FFFFF) | 0x3F800000;
+
+    return (FLOAT32)e + (-0.34484843f * v.f + 2.02466578f) * v.f - 0.67487759f;
+}
+
+/*******************************************************************************
+ * Block processing
+ ******************************************************************************/
+
+/* ...process one block of BLOCK samples; d[] holds mic, t[BLOCK..N) holds reference */
+static void xa_aec_fdaf_block(xa_aec_fdaf_t *s, xa_aec_fdaf_scratch_t *w)
+{
+    UWORD32     P = s->partitions;
+    FLOAT32    *t = w->t, *d = w->d;
+    FLOAT32     xpeak = 0, dpeak = 0, emic = 0, eerr = 0, emag = 0, lim, v;
+    UWORD32     p, q, k, dt;
+
+    /* ...advance reference history */
+    s->head = (s->head == 0 ? P - 1 : s->head - 1);
+
+    /* ...reference block peak for double-talk detector */
+    for (k = 0; k < XA_AEC_FDAF_BLOCK; k++)
+    {
+        v = t[XA_AEC_FDAF_BLOCK + k];
+        xpeak = (v > xpeak ? v : (-v > xpeak ? -v : xpeak));
+    }
+
+    s->xmax[s->head] = xpeak;
+
+    /* ...overlap-save input: previous and current reference block */
+    memcpy(t, s->xold, sizeof(s->xold));
+    memcpy(s->xold, t + XA_AEC_FDAF_BLOCK, sizeof(s->xold));
+    xa_aec_fdaf_rfft(s, w, t, XR(s, s->head), XI(s, s->head));
+
+    /* ...echo estimate: sum of partitions applied to delayed reference spectra */
+    memset(w->yr, 0, sizeof(w->yr));
+    memset(w->yi, 0, sizeof(w->yi));
+
+    for (p = 0, q = s->head; p < P; p++, q = (q + 1 == P ? 0 : q + 1))
+    {
+        xa_aec_fdaf_cmac(w->yr, w->yi, WR(s, p), WI(s, p), XR(s, q), XI(s, q));
+    }
+
+    xa_aec_fdaf_irfft(s, w, w->yr, w->yi, t);
+
+    /* ...error signal replaces mic block; last half of t[] is valid convolution */
+    for (k = 0; k < XA_AEC_FDAF_BLOCK; k++)
+    {
+        v = d[k];
+        dpeak = (v > dpeak ? v : (-v > dpeak ? -v : dpeak));
+        emic += v * v;
+        d[k] = v - t[XA_AEC_FDAF_BLOCK + k];
+        eerr += d[k] * d[k];
+    }
+
+    /* ...Geigel detector: near-end is present if mic peak exceeds reference peak over the tail */
+    for (p = 0, xpeak = 0; p < P; p++)
+    {
+        xpeak = (s->xmax[p] > xpeak ? s->xmax[p] : xpeak);
+    }
+
+    dt = (dpeak > XA_AEC_FDAF_GEIGEL * xpeak);
+    s->hangover = (dt ? XA_AEC_FDAF_HANGOVER : (s->hangover ? s->hangover - 1 : 0));
+
+    /* ...track energies for ERLE during single talk only */
+    if (!s->hangover && xpeak > XA_AEC_FDAF_SILENCE)
+    {
+        s->pmic += XA_AEC_FDAF_BETA * (emic - s->pmic);
+        s->perr += XA_AEC_FDAF_BETA * (eerr - s->perr);
+    }
+
+    /* ...adapt only with active reference and no double talk */
+    if (s->hangover || xpeak <= XA_AEC_FDAF_SILENCE)
+        return;
+
+    /* ...error spectrum (zero-padded in front); error is clipped so that onset of
+     * near-end speech missed by detector cannot throw the filter off */
+    memset(t, 0, XA_AEC_FDAF_BLOCK * sizeof(FLOAT32));
+    lim = XA_AEC_FDAF_CLIP * s->escale;
+
+    for (k = 0; k < XA_AEC_FDAF_BLOCK; k++)
+    {
+        v = d[k];
+        v = (v > lim ? lim : (v < -lim ? -lim : v));
+        emag += (v >= 0 ? v : -v);
+        t[XA_AEC_FDAF_BLOCK + k] = v;
+    }
+
+    /* ...scale tracks mean magnitude; growth is limited to a fraction per block */
+    s->escale += XA_AEC_FDAF_BETA * (emag * (1.0f / XA_AEC_FDAF_BLOCK) - s->escale);
+
+    xa_aec_fdaf_rfft(s, w, t, w->er, w->ei);
+
+    /* ...power-normalized step per bin */
+    {
+        const FLOAT32  *xr = XR(s, s->head), *xi = XI(s, s->head);
+
+        for (k = 0; k < KP; k++)
+        {
+            s->pxx[k] += XA_AEC_FDAF_ALPHA * (xr[k] * xr[k] + xi[k] * xi[k] - s->pxx[k]);
+            v = XA_AEC_FDAF_MU / (P * s->pxx[k] + XA_AEC_FDAF_DELTA);
+            w->er[k] *= v, w->ei[k] *= v;
+        }
+    }
+
+    for (p = 0, q = s->head; p < P; p++, q = (q + 1 == P ? 0 : q + 1))
+    {
+        xa_aec_fdaf_update(WR(s, p), WI(s, p), XR(s, q), XI(s, q), w->er, w->ei);
+    }
+
+    /* ...constrain one partition to linear convolution (first half of impulse response) */
+    p = s->cpart, s->cpart = (p + 1 == P ? 0 : p + 1);
+    xa_aec_fdaf_irfft(s, w, WR(s, p), WI(s, p), t);
+    memset(t + XA_AEC_FDAF_BLOCK, 0, XA_AEC_FDAF_BLOCK * sizeof(FLOAT32));
+    xa_aec_fdaf_rfft(s, w, t, WR(s, p), WI(s, p));
+}
+
+/*******************************************************************************
+ * API functions
+ ******************************************************************************/
+
+/* ...persistent memory size of one channel canceller */
+UWORD32 xa_aec_fdaf_persist_size(UWORD32 tail)
+{
+    UWORD32     P = tail / XA_AEC_FDAF_BLOCK;
+
+    return sizeof(xa_aec_fdaf_t) + 4 * P * KP * sizeof(FLOAT32);
+}
+
+/* ...scratch memory size */
+UWORD32 xa_aec_fdaf_scratch_size(void)
+{
+    return sizeof(xa_aec_fdaf_scratch_t);
+}
+
+/* ...reset canceller state */
+void xa_aec_fdaf_init(void *persist, UWORD32 tail)
+{
+    xa_aec_fdaf_t  *s = persist;
+    FLOAT64         cr = 1, ci = 0, t;
+    UWORD32         k, j, h, r;
+
+    memset(s, 0, xa_aec_fdaf_persist_size(tail));
+    s->partitions = tail / XA_AEC_FDAF_BLOCK;
+    s->escale = XA_AEC_FDAF_SCALE_INIT;
+
+    /* ...W_N^k = exp(-2*pi*i*k/N), k = 0..M, by rotation in double precision */
+    for (k = 0; k <= M; k++)
+    {
+        s->tw_r[k] = (FLOAT32)cr, s->tw_i[k] = (FLOAT32)-ci;
+        t = cr * XA_AEC_FDAF_COS1 - ci * XA_AEC_FDAF_SIN1;
+        ci = cr * XA_AEC_FDAF_SIN1 + ci * XA_AEC_FDAF_COS1;
+        cr = t;
+    }
+
+    /* ...stage twiddles exp(-2*pi*i*j/(2h)) = W_N^(j*N/(2h)) */
+    for (h = 1; h < M; h <<= 1)
+    {
+        for (j = 0; j < h; j++)
+        {
+            s->st_r[h + j] = s->tw_r[j * (N / (2 * h))];
+            s->st_i[h + j] = s->tw_i[j * (N / (2 * h))];
+        }
+    }
+
+    /* ...bit-reversal permutation */
+    for (k = 0; k < M; k++)
+    {
+        for (j = 1, r = 0; j < M; j <<= 1)
+        {
+            r = (r << 1) | ((k & j) ? 1 : 0);
+        }
+
+        s->rev[k] = (UWORD8)r;
+    }
+}
+
+/* ...cancel echo for n samples */
+void xa_aec_fdaf_process(void *persist, void *scratch, WORD16 *out, const WORD16 *mic, const WORD16 *ref, UWORD32 stride, UWORD32 n)
+{
+    xa_aec_fdaf_t          *s = persist;
+    xa_aec_fdaf_scratch_t  *w = scratch;
+    FLOAT32                 v;
+    UWORD32                 i, k;
+
+    for (i = 0; i + XA_AEC_FDAF_BLOCK <= n; i += XA_AEC_FDAF_BLOCK)
+    {
+        /* ...deinterleave block */
+        for (k = 0; k < XA_AEC_FDAF_BLOCK; k++)
+        {
+            w->d[k] = mic[(i + k) * stride];
+            w->t[XA_AEC_FDAF_BLOCK + k] = (ref ? ref[(i + k) * stride] : 0);
+        }
+
+        xa_aec_fdaf_block(s, w);
+
+        /* ...saturate and interleave result */
+        for (k = 0; k < XA_AEC_FDAF_BLOCK; k++)
+        {
+            v = w->d[k];
+            v = (v > 32767.0f ? 32767.0f : (v < -32768.0f ? -32768.0f : v));
+            out[(i + k) * stride] = (WORD16)v;
+        }
+    }
+}
+
+/* ...echo return loss enhancement in dB (Q8) */
+WORD32 xa_aec_fdaf_erle(void *persist)
+{
+    xa_aec_fdaf_t  *s = persist;
+
+    if (s->pmic <= 0 || s->perr <= 0)
+        return 0;
+
+    /* ...10*log10(x) = 3.0103 * log2(x) */
+    return (WORD32)(3.0103f * 256 * (xa_aec_fdaf_log2(s->pmic) - xa_aec_fdaf_log2(s->perr)));
+}
+
+/* ...double-talk state */
+UWORD32 xa_aec_fdaf_double_talk(void *persist)
+{
+    xa_aec_fdaf_t  *s = persist;
+
+    return (s->hangover != 0);
+}
@@ -0,0 +1,74 @@
+/*
+* Copyright (c) 2015-2021 Cadence Design Systems Inc.
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/*******************************************************************************
+ * xa-aec-fdaf.h
+ *
+ * Partitioned-block frequency-domain NLMS echo canceller
+ *
+ * Shared by aec22/aec23 plugins. Echo path is modelled by P partitions of
+ * XA_AEC_FDAF_BLOCK taps each (overlap-save, 2*BLOCK real FFT); adaptation is
+ * power-normalized per bin and frozen while Geigel detector reports double
+ * talk. One partition per block is gradient-constrained in round-robin order.
+ ******************************************************************************/
+
+#ifndef __XA_AEC_FDAF_H__
+#define __XA_AEC_FDAF_H__
+
+#include "xa_type_def.h"
+
+/*******************************************************************************
+ * Constants definitions
+ ******************************************************************************/
+
+/* ...block length in samples (partition length) */
+#define XA_AEC_FDAF_BLOCK               128
+
+/* ...supported echo tail range in samples (multiple of block) */
+#define XA_AEC_FDAF_TAIL_MIN            XA_AEC_FDAF_BLOCK
+#define XA_AEC_FDAF_TAIL_MAX            (32 * XA_AEC_FDAF_BLOCK)
+#define XA_AEC_FDAF_TAIL_DEFAULT        (8 * XA_AEC_FDAF_BLOCK)
+
+/*******************************************************************************
+ * API functions
+ ******************************************************************************/
+
+/* ...persistent memory size of one channel canceller for given tail */
+extern UWORD32 xa_aec_fdaf_persist_size(UWORD32 tail);
+
+/* ...scratch memory size (shared by all channels) */
+extern UWORD32 xa_aec_fdaf_scratch_size(void);
+
+/* ...reset canceller state */
+extern void xa_aec_fdaf_init(void *persist, UWORD32 tail);
+
+/* ...cancel echo of "ref" in "mic" for n samples (multiple of block); buffers
+ * are interleaved with given stride, "ref" may be NULL (silence) */
+extern void xa_aec_fdaf_process(void *persist, void *scratch, WORD16 *out, const WORD16 *mic, const WORD16 *ref, UWORD32 stride, UWORD32 n);
+
+/* ...echo return loss enhancement in dB (Q8), smoothed */
+extern WORD32 xa_aec_fdaf_erle(void *persist);
+
+/* ...non-zero while double talk is detected */
+extern UWORD32 xa_aec_fdaf_double_talk(void *persist);
+
+#endif /* __XA_AEC_FDAF_H__ */
@@ -45,6 +45,39 @@
 extern clk_t mix_cycles;
 #endif
 
+/* ...SIMD flavour of accumulation kernels */
+#ifdef __XCC__
+#include <xtensa/config/core-isa.h>
+#endif
+
+#if defined(__XCC__) && XCHAL_HAVE_HIFI4
+#include <xtensa/tie/xt_hifi4.h>
+#define XA_MIXER_HIFI4                  1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define XA_MIXER_NEON                   1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define XA_MIXER_SSE2                   1
+#endif
+
+/*******************************************************************************
+ * Macro definitions
+ ******************************************************************************/
+
+/* mixer frame-size in samples/channel */
+#define MIXER_FRAME_SIZE_MAX    4096
+#define MIXER_FRAME_SIZE_MIN      32
+
+/* ...maximal number of interleaved channels */
+#define XA_MIXER_MAX_CHANNELS           8
+
+/* ...gain row holds 8 frames worth of per-channel gains (multiple of any vector width) */
+#define XA_MIXER_GAIN_ROW               (8 * XA_MIXER_MAX_CHANNELS)
+
+/* ...unity gain (Q12) */
+#define XA_MIXER_UNITY                  (1 << 12)
+
 /*******************************************************************************
  * Internal functions definitions
  ******************************************************************************/
@@ -64,15 +97,30 @@ typedef struct XAPcmMixer
     /* ...PCM sample width */
     UWORD32                 pcm_width;
 
+    /* ...sample format (integer or floating-point) */
+    UWORD32                 sample_format;
+
     /* ...sampling rate */
     UWORD32                 sample_rate;
 
     /* ...number of bytes in input/output buffer */
     UWORD32                 buffer_size;
     
-    /* ...master volume and individual track volumes*/
-    UWORD32                 volume[XA_MIXER_MAX_TRACK_NUMBER + 1];
+    /* ...number of bytes in accumulator (scratch) buffer */
+    UWORD32                 scratch_size;
+
+    /* ...length of gain row in samples (8 frames) */
+    UWORD32                 row_length;
+
+    /* ...set if all gains fit into signed 16 bits */
+    UWORD32                 gain_s16;
+
+    /* ...master volume and individual track volumes per channel (Q12, last index is a master volume) */
+    UWORD16                 volume[XA_MIXER_MAX_TRACK_NUMBER + 1][XA_MIXER_MAX_CHANNELS];
     
+    /* ...volumes replicated over interleaved samples */
+    UWORD16                 gain[XA_MIXER_MAX_TRACK_NUMBER + 1][XA_MIXER_GAIN_ROW] __attribute__((aligned(16)));
+
     /* ...input buffers */
     void               *input[XA_MIXER_MAX_TRACK_NUMBER];
     
@@ -85,7 +133,7 @@ typedef struct XAPcmMixer
     /* ...number of produced bytes - do I need that? have buffer-size already - tbd */
     UWORD32                 produced;
     
-    /* ...scratch buffer pointer */
+    /* ...scratch buffer pointer (accumulator) */
     void               *scratch;
     
     /* ...input over flag */
@@ -104,89 +152,311 @@ typedef struct XAPcmMixer
 #define XA_MIXER_FLAG_COMPLETE          (1 << 4)
 
 /*******************************************************************************
- * Macro definitions
+ * Mixing kernels
+ *
+ * Every track with data is multiplied by its per-sample gain row and added to
+ * the accumulator; tracks without data are not touched at all. 16-bit tracks
+ * are accumulated in 32 bits with saturation, 24/32-bit tracks in 64 bits (no
+ * overflow is possible), floating-point ones in single precision. The final
+ * pass applies master volume and saturates the result into the output format.
+ * Gain rows repeat every "l" samples; "l" is a multiple of 8 and of channels.
  ******************************************************************************/
-/* mixer frame-size in samples/channel */
-#define MIXER_FRAME_SIZE_MAX    4096
-#define MIXER_FRAME_SIZE_MIN      32
+
+/* ...branch-free saturation (maps to min/max) */
+#define XA_MIXER_SAT(v, lo, hi)         ((v) < (lo) ? (lo) : ((v) > (hi) ? (hi) : (v)))
+
+#define MAX_16BIT ((WORD16)0x7FFF)
+#define MIN_16BIT ((WORD16)0x8000)
+
+#define MAX_32BIT ((WORD32)0x7FFFFFFF)
+#define MIN_32BIT  ((WORD32)0x80000000)
+
+/* ...16-bit track accumulation with saturation */
+static void xa_mixer_acc_16bit(WORD32 * restrict acc, const WORD16 * restrict in, UWORD32 n, const UWORD16 * restrict g, UWORD32 l, UWORD32 gain_s16)
+{
+    WORD64                  sum;
+    UWORD32                 i = 0, j = 0;
+
+#if XA_MIXER_HIFI4
+    /* ...16x16 multiply is signed; use it only when gains do not exceed 0x7FFF */
+    if (gain_s16)
+    {
+        const ae_int16x4       *pi = (const ae_int16x4 *) in;
+        ae_valign               ai = AE_LA64_PP(pi);
+        ae_int32x2             *pa = (ae_int32x2 *) acc;
+        ae_int16x4              x, v;
+        ae_int32x2              p0, p1;
+
+        /* ...input buffers are only 4-bytes aligned; accumulator and gains are 8-bytes aligned */
+        for (; i + 4 <= n; i += 4, pa += 2)
+        {
+            AE_LA16X4_IP(x, ai, pi);
+            v = *(const ae_int16x4 *)(g + j);
+            AE_MUL16X4(p0, p1, x, v);
+            pa[0] = AE_ADD32S(pa[0], p0);
+            pa[1] = AE_ADD32S(pa[1], p1);
+            j = (j + 4 == l ? 0 : j + 4);
+        }
+    }
+#elif XA_MIXER_NEON
+    int16x8_t               x;
+    uint16x8_t              v;
+    int32x4_t               p0, p1;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        x = vld1q_s16(in + i);
+        v = vld1q_u16(g + j);
+        p0 = vmulq_s32(vmovl_s16(vget_low_s16(x)), vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(v))));
+        p1 = vmulq_s32(vmovl_s16(vget_high_s16(x)), vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(v))));
+        vst1q_s32(acc + i, vqaddq_s32(vld1q_s32(acc + i), p0));
+        vst1q_s32(acc + i + 4, vqaddq_s32(vld1q_s32(acc + i + 4), p1));
+        j = (j + 8 == l ? 0 : j + 8);
+    }
+#elif XA_MIXER_SSE2
+    __m128i                 x, v, lo, hi, a, p, s, m;
+    UWORD32                 k;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        x = _mm_loadu_si128((const __m128i *)(in + i));
+        v = _mm_load_si128((const __m128i *)(g + j));
+
+        /* ...signed x unsigned product: fix up high half where gain has MSB set */
+        lo = _mm_mullo_epi16(x, v);
+        hi = _mm_add_epi16(_mm_mulhi_epi16(x, v), _mm_and_si128(x, _mm_srai_epi16(v, 15)));
+
+        for (k = 0; k < 2; k++)
+        {
+            p = (k == 0 ? _mm_unpacklo_epi16(lo, hi) : _mm_unpackhi_epi16(lo, hi));
+            a = _mm_loadu_si128((const __m128i *)(acc + i + 4 * k));
+
+            /* ...saturating add: overflow if both operands differ in sign from the sum */
+            s = _mm_add_epi32(a, p);
+            m = _mm_srai_epi32(_mm_and_si128(_mm_xor_si128(a, s), _mm_xor_si128(p, s)), 31);
+            p = _mm_xor_si128(_mm_srai_epi32(a, 31), _mm_set1_epi32(0x7FFFFFFF));
+            _mm_storeu_si128((__m128i *)(acc + i + 4 * k), _mm_or_si128(_mm_andnot_si128(m, s), _mm_and_si128(m, p)));
+        }
+
+        j = (j + 8 == l ? 0 : j + 8);
+    }
+#endif
+
+    /* ...generic loop (or vector tail) */
+    for (; i < n; i++)
+    {
+        sum = (WORD64)acc[i] + (WORD32)in[i] * (WORD32)g[j];
+        acc[i] = (WORD32)XA_MIXER_SAT(sum, MIN_32BIT, MAX_32BIT);
+        j = (j + 1 == l ? 0 : j + 1);
+    }
+}
+
+/* ...24/32-bit track accumulation (24-bit samples are left-aligned in 32-bit containers) */
+static void xa_mixer_acc_32bit(WORD64 * restrict acc, const WORD32 * restrict in, UWORD32 n, const UWORD16 * restrict g, UWORD32 l, UWORD32 gain_s16)
+{
+    UWORD32                 i = 0, j = 0;
+
+#if XA_MIXER_NEON
+    int32x4_t               x;
+    int32x4_t               v;
+
+    for (; i + 4 <= n; i += 4)
+    {
+        x = vld1q_s32(in + i);
+        v = vreinterpretq_s32_u32(vmovl_u16(vld1_u16(g + j)));
+        vst1q_s64(acc + i, vmlal_s32(vld1q_s64(acc + i), vget_low_s32(x), vget_low_s32(v)));
+        vst1q_s64(acc + i + 2, vmlal_s32(vld1q_s64(acc + i + 2), vget_high_s32(x), vget_high_s32(v)));
+        j = (j + 4 == l ? 0 : j + 4);
+    }
+#endif
+
+    for (; i < n; i++)
+    {
+        acc[i] += (WORD64)in[i] * g[j];
+        j = (j + 1 == l ? 0 : j + 1);
+    }
+}
+
+/* ...floating-point track accumulation */
+static void xa_mixer_acc_float(FLOAT32 * restrict acc, const FLOAT32 * restrict in, UWORD32 n, const UWORD16 * restrict g, UWORD32 l, UWORD32 gain_s16)
+{
+    UWORD32                 i, j;
+
+    /* ...blocks of gain row length vectorize without index wrapping */
+    for (i = 0; i < n; i += l)
+    {
+        UWORD32     m = (n - i < l ? n - i : l);
+
+        for (j = 0; j < m; j++)
+        {
+            acc[i + j] += in[i + j] * (g[j] * (1.0f / XA_MIXER_UNITY));
+        }
+    }
+}
+
+/* ...16-bit output with master volume */
+static void xa_mixer_out_16bit(WORD16 * restrict out, const WORD32 * restrict acc, UWORD32 n, const UWORD16 * restrict w, UWORD32 l, UWORD32 unity)
+{
+    WORD64                  v;
+    UWORD32                 i = 0, j = 0;
+
+    if (unity)
+    {
+        /* ...normalize (truncate towards -inf) and saturate */
+#if XA_MIXER_HIFI4
+        const ae_int32x2       *pa = (const ae_int32x2 *) acc;
+        ae_int16x4             *po = (ae_int16x4 *) out;
+        ae_valign               ao = AE_ZALIGN64();
+
+        for (; i + 4 <= n; i += 4, pa += 2)
+        {
+            AE_SA16X4_IP(AE_SAT16X4(AE_SRAI32(pa[0], 12), AE_SRAI32(pa[1], 12)), ao, po);
+        }
+
+        AE_SA64POS_FP(ao, po);
+#elif XA_MIXER_NEON
+        for (; i + 8 <= n; i += 8)
+        {
+            vst1q_s16(out + i, vcombine_s16(vqshrn_n_s32(vld1q_s32(acc + i), 12), vqshrn_n_s32(vld1q_s32(acc + i + 4), 12)));
+        }
+#elif XA_MIXER_SSE2
+        for (; i + 8 <= n; i += 8)
+        {
+            __m128i     a0 = _mm_srai_epi32(_mm_loadu_si128((const __m128i *)(acc + i)), 12);
+            __m128i     a1 = _mm_srai_epi32(_mm_loadu_si128((const __m128i *)(acc + i + 4)), 12);
+
+            _mm_storeu_si128((__m128i *)(out + i), _mm_packs_epi32(a0, a1));
+        }
+#endif
+
+        for (; i < n; i++)
+        {
+            v = acc[i] >> 12;
+            out[i] = (WORD16)XA_MIXER_SAT(v, MIN_16BIT, MAX_16BIT);
+        }
+    }
+    else
+    {
+        /* ...normalize and multiply by master volume */
+        for (; i < n; i++)
+        {
+            v = ((WORD64)(acc[i] >> 12) * w[j]) >> 12;
+            out[i] = (WORD16)XA_MIXER_SAT(v, MIN_16BIT, MAX_16BIT);
+            j = (j + 1 == l ? 0 : j + 1);
+        }
+    }
+}
+
+/* ...24/32-bit output with master volume; 24-bit output has lower byte cleared */
+static void xa_mixer_out_32bit(WORD32 * restrict out, const WORD64 * restrict acc, UWORD32 n, const UWORD16 * restrict w, UWORD32 l, WORD32 mask)
+{
+    WORD64                  v;
+    UWORD32                 i, j = 0;
+
+    for (i = 0; i < n; i++)
+    {
+        v = ((acc[i] >> 12) * w[j]) >> 12;
+        out[i] = (WORD32)XA_MIXER_SAT(v, MIN_32BIT, MAX_32BIT) & mask;
+        j = (j + 1 == l ? 0 : j + 1);
+    }
+}
+
+/* ...floating-point output with master volume (not clipped) */
+static void xa_mixer_out_float(FLOAT32 * restrict out, const FLOAT32 * restrict acc, UWORD32 n, const UWORD16 * restrict w, UWORD32 l)
+{
+    UWORD32                 i, j;
+
+    for (i = 0; i < n; i += l)
+    {
+        UWORD32     m = (n - i < l ? n - i : l);
+
+        for (j = 0; j < m; j++)
+        {
+            out[i + j] = acc[i + j] * (w[j] * (1.0f / XA_MIXER_UNITY));
+        }
+    }
+}
 
 /*******************************************************************************
  * DSP functions
  ******************************************************************************/
 
-#define DSP_SATURATE_S16(WORD32)   \
-    (WORD16)((WORD32) > 0x7fff ? 0x7fff : ((WORD32) < -0x8000 ? -0x8000 : (WORD32)))
+/* ...size of a sample in input/output buffers */
+static inline UWORD32 xa_mixer_sample_bytes(XAPcmMixer *d)
+{
+    return (d->pcm_width == 16 ? sizeof(WORD16) : sizeof(WORD32));
+}
+
+/* ...size of a sample in accumulator */
+static inline UWORD32 xa_mixer_acc_bytes(XAPcmMixer *d)
+{
+    if (d->sample_format == XA_MIXER_SAMPLE_FORMAT_FLOAT)
+        return sizeof(FLOAT32);
+    else
+        return (d->pcm_width == 16 ? sizeof(WORD32) : sizeof(WORD64));
+}
+
+/* ...replicate track volumes over gain rows */
+static void xa_mixer_update_gains(XAPcmMixer *d)
+{
+    UWORD32     i, j;
+
+    d->row_length = 8 * d->channels;
+    d->gain_s16 = 1;
+
+    for (i = 0; i <= XA_MIXER_MAX_TRACK_NUMBER; i++)
+    {
+        for (j = 0; j < d->row_length; j++)
+        {
+            d->gain[i][j] = d->volume[i][j % d->channels];
+            (d->gain[i][j] > 0x7FFF ? d->gain_s16 = 0 : 0);
+        }
+    }
+}
 
 /* ...mixer preinitialization (default parameters) */
 static inline void xa_mixer_preinit(XAPcmMixer *d)
 {
-    UWORD32     i;
+    UWORD32     i, j;
     
     /* ...pre-configuration initialization; reset internal data */
     memset(d, 0, sizeof(*d));
         
     /* ...set default parameters */
     d->pcm_width = 16, d->channels = 2, d->frame_size = 512;
+    d->sample_format = XA_MIXER_SAMPLE_FORMAT_INT;
 
     /* ...set default volumes (last index is a master volume)*/
     for (i = 0; i <= XA_MIXER_MAX_TRACK_NUMBER; i++)
     {
-        d->volume[i] = ((1 << 12) << 16) | (1 << 12);
+        for (j = 0; j < XA_MIXER_MAX_CHANNELS; j++)
+        {
+            d->volume[i][j] = XA_MIXER_UNITY;
+        }
     }
 }
 
-/* ...do mixing of stereo PCM-16 streams */
-static XA_ERRORCODE xa_mixer_do_execute_stereo_16bit(XAPcmMixer *d)
+/* ...do mixing of PCM streams */
+static XA_ERRORCODE xa_mixer_do_execute(XAPcmMixer *d)
 {
-    WORD16    *output = d->output;
-    WORD16    *b[XA_MIXER_MAX_TRACK_NUMBER]; 
-    UWORD16     v_l[XA_MIXER_MAX_TRACK_NUMBER];
-    UWORD16     v_r[XA_MIXER_MAX_TRACK_NUMBER];
-    UWORD16     w_l, w_r;    
-    UWORD32     t32;
-    UWORD32     i, j;
+    UWORD32     sample_bytes = xa_mixer_sample_bytes(d);
+    UWORD32     n = d->frame_size * d->channels;
+    UWORD32     l = d->row_length;
+    const UWORD16  *w = d->gain[XA_MIXER_MAX_TRACK_NUMBER];
+    UWORD32     unity;
+    UWORD32     j;
     UWORD32 ports_inactive = 0;
     UWORD32 ports_completed = 0;
+    UWORD32 ports_mixed = 0;
     
-    /* ...retrieve master volume - assume up to 24dB amplifying (4 bits) */
-    t32 = d->volume[XA_MIXER_MAX_TRACK_NUMBER];
-    w_l = (UWORD16)(t32 & 0xFFFF), w_r = (UWORD16)(t32 >> 16);
-
     /* ...reset produced bytes */
     d->produced = 0;
     
-    /* ...prepare individual tracks */
+    /* ...check if any input is still alive */
     for (j = 0; j < XA_MIXER_MAX_TRACK_NUMBER; j++)
     {
-        UWORD32     n = d->input_length[j];
-        
-        /* ...check if we have input buffer available */
-        if (n == 0)
-        {
-            /* ...output silence (multiply garbage in the scratch buffer by 0) */
-            b[j] = d->scratch;
-            v_l[j] = v_r[j] = 0;
-
-            ports_inactive += (d->input_over[j]);
-        }
-        else
-        {
-            WORD32     k = (WORD32)(d->buffer_size - n);
-            
-            /* ...put input buffer */
-            XF_CHK_ERR(b[j] = d->input[j], XA_MIXER_EXEC_FATAL_INPUT);
-            
-            /* ...if length is not sufficient, pad buffer remainder */
-            (k > 0 ? memset((void *)b[j] + n, 0x00, k) : 0);
-            
-            /* ...set individual track volume/balance */
-            t32 = d->volume[j];
-            v_l[j] = (UWORD16)(t32 & 0xFFFF), v_r[j] = (UWORD16)(t32 >> 16);
-        }
-
+        ports_inactive += (d->input_length[j] == 0 && d->input_over[j]);
         ports_completed += (d->input_over[j]);
-
-        TRACE(PROCESS, _b("b[%u] = %p%s"), j, b[j], (n == 0 ? " - scratch" : ""));
     }
 
     /* ...set complete flag saying we have no active input port */
@@ -200,46 +470,55 @@ static XA_ERRORCODE xa_mixer_do_execute_stereo_16bit(XAPcmMixer *d)
         return XA_NO_ERROR;
     }
 
-#if 1
-    /* ...process all tracks */
-    for (i = 0; i < d->frame_size; i++)
+    /* ...reset accumulator */
+    XF_CHK_ERR(d->scratch && d->output, XA_MIXER_EXEC_FATAL_STATE);
+    memset(d->scratch, 0, n * xa_mixer_acc_bytes(d));
+
+    /* ...accumulate tracks having data; silent tracks are skipped */
+    for (j = 0; j < XA_MIXER_MAX_TRACK_NUMBER; j++)
     {
-        WORD32     l32 = 0, r32 = 0;
+        UWORD32     k = d->input_length[j] / sample_bytes;
 
-        /* ...fill-in every channel in our map (unrolls loop here) */
-        for (j = 0; j < XA_MIXER_MAX_TRACK_NUMBER; j++)
-        {
-            /* ...left channel processing (no saturation here yet) */
-            l32 += *b[j]++ * v_l[j];
+        if (k == 0)     continue;
 
-            /* ...right channel processing */
-            r32 += *b[j]++ * v_r[j];
-        }
+        XF_CHK_ERR(d->input[j], XA_MIXER_EXEC_FATAL_INPUT);
 
-        /* ...normalize (truncate towards -inf) and multiply by master volume */
-        l32 = ((l32 >> 12) * w_l) >> 12;
-        r32 = ((r32 >> 12) * w_r) >> 12;
+        /* ...short buffer is mixed as if padded with silence */
+        (k > n ? k = n : 0);
 
-        /* ...saturate and store in buffer */
-        *output++ = DSP_SATURATE_S16(l32);
-        *output++ = DSP_SATURATE_S16(r32);
+        if (d->sample_format == XA_MIXER_SAMPLE_FORMAT_FLOAT)
+            xa_mixer_acc_float(d->scratch, d->input[j], k, d->gain[j], l, d->gain_s16);
+        else if (d->pcm_width == 16)
+            xa_mixer_acc_16bit(d->scratch, d->input[j], k, d->gain[j], l, d->gain_s16);
+        else
+            xa_mixer_acc_32bit(d->scratch, d->input[j], k, d->gain[j], l, d->gain_s16);
+
+        ports_mixed++;
+
+        TRACE(PROCESS, _b("track[%u]: mixed %u samples"), j, k);
     }
-#else
-    // Bypass processing
-    output += d->frame_size;
-    output += d->frame_size;  
-#endif
+
+    /* ...apply master volume and store result */
+    for (j = 0, unity = 1; j < l; j++)
+    {
+        unity &= (w[j] == XA_MIXER_UNITY);
+    }
+
+    if (d->sample_format == XA_MIXER_SAMPLE_FORMAT_FLOAT)
+        xa_mixer_out_float(d->output, d->scratch, n, w, l);
+    else if (d->pcm_width == 16)
+        xa_mixer_out_16bit(d->output, d->scratch, n, w, l, unity);
+    else
+        xa_mixer_out_32bit(d->output, d->scratch, n, w, l, (d->pcm_width == 24 ? (WORD32)0xffffff00 : (WORD32)0xffffffff));
+
     /* ...save total number of produced bytes */
-    d->produced = (UWORD32)((void *)output - d->output);
+    d->produced = n * sample_bytes;
 
     /* ...put flag saying we have output buffer */
     d->state |= XA_MIXER_FLAG_OUTPUT;
  
-    TRACE(PROCESS, _b("produced: %u bytes (%u samples)"), d->produced, d->frame_size);
+    TRACE(PROCESS, _b("produced: %u bytes (%u samples, %u tracks)"), d->produced, d->frame_size, ports_mixed);
     
-    /* ...reset input buffer length? */
-    //memset(d->input_length, 0, sizeof(d->input_length));
-
     /* ...set complete flag saying we have consumed all available input and input is over */
     if(ports_completed == XA_MIXER_MAX_TRACK_NUMBER)
     {
@@ -302,8 +581,15 @@ static XA_ERRORCODE xa_mixer_init(XAPcmMixer *d, WORD32 i_idx, pVOID pv_value)
         /* ...post-configuration initialization (all parameters are set) */
         XF_CHK_ERR(d->state & XA_MIXER_FLAG_PREINIT_DONE, XA_API_FATAL_INVALID_CMD_TYPE);
     
-        /* ...calculate input/output buffer size in bytes */
-        d->buffer_size = d->channels * d->frame_size * (d->pcm_width == 16 ? sizeof(WORD16) : sizeof(WORD32));
+        /* ...floating-point samples are 32-bit wide */
+        XF_CHK_ERR(d->sample_format != XA_MIXER_SAMPLE_FORMAT_FLOAT || d->pcm_width == 32, XA_MIXER_CONFIG_FATAL_RANGE);
+
+        /* ...calculate input/output and accumulator buffer sizes in bytes */
+        d->buffer_size = d->channels * d->frame_size * xa_mixer_sample_bytes(d);
+        d->scratch_size = d->channels * d->frame_size * xa_mixer_acc_bytes(d);
+
+        /* ...prepare gain rows for configured channel number */
+        xa_mixer_update_gains(d);
         
         /* ...mark post-initialization is complete */
         d->state |= XA_MIXER_FLAG_POSTINIT_DONE;
@@ -358,17 +644,49 @@ static XA_ERRORCODE xa_mixer_set_config_param(XAPcmMixer *d, WORD32 i_idx, pVOID
     switch (i_idx)
     {
     case XA_MIXER_CONFIG_PARAM_PCM_WIDTH:
-        /* ...check value is permitted (16 bits only) */
-        XF_CHK_ERR(i_value == 16, XA_MIXER_CONFIG_NONFATAL_RANGE);
+        /* ...command is valid only in configuration state */
+        XF_CHK_ERR((d->state & XA_MIXER_FLAG_POSTINIT_DONE) == 0, XA_MIXER_CONFIG_NONFATAL_STATE);
+        /* ...check value is permitted (24-bit samples are left-aligned in 32-bit containers) */
+        XF_CHK_ERR(i_value == 16 || i_value == 24 || i_value == 32, XA_MIXER_CONFIG_NONFATAL_RANGE);
         d->pcm_width = (UWORD32)i_value;
         return XA_NO_ERROR;
 
     case XA_MIXER_CONFIG_PARAM_CHANNELS:
-        /* ...allow stereo only */
-        XF_CHK_ERR(i_value == 2, XA_MIXER_CONFIG_NONFATAL_RANGE);
+        /* ...command is valid only in configuration state */
+        XF_CHK_ERR((d->state & XA_MIXER_FLAG_POSTINIT_DONE) == 0, XA_MIXER_CONFIG_NONFATAL_STATE);
+        /* ...allow mono up to 8 interleaved channels */
+        XF_CHK_ERR(i_value >= 1 && i_value <= XA_MIXER_MAX_CHANNELS, XA_MIXER_CONFIG_NONFATAL_RANGE);
         d->channels = (UWORD32)i_value;
         return XA_NO_ERROR;
 
+    case XA_MIXER_CONFIG_PARAM_SAMPLE_FORMAT:
+        /* ...command is valid only in configuration state */
+        XF_CHK_ERR((d->state & XA_MIXER_FLAG_POSTINIT_DONE) == 0, XA_MIXER_CONFIG_NONFATAL_STATE);
+        XF_CHK_ERR(i_value == XA_MIXER_SAMPLE_FORMAT_INT || i_value == XA_MIXER_SAMPLE_FORMAT_FLOAT, XA_MIXER_CONFIG_NONFATAL_RANGE);
+        d->sample_format = (UWORD32)i_value;
+        return XA_NO_ERROR;
+
+    case XA_MIXER_CONFIG_PARAM_VOLUME:
+    {
+        /* ...volume of particular track (or master volume) and channel (or all channels) */
+        UWORD32     track = (i_value >> 16) & 0xF;
+        UWORD32     channel = (i_value >> 20) & 0xF;
+        UWORD32     i;
+
+        XF_CHK_ERR(track <= XA_MIXER_MAX_TRACK_NUMBER, XA_MIXER_CONFIG_NONFATAL_RANGE);
+        XF_CHK_ERR(channel < XA_MIXER_MAX_CHANNELS || channel == XA_MIXER_VOLUME_ALL_CHANNELS, XA_MIXER_CONFIG_NONFATAL_RANGE);
+
+        for (i = 0; i < XA_MIXER_MAX_CHANNELS; i++)
+        {
+            (channel == XA_MIXER_VOLUME_ALL_CHANNELS || channel == i ? d->volume[track][i] = (UWORD16)i_value : 0);
+        }
+
+        /* ...apply new volume to next frame if mixer is running already */
+        (d->state & XA_MIXER_FLAG_POSTINIT_DONE ? xa_mixer_update_gains(d) : (void)0);
+
+        return XA_NO_ERROR;
+    }
+
     case XA_MIXER_CONFIG_PARAM_SAMPLE_RATE:      
          {
             /* ...set mixer sample rate */
@@ -400,6 +718,8 @@ static XA_ERRORCODE xa_mixer_set_config_param(XAPcmMixer *d, WORD32 i_idx, pVOID
         
     case XA_MIXER_CONFIG_PARAM_FRAME_SIZE: /* ...deprecated */
     case XA_MIXER_CONFIG_PARAM_FRAME_SIZE_IN_SAMPLES:
+        /* ...command is valid only in configuration state */
+        XF_CHK_ERR((d->state & XA_MIXER_FLAG_POSTINIT_DONE) == 0, XA_MIXER_CONFIG_NONFATAL_STATE);
         XF_CHK_ERR(((i_value <= MIXER_FRAME_SIZE_MAX) && (i_value >= MIXER_FRAME_SIZE_MIN)), XA_MIXER_CONFIG_NONFATAL_RANGE);
         /* ...set frame length (in samples) */
         d->frame_size = *(WORD32 *)pv_value;
@@ -443,6 +763,11 @@ static XA_ERRORCODE xa_mixer_get_config_param(XAPcmMixer *d, WORD32 i_idx, pVOID
         *(WORD32 *)pv_value = d->channels;
         return XA_NO_ERROR;
 
+    case XA_MIXER_CONFIG_PARAM_SAMPLE_FORMAT:
+        /* ...return current sample format */
+        *(WORD32 *)pv_value = d->sample_format;
+        return XA_NO_ERROR;
+
     case XA_MIXER_CONFIG_PARAM_FRAME_SIZE: /* ...deprecated */
     case XA_MIXER_CONFIG_PARAM_FRAME_SIZE_IN_SAMPLES:
         /* ...return current in/out frame length (in samples) */
@@ -482,7 +807,7 @@ static XA_ERRORCODE xa_mixer_execute(XAPcmMixer *d, WORD32 i_idx, pVOID pv_value
 #ifdef XAF_PROFILE
         mix_start = clk_read_start(CLK_SELN_THREAD);
 #endif
-        ret = xa_mixer_do_execute_stereo_16bit(d);
+        ret = xa_mixer_do_execute(d);
 #ifdef XAF_PROFILE
         mix_stop = clk_read_stop(CLK_SELN_THREAD);
         mix_cycles += clk_diff(mix_stop, mix_start);
@@ -633,8 +958,8 @@ static XA_ERRORCODE xa_mixer_get_mem_info_size(XAPcmMixer *d, WORD32 i_idx, pVOI
     /* ...return frame buffer minimal size only after post-initialization is done */
     XF_CHK_ERR(d->state & XA_MIXER_FLAG_POSTINIT_DONE, XA_API_FATAL_INVALID_CMD_TYPE);
 
-    /* ...all buffers are of the same length */
-    *(WORD32 *)pv_value = (WORD32) d->buffer_size;
+    /* ...input and output buffers are of the same length; scratch holds accumulator */
+    *(WORD32 *)pv_value = (WORD32) (i_idx == XA_MIXER_MAX_TRACK_NUMBER + 1 ? d->scratch_size : d->buffer_size);
         
     return XA_NO_ERROR;
 }
@@ -648,8 +973,8 @@ static XA_ERRORCODE xa_mixer_get_mem_info_alignment(XAPcmMixer *d, WORD32 i_idx,
     /* ...return frame buffer minimal size only after post-initialization is done */
     XF_CHK_ERR(d->state & XA_MIXER_FLAG_POSTINIT_DONE, XA_API_FATAL_INVALID_CMD_TYPE);
 
-    /* ...all buffers are 4-bytes aligned */
-    *(WORD32 *)pv_value = 4;
+    /* ...all buffers are 8-bytes aligned (accumulator is accessed with 64-bit loads) */
+    *(WORD32 *)pv_value = 8;
         
     return XA_NO_ERROR;
 }
@@ -49,6 +49,22 @@
 extern clk_t pcm_gain_cycles;
 #endif
 
+/* ...SIMD flavour of gain kernels */
+#ifdef __XCC__
+#include <xtensa/config/core-isa.h>
+#endif
+
+#if defined(__XCC__) && XCHAL_HAVE_HIFI4
+#include <xtensa/tie/xt_hifi4.h>
+#define XA_PCM_GAIN_HIFI4               1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define XA_PCM_GAIN_NEON                1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define XA_PCM_GAIN_SSE2                1
+#endif
+
 /*******************************************************************************
  * Internal functions definitions
  ******************************************************************************/
@@ -94,6 +110,9 @@ typedef struct XAPcmGain
     
     /* ...gain index */
     UWORD32                 gain_idx;
+
+    /* ...currently applied gain (Q12); follows gain index with a ramp */
+    WORD32                  gain;
  
     /* ...framesize in samples per channel */
     UWORD32                 frame_size;    
@@ -144,219 +163,224 @@ WORD16 pcm_gains[7]    = {4096, 2053, 1029, 516, 8173, 16306, 32536};    // Q12
 #define XA_PCM_GAIN_FLAG_COMPLETE          (1 << 5)
 
 /*******************************************************************************
- * DSP functions
+ * Gain kernels
+ *
+ * Each kernel applies constant Q12 gain to n samples of particular format with
+ * saturation. Generic loops are branch-free so that compiler can vectorize them;
+ * SIMD versions are bit-exact with generic ones. Input and output buffers do
+ * not overlap, and gain always fits into 16 bits.
  ******************************************************************************/
 
-/* ...pcm gain component pre-initialization (default parameters) */
-static inline void xa_pcm_gain_preinit(XAPcmGain *d)
-{
-  
-    /* ...pre-configuration initialization; reset internal data */
-    memset(d, 0, sizeof(*d));
-        
-    /* ...set default parameters */
-    d->channels = 1;
-    d->pcm_width = 16;
-    d->sample_rate = 48000;
-    d->burn_cycles = 0;
-    d->frame_size = 480; /* ...10ms frame size at 48 kHz */
-}
+/* ...branch-free saturation (maps to min/max) */
+#define XA_PCM_GAIN_SAT(v, lo, hi)      ((v) < (lo) ? (lo) : ((v) > (hi) ? (hi) : (v)))
+
+typedef void (*xa_pcm_gain_kernel_t)(void *output, const void *input, UWORD32 n, WORD32 gain);
 
-/* ...apply gain to 8-bit PCM stream */
-static XA_ERRORCODE xa_pcm_gain_do_execute_8bit(XAPcmGain *d)
+/* ...8-bit samples */
+static void xa_pcm_gain_kernel_8bit(void *output, const void *input, UWORD32 n, WORD32 gain)
 {
-    WORD32     i, k, nSize;
-    WORD8    *pIn = (WORD8 *) d->input;
-    WORD8    *pOut = (WORD8 *) d->output;
-    UWORD32     filled = d->input_avail;   
-    WORD8     input;
-    WORD16     gain = pcm_gains[d->gain_idx];
-    WORD32     product;
+    const WORD8 * restrict  pIn = (const WORD8 *) input;
+    WORD8 * restrict        pOut = (WORD8 *) output;
+    WORD32                  product;
+    UWORD32                 i = 0;
 
+#if XA_PCM_GAIN_NEON
+    int16x8_t               x;
+    int16x4_t               p0, p1;
 
-    nSize = filled;    //size of each sample is 1 byte    
-    k = (WORD32)(d->buffer_size - filled);
-    
-    /* ...check I/O buffer */
-    XF_CHK_ERR(d->input, XA_PCM_GAIN_EXEC_FATAL_INPUT);    
-    XF_CHK_ERR(d->output, XA_PCM_GAIN_EXEC_FATAL_INPUT);
-    
-    (k > 0 ? memset((void *)pIn + filled, 0x00, k) : 0);
-    
-    /* ...Processing loop */
-    for (i = 0; i < nSize; i++)
-    {    
-        input = *pIn++;
-        product = (WORD32)input*gain;
-        product = product >> 12;
-        
-        if(product > MAX_8BIT)
-            product = MAX_8BIT;
-        else if(product < MIN_8BIT)
-            product = MIN_8BIT;
-        
-        *pOut++ = (WORD8)product;
+    /* ...widen to 16 bits and saturate twice (to 16 and then to 8 bits) */
+    for (; i + 8 <= n; i += 8)
+    {
+        x = vmovl_s8(vld1_s8(pIn + i));
+        p0 = vqshrn_n_s32(vmull_n_s16(vget_low_s16(x), (WORD16)gain), 12);
+        p1 = vqshrn_n_s32(vmull_n_s16(vget_high_s16(x), (WORD16)gain), 12);
+        vst1_s8(pOut + i, vqmovn_s16(vcombine_s16(p0, p1)));
     }
+#elif XA_PCM_GAIN_SSE2
+    __m128i                 g = _mm_set1_epi16((WORD16)gain), x, y, lo, hi, p0, p1;
 
-    /* ...save total number of consumed bytes */
-    d->consumed = (UWORD32)((void *)pIn - d->input);
-
-    /* ...save total number of produced bytes */
-    d->produced = (UWORD32)((void *)pOut - d->output);
-
-    /* ...put flag saying we have output buffer */
-    d->state |= XA_PCM_GAIN_FLAG_OUTPUT;
-    
-    TRACE(PROCESS, _b("produced: %u bytes (%u samples)"), d->produced, nSize);
+    /* ...widen to 16 bits and saturate twice (to 16 and then to 8 bits) */
+    for (; i + 16 <= n; i += 16)
+    {
+        x = _mm_loadu_si128((const __m128i *)(pIn + i));
+        y = _mm_srai_epi16(_mm_unpacklo_epi8(x, x), 8);
+        lo = _mm_mullo_epi16(y, g);
+        hi = _mm_mulhi_epi16(y, g);
+        p0 = _mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), 12);
+        p1 = _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), 12);
+        y = _mm_packs_epi32(p0, p1);
+        x = _mm_srai_epi16(_mm_unpackhi_epi8(x, x), 8);
+        lo = _mm_mullo_epi16(x, g);
+        hi = _mm_mulhi_epi16(x, g);
+        p0 = _mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), 12);
+        p1 = _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), 12);
+        _mm_storeu_si128((__m128i *)(pOut + i), _mm_packs_epi16(y, _mm_packs_epi32(p0, p1)));
+    }
+#endif
 
-    /* ...return success result code */
-    return XA_NO_ERROR;
-}    
+    /* ...generic loop (or vector tail) */
+    for (; i < n; i++)
+    {
+        product = ((WORD32)pIn[i] * gain) >> 12;
+        pOut[i] = (WORD8)XA_PCM_GAIN_SAT(product, MIN_8BIT, MAX_8BIT);
+    }
+}
 
-/* ...apply gain to 16-bit PCM stream */
-static XA_ERRORCODE xa_pcm_gain_do_execute_16bit(XAPcmGain *d)
+/* ...16-bit samples */
+static void xa_pcm_gain_kernel_16bit(void *output, const void *input, UWORD32 n, WORD32 gain)
 {
-    WORD32     i, k, nSize;
-    WORD16    *pIn = (WORD16 *) d->input;
-    WORD16    *pOut = (WORD16 *) d->output;
-    UWORD32     filled = d->input_avail;   
-    WORD16     input;
-    WORD16     gain = pcm_gains[d->gain_idx];
-    WORD32     product;
-
-
-    nSize = filled >> 1;    //size of each sample is 2 bytes    
-    k = (WORD32)(d->buffer_size - filled);
-    
-    /* ...check I/O buffer */
-    XF_CHK_ERR(d->input, XA_PCM_GAIN_EXEC_FATAL_INPUT);    
-    XF_CHK_ERR(d->output, XA_PCM_GAIN_EXEC_FATAL_INPUT);
-    
-    (k > 0 ? memset((void *)pIn + filled, 0x00, k) : 0);
-    
-    /* ...Processing loop */
-    for (i = 0; i < nSize; i++)
-    {    
-        input = *pIn++;
-        product = (WORD32)input*gain;
-        product = product >> 12;
-        
-        if(product > MAX_16BIT)
-            product = MAX_16BIT;
-        else if(product < MIN_16BIT)
-            product = MIN_16BIT;
-        
-        *pOut++ = (WORD16)product;
+    const WORD16 * restrict pIn = (const WORD16 *) input;
+    WORD16 * restrict       pOut = (WORD16 *) output;
+    WORD32                  product;
+    UWORD32                 i = 0;
+
+#if XA_PCM_GAIN_HIFI4
+    const ae_int16x4       *pi = (const ae_int16x4 *) pIn;
+    ae_int16x4             *po = (ae_int16x4 *) pOut;
+    ae_valign               ai = AE_LA64_PP(pi), ao = AE_ZALIGN64();
+    ae_int16x4              g = AE_MOVDA16(gain), x;
+    ae_int32x2              p0, p1;
+
+    /* ...buffers are only 4-bytes aligned; use aligning loads/stores */
+    for (; i + 4 <= n; i += 4)
+    {
+        AE_LA16X4_IP(x, ai, pi);
+        AE_MUL16X4(p0, p1, x, g);
+        p0 = AE_SRAI32(p0, 12);
+        p1 = AE_SRAI32(p1, 12);
+        AE_SA16X4_IP(AE_SAT16X4(p0, p1), ao, po);
     }
 
-    /* ...save total number of consumed bytes */
-    d->consumed = (UWORD32)((void *)pIn - d->input);
+    AE_SA64POS_FP(ao, po);
+#elif XA_PCM_GAIN_NEON
+    int16x8_t               x;
+    int16x4_t               p0, p1;
 
-    /* ...save total number of produced bytes */
-    d->produced = (UWORD32)((void *)pOut - d->output);
+    for (; i + 8 <= n; i += 8)
+    {
+        x = vld1q_s16(pIn + i);
+        p0 = vqshrn_n_s32(vmull_n_s16(vget_low_s16(x), (WORD16)gain), 12);
+        p1 = vqshrn_n_s32(vmull_n_s16(vget_high_s16(x), (WORD16)gain), 12);
+        vst1q_s16(pOut + i, vcombine_s16(p0, p1));
+    }
+#elif XA_PCM_GAIN_SSE2
+    __m128i                 g = _mm_set1_epi16((WORD16)gain), x, lo, hi, p0, p1;
 
-    /* ...put flag saying we have output buffer */
-    d->state |= XA_PCM_GAIN_FLAG_OUTPUT;
-    
-    TRACE(PROCESS, _b("produced: %u bytes (%u samples)"), d->produced, nSize);
+    for (; i + 8 <= n; i += 8)
+    {
+        x = _mm_loadu_si128((const __m128i *)(pIn + i));
+        lo = _mm_mullo_epi16(x, g);
+        hi = _mm_mulhi_epi16(x, g);
+        p0 = _mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), 12);
+        p1 = _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), 12);
+        _mm_storeu_si128((__m128i *)(pOut + i), _mm_packs_epi32(p0, p1));
+    }
+#endif
 
-    /* ...return success result code */
-    return XA_NO_ERROR;
-}    
+    /* ...generic loop (or vector tail) */
+    for (; i < n; i++)
+    {
+        product = ((WORD32)pIn[i] * gain) >> 12;
+        pOut[i] = (WORD16)XA_PCM_GAIN_SAT(product, MIN_16BIT, MAX_16BIT);
+    }
+}
 
-/* ...apply gain to 24-bit PCM stream */
-static XA_ERRORCODE xa_pcm_gain_do_execute_24bit(XAPcmGain *d)
+/* ...32-bit containers; 24-bit samples are left-aligned, lower byte is cleared */
+static inline void xa_pcm_gain_kernel_32(WORD32 * restrict pOut, const WORD32 * restrict pIn, UWORD32 n, WORD32 gain, WORD32 mask)
 {
-    WORD32     i, k, nSize;
-    WORD24    *pIn = (WORD24 *) d->input;
-    WORD24    *pOut = (WORD24 *) d->output;
-    UWORD32     filled = d->input_avail;   
-    WORD24     input;
-    WORD16     gain = pcm_gains[d->gain_idx];
-    WORD64     product;
+    WORD64                  product;
+    UWORD32                 i = 0;
 
+#if XA_PCM_GAIN_NEON
+    int32x4_t               x, m = vdupq_n_s32(mask);
+    int32x2_t               p0, p1;
 
-    nSize = filled >> 2;    //size of each sample is 4 bytes    
-    k = (WORD32)(d->buffer_size - filled);
-    
-    /* ...check I/O buffer */
-    XF_CHK_ERR(d->input, XA_PCM_GAIN_EXEC_FATAL_INPUT);    
-    XF_CHK_ERR(d->output, XA_PCM_GAIN_EXEC_FATAL_INPUT);
-    
-    (k > 0 ? memset((void *)pIn + filled, 0x00, k) : 0);
-    
-    /* ...Processing loop */
-    for (i = 0; i < nSize; i++)
-    {    
-        input = *pIn++;
-        product = (WORD64)input*gain;
-        product = product >> 12;
-        
-        if(product > MAX_24BIT)
-            product = MAX_24BIT;
-        else if(product < MIN_24BIT)
-            product = MIN_24BIT;
-        
-        product &= 0xffffff00;
-        *pOut++ = (WORD24)product;
+    for (; i + 4 <= n; i += 4)
+    {
+        x = vld1q_s32(pIn + i);
+        p0 = vqshrn_n_s64(vmull_n_s32(vget_low_s32(x), gain), 12);
+        p1 = vqshrn_n_s64(vmull_n_s32(vget_high_s32(x), gain), 12);
+        vst1q_s32(pOut + i, vandq_s32(vcombine_s32(p0, p1), m));
     }
+#endif
 
-    /* ...save total number of consumed bytes */
-    d->consumed = (UWORD32)((void *)pIn - d->input);
+    for (; i < n; i++)
+    {
+        product = ((WORD64)pIn[i] * gain) >> 12;
+        pOut[i] = (WORD32)XA_PCM_GAIN_SAT(product, MIN_32BIT, MAX_32BIT) & mask;
+    }
+}
 
-    /* ...save total number of produced bytes */
-    d->produced = (UWORD32)((void *)pOut - d->output);
+/* ...24-bit samples */
+static void xa_pcm_gain_kernel_24bit(void *output, const void *input, UWORD32 n, WORD32 gain)
+{
+    xa_pcm_gain_kernel_32((WORD32 *) output, (const WORD32 *) input, n, gain, (WORD32)0xffffff00);
+}
 
-    /* ...put flag saying we have output buffer */
-    d->state |= XA_PCM_GAIN_FLAG_OUTPUT;
-    
-    TRACE(PROCESS, _b("produced: %u bytes (%u samples)"), d->produced, nSize);
+/* ...32-bit samples */
+static void xa_pcm_gain_kernel_32bit(void *output, const void *input, UWORD32 n, WORD32 gain)
+{
+    xa_pcm_gain_kernel_32((WORD32 *) output, (const WORD32 *) input, n, gain, (WORD32)0xffffffff);
+}
 
-    /* ...return success result code */
-    return XA_NO_ERROR;
-}    
+/*******************************************************************************
+ * DSP functions
+ ******************************************************************************/
 
-/* ...apply gain to 32-bit PCM stream */
-static XA_ERRORCODE xa_pcm_gain_do_execute_32bit(XAPcmGain *d)
+/* ...pcm gain component pre-initialization (default parameters) */
+static inline void xa_pcm_gain_preinit(XAPcmGain *d)
 {
-    WORD32     i, k, nSize;
-    WORD32    *pIn = (WORD32 *) d->input;
-    WORD32    *pOut = (WORD32 *) d->output;
-    UWORD32     filled = d->input_avail;   
-    WORD32     input;
-    WORD16     gain = pcm_gains[d->gain_idx];
-    WORD64     product;
+  
+    /* ...pre-configuration initialization; reset internal data */
+    memset(d, 0, sizeof(*d));
+        
+    /* ...set default parameters */
+    d->channels = 1;
+    d->pcm_width = 16;
+    d->sample_rate = 48000;
+    d->burn_cycles = 0;
+    d->frame_size = 480; /* ...10ms frame size at 48 kHz */
+}
 
+/* ...apply gain to PCM stream; ramp linearly over the buffer if gain has changed */
+static XA_ERRORCODE xa_pcm_gain_do_execute(XAPcmGain *d, xa_pcm_gain_kernel_t kernel, UWORD32 sample_size)
+{
+    UWORD32     nSize = d->input_avail / sample_size;
+    UWORD32     frames = nSize / d->channels;
+    UWORD32     stride = d->channels * sample_size;
+    WORD32      target = pcm_gains[d->gain_idx];
+    WORD32      acc, step;
+    UWORD32     i, n = 0;
 
-    nSize = filled >> 2;    //size of each sample is 4 bytes    
-    k = (WORD32)(d->buffer_size - filled);
-    
     /* ...check I/O buffer */
     XF_CHK_ERR(d->input, XA_PCM_GAIN_EXEC_FATAL_INPUT);    
     XF_CHK_ERR(d->output, XA_PCM_GAIN_EXEC_FATAL_INPUT);
-    
-    (k > 0 ? memset((void *)pIn + filled, 0x00, k) : 0);
-    
-    /* ...Processing loop */
-    for (i = 0; i < nSize; i++)
-    {    
-        input = *pIn++;
-        product = (WORD64)input*gain;
-        product = product >> 12;
-        
-        if(product > MAX_32BIT)
-            product = MAX_32BIT;
-        else if(product < MIN_32BIT)
-            product = MIN_32BIT;
-        
-        *pOut++ = (WORD32)product;
+
+    if (d->gain != target && frames > 0)
+    {
+        /* ...interpolate gain per sample frame in Q16 to avoid zipper noise */
+        acc = d->gain << 16;
+        step = (WORD32)(((WORD64)(target - d->gain) << 16) / (WORD32)frames);
+
+        for (i = 0; i < frames; i++, n += d->channels)
+        {
+            acc += step;
+            kernel(d->output + i * stride, d->input + i * stride, d->channels, acc >> 16);
+        }
+
+        TRACE(PROCESS, _b("gain ramp: %d -> %d over %u frames"), d->gain, target, frames);
+
+        d->gain = target;
     }
 
+    /* ...constant gain for the rest of the buffer */
+    kernel(d->output + n * sample_size, d->input + n * sample_size, nSize - n, target);
+
     /* ...save total number of consumed bytes */
-    d->consumed = (UWORD32)((void *)pIn - d->input);
+    d->consumed = nSize * sample_size;
 
     /* ...save total number of produced bytes */
-    d->produced = (UWORD32)((void *)pOut - d->output);
+    d->produced = nSize * sample_size;
 
     /* ...put flag saying we have output buffer */
     d->state |= XA_PCM_GAIN_FLAG_OUTPUT;
@@ -414,6 +438,9 @@ static XA_ERRORCODE xa_pcm_gain_init(XAPcmGain *d, WORD32 i_idx, pVOID pv_value)
     {
         /* ...post-configuration initialization (all parameters are set) */
         XF_CHK_ERR(d->state & XA_PCM_GAIN_FLAG_PREINIT_DONE, XA_API_FATAL_INVALID_CMD_TYPE);
+
+        /* ...start with configured gain; only run-time changes are ramped */
+        d->gain = pcm_gains[d->gain_idx];
       
         /* ...mark post-initialization is complete */
         d->state |= XA_PCM_GAIN_FLAG_POSTINIT_DONE;
@@ -670,16 +697,16 @@ static XA_ERRORCODE xa_pcm_gain_execute(XAPcmGain *d, WORD32 i_idx, pVOID pv_val
         switch(d->pcm_width)
         {
             case 8:
-                ret = xa_pcm_gain_do_execute_8bit(d);
+                ret = xa_pcm_gain_do_execute(d, xa_pcm_gain_kernel_8bit, sizeof(WORD8));
                 break;
             case 16:
-                ret = xa_pcm_gain_do_execute_16bit(d);
+                ret = xa_pcm_gain_do_execute(d, xa_pcm_gain_kernel_16bit, sizeof(WORD16));
                 break;
             case 24:
-                ret = xa_pcm_gain_do_execute_24bit(d);
+                ret = xa_pcm_gain_do_execute(d, xa_pcm_gain_kernel_24bit, sizeof(WORD24));
                 break;
             case 32:
-                ret = xa_pcm_gain_do_execute_32bit(d);
+                ret = xa_pcm_gain_do_execute(d, xa_pcm_gain_kernel_32bit, sizeof(WORD32));
                 break;
             default:
                 XF_CHK_ERR(0, XA_PCM_GAIN_CONFIG_NONFATAL_RANGE);
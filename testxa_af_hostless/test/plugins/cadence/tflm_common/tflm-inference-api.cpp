@@ -28,11 +28,13 @@
 namespace {}  // namespace
 
 int inference_persistent_byte_size(int kTensorArenaSize) {return 0;};
-int inference_init(void *pPersist, void * pModel, int kTensorArenaSize, void *p_micro_op_resolver) {return 0;};
+int inference_init(void *pPersist, void * pModel, int kTensorArenaSize, void *p_micro_op_resolver, void *pScratchArena, int kScratchArenaSize) {return 0;};
 int inference_exec_process(void *pIn, int inp_bytes, void *pOut, int *out_bytes, void **output_tensor, void *pPersist) {return 0;};
+void *inference_input_buffer(void *pPersist) {return 0;};
 
 #else //PACK_WS_DUMMY
 #include "tensorflow/lite/micro/kernels/micro_ops.h"
+#include "tensorflow/lite/micro/micro_allocator.h"
 #include "tensorflow/lite/micro/micro_error_reporter.h"
 #include "tensorflow/lite/micro/micro_interpreter.h"
 #include "tensorflow/lite/micro/micro_mutable_op_resolver.h"
@@ -58,16 +60,36 @@ int inference_persistent_byte_size(int kTensorArenaSize)
             + sizeof(xa_inference_state_struct);
 }
 
-int inference_init(void *pPersist, void * pModel, int kTensorArenaSize, void *p_micro_op_resolver)
+int inference_init(void *pPersist, void * pModel, int kTensorArenaSize, void *p_micro_op_resolver, void *pScratchArena, int kScratchArenaSize)
 {
     xa_inference_state_struct *pState = (xa_inference_state_struct *)pPersist;
     tflite::MicroErrorReporter *error_reporter = new (&pState->error_reporter) tflite::MicroErrorReporter;
     const tflite::Model* model;
     model = tflite::GetModel(pModel);
+    tflite::MicroInterpreter *interpreter;
         
     // Build an interpreter to run the model with.
-    tflite::MicroInterpreter *interpreter = new (&pState->interpreter) tflite::MicroInterpreter(
-            model, *(tflite::MicroOpResolver *) p_micro_op_resolver, (uint8_t *)pState->tensor_arena, kTensorArenaSize, error_reporter);
+    if (pScratchArena == nullptr)
+    {
+        interpreter = new (&pState->interpreter) tflite::MicroInterpreter(
+                model, *(tflite::MicroOpResolver *) p_micro_op_resolver, (uint8_t *)pState->tensor_arena, kTensorArenaSize, error_reporter);
+    }
+    else
+    {
+        // Keep persistent allocations in the private arena; activations are
+        // only live within Invoke() and are planned into the shared one
+        tflite::MicroAllocator *allocator = tflite::MicroAllocator::Create(
+                (uint8_t *)pState->tensor_arena, kTensorArenaSize, (uint8_t *)pScratchArena, kScratchArenaSize, error_reporter);
+
+        if (allocator == nullptr)
+        {
+            printf("MicroAllocator::Create() failed\n");
+            return -1;
+        }
+
+        interpreter = new (&pState->interpreter) tflite::MicroInterpreter(
+                model, *(tflite::MicroOpResolver *) p_micro_op_resolver, allocator, error_reporter);
+    }
 
     pState->kTensorArenaSize = kTensorArenaSize;
 
@@ -81,6 +103,13 @@ int inference_init(void *pPersist, void * pModel, int kTensorArenaSize, void *p_
     return 0;
 }
 
+void *inference_input_buffer(void *pPersist)
+{
+    xa_inference_state_struct *pState = (xa_inference_state_struct *)pPersist;
+
+    return (void *) pState->interpreter.input(0)->data.uint8;
+}
+
 int  inference_exec_process(void *pIn, int inp_bytes, void *pOut, int *out_bytes, void **output_tensor, void *pPersist)
 {
     /* derive the pointers for instances */
@@ -95,8 +124,8 @@ int  inference_exec_process(void *pIn, int inp_bytes, void *pOut, int *out_bytes
     tensor_data = tensor->data.uint8;
     buffer = (uint8_t *)pIn;
 
-    // Copy feature buffer to input tensor
-    for (int i = 0; i < inp_bytes; i++) 
+    // Copy feature buffer to input tensor (NULL if already written in place)
+    for (int i = 0; buffer && i < inp_bytes; i++) 
     {
         tensor_data[i] = buffer[i];
     }
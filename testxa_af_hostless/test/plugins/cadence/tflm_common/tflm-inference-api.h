@@ -101,8 +101,9 @@ typedef enum {
 #endif
 
 int  inference_persistent_byte_size(int kTensorArenaSize);
-int  inference_init(void *pPersist, void * pModel, int kTensorArenaSize, void *op_resolver);
+int  inference_init(void *pPersist, void * pModel, int kTensorArenaSize, void *op_resolver, void *pScratchArena, int kScratchArenaSize);
 int  inference_exec_process(void *pIn, int inp_bytes, void *pOut, int *out_bytes, void **output_tensor, void *pPersist);
+void *inference_input_buffer(void *pPersist);
 #if 0
 int op_resolver_add_operator(void *pPersist, int tflm_operator);
 #endif
@@ -0,0 +1,133 @@
+/*
+* Copyright (c) 2015-2022 Cadence Design Systems Inc.
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/*******************************************************************************
+ * xa-hop-window.c
+ *
+ * Hop/window input adapter for overlapping-frame processing
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+
+#include <string.h>
+
+#include "xa-hop-window.h"
+
+/*******************************************************************************
+ * Internal helpers
+ ******************************************************************************/
+
+/* ...ring offset of the window start */
+static inline UWORD32 xa_hop_window_start(xa_hop_window_t *hw)
+{
+    return (hw->write >= hw->level ? hw->write - hw->level : hw->write + hw->size - hw->level);
+}
+
+/*******************************************************************************
+ * API functions
+ ******************************************************************************/
+
+UWORD32 xa_hop_window_size(UWORD32 window, UWORD32 hop, UWORD32 depth)
+{
+    UWORD32     span = window * (depth ? depth : 1);
+
+    /* ...windows always start at hop boundaries of the ring */
+    return (span + hop - 1) / hop * hop;
+}
+
+void xa_hop_window_init(xa_hop_window_t *hw, void *ring, UWORD32 size, UWORD32 window, UWORD32 hop)
+{
+    hw->ring = (UWORD8 *) ring;
+    hw->size = size;
+    hw->window = window;
+    hw->hop = hop;
+
+    xa_hop_window_reset(hw);
+}
+
+void xa_hop_window_reset(xa_hop_window_t *hw)
+{
+    hw->write = 0;
+    hw->level = 0;
+}
+
+UWORD32 xa_hop_window_put(xa_hop_window_t *hw, const void *data, UWORD32 n)
+{
+    const UWORD8   *src = (const UWORD8 *) data;
+    UWORD32         k;
+
+    /* ...take no more than needed to complete the window */
+    if (hw->level >= hw->window)
+        return 0;
+    else if (n > hw->window - hw->level)
+        n = hw->window - hw->level;
+
+    /* ...copy up to the ring end, then wrap around */
+    k = hw->size - hw->write;
+    k = (n < k ? n : k);
+    memcpy(hw->ring + hw->write, src, k);
+
+    if (n > k)
+        memcpy(hw->ring, src + k, n - k);
+
+    hw->write = (hw->write + n) % hw->size;
+    hw->level += n;
+
+    return n;
+}
+
+const void * xa_hop_window_get(xa_hop_window_t *hw, void *linear)
+{
+    UWORD32     start = xa_hop_window_start(hw);
+
+    /* ...window is contiguous in the ring - access in place */
+    if (start + hw->window <= hw->size)
+        return hw->ring + start;
+
+    /* ...window wraps around; gather it */
+    xa_hop_window_copy(hw, linear);
+
+    return linear;
+}
+
+void xa_hop_window_copy(xa_hop_window_t *hw, void *dst)
+{
+    UWORD32     start = xa_hop_window_start(hw);
+    UWORD32     k = hw->size - start;
+
+    if (k >= hw->window)
+    {
+        memcpy(dst, hw->ring + start, hw->window);
+    }
+    else
+    {
+        memcpy(dst, hw->ring + start, k);
+        memcpy((UWORD8 *) dst + k, hw->ring, hw->window - k);
+    }
+}
+
+void xa_hop_window_advance(xa_hop_window_t *hw)
+{
+    hw->level = (hw->level > hw->hop ? hw->level - hw->hop : 0);
+}
@@ -0,0 +1,106 @@
+/*
+* Copyright (c) 2015-2022 Cadence Design Systems Inc.
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/*******************************************************************************
+ * xa-hop-window.h
+ *
+ * Hop/window input adapter for overlapping-frame processing
+ *
+ * Input is accumulated in a ring buffer; a window of "window" bytes is
+ * processed each time it is complete, and the window then advances by "hop"
+ * bytes. Overlapping data stays in place, so the plugin consumes every input
+ * byte it accepts and the input port never has to shift leftovers.
+ ******************************************************************************/
+
+#ifndef __XA_HOP_WINDOW_H__
+#define __XA_HOP_WINDOW_H__
+
+#include "xa_type_def.h"
+
+/*******************************************************************************
+ * Adapter state
+ ******************************************************************************/
+
+typedef struct xa_hop_window
+{
+    /* ...ring buffer storage */
+    UWORD8             *ring;
+
+    /* ...ring buffer size in bytes (multiple of hop) */
+    UWORD32             size;
+
+    /* ...window length in bytes */
+    UWORD32             window;
+
+    /* ...window advance in bytes */
+    UWORD32             hop;
+
+    /* ...write position */
+    UWORD32             write;
+
+    /* ...number of buffered bytes */
+    UWORD32             level;
+
+}   xa_hop_window_t;
+
+/*******************************************************************************
+ * API functions
+ ******************************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ...ring size for given window and hop; ring spans at least "depth" windows
+ * (the deeper the ring, the fewer windows wrap around its end) */
+extern UWORD32 xa_hop_window_size(UWORD32 window, UWORD32 hop, UWORD32 depth);
+
+/* ...attach ring storage of xa_hop_window_size() bytes and reset (hop <= window) */
+extern void xa_hop_window_init(xa_hop_window_t *hw, void *ring, UWORD32 size, UWORD32 window, UWORD32 hop);
+
+/* ...drop buffered data */
+extern void xa_hop_window_reset(xa_hop_window_t *hw);
+
+/* ...buffer input data up to a complete window; returns number of bytes taken */
+extern UWORD32 xa_hop_window_put(xa_hop_window_t *hw, const void *data, UWORD32 n);
+
+/* ...contiguous window pointer; data is gathered into "linear" (window bytes)
+ * only if the window wraps around the ring end */
+extern const void * xa_hop_window_get(xa_hop_window_t *hw, void *linear);
+
+/* ...copy window into destination buffer */
+extern void xa_hop_window_copy(xa_hop_window_t *hw, void *dst);
+
+/* ...advance window by one hop */
+extern void xa_hop_window_advance(xa_hop_window_t *hw);
+
+#ifdef __cplusplus
+}
+#endif
+
+/* ...check if complete window is buffered */
+static inline UWORD32 xa_hop_window_ready(xa_hop_window_t *hw)
+{
+    return (hw->level >= hw->window);
+}
+
+#endif /* __XA_HOP_WINDOW_H__ */
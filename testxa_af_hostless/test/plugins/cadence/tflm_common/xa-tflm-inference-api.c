@@ -38,8 +38,24 @@
 #include "xf-debug.h"
 #include "tflm-inference-api.h"
 #include "audio/xa-microspeech-inference-api.h"
+#include "xa-hop-window.h"
 
 
+/*******************************************************************************
+ * Local configuration
+ ******************************************************************************/
+
+/* ...default number of inferences per execute call for overlapping frames */
+#ifndef XA_INFERENCE_CFG_BATCH
+#define XA_INFERENCE_CFG_BATCH              4
+#endif
+
+/* ...maximal number of inferences per execute call */
+#define XA_INFERENCE_BATCH_MAX              16
+
+/* ...tensor arena alignment required by TFLM */
+#define XA_INFERENCE_ARENA_ALIGN            16
+
 /*******************************************************************************
  * Tracing configuration
  ******************************************************************************/
@@ -93,6 +109,32 @@ typedef struct XAInference
     /* ...inference specification */
     xaf_tflm_inference_spec_t inf_spec;
 
+    /* ...overlapping window input adapter (input stride shorter than frame) */
+    xa_hop_window_t     hop_window;
+
+    /* ...adapter ring buffer size (zero if frames do not overlap) */
+    UWORD32             ring_size;
+
+    /* ...maximal number of inferences per execute call (output budget) */
+    UWORD32             batch;
+
+    /* ...gating threshold passed to network-specific gate */
+    WORD32              gate_threshold;
+
+    /* ...remaining strides to keep inference running after gate activity */
+    UWORD32             gate_hold;
+
+    /* ...number of inferences run and skipped by the gate */
+    UWORD32             inferences;
+    UWORD32             skipped;
+
+    /* ...cycles spent in last inference and in all of them */
+    UWORD32             cycles_last;
+    UWORD64             cycles_total;
+
+    /* ...part of tensor arena placed in scratch shared by components of same priority */
+    UWORD32             arena_shared;
+
 }   XAInference;
 
 /*******************************************************************************
@@ -105,6 +147,7 @@ typedef struct XAInference
 #define XA_INFERENCE_FLAG_OUTPUT            (1 << 3)
 #define XA_INFERENCE_FLAG_EOS_RECEIVED      (1 << 4)
 #define XA_INFERENCE_FLAG_COMPLETE          (1 << 5)
+#define XA_INFERENCE_FLAG_GATE              (1 << 6)
 
 /*******************************************************************************
  * DSP functions
@@ -123,11 +166,108 @@ static inline void xa_inference_preinit(XAInference *d)
 }
 
 
-/* ...apply gain to 16-bit PCM stream */
+/* ...input buffer length (one stride per batched inference if frames overlap) */
+static inline UWORD32 xa_inference_input_frame(XAInference *d)
+{
+    return (d->ring_size ? d->batch * d->inf_spec.input_stride : d->inf_spec.input_size);
+}
+
+/* ...tensor arena size kept in persistent memory */
+static inline UWORD32 xa_inference_arena_persist(XAInference *d)
+{
+    return d->inf_spec.tensor_arena_size - d->arena_shared;
+}
+
+/* ...additional persistent memory of inference wrapper */
+static inline void * xa_inference_addl_persist(XAInference *d)
+{
+    return (UWORD8 *) d->persistent + inference_persistent_byte_size(xa_inference_arena_persist(d)) + d->inf_spec.op_resolver_size;
+}
+
+/* ...(re)build interpreter over persistent arena and shared scratch arena, if any */
+static XA_ERRORCODE xa_inference_bind(XAInference *d)
+{
+    void       *p_op_resolver = (UWORD8 *) d->persistent + inference_persistent_byte_size(xa_inference_arena_persist(d));
+    void       *arena = NULL;
+
+    if (d->arena_shared)
+    {
+        /* ...scratch is reported with alignment slack; arena goes first */
+        arena = (void *) (((uintptr_t) d->scratch + XA_INFERENCE_ARENA_ALIGN - 1) & ~(uintptr_t) (XA_INFERENCE_ARENA_ALIGN - 1));
+    }
+
+    if (inference_init(d->persistent, d->inf_spec.model, xa_inference_arena_persist(d), p_op_resolver, arena, d->arena_shared) != 0)
+        return XA_FATAL_ERROR;
+
+    TRACE(INIT, _b("arena: %u persistent, %u shared (%p)"), xa_inference_arena_persist(d), d->arena_shared, arena);
+
+    return XA_NO_ERROR;
+}
+
+/* ...check new input data with network-specific gate; inactive input skips inference */
+static inline UWORD32 xa_inference_gate(XAInference *d, void *data, UWORD32 n)
+{
+    if (!(d->state & XA_INFERENCE_FLAG_GATE) || !d->inf_spec.inference_gate)
+        return 1;
+
+    return (d->inf_spec.inference_gate(data, n, d->gate_threshold, xa_inference_addl_persist(d)) != 0);
+}
+
+/* ...take next complete input frame; returns 0 if there is none. Overlapping
+ * frames are assembled in the ring and copied straight into the input tensor
+ * ("frame" is NULL then); the frame is not copied if it is gated out */
+static UWORD32 xa_inference_next_frame(XAInference *d, void **frame, UWORD32 *active)
+{
+    UWORD8     *input = (UWORD8 *) d->input + d->consumed;
+    UWORD32     avail = d->input_avail - d->consumed;
+    UWORD32     n;
+    void       *tensor;
+
+    if (d->ring_size == 0)
+    {
+        if (avail < (UWORD32) d->inf_spec.input_size)
+            return 0;
+
+        *frame = input, *active = xa_inference_gate(d, input, d->inf_spec.input_size);
+        d->consumed += d->inf_spec.input_stride;
+
+        return 1;
+    }
+
+    /* ...all accepted input is consumed; frame overlap is kept in the ring */
+    if ((n = xa_hop_window_put(&d->hop_window, input, avail)) != 0)
+    {
+        /* ...keep inferring while active input is within the frame */
+        if (xa_inference_gate(d, input, n))
+            d->gate_hold = (d->inf_spec.input_size + d->inf_spec.input_stride - 1) / d->inf_spec.input_stride;
+
+        d->consumed += n;
+    }
+
+    if (!xa_hop_window_ready(&d->hop_window))
+        return 0;
+
+    *frame = input, *active = (d->gate_hold != 0 || !(d->state & XA_INFERENCE_FLAG_GATE));
+
+    if (*active && (tensor = inference_input_buffer(d->persistent)) != NULL)
+    {
+        xa_hop_window_copy(&d->hop_window, tensor);
+        *frame = NULL;
+    }
+
+    (d->gate_hold ? d->gate_hold-- : 0);
+    xa_hop_window_advance(&d->hop_window);
+
+    return 1;
+}
+
+/* ...run inference on 16-bit PCM / feature stream */
 static XA_ERRORCODE xa_inference_do_execute(XAInference *d)
 {
-    WORD16   *pIn = (WORD16 *) d->input;
-    WORD8    *pOut = (WORD8 *) d->output;
+    WORD8      *pOut = (WORD8 *) d->output;
+    UWORD32     frames = 0, runs = 0;
+    void       *frame;
+    UWORD32     active;
 
     /* ...check I/O buffer */
     XF_CHK_ERR(d->input, XA_INFERENCE_EXEC_FATAL_INPUT);
@@ -137,36 +277,54 @@ static XA_ERRORCODE xa_inference_do_execute(XAInference *d)
     d->consumed = 0;
     d->produced = 0;
 
-
-    if ( d->input_avail >=  d->inf_spec.input_size)
+    /* ...drain all complete frames the output buffer has room for */
+    while (runs < d->batch && xa_inference_next_frame(d, &frame, &active))
     {
-        void *output_tensor;
-        int ret = inference_exec_process(pIn, d->inf_spec.input_size, pOut, (int *) &d->produced, &output_tensor, d->persistent);
+        void   *output_tensor;
+        int     produced;
+        UWORD32 t0;
+        int     ret;
+
+        frames++;
+
+        if (!active)
+        {
+            /* ...gated out; no inference, no output */
+            d->skipped++;
+            continue;
+        }
+
+        t0 = (UWORD32) __xf_get_cycles();
+
+        ret = inference_exec_process(frame, d->inf_spec.input_size, pOut, &produced, &output_tensor, d->persistent);
 
         if ( ret != 0 )
         {
             return XA_FATAL_ERROR;
         }
-        
-        /* ...save total number of consumed bytes */
-        d->consumed = d->inf_spec.input_stride;
 
         /* ...save total number of produced bytes */
-        d->produced = d->inf_spec.output_size;
+        produced = d->inf_spec.output_size;
         
         if (d->inf_spec.inference_exec_postprocess)
         {
-            void *p_op_resolver = (void *) ((unsigned int) d->persistent + inference_persistent_byte_size(d->inf_spec.tensor_arena_size));
-            void *addl_persist = (void *) ((unsigned int) p_op_resolver + d->inf_spec.op_resolver_size);
-            ret = (d->inf_spec.inference_exec_postprocess)(pOut, output_tensor, (int *) &d->produced, addl_persist);
+            ret = (d->inf_spec.inference_exec_postprocess)(pOut, output_tensor, &produced, xa_inference_addl_persist(d));
 
             if ( ret != 0 )
             {
                 return XA_FATAL_ERROR;
             }
         }
+
+        /* ...account inference cost */
+        d->cycles_last = (UWORD32) __xf_get_cycles() - t0;
+        d->cycles_total += d->cycles_last;
+        d->inferences++;
+
+        pOut += produced, d->produced += produced, runs++;
     }
-    else if(d->state & XA_INFERENCE_FLAG_EOS_RECEIVED)
+
+    if (frames == 0 && (d->state & XA_INFERENCE_FLAG_EOS_RECEIVED))
     {
         d->state |= XA_INFERENCE_FLAG_COMPLETE;
         d->state &= ~XA_INFERENCE_FLAG_EOS_RECEIVED;
@@ -175,7 +333,7 @@ static XA_ERRORCODE xa_inference_do_execute(XAInference *d)
     /* ...put flag saying we have output buffer */
     d->state |= XA_INFERENCE_FLAG_OUTPUT;
 
-    TRACE(PROCESS, _b("produced: %u bytes"), d->produced);
+    TRACE(PROCESS, _b("frames: %u, inferences: %u, produced: %u bytes"), frames, runs, d->produced);
 
     /* ...return success result code */
     return XA_NO_ERROR;
@@ -184,7 +342,12 @@ static XA_ERRORCODE xa_inference_do_execute(XAInference *d)
 /* ...runtime reset */
 static XA_ERRORCODE xa_inference_do_runtime_init(XAInference *d)
 {
-    /* ...no special processing is needed here */
+    /* ...drop buffered input frames */
+    if (d->ring_size)
+        xa_hop_window_reset(&d->hop_window);
+
+    d->gate_hold = 0;
+
     return XA_NO_ERROR;
 }
 
@@ -230,11 +393,29 @@ static XA_ERRORCODE xa_inference_init(XAInference *d, WORD32 i_idx, pVOID pv_val
         XF_CHK_ERR(d->state & XA_INFERENCE_FLAG_PREINIT_DONE, XA_API_FATAL_INVALID_CMD_TYPE);
 
         d->scratch_size = d->inf_spec.addl_scratch_size;
+
+        /* ...shared part of tensor arena heads the scratch (with alignment slack) */
+        if (d->arena_shared)
+            d->scratch_size += d->arena_shared + XA_INFERENCE_ARENA_ALIGN;
         
-        d->persist_size  = inference_persistent_byte_size(d->inf_spec.tensor_arena_size);
+        d->persist_size  = inference_persistent_byte_size(xa_inference_arena_persist(d));
         d->persist_size += d->inf_spec.op_resolver_size;
         d->persist_size += d->inf_spec.addl_persist_size;
 
+        /* ...overlapping input frames are windowed in a ring at the end of persistent memory */
+        if (d->inf_spec.input_stride < d->inf_spec.input_size)
+            d->ring_size = xa_hop_window_size(d->inf_spec.input_size, d->inf_spec.input_stride, 1);
+        else
+            d->ring_size = 0;
+
+        /* ...batch strides of overlapping frames; non-overlapping frames are taken one per call */
+        if (d->ring_size == 0)
+            d->batch = 1;
+        else if (d->batch == 0)
+            d->batch = XA_INFERENCE_CFG_BATCH;
+
+        d->persist_size += d->ring_size;
+
         /* ...mark post-initialization is complete */
         d->state |= XA_INFERENCE_FLAG_POSTINIT_DONE;
 
@@ -246,20 +427,25 @@ static XA_ERRORCODE xa_inference_init(XAInference *d, WORD32 i_idx, pVOID pv_val
         /* ...kick run-time initialization process; make sure Micro speech inference component is setup */
         XF_CHK_ERR(d->state & XA_INFERENCE_FLAG_POSTINIT_DONE, XA_API_FATAL_INVALID_CMD_TYPE);
 
-        void *p_op_resolver = (void *) ((unsigned int) d->persistent + inference_persistent_byte_size(d->inf_spec.tensor_arena_size));
-        void *addl_persist = (void *) ((unsigned int) d->persistent 
-                                   + inference_persistent_byte_size(d->inf_spec.tensor_arena_size)
-                                   + d->inf_spec.op_resolver_size);
+        void *p_op_resolver = (UWORD8 *) d->persistent + inference_persistent_byte_size(xa_inference_arena_persist(d));
+        void *addl_persist = xa_inference_addl_persist(d);
         
         int ret = (d->inf_spec.inference_init_ops)(p_op_resolver, addl_persist);
             
         if ( ret != 0 )
             return XA_FATAL_ERROR;
     
-        ret = inference_init(d->persistent, d->inf_spec.model, d->inf_spec.tensor_arena_size, p_op_resolver);
+        ret = xa_inference_bind(d);
     
-        if ( ret != 0 )
-            return XA_FATAL_ERROR;
+        if ( ret != XA_NO_ERROR )
+            return ret;
+
+        if (d->ring_size)
+        {
+            void *ring = (UWORD8 *) addl_persist + d->inf_spec.addl_persist_size;
+
+            xa_hop_window_init(&d->hop_window, ring, d->ring_size, d->inf_spec.input_size, d->inf_spec.input_stride);
+        }
 
         /* ...enter into execution stage */
         d->state |= XA_INFERENCE_FLAG_RUNNING;
@@ -346,6 +532,40 @@ static XA_ERRORCODE xa_inference_set_config_param(XAInference *d, WORD32 i_idx,
     case XA_INFERENCE_CONFIG_PARAM_FRAME_SIZE:
         return XA_INFERENCE_CONFIG_NONFATAL_READONLY;
 
+    case XA_INFERENCE_CONFIG_PARAM_HOP_SIZE:
+        /* ...input stride may only be changed before memory is allocated */
+        XF_CHK_ERR((d->state & XA_INFERENCE_FLAG_POSTINIT_DONE) == 0, XA_INFERENCE_CONFIG_NONFATAL_STATE);
+        XF_CHK_ERR(i_value > 0 && i_value <= (UWORD32) d->inf_spec.input_size, XA_INFERENCE_CONFIG_NONFATAL_RANGE);
+        d->inf_spec.input_stride = (WORD32)i_value;
+        return XA_NO_ERROR;
+
+    case XA_INFERENCE_CONFIG_PARAM_BATCH_SIZE:
+        /* ...output budget defines buffer sizes; set it before memory is allocated */
+        XF_CHK_ERR((d->state & XA_INFERENCE_FLAG_POSTINIT_DONE) == 0, XA_INFERENCE_CONFIG_NONFATAL_STATE);
+        XF_CHK_ERR(i_value > 0 && i_value <= XA_INFERENCE_BATCH_MAX, XA_INFERENCE_CONFIG_NONFATAL_RANGE);
+        d->batch = i_value;
+        return XA_NO_ERROR;
+
+    case XA_INFERENCE_CONFIG_PARAM_GATE_THRESHOLD:
+        /* ...gating needs network-specific gate */
+        XF_CHK_ERR(d->inf_spec.inference_gate, XA_INFERENCE_CONFIG_NONFATAL_RANGE);
+        d->gate_threshold = (WORD32)i_value;
+        d->state |= XA_INFERENCE_FLAG_GATE;
+        return XA_NO_ERROR;
+
+    case XA_INFERENCE_CONFIG_PARAM_INFERENCES:
+    case XA_INFERENCE_CONFIG_PARAM_SKIPPED:
+    case XA_INFERENCE_CONFIG_PARAM_CYCLES:
+    case XA_INFERENCE_CONFIG_PARAM_CYCLES_AVG:
+        return XA_INFERENCE_CONFIG_NONFATAL_READONLY;
+
+    case XA_INFERENCE_CONFIG_PARAM_SHARED_ARENA:
+        /* ...arena split defines memory sizes; set it before memory is allocated */
+        XF_CHK_ERR((d->state & XA_INFERENCE_FLAG_POSTINIT_DONE) == 0, XA_INFERENCE_CONFIG_NONFATAL_STATE);
+        XF_CHK_ERR(i_value < (UWORD32) d->inf_spec.tensor_arena_size, XA_INFERENCE_CONFIG_NONFATAL_RANGE);
+        d->arena_shared = (i_value + XA_INFERENCE_ARENA_ALIGN - 1) & ~(XA_INFERENCE_ARENA_ALIGN - 1);
+        return XA_NO_ERROR;
+
     default:
         TRACE(ERROR, _x("Invalid parameter: %X"), i_idx);
         return XA_API_FATAL_INVALID_CMD_TYPE;
@@ -386,7 +606,47 @@ static XA_ERRORCODE xa_inference_get_config_param(XAInference *d, WORD32 i_idx,
 
     case XA_INFERENCE_CONFIG_PARAM_FRAME_SIZE:
         /* ...return Micro speech inference component buffer size */
-        *(WORD32 *)pv_value = d->inf_spec.input_size;
+        *(WORD32 *)pv_value = xa_inference_input_frame(d);
+        return XA_NO_ERROR;
+
+    case XA_INFERENCE_CONFIG_PARAM_HOP_SIZE:
+        /* ...return input stride between inferences */
+        *(WORD32 *)pv_value = d->inf_spec.input_stride;
+        return XA_NO_ERROR;
+
+    case XA_INFERENCE_CONFIG_PARAM_BATCH_SIZE:
+        /* ...return maximal number of inferences per execute call */
+        *(WORD32 *)pv_value = d->batch;
+        return XA_NO_ERROR;
+
+    case XA_INFERENCE_CONFIG_PARAM_GATE_THRESHOLD:
+        /* ...return gating threshold */
+        *(WORD32 *)pv_value = d->gate_threshold;
+        return XA_NO_ERROR;
+
+    case XA_INFERENCE_CONFIG_PARAM_INFERENCES:
+        /* ...return number of inferences run */
+        *(WORD32 *)pv_value = d->inferences;
+        return XA_NO_ERROR;
+
+    case XA_INFERENCE_CONFIG_PARAM_SKIPPED:
+        /* ...return number of frames skipped by the gate */
+        *(WORD32 *)pv_value = d->skipped;
+        return XA_NO_ERROR;
+
+    case XA_INFERENCE_CONFIG_PARAM_CYCLES:
+        /* ...return cycles spent in last inference */
+        *(WORD32 *)pv_value = d->cycles_last;
+        return XA_NO_ERROR;
+
+    case XA_INFERENCE_CONFIG_PARAM_CYCLES_AVG:
+        /* ...return average cycles per inference */
+        *(WORD32 *)pv_value = (d->inferences ? (WORD32) (d->cycles_total / d->inferences) : 0);
+        return XA_NO_ERROR;
+
+    case XA_INFERENCE_CONFIG_PARAM_SHARED_ARENA:
+        /* ...return part of tensor arena placed in shared scratch */
+        *(WORD32 *)pv_value = d->arena_shared;
         return XA_NO_ERROR;
 
     default:
@@ -572,11 +832,11 @@ static XA_ERRORCODE xa_inference_get_mem_info_size(XAInference *d, WORD32 i_idx,
     switch (i_idx)
     {
     /* ...using intput, output and scratch buffers are of the same length */
-    case 0: /* ...input buffers */
-        *(WORD32 *)pv_value = (WORD32) d->inf_spec.input_size;
+    case 0: /* ...input buffers (strides of a batch if frames overlap) */
+        *(WORD32 *)pv_value = (WORD32) xa_inference_input_frame(d);
         return XA_NO_ERROR;
-    case 1: /* ...output buffers */
-        *(WORD32 *)pv_value = (WORD32) d->inf_spec.output_size;
+    case 1: /* ...output buffers (output of a batch) */
+        *(WORD32 *)pv_value = (WORD32) (d->batch * d->inf_spec.output_size);
         return XA_NO_ERROR;
     case 2: /* ...scratch buffers */
         *(WORD32 *)pv_value = (WORD32) d->scratch_size;
@@ -667,7 +927,13 @@ static XA_ERRORCODE xa_inference_set_mem_ptr(XAInference *d, WORD32 i_idx, pVOID
         return XA_NO_ERROR;
 
     case 2:
-        /* ...scratch buffer */
+        /* ...scratch buffer; interpreter is rebuilt if shared arena moves (priority change) */
+        if ((d->state & XA_INFERENCE_FLAG_RUNNING) && d->arena_shared && d->scratch != pv_value)
+        {
+            d->scratch = pv_value;
+            return xa_inference_bind(d);
+        }
+
         d->scratch = pv_value;
         return XA_NO_ERROR;
 
@@ -40,6 +40,14 @@ enum xa_config_param_inference {
     XA_INFERENCE_CONFIG_PARAM_PCM_WIDTH         = 0x2,
     XA_INFERENCE_CONFIG_PARAM_PRODUCED          = 0x3,
     XA_INFERENCE_CONFIG_PARAM_FRAME_SIZE        = 0x4,
+    XA_INFERENCE_CONFIG_PARAM_HOP_SIZE          = 0x5,
+    XA_INFERENCE_CONFIG_PARAM_BATCH_SIZE        = 0x6,
+    XA_INFERENCE_CONFIG_PARAM_GATE_THRESHOLD    = 0x7,
+    XA_INFERENCE_CONFIG_PARAM_INFERENCES        = 0x8,
+    XA_INFERENCE_CONFIG_PARAM_SKIPPED           = 0x9,
+    XA_INFERENCE_CONFIG_PARAM_CYCLES            = 0xA,
+    XA_INFERENCE_CONFIG_PARAM_CYCLES_AVG        = 0xB,
+    XA_INFERENCE_CONFIG_PARAM_SHARED_ARENA      = 0xC,
     XA_INFERENCE_CONFIG_PARAM_COUNT,
 };
 
@@ -98,7 +106,8 @@ typedef struct xaf_tflm_inference_spec
     /* ...input consumed (stride) after each inference */
     WORD32 input_stride;
  
-    /* ...tensor arena size of inference */
+    /* ...tensor arena size of inference (part of it may be placed in scratch
+       shared with other components, see XA_INFERENCE_CONFIG_PARAM_SHARED_ARENA) */
     WORD32 tensor_arena_size;
 
     /* ...size of op resolver struct (function of num_operators in inference */
@@ -123,6 +132,12 @@ typedef struct xaf_tflm_inference_spec
        component output buffer to the wrapper */
     int (*inference_exec_postprocess)(void *, void *, int *, void *);
 
+    /* ...callback function that <TFLM-n/w>-inference-wrapper may (OPTIONAL)
+       implement to skip inference on inactive input (e.g. silence). It gets
+       newly received input data, its length, the configured threshold and
+       additional persist, and returns non-zero if the data is active */
+    int (*inference_gate)(void *, int, int, void *);
+
 } xaf_tflm_inference_spec_t;
 
 /*******************************************************************************
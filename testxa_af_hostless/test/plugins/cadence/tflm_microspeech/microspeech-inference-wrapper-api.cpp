@@ -62,6 +62,7 @@ extern clk_t inference_cycles;
 
 int  microspeech_inference_init_ops(void *op_resolver, void *addl_persist);
 int  microspeech_inference_exec_postprocess(void *output_buffer, void *output_tensor, int *out_bytes, void *addl_persist);
+int  microspeech_inference_gate(void *input, int bytes, int threshold, void *addl_persist);
    
 #ifdef __cplusplus
 }
@@ -92,6 +93,7 @@ static tflite::MicroErrorReporter microspeech_local_error_reporter;
     inference_spec.addl_scratch_size = 0; \
     inference_spec.inference_init_ops = microspeech_inference_init_ops; \
     inference_spec.inference_exec_postprocess = microspeech_inference_exec_postprocess; \
+    inference_spec.inference_gate = microspeech_inference_gate; \
 }
 
 int microspeech_inference_init_ops(void *op_resolver, void *addl_persist)
@@ -157,6 +159,22 @@ int  microspeech_inference_exec_postprocess(void *output_buffer, void *output_te
     return 0;
 }
 
+/* ...microspeech feature gate: slices are active if any band rises above threshold */
+int  microspeech_inference_gate(void *input, int bytes, int threshold, void *addl_persist)
+{
+    const int8_t *feature = (const int8_t *) input;
+
+    for (int i = 0; i < bytes; i++)
+    {
+        if (feature[i] > threshold)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
 static XA_ERRORCODE map_error_code(XA_ERRORCODE error_code)
 {
     switch (error_code)
@@ -40,6 +40,7 @@
 #include "osal-timer.h"
 #include "xf-debug.h"
 #include "audio/xa-microspeech-frontend-api.h"
+#include "xa-hop-window.h"
 
 int  microspeech_frontend_init();
 int  microspeech_frontend_process(void *pIn, void *pOut);
@@ -58,6 +59,26 @@ extern clk_t microspeech_fe_cycles;
  * Internal functions definitions
  ******************************************************************************/
 
+#define MAX_16BIT (32767)
+#define MIN_16BIT (-32768)
+
+extern short audio_input[16000];
+
+#define FRAME_SIZE_IN_BYTES_20_MS   (20*16*2)
+#define FRAME_SIZE_IN_BYTES_30_MS   (30*16*2)
+#define PRODUCED_kFeatureSliceSize  (40)
+
+/* ...feature window (30 ms) advances by one slice stride (20 ms) */
+#define WINDOW_SIZE                 FRAME_SIZE_IN_BYTES_30_MS
+#define HOP_SIZE                    FRAME_SIZE_IN_BYTES_20_MS
+
+/* ...ring spans several windows so that few of them wrap */
+#define RING_DEPTH                  4
+#define RING_SIZE                   ((RING_DEPTH * WINDOW_SIZE + HOP_SIZE - 1) / HOP_SIZE * HOP_SIZE)
+
+/* ...scratch holds a window that wraps around the ring end */
+#define SCRATCH_SIZE                WINDOW_SIZE
+
 /* ...API structure */
 typedef struct XAMicrospeechFe
 {
@@ -91,19 +112,14 @@ typedef struct XAMicrospeechFe
     /* ...number of produced bytes */
     UWORD32                 produced;
 
-}   XAMicrospeechFe;
-
+    /* ...overlapping window input adapter */
+    xa_hop_window_t         hop_window;
 
-#define MAX_16BIT (32767)
-#define MIN_16BIT (-32768)
+    /* ...adapter ring buffer */
+    UWORD8                  ring[RING_SIZE];
 
-extern short audio_input[16000];
+}   XAMicrospeechFe;
 
-#define FRAME_SIZE_IN_BYTES_20_MS   (20*16*2)
-#define FRAME_SIZE_IN_BYTES_30_MS   (30*16*2)
-#define PRODUCED_kFeatureSliceSize  (40)
-//place_holder
-#define SCRATCH_SIZE        (4)
 
 #define FS_16KHZ                    (16000)
 
@@ -137,7 +153,6 @@ static inline void xa_microspeech_fe_preinit(XAMicrospeechFe *d)
 /* ...apply gain to 16-bit PCM stream */
 static XA_ERRORCODE xa_microspeech_fe_do_execute_16bit(XAMicrospeechFe *d)
 {
-    WORD16    *pIn = (WORD16 *) d->input;
     WORD8      *pOut = (WORD8 *) d->output;
 
     /* ...check I/O buffer */
@@ -145,20 +160,23 @@ static XA_ERRORCODE xa_microspeech_fe_do_execute_16bit(XAMicrospeechFe *d)
     XF_CHK_ERR(d->output, XA_MICROSPEECH_FE_EXEC_FATAL_INPUT);
     
     /* ...Processing loop */
-    d->consumed = 0;
     d->produced = 0;
 
-    if ( d->input_avail >= FRAME_SIZE_IN_BYTES_30_MS)
+    /* ...all accepted input is consumed; window overlap is kept in the ring */
+    d->consumed = xa_hop_window_put(&d->hop_window, d->input, d->input_avail);
+
+    if (xa_hop_window_ready(&d->hop_window))
     {
-        int ret = microspeech_frontend_process( pIn, pOut );
+        const void *pIn = xa_hop_window_get(&d->hop_window, d->scratch);
+        int ret = microspeech_frontend_process( (void *) pIn, pOut );
 
         if ( ret != 0 )
         {
             return XA_FATAL_ERROR;
         }
 
-        /* ...save total number of consumed bytes */
-        d->consumed = (UWORD32)(FRAME_SIZE_IN_BYTES_20_MS);
+        /* ...advance window by one feature slice stride */
+        xa_hop_window_advance(&d->hop_window);
 
         /* ...save total number of produced bytes */
         d->produced = (UWORD32)(PRODUCED_kFeatureSliceSize);
@@ -177,7 +195,9 @@ static XA_ERRORCODE xa_microspeech_fe_do_execute_16bit(XAMicrospeechFe *d)
 /* ...runtime reset */
 static XA_ERRORCODE xa_microspeech_fe_do_runtime_init(XAMicrospeechFe *d)
 {
-    /* ...no special processing is needed here */
+    /* ...drop buffered samples */
+    xa_hop_window_reset(&d->hop_window);
+
     return XA_NO_ERROR;
 }
 
@@ -228,6 +248,10 @@ static XA_ERRORCODE xa_microspeech_fe_init(XAMicrospeechFe *d, WORD32 i_idx, pVO
         {
             return XA_FATAL_ERROR;
         }
+
+        /* ...set up overlapping window input adapter */
+        xa_hop_window_init(&d->hop_window, d->ring, RING_SIZE, WINDOW_SIZE, HOP_SIZE);
+
         /* ...mark post-initialization is complete */
         d->state |= XA_MICROSPEECH_FE_FLAG_POSTINIT_DONE;
         
@@ -363,8 +387,8 @@ static XA_ERRORCODE xa_microspeech_fe_get_config_param(XAMicrospeechFe *d, WORD3
         return XA_NO_ERROR;        
 
     case XA_MICROSPEECH_FE_CONFIG_PARAM_FRAME_SIZE:
-        /* ...return Micro speech Front end processing component buffer size */
-        *(WORD32 *)pv_value = FRAME_SIZE_IN_BYTES_30_MS;
+        /* ...return Micro speech Front end processing component buffer size (one hop) */
+        *(WORD32 *)pv_value = HOP_SIZE;
         return XA_NO_ERROR;        
 
     default:
@@ -559,8 +583,8 @@ static XA_ERRORCODE xa_microspeech_fe_get_mem_info_size(XAMicrospeechFe *d, WORD
     switch (i_idx)
     {
       /* ...using intput, output and scratch buffers are of the same length */
-      case 0: /* ...input buffers */
-        *(WORD32 *)pv_value = (WORD32) FRAME_SIZE_IN_BYTES_30_MS;
+      case 0: /* ...input buffers (one hop; window overlap is kept internally) */
+        *(WORD32 *)pv_value = (WORD32) HOP_SIZE;
         return XA_NO_ERROR;
       case 1: /* ...output buffers */
         *(WORD32 *)pv_value = (WORD32) PRODUCED_kFeatureSliceSize;
@@ -0,0 +1,880 @@
+/*
+* Copyright (c) 2015-2021 Cadence Design Systems Inc.
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/*******************************************************************************
+ * xa-sim-capturer.c
+ *
+ * Software-timed capturer for host (XA_RTOS=linux) builds
+ *
+ * Periods become available at the exact configured sample rate, paced by a
+ * monotonic one-shot timer re-armed for every period boundary. Samples are
+ * read from a file (XA_SIM_CAPTURER_IN environment variable, /dev/zero by
+ * default); periods not collected in time are dropped from the source as a
+ * real FIFO would overwrite them, so the stream position always tracks
+ * wall-clock time.
+ ******************************************************************************/
+
+#define MODULE_TAG                      CAPTURER
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "osal-timer.h"
+#include "osal-isr.h"
+#include "audio/xa-capturer-api.h"
+#include "xf-debug.h"
+
+#ifndef XA_DISABLE_EVENT
+#include "xaf-api.h"
+#endif
+
+/*******************************************************************************
+ * Codec parameters
+ ******************************************************************************/
+
+/* ...default input file; overridden by XA_SIM_CAPTURER_IN environment variable */
+#ifndef XA_SIM_CAPTURER_IN_FILE
+#define XA_SIM_CAPTURER_IN_FILE         "/dev/zero"
+#endif
+
+/* ...number of periods the emulated FIFO holds before overrun */
+#define XA_SIM_CAPTURER_PERIODS         2
+
+/* ...maximal number of channels */
+#define XA_SIM_CAPTURER_MAX_CHANNELS    8
+
+/* ...default frame size in samples per channel (8 msec at 48KHz) */
+#define FRAME_SIZE_DEFAULT              384
+
+/* ...frame size limits in samples per channel */
+#define MIN_FRAME_SIZE                  16
+#define MAX_FRAME_SIZE                  8192
+
+/*******************************************************************************
+ * Local data definition
+ ******************************************************************************/
+
+typedef struct XASimCapturer
+{
+    /***************************************************************************
+     * Internal stuff
+     **************************************************************************/
+
+    /* ...component state */
+    UWORD32                     state;
+
+    /* ...notification callback pointer */
+    xa_capturer_cb_t           *cdata;
+
+#ifndef XA_DISABLE_EVENT
+    /* ...event raising callback */
+    xa_raise_event_cb_t        *event_cb;
+#endif
+
+    /* ...output buffer pointer */
+    void                       *output;
+
+    /* ...number of bytes produced by last execution */
+    UWORD32                     produced;
+
+    /* ...total bytes produced and total bytes to be produced (0 - unlimited) */
+    UWORD64                     tot_bytes_produced;
+    UWORD64                     bytes_end;
+
+    /* ...end of source reached */
+    UWORD32                     eof;
+
+    /***************************************************************************
+     * Run-time data
+     **************************************************************************/
+
+    /* ...size of PCM sample in bytes */
+    UWORD32                     sample_size;
+
+    /* ...number of channels */
+    UWORD32                     channels;
+
+    /* ...sample width in bits */
+    UWORD32                     pcm_width;
+
+    /* ...current sampling rate */
+    UWORD32                     rate;
+
+    /* ...framesize in samples per channel (one period) */
+    UWORD32                     frame_size;
+
+    /* ...period length in bytes */
+    UWORD32                     period_bytes;
+
+    /* ...captured periods not collected yet; shared with timer, access with interrupts masked */
+    UWORD32                     avail;
+
+    /* ...overwritten periods to be skipped in the source */
+    UWORD32                     dropped;
+
+    /* ...input source */
+    FILE                       *fr;
+
+    /***************************************************************************
+     * Software clock
+     **************************************************************************/
+
+    /* ...period timer */
+    xf_timer_t                  timer;
+
+    /* ...stream start time (nsec) and number of periods elapsed since */
+    UWORD64                     t0;
+    UWORD64                     periods;
+
+    /* ...maximal lateness of period deadline (nsec) */
+    UWORD64                     jitter_max;
+
+    /* ...number of overruns; last value raised as event */
+    UWORD32                     xruns;
+    UWORD32                     xruns_reported;
+
+}   XASimCapturer;
+
+#define MAX_UWORD32 ((UWORD64)0xFFFFFFFF)
+
+/*******************************************************************************
+ * Operating flags
+ ******************************************************************************/
+
+#define XA_CAPTURER_FLAG_PREINIT_DONE   (1 << 0)
+#define XA_CAPTURER_FLAG_POSTINIT_DONE  (1 << 1)
+#define XA_CAPTURER_FLAG_IDLE           (1 << 2)
+#define XA_CAPTURER_FLAG_RUNNING        (1 << 3)
+#define XA_CAPTURER_FLAG_PAUSED         (1 << 4)
+
+/*******************************************************************************
+ * Software clock
+ ******************************************************************************/
+
+/* ...monotonic host time in nanoseconds */
+static inline UWORD64 xa_sim_time(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (UWORD64)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/* ...deadline of period "k" counted from stream start; exact, no accumulated rounding */
+static inline UWORD64 xa_sim_deadline(XASimCapturer *d, UWORD64 k)
+{
+    UWORD64 n = k * d->frame_size;
+
+    return d->t0 + (n / d->rate) * 1000000000ull + (n % d->rate) * 1000000000ull / d->rate;
+}
+
+/* ...start period clock (IDLE or PAUSED -> RUNNING); first period is due one period from now */
+static void xa_sim_capturer_clock_start(XASimCapturer *d)
+{
+    unsigned long   flags;
+
+    d->t0 = xa_sim_time();
+    d->periods = 0;
+
+    flags = __xf_disable_interrupts();
+    d->state &= ~(XA_CAPTURER_FLAG_IDLE | XA_CAPTURER_FLAG_PAUSED);
+    d->state |= XA_CAPTURER_FLAG_RUNNING;
+    __xf_restore_interrupts(flags);
+
+    __xf_timer_start(&d->timer, (unsigned long)(xa_sim_deadline(d, 1) - d->t0));
+}
+
+/*******************************************************************************
+ * xa_sim_capturer_tick
+ *
+ * Period timer expiration (timer thread). Every period whose deadline has
+ * passed becomes available; when the FIFO is full the oldest one is lost.
+ ******************************************************************************/
+
+static void xa_sim_capturer_tick(void *arg)
+{
+    XASimCapturer  *d = arg;
+    UWORD64         now = xa_sim_time();
+    UWORD64         due = xa_sim_deadline(d, d->periods + 1);
+    unsigned long   flags;
+    UWORD32         running;
+
+    /* ...lateness of the oldest deadline we are serving */
+    if (now >= due && now - due > d->jitter_max)
+        d->jitter_max = now - due;
+
+    flags = __xf_disable_interrupts();
+
+    for (running = d->state & XA_CAPTURER_FLAG_RUNNING; running && now >= due; due = xa_sim_deadline(d, d->periods + 1))
+    {
+        d->periods++;
+
+        if (d->avail < XA_SIM_CAPTURER_PERIODS)
+        {
+            d->avail++;
+        }
+        else
+        {
+            /* ...overrun; oldest period is overwritten */
+            d->dropped++;
+            d->xruns++;
+        }
+    }
+
+    __xf_restore_interrupts(flags);
+
+    /* ...re-arm for the next period boundary */
+    if (running)
+        __xf_timer_start(&d->timer, (unsigned long)(due - now));
+
+    /* ...let component collect the data */
+    d->cdata->cb(d->cdata, 0);
+}
+
+/*******************************************************************************
+ * Codec access functions
+ ******************************************************************************/
+
+static inline void xa_sim_capturer_close(XASimCapturer *d)
+{
+    /* ...already closed */
+    if (d->fr == NULL)
+        return;
+
+    __xf_timer_stop(&d->timer);
+    __xf_timer_destroy(&d->timer);
+
+    fclose(d->fr);
+    d->fr = NULL;
+}
+
+/*******************************************************************************
+ * API command hooks
+ ******************************************************************************/
+
+/* ...standard codec initialization routine */
+static XA_ERRORCODE xa_capturer_get_api_size(XASimCapturer *d, WORD32 i_idx, pVOID pv_value)
+{
+    /* ...check parameters are sane */
+    XF_CHK_ERR(pv_value, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    /* ...retrieve API structure size */
+    *(WORD32 *)pv_value = sizeof(*d);
+
+    return XA_NO_ERROR;
+}
+
+static XA_ERRORCODE xa_sim_capturer_init(XASimCapturer *d)
+{
+    const char *name = getenv("XA_SIM_CAPTURER_IN");
+
+    d->period_bytes = d->frame_size * d->channels * d->sample_size;
+    d->avail = d->dropped = 0;
+    d->tot_bytes_produced = 0;
+
+    /* ...open input source */
+    d->fr = fopen(name ? name : XA_SIM_CAPTURER_IN_FILE, "rb");
+    XF_CHK_ERR(d->fr, XA_CAPTURER_CONFIG_FATAL_HW);
+
+    /* ...one-shot timer, re-armed on every period */
+    if (__xf_timer_init(&d->timer, xa_sim_capturer_tick, d, 0))
+    {
+        fclose(d->fr);
+        d->fr = NULL;
+        return XA_CAPTURER_CONFIG_FATAL_HW;
+    }
+
+    TRACE(INIT, _b("sim capturer: %u bytes period, %u Hz"), d->period_bytes, d->rate);
+
+    return XA_NO_ERROR;
+}
+
+/* ...standard codec initialization routine */
+static XA_ERRORCODE xa_capturer_init(XASimCapturer *d, WORD32 i_idx, pVOID pv_value)
+{
+    /* ...sanity check - pointer must be valid */
+    XF_CHK_ERR(d, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    /* ...process particular initialization type */
+    switch (i_idx)
+    {
+    case XA_CMD_TYPE_INIT_API_PRE_CONFIG_PARAMS:
+    {
+        /* ...pre-configuration initialization; reset internal data */
+        memset(d, 0, sizeof(*d));
+
+        /* ...set default capturer parameters - 16-bit little-endian stereo @ 48KHz */
+        d->channels = 2;
+        d->pcm_width = 16;
+        d->rate = 48000;
+        d->sample_size = (d->pcm_width >> 3);
+        d->frame_size = FRAME_SIZE_DEFAULT;
+
+        /* ...and mark capturer has been created */
+        d->state = XA_CAPTURER_FLAG_PREINIT_DONE;
+
+        return XA_NO_ERROR;
+    }
+
+    case XA_CMD_TYPE_INIT_API_POST_CONFIG_PARAMS:
+    {
+        /* ...post-configuration initialization (all parameters are set) */
+        XF_CHK_ERR(d->state & XA_CAPTURER_FLAG_PREINIT_DONE, XA_API_FATAL_INVALID_CMD_TYPE);
+
+        XF_CHK_API(xa_sim_capturer_init(d));
+
+        /* ...mark post-initialization is complete */
+        d->state |= XA_CAPTURER_FLAG_POSTINIT_DONE;
+
+        return XA_NO_ERROR;
+    }
+
+    case XA_CMD_TYPE_INIT_PROCESS:
+    {
+        /* ...kick run-time initialization process; make sure setup is complete */
+        XF_CHK_ERR(d->state & XA_CAPTURER_FLAG_POSTINIT_DONE, XA_API_FATAL_INVALID_CMD_TYPE);
+
+        /* ...mark capturer is in idle state */
+        d->state |= XA_CAPTURER_FLAG_IDLE;
+
+        return XA_NO_ERROR;
+    }
+
+    case XA_CMD_TYPE_INIT_DONE_QUERY:
+    {
+        /* ...check if initialization is done; make sure pointer is sane */
+        XF_CHK_ERR(pv_value, XA_API_FATAL_INVALID_CMD_TYPE);
+
+        /* ...put current status */
+        *(WORD32 *)pv_value = (d->state & XA_CAPTURER_FLAG_IDLE ? 1 : 0);
+
+        return XA_NO_ERROR;
+    }
+
+    default:
+        /* ...unrecognized command type */
+        return XF_CHK_ERR(0, XA_API_FATAL_INVALID_CMD_TYPE);
+    }
+}
+
+/* ...capturer control function */
+static inline XA_ERRORCODE xa_sim_capturer_control(XASimCapturer *d, UWORD32 state)
+{
+    unsigned long   flags;
+
+    switch (state)
+    {
+    case XA_CAPTURER_STATE_START:
+        /* ...capturer must be in idle state */
+        XF_CHK_ERR(d->state & XA_CAPTURER_FLAG_IDLE, XA_CAPTURER_EXEC_NONFATAL_STATE);
+
+        /* ...start the clock; state is RUNNING afterwards */
+        xa_sim_capturer_clock_start(d);
+
+        return XA_NO_ERROR;
+
+    case XA_CAPTURER_STATE_RUN:
+        /* ...capturer must be in paused state */
+        XF_CHK_ERR(d->state & XA_CAPTURER_FLAG_PAUSED, XA_CAPTURER_EXEC_NONFATAL_STATE);
+
+        /* ...restart the clock; paused time is not captured */
+        xa_sim_capturer_clock_start(d);
+
+        return XA_NO_ERROR;
+
+    case XA_CAPTURER_STATE_PAUSE:
+        /* ...capturer must be in running state */
+        XF_CHK_ERR(d->state & XA_CAPTURER_FLAG_RUNNING, XA_CAPTURER_EXEC_NONFATAL_STATE);
+
+        /* ...mark capturer is paused and stop the clock */
+        flags = __xf_disable_interrupts();
+        d->state ^= XA_CAPTURER_FLAG_RUNNING | XA_CAPTURER_FLAG_PAUSED;
+        __xf_restore_interrupts(flags);
+        __xf_timer_stop(&d->timer);
+
+        return XA_NO_ERROR;
+
+    case XA_CAPTURER_STATE_SUSPEND:
+    case XA_CAPTURER_STATE_SUSPEND_RESUME:
+        /* ...no hardware context to save; pause/run does the work */
+        return XA_NO_ERROR;
+
+    case XA_CAPTURER_STATE_IDLE:
+        /* ...command is valid in any active state; stop capturer operation */
+        xa_sim_capturer_close(d);
+
+        /* ...reset capturer flags */
+        d->state &= ~(XA_CAPTURER_FLAG_RUNNING | XA_CAPTURER_FLAG_PAUSED);
+
+        return XA_NO_ERROR;
+
+    default:
+        /* ...unrecognized command */
+        return XF_CHK_ERR(0, XA_API_FATAL_INVALID_CMD_TYPE);
+    }
+}
+
+/* ...set capturer configuration parameter */
+static XA_ERRORCODE xa_capturer_set_config_param(XASimCapturer *d, WORD32 i_idx, pVOID pv_value)
+{
+    UWORD32     i_value;
+
+#ifndef XA_DISABLE_EVENT
+    if (d && i_idx == XAF_COMP_CONFIG_PARAM_EVENT_CB)
+    {
+        /* ...set (or reset with NULL) event raising callback */
+        d->event_cb = (xa_raise_event_cb_t *)pv_value;
+        return XA_NO_ERROR;
+    }
+#endif
+
+    /* ...sanity check - pointers must be sane */
+    XF_CHK_ERR(d && pv_value, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    /* ...pre-initialization must be completed */
+    XF_CHK_ERR(d->state & XA_CAPTURER_FLAG_PREINIT_DONE, XA_CAPTURER_CONFIG_FATAL_STATE);
+
+    /* ...only callback and state may be changed after post-init */
+    if (i_idx != XA_CAPTURER_CONFIG_PARAM_CB && i_idx != XA_CAPTURER_CONFIG_PARAM_STATE)
+    {
+        XF_CHK_ERR((d->state & XA_CAPTURER_FLAG_POSTINIT_DONE) == 0, XA_CAPTURER_CONFIG_FATAL_STATE);
+    }
+
+    /* ...process individual configuration parameter */
+    i_value = (UWORD32) *(WORD32 *)pv_value;
+
+    switch (i_idx)
+    {
+    case XA_CAPTURER_CONFIG_PARAM_PCM_WIDTH:
+        /* ...16 or 32-bit containers */
+        XF_CHK_ERR(i_value == 16 || i_value == 32, XA_CAPTURER_CONFIG_NONFATAL_RANGE);
+        d->pcm_width = i_value;
+        d->sample_size = (d->pcm_width >> 3);
+        return XA_NO_ERROR;
+
+    case XA_CAPTURER_CONFIG_PARAM_CHANNELS:
+        XF_CHK_ERR(i_value >= 1 && i_value <= XA_SIM_CAPTURER_MAX_CHANNELS, XA_CAPTURER_CONFIG_NONFATAL_RANGE);
+        d->channels = i_value;
+        return XA_NO_ERROR;
+
+    case XA_CAPTURER_CONFIG_PARAM_SAMPLE_RATE:
+        /* ...any rate; there is no clock tree to configure */
+        XF_CHK_ERR(i_value >= 8000 && i_value <= 192000, XA_CAPTURER_CONFIG_NONFATAL_RANGE);
+        d->rate = i_value;
+        return XA_NO_ERROR;
+
+    case XA_CAPTURER_CONFIG_PARAM_FRAME_SIZE:
+        /* ...deprecated; frame size per channel in bytes */
+        XF_CHK_ERR(i_value % d->sample_size == 0, XA_CAPTURER_CONFIG_NONFATAL_RANGE);
+        i_value /= d->sample_size;
+        XF_CHK_ERR(i_value >= MIN_FRAME_SIZE && i_value <= MAX_FRAME_SIZE, XA_CAPTURER_CONFIG_NONFATAL_RANGE);
+        d->frame_size = i_value;
+        return XA_NO_ERROR;
+
+    case XA_CAPTURER_CONFIG_PARAM_FRAME_SIZE_IN_SAMPLES:
+        XF_CHK_ERR(i_value >= MIN_FRAME_SIZE && i_value <= MAX_FRAME_SIZE, XA_CAPTURER_CONFIG_NONFATAL_RANGE);
+        d->frame_size = i_value;
+        TRACE(INIT, _b("frame_size:%d"), d->frame_size);
+        return XA_NO_ERROR;
+
+    case XA_CAPTURER_CONFIG_PARAM_SAMPLE_END:
+        /* ...number of samples per channel to capture; 0 - until end of source */
+        d->bytes_end = (UWORD64)i_value * d->sample_size * d->channels;
+        TRACE(INIT, _b("bytes requested:%llu"), (unsigned long long)d->bytes_end);
+        return XA_NO_ERROR;
+
+    case XA_CAPTURER_CONFIG_PARAM_CB:
+        /* ...set opaque callback data function */
+        d->cdata = (xa_capturer_cb_t *)pv_value;
+        return XA_NO_ERROR;
+
+    case XA_CAPTURER_CONFIG_PARAM_STATE:
+        /* ...runtime state control parameter valid only in execution state */
+        XF_CHK_ERR(d->state & XA_CAPTURER_FLAG_POSTINIT_DONE, XA_CAPTURER_CONFIG_FATAL_STATE);
+        return xa_sim_capturer_control(d, i_value);
+
+    default:
+        /* ...unrecognized parameter */
+        return XF_CHK_ERR(0, XA_API_FATAL_INVALID_CMD_TYPE);
+    }
+}
+
+/* ...state retrieval function */
+static inline UWORD32 xa_sim_capturer_get_state(XASimCapturer *d)
+{
+    if (d->state & XA_CAPTURER_FLAG_RUNNING)
+        return XA_CAPTURER_STATE_RUN;
+    else if (d->state & XA_CAPTURER_FLAG_PAUSED)
+        return XA_CAPTURER_STATE_PAUSE;
+    else
+        return XA_CAPTURER_STATE_IDLE;
+}
+
+/* ...retrieve configuration parameter */
+static XA_ERRORCODE xa_capturer_get_config_param(XASimCapturer *d, WORD32 i_idx, pVOID pv_value)
+{
+    /* ...sanity check - capturer must be initialized */
+    XF_CHK_ERR(d && pv_value, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    /* ...make sure pre-initialization is completed */
+    XF_CHK_ERR(d->state & XA_CAPTURER_FLAG_PREINIT_DONE, XA_CAPTURER_CONFIG_FATAL_STATE);
+
+    /* ...process individual configuration parameter */
+    switch (i_idx)
+    {
+    case XA_CAPTURER_CONFIG_PARAM_PCM_WIDTH:
+        *(WORD32 *)pv_value = d->pcm_width;
+        return XA_NO_ERROR;
+
+    case XA_CAPTURER_CONFIG_PARAM_CHANNELS:
+        *(WORD32 *)pv_value = d->channels;
+        return XA_NO_ERROR;
+
+    case XA_CAPTURER_CONFIG_PARAM_SAMPLE_RATE:
+        *(WORD32 *)pv_value = d->rate;
+        return XA_NO_ERROR;
+
+    case XA_CAPTURER_CONFIG_PARAM_FRAME_SIZE: /* ...deprecated */
+        *(WORD32 *)pv_value = d->frame_size * d->sample_size;
+        return XA_NO_ERROR;
+
+    case XA_CAPTURER_CONFIG_PARAM_FRAME_SIZE_IN_SAMPLES:
+        *(WORD32 *)pv_value = d->frame_size;
+        return XA_NO_ERROR;
+
+    case XA_CAPTURER_CONFIG_PARAM_STATE:
+        *(WORD32 *)pv_value = xa_sim_capturer_get_state(d);
+        return XA_NO_ERROR;
+
+    case XA_CAPTURER_CONFIG_PARAM_BYTES_PRODUCED:
+        *(UWORD32 *)pv_value = (UWORD32)(d->tot_bytes_produced > MAX_UWORD32 ? MAX_UWORD32 : d->tot_bytes_produced);
+        return XA_NO_ERROR;
+
+    case XA_CAPTURER_CONFIG_PARAM_XRUN_COUNT:
+        /* ...return number of overruns (also event payload) */
+        *(WORD32 *)pv_value = d->xruns;
+        return XA_NO_ERROR;
+
+    case XA_CAPTURER_CONFIG_PARAM_TIMER_JITTER:
+        /* ...worst period deadline lateness in microseconds */
+        *(WORD32 *)pv_value = (WORD32)(d->jitter_max / 1000);
+        return XA_NO_ERROR;
+
+    default:
+        /* ...unrecognized parameter */
+        return XF_CHK_ERR(0, XA_API_FATAL_INVALID_CMD_TYPE);
+    }
+}
+
+static XA_ERRORCODE xa_capturer_do_exec(XASimCapturer *d)
+{
+    unsigned long   flags;
+    UWORD32         avail;
+    UWORD32         dropped;
+    UWORD32         n;
+
+    d->produced = 0;
+
+#ifndef XA_DISABLE_EVENT
+    /* ...report overruns counted by the clock; events can't be raised from there */
+    if (d->xruns != d->xruns_reported && d->event_cb)
+    {
+        d->xruns_reported = d->xruns;
+        d->event_cb->cb(d->event_cb, XA_CAPTURER_CONFIG_PARAM_XRUN_COUNT);
+    }
+#endif
+
+    flags = __xf_disable_interrupts();
+    if ((avail = d->avail) != 0)
+        d->avail--;
+    dropped = d->dropped, d->dropped = 0;
+    __xf_restore_interrupts(flags);
+
+    /* ...nothing captured yet */
+    if (avail == 0 || d->eof)
+        return XA_NO_ERROR;
+
+    /* ...no output buffer; the period is lost like an overwritten one */
+    if (d->output == NULL)
+    {
+        dropped++;
+    }
+
+    /* ...skip overwritten periods so the source position follows the clock */
+    while (dropped--)
+    {
+        if (d->output == NULL)
+        {
+            TRACE(OUTPUT, _b("output buffer is NULL, dropped %u bytes"), d->period_bytes);
+
+            if (fseek(d->fr, d->period_bytes, SEEK_CUR) == 0)
+                continue;
+        }
+        else if (fread(d->output, 1, d->period_bytes, d->fr) == d->period_bytes)
+        {
+            continue;
+        }
+
+        d->eof = 1;
+        return XA_NO_ERROR;
+    }
+
+    if (d->output == NULL)
+        return XA_CAPTURER_EXEC_NONFATAL_NO_DATA;
+
+    /* ...read one period; short read ends the stream */
+    n = (UWORD32)fread(d->output, 1, d->period_bytes, d->fr);
+    if (n < d->period_bytes)
+        d->eof = 1;
+
+    /* ...clip to requested amount of samples */
+    if (d->bytes_end && d->tot_bytes_produced + n >= d->bytes_end)
+    {
+        n = (UWORD32)(d->bytes_end - d->tot_bytes_produced);
+        d->eof = 1;
+    }
+
+    d->produced = n;
+    d->tot_bytes_produced += n;
+
+    return XA_NO_ERROR;
+}
+
+/* ...execution command */
+static XA_ERRORCODE xa_capturer_execute(XASimCapturer *d, WORD32 i_idx, pVOID pv_value)
+{
+    /* ...sanity check - pointer must be valid */
+    XF_CHK_ERR(d, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    /* ...capturer must be in running state */
+    XF_CHK_ERR(d->state & (XA_CAPTURER_FLAG_RUNNING | XA_CAPTURER_FLAG_IDLE), XA_CAPTURER_EXEC_FATAL_STATE);
+
+    /* ...process individual command type */
+    switch (i_idx)
+    {
+    case XA_CMD_TYPE_DO_EXECUTE:
+        return xa_capturer_do_exec(d);
+
+    case XA_CMD_TYPE_DONE_QUERY:
+        XF_CHK_ERR(pv_value, XA_API_FATAL_INVALID_CMD_TYPE);
+
+        /* ...stream is over once the source is exhausted and the last period is passed on */
+        if (d->eof && d->produced == 0)
+        {
+            __xf_timer_stop(&d->timer);
+            *(WORD32 *)pv_value = 1;
+        }
+        else
+        {
+            *(WORD32 *)pv_value = 0;
+        }
+
+        return XA_NO_ERROR;
+
+    case XA_CMD_TYPE_DO_RUNTIME_INIT:
+        /* ...silently ignore */
+        return XA_NO_ERROR;
+
+    default:
+        /* ...unrecognized command */
+        return XF_CHK_ERR(0, XA_API_FATAL_INVALID_CMD_TYPE);
+    }
+}
+
+/* ...get number of produced bytes */
+static XA_ERRORCODE xa_capturer_get_output_bytes(XASimCapturer *d, WORD32 i_idx, pVOID pv_value)
+{
+    /* ...sanity check - check parameters */
+    XF_CHK_ERR(d && pv_value, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    /* ...output buffer index must be valid */
+    XF_CHK_ERR(i_idx == 0, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    /* ...capturer must be in post-init state */
+    XF_CHK_ERR(d->state & XA_CAPTURER_FLAG_POSTINIT_DONE, XA_CAPTURER_EXEC_FATAL_STATE);
+
+    /* ...return number of bytes produced */
+    *(WORD32 *)pv_value = d->produced;
+
+    d->produced = 0;
+
+    return XA_NO_ERROR;
+}
+
+/*******************************************************************************
+ * Memory information API
+ ******************************************************************************/
+
+/* ..get total amount of data for memory tables */
+static XA_ERRORCODE xa_capturer_get_memtabs_size(XASimCapturer *d, WORD32 i_idx, pVOID pv_value)
+{
+    /* ...basic sanity checks */
+    XF_CHK_ERR(d && pv_value, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    /* ...check capturer is pre-initialized */
+    XF_CHK_ERR(d->state & XA_CAPTURER_FLAG_PREINIT_DONE, XA_CAPTURER_CONFIG_FATAL_STATE);
+
+    /* ...we have all our tables inside API structure */
+    *(WORD32 *)pv_value = 0;
+
+    return XA_NO_ERROR;
+}
+
+/* ..set memory tables pointer */
+static XA_ERRORCODE xa_capturer_set_memtabs_ptr(XASimCapturer *d, WORD32 i_idx, pVOID pv_value)
+{
+    /* ...basic sanity checks */
+    XF_CHK_ERR(d && pv_value, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    /* ...check capturer is pre-initialized */
+    XF_CHK_ERR(d->state & XA_CAPTURER_FLAG_PREINIT_DONE, XA_CAPTURER_CONFIG_FATAL_STATE);
+
+    return XA_NO_ERROR;
+}
+
+/* ...return total amount of memory buffers */
+static XA_ERRORCODE xa_capturer_get_n_memtabs(XASimCapturer *d, WORD32 i_idx, pVOID pv_value)
+{
+    /* ...basic sanity checks */
+    XF_CHK_ERR(d && pv_value, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    /* ...we have 1 output buffer only */
+    *(WORD32 *)pv_value = 1;
+
+    return XA_NO_ERROR;
+}
+
+/* ...return memory buffer data */
+static XA_ERRORCODE xa_capturer_get_mem_info_size(XASimCapturer *d, WORD32 i_idx, pVOID pv_value)
+{
+    /* ...basic sanity check */
+    XF_CHK_ERR(d && pv_value, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    /* ...command valid only after post-initialization step */
+    XF_CHK_ERR(d->state & XA_CAPTURER_FLAG_POSTINIT_DONE, XA_CAPTURER_CONFIG_FATAL_STATE);
+
+    /* ...output buffer specification; exact audio frame */
+    XF_CHK_ERR(i_idx == 0, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    *(WORD32 *)pv_value = (WORD32)d->period_bytes;
+
+    return XA_NO_ERROR;
+}
+
+/* ...return memory alignment data */
+static XA_ERRORCODE xa_capturer_get_mem_info_alignment(XASimCapturer *d, WORD32 i_idx, pVOID pv_value)
+{
+    /* ...basic sanity check */
+    XF_CHK_ERR(d && pv_value, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    /* ...command valid only after post-initialization step */
+    XF_CHK_ERR(d->state & XA_CAPTURER_FLAG_POSTINIT_DONE, XA_CAPTURER_CONFIG_FATAL_STATE);
+
+    /* ...all buffers are at least 4-bytes aligned */
+    *(WORD32 *)pv_value = 4;
+
+    return XA_NO_ERROR;
+}
+
+/* ...return memory type data */
+static XA_ERRORCODE xa_capturer_get_mem_info_type(XASimCapturer *d, WORD32 i_idx, pVOID pv_value)
+{
+    /* ...basic sanity check */
+    XF_CHK_ERR(d && pv_value, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    /* ...command valid only after post-initialization step */
+    XF_CHK_ERR(d->state & XA_CAPTURER_FLAG_POSTINIT_DONE, XA_CAPTURER_CONFIG_FATAL_STATE);
+
+    /* ...output buffer only */
+    XF_CHK_ERR(i_idx == 0, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    *(WORD32 *)pv_value = XA_MEMTYPE_OUTPUT;
+
+    return XA_NO_ERROR;
+}
+
+/* ...set memory pointer */
+static XA_ERRORCODE xa_capturer_set_mem_ptr(XASimCapturer *d, WORD32 i_idx, pVOID pv_value)
+{
+    /* ...basic sanity check */
+    XF_CHK_ERR(d, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    /* ...codec must be initialized */
+    XF_CHK_ERR(d->state & XA_CAPTURER_FLAG_POSTINIT_DONE, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    TRACE(INIT, _b("xa_capturer_set_mem_ptr[%u]: %p"), i_idx, pv_value);
+
+    /* ...output buffer; may be NULL if no buffer is available */
+    XF_CHK_ERR(i_idx == 0, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    d->output = pv_value;
+
+    return XA_NO_ERROR;
+}
+
+/*******************************************************************************
+ * API command hooks
+ ******************************************************************************/
+
+static XA_ERRORCODE (* const xa_sim_capturer_api[])(XASimCapturer *, WORD32, pVOID) =
+{
+    [XA_API_CMD_GET_API_SIZE]           = xa_capturer_get_api_size,
+    [XA_API_CMD_INIT]                   = xa_capturer_init,
+    [XA_API_CMD_SET_CONFIG_PARAM]       = xa_capturer_set_config_param,
+    [XA_API_CMD_GET_CONFIG_PARAM]       = xa_capturer_get_config_param,
+    [XA_API_CMD_EXECUTE]                = xa_capturer_execute,
+    [XA_API_CMD_GET_OUTPUT_BYTES]       = xa_capturer_get_output_bytes,
+    [XA_API_CMD_GET_MEMTABS_SIZE]       = xa_capturer_get_memtabs_size,
+    [XA_API_CMD_SET_MEMTABS_PTR]        = xa_capturer_set_memtabs_ptr,
+    [XA_API_CMD_GET_N_MEMTABS]          = xa_capturer_get_n_memtabs,
+    [XA_API_CMD_GET_MEM_INFO_SIZE]      = xa_capturer_get_mem_info_size,
+    [XA_API_CMD_GET_MEM_INFO_ALIGNMENT] = xa_capturer_get_mem_info_alignment,
+    [XA_API_CMD_GET_MEM_INFO_TYPE]      = xa_capturer_get_mem_info_type,
+    [XA_API_CMD_SET_MEM_PTR]            = xa_capturer_set_mem_ptr,
+};
+
+/* ...total numer of commands supported */
+#define XA_SIM_CAPTURER_API_COMMANDS_NUM   (sizeof(xa_sim_capturer_api) / sizeof(xa_sim_capturer_api[0]))
+
+/*******************************************************************************
+ * API entry point
+ ******************************************************************************/
+
+XA_ERRORCODE xa_sim_capturer(xa_codec_handle_t p_xa_module_obj, WORD32 i_cmd, WORD32 i_idx, pVOID pv_value)
+{
+    XASimCapturer *capturer = (XASimCapturer *) p_xa_module_obj;
+
+    /* ...check if command index is sane */
+    XF_CHK_ERR(i_cmd < XA_SIM_CAPTURER_API_COMMANDS_NUM, XA_API_FATAL_INVALID_CMD);
+
+    /* ...see if command is defined */
+    XF_CHK_ERR(xa_sim_capturer_api[i_cmd], XA_API_FATAL_INVALID_CMD);
+
+    /* ...execute requested command */
+    return xa_sim_capturer_api[i_cmd](capturer, i_idx, pv_value);
+}
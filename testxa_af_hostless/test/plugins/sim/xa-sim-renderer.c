@@ -0,0 +1,1061 @@
+/*
+* Copyright (c) 2015-2021 Cadence Design Systems Inc.
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/*******************************************************************************
+ * xa-sim-renderer.c
+ *
+ * Software-timed renderer for host (XA_RTOS=linux) builds
+ *
+ * The ring of periods is drained at the exact configured sample rate by a
+ * monotonic one-shot timer that is re-armed for every period boundary, so
+ * timer rounding never accumulates. Played periods are written to a file
+ * (XA_SIM_RENDERER_OUT environment variable, /dev/null by default), which
+ * makes underruns and scheduling jitter of a complete graph observable on a
+ * Linux box without the audio hardware.
+ ******************************************************************************/
+
+#define MODULE_TAG                      RENDERER
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "osal-timer.h"
+#include "osal-isr.h"
+#include "audio/xa-renderer-api.h"
+#include "xf-debug.h"
+
+#ifndef XA_DISABLE_EVENT
+#include "xaf-api.h"
+#endif
+
+/*******************************************************************************
+ * Codec parameters
+ ******************************************************************************/
+
+/* ...default output file; overridden by XA_SIM_RENDERER_OUT environment variable */
+#ifndef XA_SIM_RENDERER_OUT_FILE
+#define XA_SIM_RENDERER_OUT_FILE        "/dev/null"
+#endif
+
+/* ...maximal number of periods in the ring */
+#define XA_SIM_RENDERER_MAX_PERIODS     16
+
+/* ...maximal number of channels */
+#define XA_SIM_RENDERER_MAX_CHANNELS    8
+
+/* ...default frame size in samples per channel (10 msec at 48KHz) */
+#define FRAME_SIZE_DEFAULT              480
+
+/* ...frame size limits in samples per channel */
+#define MIN_FRAME_SIZE                  16
+#define MAX_FRAME_SIZE                  8192
+
+/*******************************************************************************
+ * Local data definition
+ ******************************************************************************/
+
+typedef struct XASimRenderer
+{
+    /***************************************************************************
+     * Internal stuff
+     **************************************************************************/
+
+    /* ...component state */
+    UWORD32                     state;
+
+    /* ...notification callback pointer */
+    xa_renderer_cb_t           *cdata;
+
+#ifndef XA_DISABLE_EVENT
+    /* ...event raising callback */
+    xa_raise_event_cb_t        *event_cb;
+#endif
+
+    /* ...input buffer pointer */
+    void                       *input;
+
+    /* ...optional output buffer pointer (copy of submitted frame) */
+    void                       *output;
+
+    /* ...number of bytes submitted to/consumed by last execution */
+    UWORD32                     submited_inbytes;
+    UWORD32                     consumed;
+
+    /* ...output bytes produced */
+    UWORD32                     bytes_produced;
+
+    /* ...cumulative bytes accepted into the ring */
+    UWORD64                     cumulative_bytes_produced;
+
+    /* ...input over / execution complete flags */
+    UWORD32                     input_over;
+    UWORD32                     exec_done;
+
+    /***************************************************************************
+     * Run-time data
+     **************************************************************************/
+
+    /* ...size of PCM sample in bytes */
+    UWORD32                     sample_size;
+
+    /* ...number of channels */
+    UWORD32                     channels;
+
+    /* ...sample width */
+    UWORD32                     pcm_width;
+
+    /* ...current sampling rate */
+    UWORD32                     rate;
+
+    /* ...framesize in samples per channel (one ring period) */
+    UWORD32                     frame_size;
+
+    /* ...requested ring latency in microseconds (0 - two periods) */
+    UWORD32                     latency_us;
+
+    /* ...underrun handling mode */
+    UWORD32                     underrun_mode;
+
+    /***************************************************************************
+     * Ring of periods
+     **************************************************************************/
+
+    /* ...ring storage, silence period, period length and number of periods */
+    UWORD8                     *ring;
+    UWORD8                     *silence;
+    UWORD32                     period_bytes;
+    UWORD32                     period_count;
+    UWORD32                     ring_bytes;
+
+    /* ...read (timer) and write (submit) offsets */
+    UWORD32                     rd;
+    UWORD32                     wr;
+
+    /* ...amount of queued data; shared with timer, access with interrupts masked */
+    UWORD32                     level;
+
+    /* ...output sink */
+    FILE                       *fw;
+
+    /***************************************************************************
+     * Software clock
+     **************************************************************************/
+
+    /* ...period timer */
+    xf_timer_t                  timer;
+
+    /* ...stream start time (nsec) and number of periods elapsed since */
+    UWORD64                     t0;
+    UWORD64                     periods;
+
+    /* ...maximal lateness of period deadline (nsec) */
+    UWORD64                     jitter_max;
+
+    /* ...number of underruns; last value raised as event */
+    UWORD32                     xruns;
+    UWORD32                     xruns_reported;
+
+}   XASimRenderer;
+
+#define MAX_UWORD32 ((UWORD64)0xFFFFFFFF)
+
+/*******************************************************************************
+ * Operating flags
+ ******************************************************************************/
+
+#define XA_RENDERER_FLAG_PREINIT_DONE   (1 << 0)
+#define XA_RENDERER_FLAG_POSTINIT_DONE  (1 << 1)
+#define XA_RENDERER_FLAG_IDLE           (1 << 2)
+#define XA_RENDERER_FLAG_RUNNING        (1 << 3)
+#define XA_RENDERER_FLAG_PAUSED         (1 << 4)
+
+/*******************************************************************************
+ * Software clock
+ ******************************************************************************/
+
+/* ...monotonic host time in nanoseconds */
+static inline UWORD64 xa_sim_time(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (UWORD64)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/* ...deadline of period "k" counted from stream start; exact, no accumulated rounding */
+static inline UWORD64 xa_sim_deadline(XASimRenderer *d, UWORD64 k)
+{
+    UWORD64 n = k * d->frame_size;
+
+    return d->t0 + (n / d->rate) * 1000000000ull + (n % d->rate) * 1000000000ull / d->rate;
+}
+
+/* ...start period clock (IDLE or PAUSED -> RUNNING); first period is due one period from now */
+static void xa_sim_renderer_clock_start(XASimRenderer *d)
+{
+    unsigned long   flags;
+
+    d->t0 = xa_sim_time();
+    d->periods = 0;
+
+    flags = __xf_disable_interrupts();
+    d->state &= ~(XA_RENDERER_FLAG_IDLE | XA_RENDERER_FLAG_PAUSED);
+    d->state |= XA_RENDERER_FLAG_RUNNING;
+    __xf_restore_interrupts(flags);
+
+    __xf_timer_start(&d->timer, (unsigned long)(xa_sim_deadline(d, 1) - d->t0));
+}
+
+/*******************************************************************************
+ * xa_sim_renderer_tick
+ *
+ * Period timer expiration (timer thread). Play every period whose deadline
+ * has passed; missing data is an underrun handled per configured mode.
+ ******************************************************************************/
+
+static void xa_sim_renderer_tick(void *arg)
+{
+    XASimRenderer  *d = arg;
+    UWORD64         now = xa_sim_time();
+    UWORD64         due = xa_sim_deadline(d, d->periods + 1);
+    unsigned long   flags;
+    UWORD32         level;
+    UWORD32         running;
+
+    /* ...lateness of the oldest deadline we are serving */
+    if (now >= due && now - due > d->jitter_max)
+        d->jitter_max = now - due;
+
+    for (running = 1; now >= due; due = xa_sim_deadline(d, d->periods + 1))
+    {
+        flags = __xf_disable_interrupts();
+        level = d->level;
+        running = d->state & XA_RENDERER_FLAG_RUNNING;
+        __xf_restore_interrupts(flags);
+
+        /* ...clock has been paused or stopped meanwhile */
+        if (!running)
+            break;
+
+        d->periods++;
+
+        if (level >= d->period_bytes)
+        {
+            /* ...period at read position is owned by the clock until level drops */
+            fwrite(d->ring + d->rd, 1, d->period_bytes, d->fw);
+
+            if ((d->rd += d->period_bytes) == d->ring_bytes)
+                d->rd = 0;
+
+            flags = __xf_disable_interrupts();
+            d->level -= d->period_bytes;
+            __xf_restore_interrupts(flags);
+        }
+        else if (d->input_over)
+        {
+            /* ...stream is over and fully played; not an underrun */
+            running = 0;
+            break;
+        }
+        else if (d->underrun_mode == XA_RENDERER_UNDERRUN_STOP)
+        {
+            /* ...stop the clock; restart after ring is primed again */
+            d->xruns++;
+            flags = __xf_disable_interrupts();
+            d->state ^= XA_RENDERER_FLAG_RUNNING | XA_RENDERER_FLAG_IDLE;
+            __xf_restore_interrupts(flags);
+            running = 0;
+
+            TRACE(OUTPUT, _b("underrun: clock stopped at period %llu"), (unsigned long long)d->periods);
+            break;
+        }
+        else
+        {
+            /* ...keep the clock going and play silence (repeat is not emulated) */
+            d->xruns++;
+            fwrite(d->silence, 1, d->period_bytes, d->fw);
+        }
+    }
+
+    /* ...re-arm for the next period boundary */
+    if (running)
+        __xf_timer_start(&d->timer, (unsigned long)(due - now));
+
+    /* ...let component refill the ring */
+    d->cdata->cb(d->cdata, 0);
+}
+
+/*******************************************************************************
+ * Codec access functions
+ ******************************************************************************/
+
+static inline void xa_sim_renderer_close(XASimRenderer *d)
+{
+    /* ...already closed */
+    if (d->ring == NULL)
+        return;
+
+    __xf_timer_stop(&d->timer);
+    __xf_timer_destroy(&d->timer);
+
+    if (d->fw)
+    {
+        fclose(d->fw);
+        d->fw = NULL;
+    }
+
+    free(d->ring);
+    d->ring = NULL;
+}
+
+/* ...submit one frame (in bytes) into the ring; return amount of consumed bytes */
+static UWORD32 xa_sim_renderer_submit(XASimRenderer *d, void *b, UWORD32 bytes_write)
+{
+    UWORD32         payload = d->period_bytes;
+    UWORD32         k;
+    unsigned long   flags;
+    UWORD32         level;
+    UWORD32         idle;
+
+    /* ...reset optional output-bytes produced */
+    d->bytes_produced = 0;
+
+    flags = __xf_disable_interrupts();
+    level = d->level;
+    idle = d->state & XA_RENDERER_FLAG_IDLE;
+    __xf_restore_interrupts(flags);
+
+    if (d->input_over && bytes_write == 0)
+    {
+        /* ...nothing more to queue; start clock for a short stream still in the ring */
+        if (idle && level)
+            xa_sim_renderer_clock_start(d);
+
+        /* ...execution is over when the ring is drained */
+        if (level == 0)
+        {
+            d->exec_done = 1;
+            __xf_timer_stop(&d->timer);
+
+            TRACE(OUTPUT, _b("exec done, timer stopped"));
+        }
+
+        return 0;
+    }
+
+    /* ...no free period in the ring */
+    if (d->ring_bytes - level < payload)
+        return 0;
+
+    /* ...write one period; zero-fill the partial tail */
+    k = (payload > bytes_write ? bytes_write : payload);
+    memcpy(d->ring + d->wr, b, k);
+    if (k < payload)
+        memset(d->ring + d->wr + k, 0, payload - k);
+
+    if (d->output)
+    {
+        /* ...write to optional output buffer */
+        memcpy(d->output, d->ring + d->wr, payload);
+        d->bytes_produced = payload;
+    }
+
+    if ((d->wr += payload) == d->ring_bytes)
+        d->wr = 0;
+
+    flags = __xf_disable_interrupts();
+    level = (d->level += payload);
+    __xf_restore_interrupts(flags);
+
+    /* ...start the clock once the ring is primed */
+    if (idle && level == d->ring_bytes)
+    {
+        xa_sim_renderer_clock_start(d);
+
+        TRACE(OUTPUT, _b("ring primed, clock started: IDLE->RUNNING"));
+    }
+
+    return k;
+}
+
+/*******************************************************************************
+ * API command hooks
+ ******************************************************************************/
+
+/* ...standard codec initialization routine */
+static XA_ERRORCODE xa_renderer_get_api_size(XASimRenderer *d, WORD32 i_idx, pVOID pv_value)
+{
+    /* ...check parameters are sane */
+    XF_CHK_ERR(pv_value, XA_API_FATAL_INVALID_CMD_TYPE);
+    /* ...retrieve API structure size */
+    *(WORD32 *)pv_value = sizeof(*d);
+    return XA_NO_ERROR;
+}
+
+static XA_ERRORCODE xa_sim_renderer_init(XASimRenderer *d)
+{
+    const char *name = getenv("XA_SIM_RENDERER_OUT");
+    UWORD64     samples;
+
+    /* ...ring holds the requested latency rounded up to periods, at least two */
+    samples = (UWORD64)d->latency_us * d->rate / 1000000;
+    d->period_bytes = d->frame_size * d->channels * d->sample_size;
+    d->period_count = (UWORD32)((samples + d->frame_size - 1) / d->frame_size);
+    if (d->period_count < 2)
+        d->period_count = 2;
+    XF_CHK_ERR(d->period_count <= XA_SIM_RENDERER_MAX_PERIODS, XA_RENDERER_CONFIG_FATAL_RANGE);
+    d->ring_bytes = d->period_bytes * d->period_count;
+
+    /* ...one extra zeroed period past the ring end is played on underrun */
+    d->rd = d->wr = d->level = 0;
+    d->ring = calloc(1, d->ring_bytes + d->period_bytes);
+    XF_CHK_ERR(d->ring, XA_RENDERER_CONFIG_FATAL_HW);
+    d->silence = d->ring + d->ring_bytes;
+
+    /* ...open output sink */
+    d->fw = fopen(name ? name : XA_SIM_RENDERER_OUT_FILE, "wb");
+    if (d->fw == NULL)
+    {
+        free(d->ring);
+        d->ring = NULL;
+        return XA_RENDERER_CONFIG_FATAL_HW;
+    }
+
+    /* ...one-shot timer, re-armed on every period */
+    if (__xf_timer_init(&d->timer, xa_sim_renderer_tick, d, 0))
+    {
+        fclose(d->fw);
+        free(d->ring);
+        d->fw = NULL;
+        d->ring = NULL;
+        return XA_RENDERER_CONFIG_FATAL_HW;
+    }
+
+    TRACE(INIT, _b("sim renderer: %u x %u bytes ring, %u Hz"), d->period_count, d->period_bytes, d->rate);
+
+    return XA_NO_ERROR;
+}
+
+/* ...standard codec initialization routine */
+static XA_ERRORCODE xa_renderer_init(XASimRenderer *d, WORD32 i_idx, pVOID pv_value)
+{
+    /* ...sanity check - pointer must be valid */
+    XF_CHK_ERR(d, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    /* ...process particular initialization type */
+    switch (i_idx)
+    {
+    case XA_CMD_TYPE_INIT_API_PRE_CONFIG_PARAMS:
+    {
+        /* ...pre-configuration initialization; reset internal data */
+        memset(d, 0, sizeof(*d));
+        /* ...set default renderer parameters - 16-bit little-endian stereo @ 48KHz */
+        d->channels = 2;
+        d->pcm_width = 16;
+        d->rate = 48000;
+        d->sample_size = (d->pcm_width >> 3);
+        d->frame_size = FRAME_SIZE_DEFAULT;
+
+        /* ...and mark renderer has been created */
+        d->state = XA_RENDERER_FLAG_PREINIT_DONE;
+        return XA_NO_ERROR;
+    }
+    case XA_CMD_TYPE_INIT_API_POST_CONFIG_PARAMS:
+    {
+        /* ...post-configuration initialization (all parameters are set) */
+        XF_CHK_ERR(d->state & XA_RENDERER_FLAG_PREINIT_DONE, XA_API_FATAL_INVALID_CMD_TYPE);
+
+        XF_CHK_API(xa_sim_renderer_init(d));
+
+        /* ...mark post-initialization is complete */
+        d->state |= XA_RENDERER_FLAG_POSTINIT_DONE;
+        return XA_NO_ERROR;
+    }
+
+    case XA_CMD_TYPE_INIT_PROCESS:
+    {
+        /* ...kick run-time initialization process; make sure setup is complete */
+        XF_CHK_ERR(d->state & XA_RENDERER_FLAG_POSTINIT_DONE, XA_API_FATAL_INVALID_CMD_TYPE);
+        /* ...mark renderer is in idle state */
+        d->state |= XA_RENDERER_FLAG_IDLE;
+        return XA_NO_ERROR;
+    }
+
+    case XA_CMD_TYPE_INIT_DONE_QUERY:
+    {
+        /* ...check if initialization is done; make sure pointer is sane */
+        XF_CHK_ERR(pv_value, XA_API_FATAL_INVALID_CMD_TYPE);
+        /* ...put current status */
+        *(WORD32 *)pv_value = (d->state & XA_RENDERER_FLAG_IDLE ? 1 : 0);
+        return XA_NO_ERROR;
+    }
+
+    default:
+        /* ...unrecognized command type */
+        return XF_CHK_ERR(0, XA_API_FATAL_INVALID_CMD_TYPE);
+    }
+}
+
+/* ...renderer control function */
+static inline XA_ERRORCODE xa_sim_renderer_control(XASimRenderer *d, UWORD32 state)
+{
+    unsigned long   flags;
+
+    switch (state)
+    {
+    case XA_RENDERER_STATE_START:
+        /* ...start-up on trigger from application with whatever is queued */
+        if (d->state & XA_RENDERER_FLAG_IDLE)
+        {
+            xa_sim_renderer_clock_start(d);
+
+            TRACE(INIT, _b("clock started, state:IDLE to RUNNING, level:%u"), d->level);
+        }
+        return XA_NO_ERROR;
+
+    case XA_RENDERER_STATE_RUN:
+        /* ...renderer must be in paused state */
+        XF_CHK_ERR(d->state & XA_RENDERER_FLAG_PAUSED, XA_RENDERER_EXEC_NONFATAL_STATE);
+        /* ...restart the clock; paused time is not counted */
+        xa_sim_renderer_clock_start(d);
+        return XA_NO_ERROR;
+
+    case XA_RENDERER_STATE_PAUSE:
+        /* ...renderer must be in running state */
+        XF_CHK_ERR(d->state & XA_RENDERER_FLAG_RUNNING, XA_RENDERER_EXEC_NONFATAL_STATE);
+        /* ...mark renderer is paused and stop the clock */
+        flags = __xf_disable_interrupts();
+        d->state ^= XA_RENDERER_FLAG_RUNNING | XA_RENDERER_FLAG_PAUSED;
+        __xf_restore_interrupts(flags);
+        __xf_timer_stop(&d->timer);
+        return XA_NO_ERROR;
+
+    case XA_RENDERER_STATE_SUSPEND:
+    case XA_RENDERER_STATE_SUSPEND_RESUME:
+        /* ...no hardware context to save; pause/run does the work */
+        return XA_NO_ERROR;
+
+    case XA_RENDERER_STATE_IDLE:
+        /* ...command is valid in any active state; stop renderer operation */
+        xa_sim_renderer_close(d);
+
+        /* ...reset renderer flags */
+        d->state &= ~(XA_RENDERER_FLAG_RUNNING | XA_RENDERER_FLAG_PAUSED);
+        return XA_NO_ERROR;
+
+    default:
+        /* ...unrecognized command */
+        return XF_CHK_ERR(0, XA_API_FATAL_INVALID_CMD_TYPE);
+    }
+}
+
+/* ...set renderer configuration parameter */
+static XA_ERRORCODE xa_renderer_set_config_param(XASimRenderer *d, WORD32 i_idx, pVOID pv_value)
+{
+    UWORD32     i_value;
+
+#ifndef XA_DISABLE_EVENT
+    if (d && i_idx == XAF_COMP_CONFIG_PARAM_EVENT_CB)
+    {
+        /* ...set (or reset with NULL) event raising callback */
+        d->event_cb = (xa_raise_event_cb_t *)pv_value;
+        return XA_NO_ERROR;
+    }
+#endif
+
+    /* ...sanity check - pointers must be sane */
+    XF_CHK_ERR(d && pv_value, XA_API_FATAL_INVALID_CMD_TYPE);
+    /* ...pre-initialization must be completed */
+    XF_CHK_ERR(d->state & XA_RENDERER_FLAG_PREINIT_DONE, XA_RENDERER_CONFIG_FATAL_STATE);
+
+    /* ...only callback, state and underrun mode may be changed after post-init */
+    if (i_idx != XA_RENDERER_CONFIG_PARAM_CB && i_idx != XA_RENDERER_CONFIG_PARAM_STATE && i_idx != XA_RENDERER_CONFIG_PARAM_UNDERRUN_MODE)
+    {
+        XF_CHK_ERR((d->state & XA_RENDERER_FLAG_POSTINIT_DONE) == 0, XA_RENDERER_CONFIG_FATAL_STATE);
+    }
+
+    /* ...process individual configuration parameter */
+    i_value = (UWORD32) *(WORD32 *)pv_value;
+
+    switch (i_idx)
+    {
+    case XA_RENDERER_CONFIG_PARAM_PCM_WIDTH:
+        /* ...16 or 32-bit containers */
+        XF_CHK_ERR(i_value == 16 || i_value == 32, XA_RENDERER_CONFIG_NONFATAL_RANGE);
+        d->pcm_width = i_value;
+        d->sample_size = (d->pcm_width >> 3);
+        return XA_NO_ERROR;
+
+    case XA_RENDERER_CONFIG_PARAM_CHANNELS:
+        XF_CHK_ERR(i_value >= 1 && i_value <= XA_SIM_RENDERER_MAX_CHANNELS, XA_RENDERER_CONFIG_NONFATAL_RANGE);
+        d->channels = i_value;
+        return XA_NO_ERROR;
+
+    case XA_RENDERER_CONFIG_PARAM_SAMPLE_RATE:
+        /* ...any rate; there is no clock tree to configure */
+        XF_CHK_ERR(i_value >= 8000 && i_value <= 192000, XA_RENDERER_CONFIG_NONFATAL_RANGE);
+        d->rate = i_value;
+        return XA_NO_ERROR;
+
+    case XA_RENDERER_CONFIG_PARAM_FRAME_SIZE:
+        /* ...deprecated; frame size per channel in bytes */
+        XF_CHK_ERR(i_value % d->sample_size == 0, XA_RENDERER_CONFIG_NONFATAL_RANGE);
+        i_value /= d->sample_size;
+        XF_CHK_ERR(i_value >= MIN_FRAME_SIZE && i_value <= MAX_FRAME_SIZE, XA_RENDERER_CONFIG_NONFATAL_RANGE);
+        d->frame_size = i_value;
+        return XA_NO_ERROR;
+
+    case XA_RENDERER_CONFIG_PARAM_FRAME_SIZE_IN_SAMPLES:
+        XF_CHK_ERR(i_value >= MIN_FRAME_SIZE && i_value <= MAX_FRAME_SIZE, XA_RENDERER_CONFIG_NONFATAL_RANGE);
+        d->frame_size = i_value;
+        TRACE(INIT, _b("frame_size:%d"), d->frame_size);
+        return XA_NO_ERROR;
+
+    case XA_RENDERER_CONFIG_PARAM_LATENCY:
+        /* ...ring latency in microseconds; 0 selects double buffering */
+        d->latency_us = i_value;
+        return XA_NO_ERROR;
+
+    case XA_RENDERER_CONFIG_PARAM_UNDERRUN_MODE:
+        /* ...repeat is played as silence */
+        XF_CHK_ERR(i_value <= XA_RENDERER_UNDERRUN_REPEAT, XA_RENDERER_CONFIG_NONFATAL_RANGE);
+        d->underrun_mode = i_value;
+        return XA_NO_ERROR;
+
+    case XA_RENDERER_CONFIG_PARAM_CB:
+        /* ...set opaque callback data function */
+        d->cdata = (xa_renderer_cb_t *)pv_value;
+        return XA_NO_ERROR;
+
+    case XA_RENDERER_CONFIG_PARAM_STATE:
+        /* ...runtime state control parameter valid only in execution state */
+        XF_CHK_ERR(d->state & XA_RENDERER_FLAG_POSTINIT_DONE, XA_RENDERER_CONFIG_FATAL_STATE);
+        return xa_sim_renderer_control(d, i_value);
+
+    default:
+        /* ...unrecognized parameter */
+        return XF_CHK_ERR(0, XA_API_FATAL_INVALID_CMD_TYPE);
+    }
+}
+
+/* ...state retrieval function */
+static inline UWORD32 xa_sim_renderer_get_state(XASimRenderer *d)
+{
+    if (d->state & XA_RENDERER_FLAG_RUNNING)
+        return XA_RENDERER_STATE_RUN;
+    else if (d->state & XA_RENDERER_FLAG_PAUSED)
+        return XA_RENDERER_STATE_PAUSE;
+    else
+        return XA_RENDERER_STATE_IDLE;
+}
+
+/* ...retrieve configuration parameter */
+static XA_ERRORCODE xa_renderer_get_config_param(XASimRenderer *d, WORD32 i_idx, pVOID pv_value)
+{
+    unsigned long   flags;
+
+    /* ...sanity check - renderer must be initialized */
+    XF_CHK_ERR(d && pv_value, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    /* ...make sure pre-initialization is completed */
+    XF_CHK_ERR(d->state & XA_RENDERER_FLAG_PREINIT_DONE, XA_RENDERER_CONFIG_FATAL_STATE);
+
+    /* ...process individual configuration parameter */
+    switch (i_idx)
+    {
+    case XA_RENDERER_CONFIG_PARAM_PCM_WIDTH:
+        *(WORD32 *)pv_value = d->pcm_width;
+        return XA_NO_ERROR;
+
+    case XA_RENDERER_CONFIG_PARAM_CHANNELS:
+        *(WORD32 *)pv_value = d->channels;
+        return XA_NO_ERROR;
+
+    case XA_RENDERER_CONFIG_PARAM_SAMPLE_RATE:
+        *(WORD32 *)pv_value = d->rate;
+        return XA_NO_ERROR;
+
+    case XA_RENDERER_CONFIG_PARAM_FRAME_SIZE: /* ...deprecated */
+        *(WORD32 *)pv_value = d->frame_size * d->sample_size;
+        return XA_NO_ERROR;
+
+    case XA_RENDERER_CONFIG_PARAM_FRAME_SIZE_IN_SAMPLES:
+        *(WORD32 *)pv_value = d->frame_size;
+        return XA_NO_ERROR;
+
+    case XA_RENDERER_CONFIG_PARAM_STATE:
+        *(WORD32 *)pv_value = xa_sim_renderer_get_state(d);
+        return XA_NO_ERROR;
+
+    case XA_RENDERER_CONFIG_PARAM_BYTES_PRODUCED:
+        *(UWORD32 *)pv_value = (UWORD32)(d->cumulative_bytes_produced > MAX_UWORD32 ? MAX_UWORD32 : d->cumulative_bytes_produced);
+        return XA_NO_ERROR;
+
+    case XA_RENDERER_CONFIG_PARAM_PERIOD_SIZE:
+        /* ...ring period is always one frame */
+        *(WORD32 *)pv_value = d->frame_size;
+        return XA_NO_ERROR;
+
+    case XA_RENDERER_CONFIG_PARAM_LATENCY:
+        /* ...actual ring length after post-init */
+        if (d->state & XA_RENDERER_FLAG_POSTINIT_DONE)
+            *(WORD32 *)pv_value = (WORD32)((UWORD64)d->period_count * d->frame_size * 1000000 / d->rate);
+        else
+            *(WORD32 *)pv_value = d->latency_us;
+        return XA_NO_ERROR;
+
+    case XA_RENDERER_CONFIG_PARAM_FIFO_LEVEL:
+        /* ...amount of data not played yet */
+        flags = __xf_disable_interrupts();
+        *(WORD32 *)pv_value = d->level;
+        __xf_restore_interrupts(flags);
+        return XA_NO_ERROR;
+
+    case XA_RENDERER_CONFIG_PARAM_UNDERRUN_MODE:
+        *(WORD32 *)pv_value = d->underrun_mode;
+        return XA_NO_ERROR;
+
+    case XA_RENDERER_CONFIG_PARAM_XRUN_COUNT:
+        /* ...return number of underruns (also event payload) */
+        *(WORD32 *)pv_value = d->xruns;
+        return XA_NO_ERROR;
+
+    case XA_RENDERER_CONFIG_PARAM_TIMER_JITTER:
+        /* ...worst period deadline lateness in microseconds */
+        *(WORD32 *)pv_value = (WORD32)(d->jitter_max / 1000);
+        return XA_NO_ERROR;
+
+    default:
+        /* ...unrecognized parameter */
+        return XF_CHK_ERR(0, XA_API_FATAL_INVALID_CMD_TYPE);
+    }
+}
+
+static XA_ERRORCODE xa_renderer_do_exec(XASimRenderer *d)
+{
+#ifndef XA_DISABLE_EVENT
+    /* ...report underruns counted by the clock; events can't be raised from there */
+    if (d->xruns != d->xruns_reported && d->event_cb)
+    {
+        d->xruns_reported = d->xruns;
+        d->event_cb->cb(d->event_cb, XA_RENDERER_CONFIG_PARAM_XRUN_COUNT);
+    }
+#endif
+
+    d->consumed = xa_sim_renderer_submit(d, d->input, d->submited_inbytes);
+
+    d->cumulative_bytes_produced += d->consumed;
+
+    return XA_NO_ERROR;
+}
+
+/* ...execution command */
+static XA_ERRORCODE xa_renderer_execute(XASimRenderer *d, WORD32 i_idx, pVOID pv_value)
+{
+    /* ...sanity check - pointer must be valid */
+    XF_CHK_ERR(d, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    /* ...renderer must be in running state */
+    XF_CHK_ERR(d->state & (XA_RENDERER_FLAG_RUNNING | XA_RENDERER_FLAG_IDLE), XA_RENDERER_EXEC_FATAL_STATE);
+
+    /* ...process individual command type */
+    switch (i_idx)
+    {
+    case XA_CMD_TYPE_DO_EXECUTE:
+        return xa_renderer_do_exec(d);
+
+    case XA_CMD_TYPE_DONE_QUERY:
+        XF_CHK_ERR(pv_value, XA_API_FATAL_INVALID_CMD_TYPE);
+        *(UWORD32 *)pv_value = d->exec_done;
+        return XA_NO_ERROR;
+
+    case XA_CMD_TYPE_DO_RUNTIME_INIT:
+        /* ...silently ignore */
+        return XA_NO_ERROR;
+
+    default:
+        /* ...unrecognized command */
+        return XF_CHK_ERR(0, XA_API_FATAL_INVALID_CMD_TYPE);
+    }
+}
+
+/* ...set number of input bytes */
+static XA_ERRORCODE xa_renderer_set_input_bytes(XASimRenderer *d, WORD32 i_idx, pVOID pv_value)
+{
+    UWORD32     size;
+
+    XF_CHK_ERR(d && pv_value, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    /* ...make sure it is an input port  */
+    XF_CHK_ERR(i_idx == 0, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    /* ...renderer must be initialized */
+    XF_CHK_ERR(d->state & XA_RENDERER_FLAG_POSTINIT_DONE, XA_RENDERER_EXEC_FATAL_STATE);
+
+    /* ...input buffer pointer must be valid */
+    XF_CHK_ERR(d->input, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    /* ...make sure we have integral amount of samples */
+    size = *(UWORD32 *)pv_value;
+    XF_CHK_ERR(size % (d->sample_size * d->channels) == 0, XA_RENDERER_EXEC_FATAL_INPUT);
+
+    d->submited_inbytes = size;
+
+    return XA_NO_ERROR;
+}
+
+/* ...get number of output bytes */
+static XA_ERRORCODE xa_renderer_get_output_bytes(XASimRenderer *d, WORD32 i_idx, pVOID pv_value)
+{
+    /* ...sanity check - check parameters */
+    XF_CHK_ERR(d && pv_value, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    /* ...track index must be valid */
+    XF_CHK_ERR(i_idx == 1, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    /* ...renderer must be initialized */
+    XF_CHK_ERR(d->state & XA_RENDERER_FLAG_POSTINIT_DONE, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    /* ...output buffer must exist */
+    XF_CHK_ERR(d->output, XA_RENDERER_EXEC_NONFATAL_OUTPUT);
+
+    /* ...return number of produced bytes */
+    *(WORD32 *)pv_value = d->bytes_produced;
+
+    return XA_NO_ERROR;
+}
+
+/* ...get number of consumed bytes */
+static XA_ERRORCODE xa_renderer_get_curidx_input_buf(XASimRenderer *d, WORD32 i_idx, pVOID pv_value)
+{
+    /* ...sanity check - check parameters */
+    XF_CHK_ERR(d && pv_value, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    /* ...input buffer index must be valid */
+    XF_CHK_ERR(i_idx == 0, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    /* ...renderer must be in post-init state */
+    XF_CHK_ERR(d->state & XA_RENDERER_FLAG_POSTINIT_DONE, XA_RENDERER_EXEC_FATAL_STATE);
+
+    /* ...input buffer must exist */
+    XF_CHK_ERR(d->input, XA_RENDERER_EXEC_FATAL_INPUT);
+
+    /* ...return number of bytes consumed */
+    *(WORD32 *)pv_value = d->consumed;
+    d->consumed = 0;
+    return XA_NO_ERROR;
+}
+
+/*******************************************************************************
+ * Memory information API
+ ******************************************************************************/
+
+/* ..get total amount of data for memory tables */
+static XA_ERRORCODE xa_renderer_get_memtabs_size(XASimRenderer *d, WORD32 i_idx, pVOID pv_value)
+{
+    /* ...basic sanity checks */
+    XF_CHK_ERR(d && pv_value, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    /* ...check renderer is pre-initialized */
+    XF_CHK_ERR(d->state & XA_RENDERER_FLAG_PREINIT_DONE, XA_RENDERER_CONFIG_FATAL_STATE);
+
+    /* ...we have all our tables inside API structure */
+    *(WORD32 *)pv_value = 0;
+
+    return XA_NO_ERROR;
+}
+
+/* ..set memory tables pointer */
+static XA_ERRORCODE xa_renderer_set_memtabs_ptr(XASimRenderer *d, WORD32 i_idx, pVOID pv_value)
+{
+    /* ...basic sanity checks */
+    XF_CHK_ERR(d && pv_value, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    /* ...check renderer is pre-initialized */
+    XF_CHK_ERR(d->state & XA_RENDERER_FLAG_PREINIT_DONE, XA_RENDERER_CONFIG_FATAL_STATE);
+
+    return XA_NO_ERROR;
+}
+
+/* ...return total amount of memory buffers */
+static XA_ERRORCODE xa_renderer_get_n_memtabs(XASimRenderer *d, WORD32 i_idx, pVOID pv_value)
+{
+    /* ...basic sanity checks */
+    XF_CHK_ERR(d && pv_value, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    /* ...we have 1 input buffer and 1 optional output buffer */
+    *(WORD32 *)pv_value = 2;
+
+    return XA_NO_ERROR;
+}
+
+/* ...return memory buffer data */
+static XA_ERRORCODE xa_renderer_get_mem_info_size(XASimRenderer *d, WORD32 i_idx, pVOID pv_value)
+{
+    /* ...basic sanity check */
+    XF_CHK_ERR(d && pv_value, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    /* ...command valid only after post-initialization step */
+    XF_CHK_ERR(d->state & XA_RENDERER_FLAG_POSTINIT_DONE, XA_RENDERER_CONFIG_FATAL_STATE);
+
+    /* ...input and optional output buffers accept exact audio frame */
+    XF_CHK_ERR(i_idx == 0 || i_idx == 1, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    *(WORD32 *)pv_value = (WORD32)d->period_bytes;
+
+    return XA_NO_ERROR;
+}
+
+/* ...return memory alignment data */
+static XA_ERRORCODE xa_renderer_get_mem_info_alignment(XASimRenderer *d, WORD32 i_idx, pVOID pv_value)
+{
+    /* ...basic sanity check */
+    XF_CHK_ERR(d && pv_value, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    /* ...command valid only after post-initialization step */
+    XF_CHK_ERR(d->state & XA_RENDERER_FLAG_POSTINIT_DONE, XA_RENDERER_CONFIG_FATAL_STATE);
+
+    /* ...all buffers are at least 4-bytes aligned */
+    *(WORD32 *)pv_value = 4;
+
+    return XA_NO_ERROR;
+}
+
+/* ...return memory type data */
+static XA_ERRORCODE xa_renderer_get_mem_info_type(XASimRenderer *d, WORD32 i_idx, pVOID pv_value)
+{
+    /* ...basic sanity check */
+    XF_CHK_ERR(d && pv_value, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    /* ...command valid only after post-initialization step */
+    XF_CHK_ERR(d->state & XA_RENDERER_FLAG_POSTINIT_DONE, XA_RENDERER_CONFIG_FATAL_STATE);
+
+    switch (i_idx)
+    {
+    case 0:
+        /* ...input buffers */
+        *(WORD32 *)pv_value = XA_MEMTYPE_INPUT;
+        return XA_NO_ERROR;
+
+    case 1:
+        /* ...output buffers */
+        *(WORD32 *)pv_value = XA_MEMTYPE_OUTPUT;
+        return XA_NO_ERROR;
+
+    default:
+        /* ...invalid index */
+        return XF_CHK_ERR(0, XA_API_FATAL_INVALID_CMD_TYPE);
+    }
+}
+
+/* ...set memory pointer */
+static XA_ERRORCODE xa_renderer_set_mem_ptr(XASimRenderer *d, WORD32 i_idx, pVOID pv_value)
+{
+    /* ...basic sanity check */
+    XF_CHK_ERR(d, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    /* ...codec must be initialized */
+    XF_CHK_ERR(d->state & XA_RENDERER_FLAG_POSTINIT_DONE, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    TRACE(INIT, _b("xa_renderer_set_mem_ptr[%u]: %p"), i_idx, pv_value);
+
+    /* ...select memory buffer */
+    switch (i_idx)
+    {
+    case 0:
+        /* ...input buffer */
+        XF_CHK_ERR(pv_value, XA_API_FATAL_INVALID_CMD_TYPE);
+        d->input = pv_value;
+        return XA_NO_ERROR;
+
+    case 1:
+        /* ...output buffer(optional). Can be NULL as this is optional output. */
+        d->output = pv_value;
+        return XA_NO_ERROR;
+
+    default:
+        /* ...invalid index */
+        return XF_CHK_ERR(0, XA_API_FATAL_INVALID_CMD_TYPE);
+    }
+}
+
+/* ...set input over */
+static XA_ERRORCODE xa_renderer_input_over(XASimRenderer *d, WORD32 i_idx, pVOID pv_value)
+{
+    /* ...basic sanity check */
+    XF_CHK_ERR(d, XA_API_FATAL_INVALID_CMD_TYPE);
+
+    d->input_over = 1;
+
+    return XA_NO_ERROR;
+}
+
+/*******************************************************************************
+ * API command hooks
+ ******************************************************************************/
+
+static XA_ERRORCODE (* const xa_sim_renderer_api[])(XASimRenderer *, WORD32, pVOID) =
+{
+    [XA_API_CMD_GET_API_SIZE]           = xa_renderer_get_api_size,
+    [XA_API_CMD_INIT]                   = xa_renderer_init,
+    [XA_API_CMD_SET_CONFIG_PARAM]       = xa_renderer_set_config_param,
+    [XA_API_CMD_GET_CONFIG_PARAM]       = xa_renderer_get_config_param,
+    [XA_API_CMD_EXECUTE]                = xa_renderer_execute,
+    [XA_API_CMD_SET_INPUT_BYTES]        = xa_renderer_set_input_bytes,
+    [XA_API_CMD_GET_CURIDX_INPUT_BUF]   = xa_renderer_get_curidx_input_buf,
+    [XA_API_CMD_GET_MEMTABS_SIZE]       = xa_renderer_get_memtabs_size,
+    [XA_API_CMD_SET_MEMTABS_PTR]        = xa_renderer_set_memtabs_ptr,
+    [XA_API_CMD_GET_N_MEMTABS]          = xa_renderer_get_n_memtabs,
+    [XA_API_CMD_GET_MEM_INFO_SIZE]      = xa_renderer_get_mem_info_size,
+    [XA_API_CMD_GET_MEM_INFO_ALIGNMENT] = xa_renderer_get_mem_info_alignment,
+    [XA_API_CMD_GET_MEM_INFO_TYPE]      = xa_renderer_get_mem_info_type,
+    [XA_API_CMD_SET_MEM_PTR]            = xa_renderer_set_mem_ptr,
+    [XA_API_CMD_INPUT_OVER]             = xa_renderer_input_over,
+    [XA_API_CMD_GET_OUTPUT_BYTES]       = xa_renderer_get_output_bytes,
+};
+
+/* ...total numer of commands supported */
+#define XA_SIM_RENDERER_API_COMMANDS_NUM   (sizeof(xa_sim_renderer_api) / sizeof(xa_sim_renderer_api[0]))
+
+/*******************************************************************************
+ * API entry point
+ ******************************************************************************/
+
+XA_ERRORCODE xa_sim_renderer(xa_codec_handle_t p_xa_module_obj, WORD32 i_cmd, WORD32 i_idx, pVOID pv_value)
+{
+    XASimRenderer *renderer = (XASimRenderer *) p_xa_module_obj;
+
+    /* ...check if command index is sane */
+    XF_CHK_ERR(i_cmd < XA_SIM_RENDERER_API_COMMANDS_NUM, XA_API_FATAL_INVALID_CMD);
+
+    /* ...see if command is defined */
+    XF_CHK_ERR(xa_sim_renderer_api[i_cmd], XA_API_FATAL_INVALID_CMD);
+
+    /* ...execute requested command */
+    return xa_sim_renderer_api[i_cmd](renderer, i_idx, pv_value);
+}
@@ -79,6 +79,8 @@ extern XA_ERRORCODE xa_amr_wb_decoder(xa_codec_handle_t, WORD32, WORD32, pVOID);
 extern XA_ERRORCODE xa_src_pp_fx(xa_codec_handle_t, WORD32, WORD32, pVOID);
 extern XA_ERRORCODE xa_renderer(xa_codec_handle_t , WORD32 , WORD32 , pVOID);
 extern XA_ERRORCODE xa_capturer(xa_codec_handle_t , WORD32 , WORD32 , pVOID);
+extern XA_ERRORCODE xa_sim_renderer(xa_codec_handle_t , WORD32 , WORD32 , pVOID);
+extern XA_ERRORCODE xa_sim_capturer(xa_codec_handle_t , WORD32 , WORD32 , pVOID);
 extern XA_ERRORCODE xa_vorbis_decoder(xa_codec_handle_t, WORD32, WORD32, pVOID);
 extern XA_ERRORCODE xa_dummy_aec22(xa_codec_handle_t, WORD32, WORD32, pVOID);
 extern XA_ERRORCODE xa_dummy_aec23(xa_codec_handle_t, WORD32, WORD32, pVOID);
@@ -166,6 +168,12 @@ static const xf_component_id_t xf_component_id[] =
 #if XA_CAPTURER
     { "capturer",              xa_capturer_factory,        xa_capturer },
 #endif
+#if XA_SIM_RENDERER
+    { "renderer/sim",          xa_renderer_factory,        xa_sim_renderer },
+#endif
+#if XA_SIM_CAPTURER
+    { "capturer/sim",          xa_capturer_factory,        xa_sim_capturer },
+#endif
 #if XA_SRC_PP_FX
     { "audio-fx/src-pp",        xa_audio_codec_factory,     xa_src_pp_fx },
 #endif
@@ -0,0 +1,367 @@
+/*
+* Copyright (c) 2015-2021 Cadence Design Systems Inc.
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/*******************************************************************************
+ * xa-aec-bench.c
+ *
+ * Echo canceller benchmark
+ *
+ * Drives aec23 plugin through its API with synthetic far-end signal, echo of
+ * a simulated room and a near-end talker segment. Checks that the echo is
+ * attenuated in single talk, that double talk is detected and near-end speech
+ * passes through, and that the filter does not diverge afterwards. Reports
+ * __xf_get_cycles() ticks per block (CPU cycles on DSP, nanoseconds on host)
+ * and the resulting load at 16kHz for several tail lengths.
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "osal-timer.h"
+#include "audio/xa-aec23-api.h"
+#include "xa-aec-fdaf.h"
+
+/*******************************************************************************
+ * Local definitions
+ ******************************************************************************/
+
+#define XA_BENCH_SAMPLE_RATE            16000
+#define XA_BENCH_FRAME                  512
+#define XA_BENCH_PORTS                  5
+
+/* ...simulated room: bulk delay, decay constant and echo return loss */
+#define XA_BENCH_ROOM_TAPS              800
+#define XA_BENCH_ROOM_DELAY             40
+#define XA_BENCH_ROOM_DECAY             150.0
+#define XA_BENCH_ROOM_ERL               0.1
+
+/* ...scenario in seconds: far-end only, double talk, far-end only */
+#define XA_BENCH_SINGLE_TALK            8
+#define XA_BENCH_DOUBLE_TALK            2
+#define XA_BENCH_RECOVERY               2
+
+/* ...acceptance limits in dB */
+#define XA_BENCH_MIN_ERLE               20.0
+#define XA_BENCH_MIN_NEAR_SNR           10.0
+#define XA_BENCH_MAX_ERLE_LOSS          6.0
+
+extern XA_ERRORCODE xa_dummy_aec23(xa_codec_handle_t, WORD32, WORD32, pVOID);
+
+typedef struct xa_bench {
+    xa_codec_handle_t   handle;
+    void               *mem[XA_BENCH_PORTS + 2];
+    WORD16             *mic;
+    WORD16             *ref;
+    WORD16             *out;
+    unsigned long       ticks;
+    UWORD32             blocks;
+
+} xa_bench_t;
+
+/* ...abort on API failure */
+#define XA_BENCH_API(b, cmd, idx, value)                                    \
+do {                                                                        \
+    XA_ERRORCODE __e = xa_dummy_aec23((b)->handle, (cmd), (idx), (value));  \
+    if (__e != XA_NO_ERROR)                                                 \
+    {                                                                       \
+        fprintf(stderr, "command %d:%d failed: %x\n", (cmd), (idx), __e);   \
+        exit(1);                                                            \
+    }                                                                       \
+} while (0)
+
+/*******************************************************************************
+ * Plugin control
+ ******************************************************************************/
+
+static void xa_bench_create(xa_bench_t *b, UWORD32 tail)
+{
+    WORD32      size, value, n;
+    WORD32      i;
+
+    memset(b, 0, sizeof(*b));
+
+    XA_BENCH_API(b, XA_API_CMD_GET_API_SIZE, 0, &size);
+    b->handle = malloc(size);
+    XA_BENCH_API(b, XA_API_CMD_INIT, XA_CMD_TYPE_INIT_API_PRE_CONFIG_PARAMS, NULL);
+
+    value = 1;
+    XA_BENCH_API(b, XA_API_CMD_SET_CONFIG_PARAM, XA_AEC23_CONFIG_PARAM_CHANNELS, &value);
+    value = XA_BENCH_SAMPLE_RATE;
+    XA_BENCH_API(b, XA_API_CMD_SET_CONFIG_PARAM, XA_AEC23_CONFIG_PARAM_SAMPLE_RATE, &value);
+    value = (WORD32)tail;
+    XA_BENCH_API(b, XA_API_CMD_SET_CONFIG_PARAM, XA_AEC23_CONFIG_PARAM_TAIL_LENGTH, &value);
+
+    XA_BENCH_API(b, XA_API_CMD_INIT, XA_CMD_TYPE_INIT_API_POST_CONFIG_PARAMS, NULL);
+    XA_BENCH_API(b, XA_API_CMD_GET_N_MEMTABS, 0, &n);
+
+    for (i = 0; i < n; i++)
+    {
+        XA_BENCH_API(b, XA_API_CMD_GET_MEM_INFO_SIZE, i, &size);
+        b->mem[i] = calloc(1, size);
+        XA_BENCH_API(b, XA_API_CMD_SET_MEM_PTR, i, b->mem[i]);
+    }
+
+    for (i = 0; i < XA_BENCH_PORTS; i++)
+    {
+        XA_BENCH_API(b, XA_API_CMD_SET_CONFIG_PARAM, XA_AEC23_CONFIG_PARAM_PORT_CONNECT, &i);
+    }
+
+    XA_BENCH_API(b, XA_API_CMD_INIT, XA_CMD_TYPE_INIT_PROCESS, NULL);
+
+    b->mic = b->mem[0], b->ref = b->mem[1], b->out = b->mem[2];
+}
+
+static void xa_bench_destroy(xa_bench_t *b)
+{
+    UWORD32     i;
+
+    for (i = 0; i < XA_BENCH_PORTS + 2; i++)
+    {
+        free(b->mem[i]);
+    }
+
+    free(b->handle);
+}
+
+/* ...process one frame already placed into input buffers */
+static void xa_bench_execute(xa_bench_t *b)
+{
+    WORD32          value = XA_BENCH_FRAME * sizeof(WORD16);
+    unsigned long   t0;
+
+    XA_BENCH_API(b, XA_API_CMD_SET_INPUT_BYTES, 0, &value);
+    XA_BENCH_API(b, XA_API_CMD_SET_INPUT_BYTES, 1, &value);
+
+    t0 = __xf_get_cycles();
+    XA_BENCH_API(b, XA_API_CMD_EXECUTE, XA_CMD_TYPE_DO_EXECUTE, NULL);
+    b->ticks += __xf_get_cycles() - t0;
+    b->blocks += XA_BENCH_FRAME / XA_AEC_FDAF_BLOCK;
+
+    XA_BENCH_API(b, XA_API_CMD_GET_OUTPUT_BYTES, 2, &value);
+
+    if (value != XA_BENCH_FRAME * sizeof(WORD16))
+    {
+        fprintf(stderr, "produced %d bytes instead of %u\n", value, (UWORD32)(XA_BENCH_FRAME * sizeof(WORD16)));
+        exit(1);
+    }
+}
+
+/*******************************************************************************
+ * Signals
+ ******************************************************************************/
+
+/* ...zero-mean noise of unit variance (sum of uniform variables) */
+static double xa_bench_noise(void)
+{
+    return ((double)rand() + rand() + rand() - 1.5 * RAND_MAX) / RAND_MAX * 2.0;
+}
+
+/* ...speech-like source: low-pass noise with syllabic envelope */
+typedef struct xa_bench_talker {
+    double      state;
+    double      rate;
+    double      level;
+    UWORD32     n;
+
+} xa_bench_talker_t;
+
+static double xa_bench_talk(xa_bench_talker_t *t)
+{
+    double      env = 0.3 + 0.7 * fabs(sin(2 * M_PI * t->rate * t->n++ / XA_BENCH_SAMPLE_RATE));
+
+    t->state = 0.8 * t->state + xa_bench_noise();
+
+    return t->level * env * t->state;
+}
+
+/* ...room impulse response: bulk delay and exponentially decaying noise */
+static void xa_bench_room(double *h)
+{
+    double      e = 0;
+    UWORD32     k;
+
+    for (k = 0; k < XA_BENCH_ROOM_TAPS; k++)
+    {
+        h[k] = (k < XA_BENCH_ROOM_DELAY ? 0 : xa_bench_noise() * exp(-((double)k - XA_BENCH_ROOM_DELAY) / XA_BENCH_ROOM_DECAY));
+        e += h[k] * h[k];
+    }
+
+    for (k = 0; k < XA_BENCH_ROOM_TAPS; k++)
+    {
+        h[k] *= sqrt(XA_BENCH_ROOM_ERL / e);
+    }
+}
+
+static WORD16 xa_bench_sat(double v)
+{
+    return (WORD16)(v > 32767 ? 32767 : (v < -32768 ? -32768 : v));
+}
+
+static double xa_bench_db(double num, double den)
+{
+    return 10 * log10((num + 1) / (den + 1));
+}
+
+/*******************************************************************************
+ * Tests
+ ******************************************************************************/
+
+/* ...silent reference must leave mic untouched */
+static void xa_bench_verify_passthrough(void)
+{
+    xa_bench_t  b;
+    UWORD32     i;
+
+    xa_bench_create(&b, XA_AEC_FDAF_TAIL_DEFAULT);
+
+    for (i = 0; i < XA_BENCH_FRAME; i++)
+    {
+        b.mic[i] = (WORD16)rand(), b.ref[i] = 0;
+    }
+
+    xa_bench_execute(&b);
+
+    if (memcmp(b.mic, b.out, XA_BENCH_FRAME * sizeof(WORD16)))
+    {
+        fprintf(stderr, "mic is modified with silent reference\n");
+        exit(1);
+    }
+
+    xa_bench_destroy(&b);
+}
+
+/* ...echo cancellation scenario; returns ticks per block */
+static double xa_bench_scenario(UWORD32 tail, int verbose)
+{
+    static double       h[XA_BENCH_ROOM_TAPS];
+    static double       hist[XA_BENCH_ROOM_TAPS];
+    xa_bench_talker_t   far = { .rate = 3.0, .level = 2500 };
+    xa_bench_talker_t   near = { .rate = 2.3, .level = 1500 };
+    xa_bench_t          b;
+    UWORD32             frames, f, i, k, dt_frames = 0, dt_total = 0;
+    double              st_mic = 0, st_res = 0, rc_mic = 0, rc_res = 0, nr_sig = 0, nr_err = 0;
+    double              echo, nearend[XA_BENCH_FRAME], noise[XA_BENCH_FRAME];
+    WORD32              value, erle = 0;
+    double              erle_st, erle_rc, snr;
+
+    srand(1);
+    xa_bench_room(h);
+    memset(hist, 0, sizeof(hist));
+    xa_bench_create(&b, tail);
+
+    frames = (XA_BENCH_SINGLE_TALK + XA_BENCH_DOUBLE_TALK + XA_BENCH_RECOVERY) * XA_BENCH_SAMPLE_RATE / XA_BENCH_FRAME;
+
+    for (f = 0; f < frames; f++)
+    {
+        double  t = (double)f * XA_BENCH_FRAME / XA_BENCH_SAMPLE_RATE;
+        int     st = (t >= XA_BENCH_SINGLE_TALK - 2 && t < XA_BENCH_SINGLE_TALK);
+        int     dt = (t >= XA_BENCH_SINGLE_TALK && t < XA_BENCH_SINGLE_TALK + XA_BENCH_DOUBLE_TALK);
+        int     rc = (t >= XA_BENCH_SINGLE_TALK + XA_BENCH_DOUBLE_TALK + 0.5);
+
+        /* ...far-end through the room, near-end talker and sensor noise */
+        for (i = 0; i < XA_BENCH_FRAME; i++)
+        {
+            memmove(hist + 1, hist, (XA_BENCH_ROOM_TAPS - 1) * sizeof(double));
+            hist[0] = b.ref[i] = xa_bench_sat(xa_bench_talk(&far));
+
+            for (k = 0, echo = 0; k < XA_BENCH_ROOM_TAPS; k++)
+            {
+                echo += h[k] * hist[k];
+            }
+
+            nearend[i] = (dt ? xa_bench_talk(&near) : 0);
+            noise[i] = 4 * xa_bench_noise();
+            b.mic[i] = xa_bench_sat(echo + nearend[i] + noise[i]);
+        }
+
+        xa_bench_execute(&b);
+
+        /* ...residual echo is what remains after near-end and noise are removed */
+        for (i = 0; i < XA_BENCH_FRAME; i++)
+        {
+            double  m = b.mic[i] - nearend[i] - noise[i];
+            double  r = b.out[i] - nearend[i] - noise[i];
+
+            if (st)
+                st_mic += m * m, st_res += r * r;
+            if (rc)
+                rc_mic += m * m, rc_res += r * r;
+            if (dt)
+                nr_sig += nearend[i] * nearend[i], nr_err += r * r;
+        }
+
+        XA_BENCH_API(&b, XA_API_CMD_GET_CONFIG_PARAM, XA_AEC23_CONFIG_PARAM_DOUBLE_TALK, &value);
+        dt_frames += (dt && value), dt_total += dt;
+
+        if (st)
+            XA_BENCH_API(&b, XA_API_CMD_GET_CONFIG_PARAM, XA_AEC23_CONFIG_PARAM_ERLE, &erle);
+    }
+
+    erle_st = xa_bench_db(st_mic, st_res);
+    erle_rc = xa_bench_db(rc_mic, rc_res);
+    snr = xa_bench_db(nr_sig, nr_err);
+
+    if (verbose)
+    {
+        printf("tail %u: ERLE %.1f dB (plugin estimate %.1f dB), double talk detected in %u/%u frames, near-end SNR %.1f dB, ERLE after double talk %.1f dB\n",
+               tail, erle_st, erle / 256.0, dt_frames, dt_total, snr, erle_rc);
+
+        if (erle_st < XA_BENCH_MIN_ERLE || snr < XA_BENCH_MIN_NEAR_SNR || erle_rc < erle_st - XA_BENCH_MAX_ERLE_LOSS)
+        {
+            fprintf(stderr, "echo canceller is out of limits\n");
+            exit(1);
+        }
+
+        if (dt_frames < dt_total / 2)
+        {
+            fprintf(stderr, "double talk is not detected\n");
+            exit(1);
+        }
+    }
+
+    xa_bench_destroy(&b);
+
+    return (double)b.ticks / b.blocks;
+}
+
+int main(void)
+{
+    static const UWORD32    tails[] = { 256, 1024, 2048, 4096 };
+    double                  ticks;
+    UWORD32                 i;
+
+    xa_bench_verify_passthrough();
+    xa_bench_scenario(XA_AEC_FDAF_TAIL_DEFAULT, 1);
+
+    printf("block %u samples, tick = 1/%lu s\n", XA_AEC_FDAF_BLOCK, __xf_get_cycles_freq());
+    printf("%8s %16s %24s\n", "tail", "ticks/block", "Mticks/s at 16kHz mono");
+
+    for (i = 0; i < sizeof(tails) / sizeof(tails[0]); i++)
+    {
+        ticks = xa_bench_scenario(tails[i], 0);
+        printf("%8u %16.0f %24.2f\n", tails[i], ticks, ticks * XA_BENCH_SAMPLE_RATE / XA_AEC_FDAF_BLOCK / 1e6);
+    }
+
+    return 0;
+}
@@ -0,0 +1,174 @@
+/*
+* Copyright (c) 2015-2022 Cadence Design Systems Inc.
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/*******************************************************************************
+ * xa-hop-window-check.c
+ *
+ * Hop/window input adapter check
+ *
+ * Streams a position-dependent byte pattern through the adapter in irregular chunks for
+ * several window/hop/depth combinations and verifies that window N always
+ * holds stream bytes [N * hop, N * hop + window), both when accessed in place
+ * and when gathered across the ring end, and that put() takes exactly what is
+ * missing from a complete window.
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xa-hop-window.h"
+
+/*******************************************************************************
+ * Local definitions
+ ******************************************************************************/
+
+#define XA_CHECK_STREAM_BYTES           65536
+
+/* ...input chunk sizes, cycled through to hit every ring offset */
+static const UWORD32 xa_check_chunk[] = { 1, 7, 64, 3, 250, 17, 1024, 5 };
+
+/* ...stream byte at given position */
+static inline UWORD8 xa_check_byte(UWORD32 pos)
+{
+    return (UWORD8)(pos * 131 + (pos >> 8));
+}
+
+/*******************************************************************************
+ * Check for one configuration
+ ******************************************************************************/
+
+/* ...returns number of wrapped windows; exits on mismatch */
+static UWORD32 xa_check_run(UWORD32 window, UWORD32 hop, UWORD32 depth)
+{
+    xa_hop_window_t     hw;
+    UWORD32             size = xa_hop_window_size(window, hop, depth);
+    UWORD8             *ring = malloc(size);
+    UWORD8             *linear = malloc(window);
+    UWORD8             *copy = malloc(window);
+    UWORD8             *chunk = malloc(1024);
+    UWORD32             pos = 0, n = 0, wrapped = 0, c = 0;
+    UWORD32             i, k, taken, missing;
+    const UWORD8       *w;
+
+    if (!ring || !linear || !copy || !chunk)
+    {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+
+    if (size % hop || size < window)
+    {
+        fprintf(stderr, "window %u hop %u depth %u: bad ring size %u\n", window, hop, depth, size);
+        exit(1);
+    }
+
+    xa_hop_window_init(&hw, ring, size, window, hop);
+
+    while (pos < XA_CHECK_STREAM_BYTES)
+    {
+        /* ...feed next chunk; adapter takes no more than missing from the window */
+        k = xa_check_chunk[c++ % (sizeof(xa_check_chunk) / sizeof(xa_check_chunk[0]))];
+
+        for (i = 0; i < k; i++)
+            chunk[i] = xa_check_byte(pos + i);
+
+        missing = window - hw.level;
+        taken = xa_hop_window_put(&hw, chunk, k);
+
+        if (taken != (k < missing ? k : missing))
+        {
+            fprintf(stderr, "window %u hop %u: put took %u of %u\n", window, hop, taken, k);
+            exit(1);
+        }
+
+        pos += taken;
+
+        if (!xa_hop_window_ready(&hw))
+            continue;
+
+        /* ...window must be complete now and nothing more accepted */
+        if (xa_hop_window_put(&hw, chunk, 1) != 0)
+        {
+            fprintf(stderr, "window %u hop %u: put accepted data over complete window\n", window, hop);
+            exit(1);
+        }
+
+        w = xa_hop_window_get(&hw, linear);
+        xa_hop_window_copy(&hw, copy);
+
+        wrapped += (w == linear);
+
+        for (i = 0; i < window; i++)
+        {
+            if (w[i] != xa_check_byte(n * hop + i) || copy[i] != w[i])
+            {
+                fprintf(stderr, "window %u hop %u depth %u: window %u byte %u mismatch\n", window, hop, depth, n, i);
+                exit(1);
+            }
+        }
+
+        xa_hop_window_advance(&hw);
+        n++;
+    }
+
+    free(chunk);
+    free(copy);
+    free(linear);
+    free(ring);
+
+    return wrapped;
+}
+
+/*******************************************************************************
+ * Entry point
+ ******************************************************************************/
+
+int main(void)
+{
+    /* ...window, hop, depth */
+    static const UWORD32    cfg[][3] = {
+        { 640, 320, 1 },
+        { 640, 320, 2 },
+        { 1024, 1024, 1 },
+        { 1000, 160, 1 },
+        { 1000, 160, 3 },
+        { 960, 96, 0 },
+        { 4, 4, 8 },
+        { 7, 3, 2 },
+    };
+    UWORD32     i, wrapped = 0;
+
+    for (i = 0; i < sizeof(cfg) / sizeof(cfg[0]); i++)
+        wrapped += xa_check_run(cfg[i][0], cfg[i][1], cfg[i][2]);
+
+    /* ...make sure the gather path has been exercised */
+    if (wrapped == 0)
+    {
+        fprintf(stderr, "no window wrapped around the ring end\n");
+        return 1;
+    }
+
+    printf("hop/window adapter matches stream: %u configurations, %u wrapped windows\n", i, wrapped);
+
+    return 0;
+}
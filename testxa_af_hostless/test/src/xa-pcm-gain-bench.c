@@ -0,0 +1,327 @@
+/*
+* Copyright (c) 2015-2021 Cadence Design Systems Inc.
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/*******************************************************************************
+ * xa-pcm-gain-bench.c
+ *
+ * PCM gain kernels micro-benchmark
+ *
+ * Drives pcm_gain plugin through its API for every sample width, verifies the
+ * output is bit-exact with scalar reference for all gain indices and that gain
+ * changes are ramped monotonically, then reports throughput in samples per
+ * __xf_get_cycles() tick (CPU cycles on DSP, nanoseconds on host) for both
+ * plugin and reference.
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "osal-timer.h"
+#include "audio/xa-pcm-gain-api.h"
+
+/*******************************************************************************
+ * Local definitions
+ ******************************************************************************/
+
+#define XA_BENCH_CHANNELS               2
+#define XA_BENCH_FRAME_SIZE             1024
+#define XA_BENCH_ITERATIONS             2000
+#define XA_BENCH_GAINS                  7
+
+extern XA_ERRORCODE xa_pcm_gain(xa_codec_handle_t, WORD32, WORD32, pVOID);
+extern WORD16 pcm_gains[XA_BENCH_GAINS];
+
+typedef struct xa_bench {
+    xa_codec_handle_t   handle;
+    UWORD32             width;
+    UWORD32             size;
+    void               *input;
+    void               *output;
+    void               *ref;
+    void               *scratch;
+
+} xa_bench_t;
+
+/* ...abort on API failure */
+#define XA_BENCH_API(b, cmd, idx, value)                                    \
+do {                                                                        \
+    XA_ERRORCODE __e = xa_pcm_gain((b)->handle, (cmd), (idx), (value));     \
+    if (__e != XA_NO_ERROR)                                                 \
+    {                                                                       \
+        fprintf(stderr, "command %d:%d failed: %x\n", (cmd), (idx), __e);   \
+        exit(1);                                                            \
+    }                                                                       \
+} while (0)
+
+/*******************************************************************************
+ * Scalar reference (original implementation)
+ ******************************************************************************/
+
+/* ...original scalar loop with branchy saturation */
+#define XA_BENCH_REFERENCE(type, wide, lo, hi, mask)                        \
+static void xa_bench_reference_##type(void *output, const void *input,     \
+                                      UWORD32 n, WORD32 gain)               \
+{                                                                           \
+    const type *pIn = (const type *) input;                                 \
+    type       *pOut = (type *) output;                                     \
+    wide        product;                                                    \
+    UWORD32     i;                                                          \
+                                                                            \
+    for (i = 0; i < n; i++)                                                 \
+    {                                                                       \
+        product = ((wide)*pIn++ * gain) >> 12;                              \
+                                                                            \
+        if (product > (hi))                                                 \
+            product = (hi);                                                 \
+        else if (product < (lo))                                            \
+            product = (lo);                                                 \
+                                                                            \
+        *pOut++ = (type)(product & (mask));                                 \
+    }                                                                       \
+}
+
+XA_BENCH_REFERENCE(WORD8, WORD32, (WORD8)0x80, (WORD8)0x7F, -1)
+XA_BENCH_REFERENCE(WORD16, WORD32, (WORD16)0x8000, (WORD16)0x7FFF, -1)
+XA_BENCH_REFERENCE(WORD24, WORD64, (WORD32)0x800000FF, (WORD32)0x7FFFFF00, 0xffffff00)
+XA_BENCH_REFERENCE(WORD32, WORD64, (WORD32)0x80000000, (WORD32)0x7FFFFFFF, -1)
+
+static void xa_bench_reference(xa_bench_t *b, void *output, UWORD32 gain_idx)
+{
+    UWORD32     n = b->size / (b->width == 24 ? 4 : b->width >> 3);
+
+    switch (b->width)
+    {
+    case 8:  xa_bench_reference_WORD8(output, b->input, n, pcm_gains[gain_idx]); break;
+    case 16: xa_bench_reference_WORD16(output, b->input, n, pcm_gains[gain_idx]); break;
+    case 24: xa_bench_reference_WORD24(output, b->input, n, pcm_gains[gain_idx]); break;
+    default: xa_bench_reference_WORD32(output, b->input, n, pcm_gains[gain_idx]); break;
+    }
+}
+
+/*******************************************************************************
+ * Plugin control
+ ******************************************************************************/
+
+static void xa_bench_create(xa_bench_t *b, UWORD32 width)
+{
+    WORD32      size, value;
+    UWORD32     i;
+
+    memset(b, 0, sizeof(*b));
+    b->width = width;
+
+    XA_BENCH_API(b, XA_API_CMD_GET_API_SIZE, 0, &size);
+    b->handle = malloc(size);
+    XA_BENCH_API(b, XA_API_CMD_INIT, XA_CMD_TYPE_INIT_API_PRE_CONFIG_PARAMS, NULL);
+
+    value = (WORD32)width;
+    XA_BENCH_API(b, XA_API_CMD_SET_CONFIG_PARAM, XA_PCM_GAIN_CONFIG_PARAM_PCM_WIDTH, &value);
+    value = XA_BENCH_CHANNELS;
+    XA_BENCH_API(b, XA_API_CMD_SET_CONFIG_PARAM, XA_PCM_GAIN_CONFIG_PARAM_CHANNELS, &value);
+    value = XA_BENCH_FRAME_SIZE;
+    XA_BENCH_API(b, XA_API_CMD_SET_CONFIG_PARAM, XA_PCM_GAIN_CONFIG_PARAM_FRAME_SIZE_IN_SAMPLES, &value);
+
+    XA_BENCH_API(b, XA_API_CMD_INIT, XA_CMD_TYPE_INIT_API_POST_CONFIG_PARAMS, NULL);
+    XA_BENCH_API(b, XA_API_CMD_GET_MEM_INFO_SIZE, 0, &size);
+    b->size = (UWORD32)size;
+
+    /* ...offset buffers by 4 bytes to exercise minimal guaranteed alignment */
+    b->input = (char *)malloc(size + 8) + 4;
+    b->output = (char *)malloc(size + 8) + 4;
+    b->ref = malloc(size);
+    b->scratch = malloc(size);
+
+    XA_BENCH_API(b, XA_API_CMD_SET_MEM_PTR, 0, b->input);
+    XA_BENCH_API(b, XA_API_CMD_SET_MEM_PTR, 1, b->output);
+    XA_BENCH_API(b, XA_API_CMD_SET_MEM_PTR, 2, b->scratch);
+    XA_BENCH_API(b, XA_API_CMD_INIT, XA_CMD_TYPE_INIT_PROCESS, NULL);
+
+    /* ...full-scale noise to hit saturation at positive gains */
+    for (i = 0; i < (UWORD32)size; i++)
+    {
+        ((UWORD8 *)b->input)[i] = (UWORD8)rand();
+    }
+
+    /* ...24-bit samples have lower byte cleared */
+    for (i = 0; width == 24 && i < (UWORD32)size / 4; i++)
+    {
+        ((WORD32 *)b->input)[i] &= 0xffffff00;
+    }
+}
+
+static void xa_bench_destroy(xa_bench_t *b)
+{
+    free((char *)b->input - 4);
+    free((char *)b->output - 4);
+    free(b->ref);
+    free(b->scratch);
+    free(b->handle);
+}
+
+static void xa_bench_set_gain(xa_bench_t *b, UWORD32 gain_idx)
+{
+    WORD32      value = (WORD32)gain_idx;
+
+    XA_BENCH_API(b, XA_API_CMD_SET_CONFIG_PARAM, XA_PCM_GAIN_CONFIG_PARAM_GAIN_FACTOR, &value);
+}
+
+static void xa_bench_execute(xa_bench_t *b)
+{
+    WORD32      value = (WORD32)b->size;
+
+    XA_BENCH_API(b, XA_API_CMD_SET_INPUT_BYTES, 0, &value);
+    XA_BENCH_API(b, XA_API_CMD_EXECUTE, XA_CMD_TYPE_DO_EXECUTE, NULL);
+    XA_BENCH_API(b, XA_API_CMD_GET_OUTPUT_BYTES, 1, &value);
+
+    if ((UWORD32)value != b->size)
+    {
+        fprintf(stderr, "%u-bit: produced %d bytes instead of %u\n", b->width, value, b->size);
+        exit(1);
+    }
+}
+
+/* ...read sample of the output buffer as 32-bit value */
+static WORD32 xa_bench_sample(xa_bench_t *b, void *buffer, UWORD32 i)
+{
+    switch (b->width)
+    {
+    case 8:  return ((WORD8 *)buffer)[i];
+    case 16: return ((WORD16 *)buffer)[i];
+    default: return ((WORD32 *)buffer)[i];
+    }
+}
+
+/*******************************************************************************
+ * Tests
+ ******************************************************************************/
+
+/* ...constant gain must be bit-exact with reference */
+static void xa_bench_verify(xa_bench_t *b)
+{
+    UWORD32     g;
+
+    for (g = 0; g < XA_BENCH_GAINS; g++)
+    {
+        /* ...first buffer after a change is ramped; compare the second one */
+        xa_bench_set_gain(b, g);
+        xa_bench_execute(b);
+        xa_bench_execute(b);
+        xa_bench_reference(b, b->ref, g);
+
+        if (memcmp(b->output, b->ref, b->size))
+        {
+            fprintf(stderr, "%u-bit: output mismatch at gain index %u\n", b->width, g);
+            exit(1);
+        }
+    }
+}
+
+/* ...gain change from 0dB to +18dB of constant signal must be monotonic */
+static void xa_bench_verify_ramp(xa_bench_t *b)
+{
+    UWORD32     i, n = b->size / (b->width == 24 ? 4 : b->width >> 3);
+    WORD32      prev, cur;
+
+    for (i = 0; i < n; i++)
+    {
+        switch (b->width)
+        {
+        case 8:  ((WORD8 *)b->input)[i] = 4; break;
+        case 16: ((WORD16 *)b->input)[i] = 1000; break;
+        default: ((WORD32 *)b->input)[i] = 1000 << 8; break;
+        }
+    }
+
+    xa_bench_set_gain(b, 0);
+    xa_bench_execute(b);
+    xa_bench_set_gain(b, 6);
+    xa_bench_execute(b);
+    xa_bench_reference(b, b->ref, 6);
+
+    for (i = 0, prev = xa_bench_sample(b, b->input, 0); i < n; i++, prev = cur)
+    {
+        cur = xa_bench_sample(b, b->output, i);
+
+        if (cur < prev)
+        {
+            fprintf(stderr, "%u-bit: gain ramp is not monotonic at sample %u\n", b->width, i);
+            exit(1);
+        }
+    }
+
+    if (xa_bench_sample(b, b->output, n - 1) != xa_bench_sample(b, b->ref, n - 1))
+    {
+        fprintf(stderr, "%u-bit: gain ramp did not reach the target\n", b->width);
+        exit(1);
+    }
+}
+
+/* ...return throughput in samples per tick */
+static double xa_bench_run(xa_bench_t *b, int reference)
+{
+    UWORD32         n = b->size / (b->width == 24 ? 4 : b->width >> 3);
+    unsigned long   t0, t1;
+    UWORD32         i;
+
+    xa_bench_set_gain(b, 4);
+    xa_bench_execute(b);
+
+    t0 = __xf_get_cycles();
+
+    for (i = 0; i < XA_BENCH_ITERATIONS; i++)
+    {
+        if (reference)
+            xa_bench_reference(b, b->ref, 4);
+        else
+            xa_bench_execute(b);
+    }
+
+    t1 = __xf_get_cycles();
+
+    return (double)n * XA_BENCH_ITERATIONS / (double)(t1 - t0);
+}
+
+int main(void)
+{
+    static const UWORD32    widths[] = { 8, 16, 24, 32 };
+    xa_bench_t              b;
+    double                  plugin, reference;
+    UWORD32                 i;
+
+    printf("%u channels x %u samples, tick = 1/%lu s\n", XA_BENCH_CHANNELS, XA_BENCH_FRAME_SIZE, __xf_get_cycles_freq());
+    printf("%8s %16s %16s %8s\n", "width", "samples/tick", "reference", "speedup");
+
+    for (i = 0; i < sizeof(widths) / sizeof(widths[0]); i++)
+    {
+        xa_bench_create(&b, widths[i]);
+        xa_bench_verify(&b);
+        plugin = xa_bench_run(&b, 0);
+        reference = xa_bench_run(&b, 1);
+        xa_bench_verify_ramp(&b);
+        xa_bench_destroy(&b);
+
+        printf("%8u %16.3f %16.3f %8.2f\n", widths[i], plugin, reference, plugin / reference);
+    }
+
+    return 0;
+}
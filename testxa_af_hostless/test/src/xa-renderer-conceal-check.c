@@ -0,0 +1,154 @@
+/*
+* Copyright (c) 2015-2021 Cadence Design Systems Inc.
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/*******************************************************************************
+ * xa-renderer-conceal-check.c
+ *
+ * DMA ring underrun concealment check
+ *
+ * Fills a ring with a known pattern and conceals the period after each
+ * possible playing period, including the one at the ring end, in every mode:
+ * - REPEAT (16-bit) holds the playing period scaled by a linear fade-out that
+ *   starts at full scale and ends close to silence;
+ * - SILENCE, and REPEAT with any other sample width, hold zeroes;
+ * - the playing period and all others are left untouched;
+ * - returned write position follows the concealed period, wrapping at the end.
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xa-renderer-conceal.h"
+
+/*******************************************************************************
+ * Local definitions
+ ******************************************************************************/
+
+/* ...abort with message */
+#define XA_CHECK(cond, ...)                                                 \
+do {                                                                        \
+    if (!(cond))                                                            \
+    {                                                                       \
+        fprintf(stderr, __VA_ARGS__);                                       \
+        fprintf(stderr, "\n");                                              \
+        exit(1);                                                            \
+    }                                                                       \
+} while (0)
+
+/* ...sample at given ring position; full-scale and of both signs */
+static inline WORD16 xa_check_sample(UWORD32 pos)
+{
+    return (WORD16)(pos & 1 ? -32768 + (WORD32)(pos % 7) : 32767 - (WORD32)(pos % 5));
+}
+
+/*******************************************************************************
+ * Check for one configuration
+ ******************************************************************************/
+
+static void xa_check_run(UWORD32 channels, UWORD32 frames, UWORD32 count, UWORD32 mode, UWORD32 pcm_width)
+{
+    UWORD32     period_bytes = frames * channels * sizeof(WORD16);
+    UWORD32     ring_bytes = period_bytes * count;
+    UWORD32     samples = ring_bytes / sizeof(WORD16);
+    UWORD32     period = period_bytes / sizeof(WORD16);
+    WORD16     *ring = malloc(ring_bytes);
+    UWORD32     p, next, i, f, c;
+    UWORD8     *w;
+    WORD32      gain, step = (0x7fff << 15) / frames;
+    WORD16      v, expect;
+    int         repeat = (mode == XA_RENDERER_UNDERRUN_REPEAT && pcm_width == 16);
+
+    XA_CHECK(ring != NULL, "out of memory");
+
+    for (p = 0; p < count; p++)
+    {
+        for (i = 0; i < samples; i++)
+            ring[i] = xa_check_sample(i);
+
+        next = (p + 1) % count;
+        w = xa_renderer_conceal((UWORD8 *)ring, ring_bytes, period_bytes,
+                                (UWORD8 *)(ring + p * period), mode, pcm_width, channels);
+
+        XA_CHECK(w == (UWORD8 *)(ring + ((next + 1) % count) * period),
+                 "ch %u periods %u: playing %u, write position %ld", channels, count, p, (long)(w - (UWORD8 *)ring));
+
+        /* ...everything but the concealed period is untouched, the playing one included */
+        for (i = 0; i < samples; i++)
+            if (i / period != next)
+                XA_CHECK(ring[i] == xa_check_sample(i), "ch %u periods %u: playing %u, sample %u overwritten", channels, count, p, i);
+
+        for (f = 0, gain = 0x7fff << 15; f < frames; f++, gain -= step)
+        {
+            for (c = 0; c < channels; c++)
+            {
+                v = ring[next * period + f * channels + c];
+                expect = (repeat ? (WORD16)(((WORD32)xa_check_sample(p * period + f * channels + c) * (gain >> 15)) >> 15) : 0);
+
+                XA_CHECK(v == expect, "mode %u width %u ch %u: frame %u channel %u is %d, expected %d", mode, pcm_width, channels, f, c, v, expect);
+            }
+        }
+
+        if (!repeat)
+            continue;
+
+        /* ...fade starts at full scale and ends close to silence */
+        v = ring[next * period];
+        XA_CHECK(abs(v) >= 32700, "ch %u: faded period starts at %d", channels, v);
+
+        for (c = 0; c < channels; c++)
+        {
+            v = ring[next * period + (frames - 1) * channels + c];
+            XA_CHECK(abs(v) * frames <= 2 * 32768, "ch %u frames %u: faded period ends at %d", channels, frames, v);
+        }
+    }
+
+    free(ring);
+}
+
+/*******************************************************************************
+ * Entry point
+ ******************************************************************************/
+
+int main(void)
+{
+    /* ...channels, frames per period, periods in ring */
+    static const UWORD32    cfg[][3] = {
+        { 2, 256, 3 },
+        { 1, 160, 4 },
+        { 8, 64, 3 },
+        { 2, 1, 3 },
+        { 6, 1000, 5 },
+    };
+    UWORD32     i;
+
+    for (i = 0; i < sizeof(cfg) / sizeof(cfg[0]); i++)
+    {
+        xa_check_run(cfg[i][0], cfg[i][1], cfg[i][2], XA_RENDERER_UNDERRUN_REPEAT, 16);
+        xa_check_run(cfg[i][0], cfg[i][1], cfg[i][2], XA_RENDERER_UNDERRUN_REPEAT, 24);
+        xa_check_run(cfg[i][0], cfg[i][1], cfg[i][2], XA_RENDERER_UNDERRUN_SILENCE, 16);
+    }
+
+    printf("underrun concealment: faded repeat and silence written after playing period, %u configurations\n", i);
+
+    return 0;
+}
@@ -0,0 +1,212 @@
+/*
+* Copyright (c) 2015-2021 Cadence Design Systems Inc.
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/*******************************************************************************
+ * xaf-emu-smoke.c
+ *
+ * Host-native build smoke test
+ *
+ * Opens the audio device against the in-process DSP emulator, makes a
+ * round-trip to the DSP core through the IPC rings, creates a component with
+ * more input buffers than the basic configuration allows, checks the mixer
+ * track limit, and closes the device again. Repeated a few times so that emulator teardown is covered as
+ * well.
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xaf-api.h"
+
+/*******************************************************************************
+ * Local definitions
+ ******************************************************************************/
+
+#define XAF_SMOKE_ITERATIONS            3
+
+/* ...abort on API failure */
+#define XAF_SMOKE_API(cmd)                                                  \
+do {                                                                        \
+    XAF_ERR_CODE __e = (cmd);                                               \
+    if (__e != XAF_NO_ERR)                                                  \
+    {                                                                       \
+        fprintf(stderr, "%s failed: %d\n", #cmd, __e);                      \
+        exit(1);                                                            \
+    }                                                                       \
+} while (0)
+
+static pVOID xaf_smoke_malloc(mem_obj_t *mem_obj, WORD32 size, WORD32 id)
+{
+    return malloc(size);
+}
+
+static VOID xaf_smoke_free(mem_obj_t *mem_obj, pVOID ptr, WORD32 id)
+{
+    free(ptr);
+}
+
+/* ...abort unless API call fails with given error */
+#define XAF_SMOKE_API_ERR(cmd, err)                                         \
+do {                                                                        \
+    XAF_ERR_CODE __e = (cmd);                                               \
+    if (__e != (err))                                                       \
+    {                                                                       \
+        fprintf(stderr, "%s returned %d, expected %d\n", #cmd, __e, (err)); \
+        exit(1);                                                            \
+    }                                                                       \
+} while (0)
+
+/*******************************************************************************
+ * Input buffers configuration
+ ******************************************************************************/
+
+#define XAF_SMOKE_INBUF_SIZE            6000
+
+static void xaf_smoke_inbufs(pVOID adev)
+{
+    xaf_comp_config_t       config;
+    xaf_comp_config_ext_t   config_ext;
+    pVOID                   inbuf[XAF_MAX_INBUFS_EXT + 1];
+    pVOID                   comp;
+    UWORD32                 i, j;
+
+    XAF_SMOKE_API(xaf_comp_config_default_init(&config));
+
+    /* ...basic configuration is limited to XAF_MAX_INBUFS buffers */
+    config.num_input_buffers = XAF_MAX_INBUFS + 1;
+    config.pp_inbuf = (pVOID (*)[XAF_MAX_INBUFS])inbuf;
+    XAF_SMOKE_API_ERR(xaf_comp_create(adev, &comp, &config), XAF_INVALIDVAL_ERR);
+
+    /* ...extended one must be at least as large as its first release */
+    XAF_SMOKE_API_ERR(xaf_comp_config_ext_default_init(&config_ext, sizeof(UWORD32)), XAF_INVALIDVAL_ERR);
+    XAF_SMOKE_API(xaf_comp_config_ext_default_init(&config_ext, sizeof(config_ext)));
+
+    config_ext.num_input_buffers = XAF_MAX_INBUFS_EXT + 1;
+    config_ext.pp_inbuf = inbuf;
+    XAF_SMOKE_API_ERR(xaf_comp_create_ext(adev, &comp, &config, &config_ext), XAF_INVALIDVAL_ERR);
+
+    /* ...largest allowed set of non-default size buffers */
+    memset(inbuf, 0, sizeof(inbuf));
+    config_ext.num_input_buffers = XAF_MAX_INBUFS_EXT;
+    config_ext.input_buffer_size = XAF_SMOKE_INBUF_SIZE;
+    XAF_SMOKE_API(xaf_comp_create_ext(adev, &comp, &config, &config_ext));
+
+    for (i = 0; i < XAF_MAX_INBUFS_EXT; i++)
+    {
+        for (j = 0; j < i; j++)
+            if (inbuf[i] == NULL || inbuf[i] == inbuf[j])
+                break;
+
+        if (j < i || inbuf[i] == NULL)
+        {
+            fprintf(stderr, "input buffer %u not allocated\n", i);
+            exit(1);
+        }
+
+        /* ...buffer must be usable in its full size */
+        memset(inbuf[i], (int)i, XAF_SMOKE_INBUF_SIZE);
+    }
+
+    if (inbuf[XAF_MAX_INBUFS_EXT] != NULL)
+    {
+        fprintf(stderr, "input buffer array overrun\n");
+        exit(1);
+    }
+
+    XAF_SMOKE_API(xaf_comp_delete(comp));
+}
+
+/*******************************************************************************
+ * Mixer track limit
+ ******************************************************************************/
+
+static void xaf_smoke_mixer_tracks(pVOID adev)
+{
+    xaf_comp_config_t       config;
+    xaf_comp_config_ext_t   config_ext;
+    pVOID                   inbuf[XAF_MAX_INBUFS];
+    pVOID                   comp;
+
+    XAF_SMOKE_API(xaf_comp_config_default_init(&config));
+    config.comp_id = "mixer";
+    config.comp_type = XAF_MIXER;
+
+    XAF_SMOKE_API(xaf_comp_config_ext_default_init(&config_ext, sizeof(config_ext)));
+    config_ext.pp_inbuf = inbuf;
+
+    /* ...one track more than built in is refused */
+    config_ext.num_input_ports = XA_MIXER_MAX_TRACK_NUMBER + 1;
+    XAF_SMOKE_API_ERR(xaf_comp_create_ext(adev, &comp, &config, &config_ext), XAF_INVALIDVAL_ERR);
+
+    config_ext.num_input_ports = XA_MIXER_MAX_TRACK_NUMBER;
+    XAF_SMOKE_API(xaf_comp_create_ext(adev, &comp, &config, &config_ext));
+    XAF_SMOKE_API(xaf_comp_delete(comp));
+
+    /* ...application built before the field existed does not request tracks */
+    config_ext.config_size = offsetof(xaf_comp_config_ext_t, num_input_ports);
+    config_ext.num_input_ports = XA_MIXER_MAX_TRACK_NUMBER + 1;
+    XAF_SMOKE_API(xaf_comp_create_ext(adev, &comp, &config, &config_ext));
+    XAF_SMOKE_API(xaf_comp_delete(comp));
+}
+
+/*******************************************************************************
+ * Entry point
+ ******************************************************************************/
+
+int main(void)
+{
+    xaf_adev_config_t   config;
+    xaf_mem_stats_t     stats;
+    pVOID               adev;
+    int                 i;
+
+    for (i = 0; i < XAF_SMOKE_ITERATIONS; i++)
+    {
+        XAF_SMOKE_API(xaf_adev_config_default_init(&config));
+        config.pmem_malloc = xaf_smoke_malloc;
+        config.pmem_free = xaf_smoke_free;
+
+        XAF_SMOKE_API(xaf_adev_open(&adev, &config));
+
+        /* ...statistics come from DSP core; response travels the emulator ring */
+        memset(&stats, 0, sizeof(stats));
+        XAF_SMOKE_API(xaf_get_mem_stats_ext(adev, &stats));
+
+        if (stats.local.size == 0 || stats.shared.size == 0)
+        {
+            fprintf(stderr, "empty DSP memory statistics\n");
+            return 1;
+        }
+
+        xaf_smoke_inbufs(adev);
+        xaf_smoke_mixer_tracks(adev);
+
+        XAF_SMOKE_API(xaf_adev_close(adev, XAF_ADEV_NORMAL_CLOSE));
+    }
+
+    printf("emulated DSP opened and closed %d times (local pool %u, shared pool %u bytes), %d input buffers of %d bytes\n",
+           XAF_SMOKE_ITERATIONS, stats.local.size, stats.shared.size, XAF_MAX_INBUFS_EXT, XAF_SMOKE_INBUF_SIZE);
+
+    return 0;
+}
@@ -967,7 +967,7 @@ int main_task(int argc, char **argv)
     TST_CHK_API(xaf_comp_process(p_adev, p_comp[XA_MIXER0], NULL, 0, XAF_START_FLAG), "xaf_comp_process");
     TST_CHK_API(xaf_comp_get_status(p_adev, p_comp[XA_MIXER0], &comp_status, &dec_info[0]), "xaf_comp_get_status");
 
-    TST_CHK_API(xaf_connect(p_comp[XA_MIXER0], 4, p_comp[XA_MIMO12_0], 0, 4), "xaf_connect"); 
+    TST_CHK_API(xaf_connect(p_comp[XA_MIXER0], XA_MIXER_MAX_TRACK_NUMBER, p_comp[XA_MIMO12_0], 0, 4), "xaf_connect"); 
     TST_CHK_API(xaf_comp_process(p_adev, p_comp[XA_MIMO12_0], NULL, 0, XAF_START_FLAG), "xaf_comp_process");
     TST_CHK_API(xaf_comp_get_status(p_adev, p_comp[XA_MIMO12_0], &comp_status, &dec_info[0]), "xaf_comp_get_status");
 
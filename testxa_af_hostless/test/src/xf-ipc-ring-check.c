@@ -0,0 +1,274 @@
+/*
+* Copyright (c) 2015-2021 Cadence Design Systems Inc.
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/*******************************************************************************
+ * xf-ipc-ring-check.c
+ *
+ * Host IPC response ring check
+ *
+ * Drives the single-producer/single-consumer response ring of the host build
+ * through its component API:
+ * - consumer sleeps on an empty ring and is woken by the doorbell eventfd;
+ * - producer sleeps on a full ring and is woken by the "space" eventfd;
+ * - multi-ring wait times out when idle and wakes on a response;
+ * - a long stream with both sides stalling now and then arrives in order.
+ * The sleep flags are observed directly, so each wake-up path is known to
+ * have been taken rather than bypassed by a lucky re-check.
+ ******************************************************************************/
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "xf.h"
+
+/*******************************************************************************
+ * Local definitions
+ ******************************************************************************/
+
+#define XF_CHECK_STREAM_ITEMS           200000
+
+/* ...abort with message */
+#define XF_CHECK(cond, ...)                                                 \
+do {                                                                        \
+    if (!(cond))                                                            \
+    {                                                                       \
+        fprintf(stderr, __VA_ARGS__);                                       \
+        fprintf(stderr, "\n");                                              \
+        exit(1);                                                            \
+    }                                                                       \
+} while (0)
+
+typedef struct xf_check_thread {
+    xf_ipc_data_t      *ipc;
+    UWORD32             count;
+    UWORD32             value;
+    volatile int        done;
+    int                 ret;
+
+} xf_check_thread_t;
+
+/* ...wait until side of the ring announces its sleep (up to one second) */
+static void xf_check_sleeping(UWORD32 *flag, const char *what)
+{
+    int     i;
+
+    for (i = 0; i < 1000; i++)
+    {
+        if (__atomic_load_n(flag, __ATOMIC_ACQUIRE))
+            return;
+
+        usleep(1000);
+    }
+
+    XF_CHECK(0, "%s did not go to sleep", what);
+}
+
+/* ...wait until woken thread completes (up to one second) */
+static void xf_check_woken(xf_check_thread_t *t, pthread_t thread, const char *what)
+{
+    int     i;
+
+    for (i = 0; i < 1000 && !t->done; i++)
+        usleep(1000);
+
+    XF_CHECK(t->done, "%s was not woken", what);
+    pthread_join(thread, NULL);
+
+    XF_CHECK(t->ret == 0, "%s woken with %d", what, t->ret);
+}
+
+static void xf_check_put(xf_ipc_data_t *ipc, UWORD32 value)
+{
+    xf_user_msg_t   msg;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.id = value;
+
+    XF_CHECK(xf_ipc_response_put(ipc, &msg) == 0, "put %u failed", value);
+}
+
+static UWORD32 xf_check_get(xf_ipc_data_t *ipc)
+{
+    xf_user_msg_t   msg;
+
+    XF_CHECK(xf_ipc_response_get(ipc, &msg) == 0, "get failed");
+
+    return msg.id;
+}
+
+/*******************************************************************************
+ * Threads
+ ******************************************************************************/
+
+static void * xf_check_consumer(void *arg)
+{
+    xf_check_thread_t  *t = arg;
+    xf_user_msg_t       msg;
+    UWORD32             i;
+
+    for (i = 0; i < t->count; i++)
+    {
+        if ((t->ret = xf_ipc_response_get(t->ipc, &msg)) != 0)
+            break;
+
+        /* ...stream must arrive in order */
+        if (msg.id != t->value + i)
+        {
+            t->ret = -EINVAL;
+            break;
+        }
+
+        /* ...stall now and then so that producer fills the ring */
+        if ((i & 0x3fff) == 0x3fff)
+            usleep(200);
+    }
+
+    t->done = 1;
+
+    return NULL;
+}
+
+static void * xf_check_producer(void *arg)
+{
+    xf_check_thread_t  *t = arg;
+    UWORD32             i;
+
+    for (i = 0; i < t->count; i++)
+    {
+        xf_user_msg_t   msg;
+
+        memset(&msg, 0, sizeof(msg));
+        msg.id = t->value + i;
+
+        if ((t->ret = xf_ipc_response_put(t->ipc, &msg)) != 0)
+            break;
+
+        /* ...stall now and then so that consumer drains the ring */
+        if ((i & 0x3fff) == 0x2000)
+            usleep(200);
+    }
+
+    t->done = 1;
+
+    return NULL;
+}
+
+/*******************************************************************************
+ * Checks
+ ******************************************************************************/
+
+/* ...consumer sleeps on empty ring, doorbell wakes it */
+static void xf_check_empty(xf_ipc_data_t *ipc)
+{
+    xf_check_thread_t   t = { .ipc = ipc, .count = 1, .value = 0x1234 };
+    pthread_t           thread;
+
+    XF_CHECK(pthread_create(&thread, NULL, xf_check_consumer, &t) == 0, "thread create failed");
+
+    xf_check_sleeping(&ipc->ring.waiting, "consumer");
+    XF_CHECK(!t.done, "consumer returned from empty ring");
+
+    xf_check_put(ipc, 0x1234);
+    xf_check_woken(&t, thread, "consumer");
+}
+
+/* ...producer sleeps on full ring, space eventfd wakes it */
+static void xf_check_full(xf_ipc_data_t *ipc)
+{
+    xf_check_thread_t   t = { .ipc = ipc, .count = 1, .value = XF_IPC_RING_ENTRIES };
+    pthread_t           thread;
+    UWORD32             i;
+
+    for (i = 0; i < XF_IPC_RING_ENTRIES; i++)
+        xf_check_put(ipc, i);
+
+    XF_CHECK(pthread_create(&thread, NULL, xf_check_producer, &t) == 0, "thread create failed");
+
+    xf_check_sleeping(&ipc->ring.full_waiting, "producer");
+    XF_CHECK(!t.done, "producer returned from full ring");
+
+    /* ...taking one item makes room for the sleeping producer */
+    XF_CHECK(xf_check_get(ipc) == 0, "ring head lost");
+    xf_check_woken(&t, thread, "producer");
+
+    for (i = 1; i <= XF_IPC_RING_ENTRIES; i++)
+        XF_CHECK(xf_check_get(ipc) == i, "item %u out of order", i);
+}
+
+/* ...multi-ring wait times out when idle and wakes on response to any ring */
+static void xf_check_wait_any(xf_ipc_data_t *ipc, xf_ipc_data_t *idle)
+{
+    xf_ipc_data_t      *set[2] = { idle, ipc };
+    xf_check_thread_t   t = { .ipc = ipc, .count = 1, .value = 7 };
+    pthread_t           thread;
+
+    XF_CHECK(xf_ipc_response_wait_any(set, 2, 10) == -ETIMEDOUT, "idle wait did not time out");
+
+    XF_CHECK(pthread_create(&thread, NULL, xf_check_producer, &t) == 0, "thread create failed");
+    XF_CHECK(xf_ipc_response_wait_any(set, 2, 1000) == 0, "wait on response failed");
+    pthread_join(thread, NULL);
+
+    XF_CHECK(xf_check_get(ipc) == 7, "wrong response");
+}
+
+/* ...long stream in order across both sleep paths */
+static void xf_check_stream(xf_ipc_data_t *ipc)
+{
+    xf_check_thread_t   p = { .ipc = ipc, .count = XF_CHECK_STREAM_ITEMS, .value = 1000 };
+    xf_check_thread_t   c = { .ipc = ipc, .count = XF_CHECK_STREAM_ITEMS, .value = 1000 };
+    pthread_t           tp, tc;
+
+    XF_CHECK(pthread_create(&tc, NULL, xf_check_consumer, &c) == 0, "thread create failed");
+    XF_CHECK(pthread_create(&tp, NULL, xf_check_producer, &p) == 0, "thread create failed");
+
+    pthread_join(tp, NULL);
+    pthread_join(tc, NULL);
+
+    XF_CHECK(p.ret == 0 && c.ret == 0, "stream failed: producer %d, consumer %d", p.ret, c.ret);
+}
+
+/*******************************************************************************
+ * Entry point
+ ******************************************************************************/
+
+int main(void)
+{
+    xf_ipc_data_t   ipc, idle;
+
+    XF_CHECK(xf_ipc_data_init(&ipc) == 0 && xf_ipc_data_init(&idle) == 0, "ring init failed");
+
+    xf_check_empty(&ipc);
+    xf_check_full(&ipc);
+    xf_check_wait_any(&ipc, &idle);
+    xf_check_stream(&ipc);
+
+    xf_ipc_data_destroy(&idle);
+    xf_ipc_data_destroy(&ipc);
+
+    printf("response ring: empty/full sleep and wake-up, %u items streamed in order\n", XF_CHECK_STREAM_ITEMS);
+
+    return 0;
+}
@@ -0,0 +1,193 @@
+/*
+* Copyright (c) 2015-2021 Cadence Design Systems Inc.
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/*******************************************************************************
+ * xf-sched-bench.c
+ *
+ * Scheduler micro-benchmark (host build only)
+ *
+ * Emulates 1..64 active components, each rescheduling itself after execution
+ * either immediately (dts = 0) or after a frame duration, and measures average
+ * cost of put/get pair. Ordering (EDF, FIFO for equal timestamps) and cancel
+ * contract are verified along the way. Build with -DXF_CFG_SCHED_WHEEL=1 to
+ * measure the timing-wheel scheduler instead of rb-tree.
+ ******************************************************************************/
+
+#define MODULE_TAG                      SCHED_BENCH
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "xf-dp.h"
+
+/*******************************************************************************
+ * Local definitions
+ ******************************************************************************/
+
+#define XF_BENCH_MAX_TASKS              64
+#define XF_BENCH_ITERATIONS             2000000
+
+/* ...1ms in timebase ticks */
+#define XF_BENCH_MS                     ((UWORD32)(XF_TIMEBASE_FREQ / 1000))
+
+typedef struct xf_bench_task {
+    /* ...scheduler node (must be first) */
+    xf_task_t       task;
+
+    /* ...rescheduling period */
+    UWORD32         dts;
+
+    /* ...insertion sequence number */
+    UWORD32         seq;
+
+} xf_bench_task_t;
+
+/* ...interrupt masking emulation lock (normally provided by xf-core.c) */
+pthread_mutex_t         __xf_isr_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* ...DSP object holding core local pool (timing wheel buckets live there) */
+static xf_dsp_t         dsp;
+xf_dsp_t               *xf_g_dsp = &dsp;
+static UWORD8           xf_bench_pool[4096] __attribute__((aligned(XF_PROXY_ALIGNMENT)));
+
+static xf_sched_t       sched;
+static xf_bench_task_t  tasks[XF_BENCH_MAX_TASKS];
+
+/* ...frame durations of emulated components (0 = data-driven component) */
+static const UWORD32    xf_bench_dts[] = {
+    0, 1 * XF_BENCH_MS, 0, 2 * XF_BENCH_MS, 0, 5 * XF_BENCH_MS / 2, 0, 10 * XF_BENCH_MS, 0, 40 * XF_BENCH_MS,
+};
+
+static UWORD64 xf_bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (UWORD64)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* ...run one configuration; returns average put/get cost in ns */
+static double xf_bench_run(UWORD32 num)
+{
+    xf_bench_task_t    *t;
+    UWORD32             seq = 0, last_ts = 0, last_seq = 0;
+    UWORD32             i;
+    UWORD64             t0, t1;
+
+    if (xf_sched_init(&sched, 0) != 0)
+    {
+        fprintf(stderr, "scheduler init failed\n");
+        exit(1);
+    }
+    memset(tasks, 0, sizeof(tasks));
+
+    for (i = 0; i < num; i++)
+    {
+        tasks[i].dts = xf_bench_dts[i % (sizeof(xf_bench_dts) / sizeof(xf_bench_dts[0]))];
+        tasks[i].seq = seq++;
+        xf_sched_put(&sched, &tasks[i].task, 0);
+    }
+
+    t0 = xf_bench_now();
+
+    for (i = 0; i < XF_BENCH_ITERATIONS; i++)
+    {
+        t = (xf_bench_task_t *)xf_sched_get(&sched);
+
+        /* ...verify ordering: timestamps never decrease, FIFO for equal ones */
+        if (!t || xf_timestamp_before(xf_task_timestamp(&t->task), last_ts) ||
+            (i && xf_task_timestamp(&t->task) == last_ts && t->seq < last_seq))
+        {
+            fprintf(stderr, "ordering violation at iteration %u\n", i);
+            exit(1);
+        }
+
+        last_ts = xf_task_timestamp(&t->task), last_seq = t->seq;
+
+        /* ...not scheduled task cannot be cancelled */
+        if ((i & 1023) == 0 && xf_sched_cancel(&sched, &t->task) != 1)
+        {
+            fprintf(stderr, "cancel of idle task succeeded\n");
+            exit(1);
+        }
+
+        t->seq = seq++;
+        xf_sched_put(&sched, &t->task, t->dts);
+
+        /* ...occasionally cancel and reschedule scheduled task */
+        if ((i & 1023) == 512)
+        {
+            if (xf_sched_cancel(&sched, &t->task) != 0)
+            {
+                fprintf(stderr, "cancel of scheduled task failed\n");
+                exit(1);
+            }
+
+            t->seq = seq++;
+            xf_sched_put(&sched, &t->task, t->dts);
+        }
+    }
+
+    t1 = xf_bench_now();
+
+    /* ...drain the scheduler */
+    for (i = 0; i < num; i++)
+    {
+        if (xf_sched_get(&sched) == NULL)
+        {
+            fprintf(stderr, "task lost\n");
+            exit(1);
+        }
+    }
+
+    if (xf_sched_get(&sched) != NULL)
+    {
+        fprintf(stderr, "spurious task\n");
+        exit(1);
+    }
+
+    xf_sched_deinit(&sched, 0);
+
+    return (double)(t1 - t0) / XF_BENCH_ITERATIONS;
+}
+
+int main(void)
+{
+    UWORD32     num;
+
+    if (xf_mm_init(&dsp.xf_core_data[0].local_pool, xf_bench_pool, sizeof(xf_bench_pool)) != 0)
+    {
+        fprintf(stderr, "pool init failed\n");
+        return 1;
+    }
+
+    printf("scheduler: %s\n", XF_CFG_SCHED_WHEEL ? "timing wheel" : "rb-tree");
+    printf("%8s %12s\n", "tasks", "ns/put+get");
+
+    for (num = 1; num <= XF_BENCH_MAX_TASKS; num <<= 1)
+    {
+        printf("%8u %12.1f\n", num, xf_bench_run(num));
+    }
+
+    return 0;
+}
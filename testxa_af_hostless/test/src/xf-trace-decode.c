@@ -0,0 +1,199 @@
+/*
+* Copyright (c) 2015-2021 Cadence Design Systems Inc.
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/*******************************************************************************
+ * xf-trace-decode.c
+ *
+ * Converts binary event trace written by xaf_trace_start()/xaf_trace_stop()
+ * into Chrome trace-event JSON loadable by chrome://tracing or Perfetto UI.
+ *
+ * Component execution is shown as a slice on a track of the component
+ * (process = DSP core, thread = client); message dispatch, scheduling, port
+ * and interrupt events are shown as instant events on the same tracks.
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xaf-api.h"
+
+/*******************************************************************************
+ * Local definitions
+ ******************************************************************************/
+
+/* ...component identifier layout (see __XF_PORT_SPEC) */
+#define PORT_CORE(spec)                 ((spec) & 0x3)
+#define PORT_CLIENT(spec)               (((spec) >> 2) & 0x3F)
+
+/* ...destination of message identifier (see __XF_MSG_ID) */
+#define MSG_DST(id)                     (((id) >> 16) & 0xFFFF)
+
+static const char *xf_decode_event[XAF_TRACE_EV_NUM] = {
+    [XAF_TRACE_EV_DISPATCH]         = "dispatch",
+    [XAF_TRACE_EV_PROCESS_START]    = "process",
+    [XAF_TRACE_EV_PROCESS_END]      = "process",
+    [XAF_TRACE_EV_SCHEDULE]         = "schedule",
+    [XAF_TRACE_EV_PORT_FILL]        = "port-fill",
+    [XAF_TRACE_EV_PORT_PRODUCE]     = "port-produce",
+    [XAF_TRACE_EV_IRQ]              = "irq",
+};
+
+/* ...message opcode types (see xf-dp_opcode.h) */
+static const char *xf_decode_opcode[] = {
+    "UNREGISTER", "REGISTER", "ROUTE", "UNROUTE", "ALLOC", "FREE", "SET_PARAM", "GET_PARAM",
+    "EMPTY_THIS_BUFFER", "FILL_THIS_BUFFER", "FLUSH", "START", "STOP", "PAUSE", "RESUME",
+    "SET_PARAM_EXT", "GET_PARAM_EXT", "SET_PRIORITIES", "EVENT_CHANNEL_CREATE",
+    "EVENT_CHANNEL_DELETE", "EVENT", "SUSPEND", "SUSPEND_RESUME", "GET_MEM_STATS", "GET_PROFILE",
+};
+
+static const char *xf_decode_opcode_name(UWORD32 op)
+{
+    return (op < sizeof(xf_decode_opcode) / sizeof(xf_decode_opcode[0]) ? xf_decode_opcode[op] : "UNKNOWN");
+}
+
+int main(int argc, char **argv)
+{
+    xaf_trace_file_hdr_t    hdr;
+    xaf_trace_event_t       ev;
+    FILE                   *in, *out;
+    UWORD64                 ts = 0;
+    UWORD32                 last = 0, n = 0, spec;
+    double                  us;
+    int                     first = 1;
+
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <trace.bin> [trace.json]\n", argv[0]);
+        return 1;
+    }
+
+    if ((in = fopen(argv[1], "rb")) == NULL)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+
+    if (fread(&hdr, sizeof(hdr), 1, in) != 1 || hdr.magic != XAF_TRACE_FILE_MAGIC ||
+        hdr.version != XAF_TRACE_FILE_VERSION || hdr.event_size != sizeof(ev) || hdr.clock_freq == 0)
+    {
+        fprintf(stderr, "%s: not a trace file\n", argv[1]);
+        return 1;
+    }
+
+    if (argc < 3)
+    {
+        out = stdout;
+    }
+    else if ((out = fopen(argv[2], "w")) == NULL)
+    {
+        perror(argv[2]);
+        return 1;
+    }
+
+    fprintf(out, "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"clock_freq\":%u,\"dropped\":%u},\"traceEvents\":[\n",
+            hdr.clock_freq, hdr.dropped);
+
+    while (fread(&ev, sizeof(ev), 1, in) == 1)
+    {
+        /* ...extend 32-bit timestamps; records may be slightly out of order */
+        if (first)
+        {
+            first = 0;
+        }
+        else
+        {
+            ts += (WORD64)(WORD32)(ev.ts - last);
+        }
+
+        last = ev.ts, n++;
+        us = (double)(WORD64)ts * 1e6 / hdr.clock_freq;
+
+        if (ev.type >= XAF_TRACE_EV_NUM)
+        {
+            continue;
+        }
+
+        /* ...component identifier of the event track */
+        switch (ev.type)
+        {
+        case XAF_TRACE_EV_PROCESS_START:
+        case XAF_TRACE_EV_PROCESS_END:
+        case XAF_TRACE_EV_SCHEDULE:
+            spec = ev.id;
+            break;
+
+        default:
+            spec = MSG_DST(ev.id);
+        }
+
+        fprintf(out, "%s{\"name\":\"%s\",\"cat\":\"xaf\",\"ts\":%.3f,\"pid\":%u,\"tid\":%u,",
+                (n > 1 ? ",\n" : ""), xf_decode_event[ev.type], us, PORT_CORE(spec), PORT_CLIENT(spec));
+
+        switch (ev.type)
+        {
+        case XAF_TRACE_EV_PROCESS_START:
+            fprintf(out, "\"ph\":\"B\"}");
+            break;
+
+        case XAF_TRACE_EV_PROCESS_END:
+            fprintf(out, "\"ph\":\"E\",\"args\":{\"result\":%d}}", (WORD32)ev.arg);
+            break;
+
+        case XAF_TRACE_EV_SCHEDULE:
+            fprintf(out, "\"ph\":\"i\",\"s\":\"t\",\"args\":{\"dts\":%u}}", ev.arg);
+            break;
+
+        case XAF_TRACE_EV_PORT_FILL:
+            fprintf(out, "\"ph\":\"i\",\"s\":\"t\",\"args\":{\"id\":\"0x%08x\",\"bytes\":%u,\"in_place\":%u}}", ev.id, ev.arg, ev.opcode);
+            break;
+
+        case XAF_TRACE_EV_PORT_PRODUCE:
+            fprintf(out, "\"ph\":\"i\",\"s\":\"t\",\"args\":{\"id\":\"0x%08x\",\"bytes\":%u}}", ev.id, ev.arg);
+            break;
+
+        default:
+            fprintf(out, "\"ph\":\"i\",\"s\":\"t\",\"args\":{\"id\":\"0x%08x\",\"opcode\":\"%s\",\"length\":%u}}",
+                    ev.id, xf_decode_opcode_name(ev.opcode), ev.arg);
+        }
+    }
+
+    fprintf(out, "\n]}\n");
+
+    if (n != hdr.events)
+    {
+        fprintf(stderr, "warning: %u records read, %u expected\n", n, hdr.events);
+    }
+
+    if (hdr.dropped)
+    {
+        fprintf(stderr, "warning: %u records were dropped by DSP\n", hdr.dropped);
+    }
+
+    fclose(in);
+    if (out != stdout)
+    {
+        fclose(out);
+    }
+
+    return 0;
+}
@@ -0,0 +1,338 @@
+/*
+* Copyright (c) 2015-2021 Cadence Design Systems Inc.
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/*******************************************************************************
+ * xtlib-prelink-check.c
+ *
+ * Pre-linked library image check (host build only)
+ *
+ * Builds a small split-load PI library image, pre-links it and loads it at
+ * various code/data buffer addresses (matching and not matching the pre-link
+ * address, unaligned, shared code). Every load is compared with the regular
+ * path: segments and pil_info as produced by the host PI loader
+ * (library_load.c), followed by R_XTENSA_RELATIVE relocation as done by
+ * xtlib_relocate_pi_lib() on DSP. Images and pil_info must be identical,
+ * except rela_count which is zero for pre-linked images.
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <elf.h>
+
+#include "library_prelink.h"
+
+/*******************************************************************************
+ * Local definitions
+ ******************************************************************************/
+
+#define XT_CHECK_IMAGE_SIZE             0x600
+#define XT_CHECK_ALIGN                  16
+#define XT_CHECK_CODE_SIZE              0x100
+#define XT_CHECK_DATA_OFFS              0x400
+#define XT_CHECK_DATA_FILESZ            0x200
+#define XT_CHECK_DATA_MEMSZ             0x280
+#define XT_CHECK_RELA_ADDR              0x500
+#define XT_CHECK_PRELINK_ADDR           0x20000000
+
+#ifndef R_XTENSA_SLOT0_OP
+#define R_XTENSA_SLOT0_OP               20
+#endif
+
+/* ...DSP buffers emulation */
+#define XT_CHECK_CODE_BUF               (XT_CHECK_CODE_SIZE + XT_CHECK_ALIGN)
+#define XT_CHECK_DATA_BUF               (XT_CHECK_DATA_OFFS + XT_CHECK_DATA_MEMSZ + XT_CHECK_ALIGN)
+
+typedef struct xt_check_buf {
+    unsigned char   code[XT_CHECK_CODE_BUF];
+    unsigned char   data[XT_CHECK_DATA_BUF];
+    uint32_t        pil_info[XTLIB_PRELINK_PIL_WORDS];
+
+} xt_check_buf_t;
+
+static unsigned char    image[XT_CHECK_IMAGE_SIZE];
+
+/* ...little-endian word access */
+static uint32_t xt_get(const unsigned char *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void xt_put(unsigned char *p, uint32_t v)
+{
+    p[0] = v, p[1] = v >> 8, p[2] = v >> 16, p[3] = v >> 24;
+}
+
+static uint32_t xt_align(uint32_t addr)
+{
+    return (addr + XT_CHECK_ALIGN - 1) & ~(XT_CHECK_ALIGN - 1);
+}
+
+/*******************************************************************************
+ * Library image
+ ******************************************************************************/
+
+/* ...build library; code relocations make code non-shareable */
+static void xt_check_image(int code_relocs, uint32_t r_type)
+{
+    Elf32_Ehdr     *eh = (Elf32_Ehdr *)image;
+    Elf32_Phdr     *ph = (Elf32_Phdr *)(image + sizeof(*eh));
+    Elf32_Shdr     *sh = (Elf32_Shdr *)(image + 0x560);
+    Elf32_Dyn      *dyn = (Elf32_Dyn *)(image + 0x500);
+    unsigned char  *code = image + 0x100, *data = image + 0x200;
+    Elf32_Rela      rela[8];
+    uint32_t        n = 0, i;
+
+    memset(image, 0, sizeof(image));
+
+    memcpy(eh->e_ident, ELFMAG, SELFMAG);
+    eh->e_ident[EI_CLASS] = ELFCLASS32;
+    eh->e_ident[EI_DATA] = ELFDATA2LSB;
+    eh->e_type = ET_DYN;
+    eh->e_entry = 0x20;
+    eh->e_phoff = sizeof(*eh);
+    eh->e_phnum = 3;
+    eh->e_shoff = 0x560;
+    eh->e_shnum = 3;
+
+    ph[0] = (Elf32_Phdr){ PT_LOAD, 0x100, 0, 0, XT_CHECK_CODE_SIZE, XT_CHECK_CODE_SIZE, PF_R | PF_X, XT_CHECK_ALIGN };
+    ph[1] = (Elf32_Phdr){ PT_LOAD, 0x200, XT_CHECK_DATA_OFFS, XT_CHECK_DATA_OFFS, XT_CHECK_DATA_FILESZ, XT_CHECK_DATA_MEMSZ, PF_R | PF_W, XT_CHECK_ALIGN };
+    ph[2] = (Elf32_Phdr){ PT_DYNAMIC, 0x500, 0, 0, 0x80, 0x80, PF_R, 4 };
+
+    sh[1] = (Elf32_Shdr){ .sh_type = SHT_PROGBITS, .sh_size = XT_CHECK_CODE_SIZE, .sh_addralign = 4 };
+    sh[2] = (Elf32_Shdr){ .sh_type = SHT_PROGBITS, .sh_size = XT_CHECK_DATA_FILESZ, .sh_addralign = XT_CHECK_ALIGN };
+
+    /* ...code and data contents */
+    for (i = 0; i < XT_CHECK_CODE_SIZE; i++)
+        code[i] = (unsigned char)(i * 7 + 1);
+    for (i = 0; i < 0x100; i++)
+        data[i] = (unsigned char)(i * 13 + 5);
+
+    /* ...data words pointing to code, data, bss; one unaligned */
+    xt_put(data + 0x00, 0x10);
+    rela[n++] = (Elf32_Rela){ XT_CHECK_DATA_OFFS + 0x00, ELF32_R_INFO(0, r_type), 0 };
+    xt_put(data + 0x04, 0);
+    rela[n++] = (Elf32_Rela){ XT_CHECK_DATA_OFFS + 0x04, ELF32_R_INFO(0, XTLIB_R_XTENSA_RELATIVE), 0x420 };
+    xt_put(data + 0x09, 0x20);
+    rela[n++] = (Elf32_Rela){ XT_CHECK_DATA_OFFS + 0x09, ELF32_R_INFO(0, XTLIB_R_XTENSA_RELATIVE), 4 };
+    xt_put(data + 0x10, 0x640);
+    rela[n++] = (Elf32_Rela){ XT_CHECK_DATA_OFFS + 0x10, ELF32_R_INFO(0, XTLIB_R_XTENSA_RELATIVE), 0 };
+    rela[n++] = (Elf32_Rela){ 0, ELF32_R_INFO(0, XTLIB_R_XTENSA_NONE), 0 };
+
+    if (code_relocs)
+    {
+        xt_put(code + 0x40, 0x410);
+        rela[n++] = (Elf32_Rela){ 0x40, ELF32_R_INFO(0, XTLIB_R_XTENSA_RELATIVE), 0 };
+        xt_put(code + 0x46, 0x30);
+        rela[n++] = (Elf32_Rela){ 0x46, ELF32_R_INFO(0, XTLIB_R_XTENSA_RELATIVE), 8 };
+    }
+
+    memcpy(data + XT_CHECK_RELA_ADDR - XT_CHECK_DATA_OFFS, rela, n * sizeof(rela[0]));
+
+    i = 0;
+    dyn[i++] = (Elf32_Dyn){ DT_RELA, { XT_CHECK_RELA_ADDR } };
+    dyn[i++] = (Elf32_Dyn){ DT_RELASZ, { n * sizeof(Elf32_Rela) } };
+    dyn[i++] = (Elf32_Dyn){ DT_INIT, { 0x8 } };
+    dyn[i++] = (Elf32_Dyn){ DT_FINI, { 0xc } };
+    dyn[i++] = (Elf32_Dyn){ DT_HASH, { 0x580 } };
+    dyn[i++] = (Elf32_Dyn){ DT_SYMTAB, { 0x590 } };
+    dyn[i++] = (Elf32_Dyn){ DT_STRTAB, { 0x5a0 } };
+    if (code_relocs)
+        dyn[i++] = (Elf32_Dyn){ DT_LOPROC + 2, { 0x4 } };
+    dyn[i++] = (Elf32_Dyn){ DT_NULL, { 0 } };
+}
+
+/*******************************************************************************
+ * Regular path: host PI loader followed by DSP relocation
+ ******************************************************************************/
+
+/* ...DSP address to buffer pointer */
+static unsigned char *xt_check_ptr(xt_check_buf_t *b, uint32_t code_phys, uint32_t data_phys, uint32_t addr)
+{
+    if (addr - data_phys < XT_CHECK_DATA_BUF)
+        return b->data + (addr - data_phys);
+
+    if (addr - code_phys < XT_CHECK_CODE_BUF)
+        return b->code + (addr - code_phys);
+
+    fprintf(stderr, "address 0x%08x outside of buffers\n", addr);
+    exit(1);
+}
+
+/* ...reloc_addr() of pi_relocate_lib.c */
+static uint32_t xt_check_reloc_addr(const uint32_t *pil, uint32_t addr)
+{
+    return (addr >= pil[3] ? pil[2] - pil[3] : pil[0] - pil[1]) + addr;
+}
+
+static void xt_check_load_ref(xt_check_buf_t *b, uint32_t code_phys, uint32_t data_phys, int load_code)
+{
+    Elf32_Ehdr     *eh = (Elf32_Ehdr *)image;
+    Elf32_Phdr     *ph = (Elf32_Phdr *)(image + eh->e_phoff);
+    Elf32_Dyn      *dyn = (Elf32_Dyn *)(image + ph[2].p_offset);
+    uint32_t        code_dst = xt_align(code_phys), data_dst = xt_align(data_phys);
+    uint32_t       *pil = b->pil_info;
+    unsigned char  *p;
+    uint32_t        i;
+
+    /* ...get_dyn_info() */
+    memset(pil, 0, sizeof(b->pil_info));
+    pil[0] = code_dst;
+    pil[1] = ph[0].p_paddr;
+    pil[2] = data_dst + ph[1].p_paddr;
+    pil[3] = ph[1].p_paddr;
+    pil[4] = code_dst - ph[0].p_paddr + eh->e_entry;
+    pil[13] = XT_CHECK_ALIGN;
+
+    for (; dyn->d_tag != DT_NULL; dyn++)
+    {
+        switch (dyn->d_tag)
+        {
+        case DT_RELA:       pil[8] = data_dst + dyn->d_un.d_ptr; break;
+        case DT_RELASZ:     pil[9] = dyn->d_un.d_val / sizeof(Elf32_Rela); break;
+        case DT_INIT:       pil[6] = code_dst - ph[0].p_paddr + dyn->d_un.d_ptr; break;
+        case DT_FINI:       pil[7] = code_dst - ph[0].p_paddr + dyn->d_un.d_ptr; break;
+        case DT_HASH:       pil[10] = data_dst + dyn->d_un.d_ptr; break;
+        case DT_SYMTAB:     pil[11] = data_dst + dyn->d_un.d_ptr; break;
+        case DT_STRTAB:     pil[12] = data_dst + dyn->d_un.d_ptr; break;
+        case DT_LOPROC + 2: pil[5] = code_dst - ph[0].p_paddr + dyn->d_un.d_ptr; break;
+        }
+    }
+
+    if (pil[5] == 0)
+        pil[5] = code_dst;
+
+    /* ...xtlib_load_seg() */
+    if (load_code)
+    {
+        p = b->code + (code_dst - code_phys);
+        memcpy(p, image + ph[0].p_offset, ph[0].p_filesz);
+        memset(p + ph[0].p_filesz, 0, ph[0].p_memsz - ph[0].p_filesz);
+    }
+
+    p = b->data + (data_dst - data_phys) + ph[1].p_paddr;
+    memcpy(p, image + ph[1].p_offset, ph[1].p_filesz);
+    memset(p + ph[1].p_filesz, 0, ph[1].p_memsz - ph[1].p_filesz);
+
+    /* ...xtlib_relocate_pi_lib(), relocation table is read from DSP memory */
+    for (i = 0; i < pil[9]; i++)
+    {
+        Elf32_Rela  r;
+
+        memcpy(&r, xt_check_ptr(b, code_phys, data_phys, pil[8] + i * sizeof(r)), sizeof(r));
+
+        if (ELF32_R_TYPE(r.r_info) != XTLIB_R_XTENSA_RELATIVE)
+            continue;
+
+        p = xt_check_ptr(b, code_phys, data_phys, xt_check_reloc_addr(pil, r.r_offset));
+        xt_put(p, xt_check_reloc_addr(pil, xt_get(p) + r.r_addend));
+    }
+}
+
+/*******************************************************************************
+ * Comparison
+ ******************************************************************************/
+
+static xt_check_buf_t   ref, plk;
+
+static void xt_check_run(const struct xtlib_prelink_header *h, uint32_t code_phys, uint32_t data_phys, int load_code)
+{
+    void       *code_virt = plk.code, *data_virt = plk.data;
+
+    memset(&ref, 0xa5, sizeof(ref));
+    memset(&plk, 0xa5, sizeof(plk));
+
+    /* ...shared code is loaded once by the regular path */
+    if (!load_code)
+    {
+        xt_check_load_ref(&ref, code_phys, data_phys, 1);
+        memcpy(plk.code, ref.code, sizeof(ref.code));
+        memset(ref.data, 0xa5, sizeof(ref.data));
+    }
+
+    xt_check_load_ref(&ref, code_phys, data_phys, load_code);
+    xtlib_prelink_load(h, &code_virt, code_phys, &data_virt, data_phys, load_code, plk.pil_info);
+
+    if (ref.pil_info[9] == 0 || plk.pil_info[9] != 0)
+    {
+        fprintf(stderr, "rela_count: %u / %u\n", ref.pil_info[9], plk.pil_info[9]);
+        exit(1);
+    }
+
+    ref.pil_info[9] = 0;
+
+    if (code_virt != plk.code + (xt_align(code_phys) - code_phys) ||
+        data_virt != plk.data + (xt_align(data_phys) - data_phys) ||
+        memcmp(&ref, &plk, sizeof(ref)))
+    {
+        fprintf(stderr, "mismatch: code 0x%08x data 0x%08x%s\n", code_phys, data_phys, load_code ? "" : " (shared code)");
+        exit(1);
+    }
+}
+
+int main(void)
+{
+    static const uint32_t   addr[][2] = {
+        { XT_CHECK_PRELINK_ADDR, 0x20010000 },
+        { XT_CHECK_PRELINK_ADDR, 0x20020004 },
+        { XT_CHECK_PRELINK_ADDR + 0x8, 0x20010000 },
+        { 0x30000000, 0x2000400c },
+        { 0x1fff0001, 0x20030000 },
+    };
+    struct xtlib_prelink_header    *h;
+    const char                     *err = NULL;
+    uint32_t                        n = 0, i;
+    int                             code_relocs;
+
+    for (code_relocs = 0; code_relocs < 2; code_relocs++)
+    {
+        xt_check_image(code_relocs, XTLIB_R_XTENSA_RELATIVE);
+
+        if ((h = xtlib_prelink_build(image, sizeof(image), XT_CHECK_PRELINK_ADDR, &err)) == NULL)
+        {
+            fprintf(stderr, "pre-link failed: %s\n", err);
+            return 1;
+        }
+
+        for (i = 0; i < sizeof(addr) / sizeof(addr[0]); i++, n++)
+        {
+            /* ...code without relocations is shared by all instances */
+            xt_check_run(h, addr[i][0], addr[i][1], code_relocs);
+        }
+
+        free(h);
+    }
+
+    /* ...instruction relocations are left to DSP */
+    xt_check_image(0, R_XTENSA_SLOT0_OP);
+
+    if ((h = xtlib_prelink_build(image, sizeof(image), XT_CHECK_PRELINK_ADDR, &err)) != NULL)
+    {
+        fprintf(stderr, "SLOT0_OP relocation pre-linked\n");
+        return 1;
+    }
+
+    printf("pre-linked images match regular load: %u configurations\n", n);
+
+    return 0;
+}